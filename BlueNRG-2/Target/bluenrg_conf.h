@@ -36,9 +36,9 @@ extern "C" {
 /*---------- Print messages from BLE2 files at middleware level -----------*/
 #define BLUENRG2_DEBUG      0
 /*---------- Number of Bytes reserved for HCI Read Packet -----------*/
-#define HCI_READ_PACKET_SIZE      128
+#define HCI_READ_PACKET_SIZE      255
 /*---------- Number of Bytes reserved for HCI Max Payload -----------*/
-#define HCI_MAX_PAYLOAD_SIZE      128
+#define HCI_MAX_PAYLOAD_SIZE      251
 /*---------- Number of incoming packets added to the list of packets to read -----------*/
 #define HCI_READ_PACKET_NUM_MAX      10
 /*---------- Scan Interval: time interval from when the Controller started its last scan until it begins the subsequent scan (for a number N, Time = N x 0.625 msec) -----------*/
@@ -21,6 +21,10 @@
 #include "RTE_Components.h"
 
 #include "hci_tl.h"
+#include <string.h>
+
+/* Application hooks: event pump (event_pump_isr_edge), profiling zones */
+#include "app_includes.h"
 
 /* Defines -------------------------------------------------------------------*/
 
@@ -28,14 +32,49 @@
 #define MAX_BUFFER_SIZE   255U
 #define TIMEOUT_DURATION  100U
 #define TIMEOUT_IRQ_HIGH  1000U
+/* IRQ line polled this long before the core sleeps: the end of frame
+   (falling) edge is not an EXTI event and usually comes within a few us */
+#define HCI_TL_SPI_WAIT_SPIN_US  50U
+/* Empty reads in a row with the IRQ line still high: the line is stuck */
+#define HCI_TL_SPI_STUCK_READS   3U
+
+/* The SPI buffers below must hold a whole HCI packet in either direction */
+#if (HCI_READ_PACKET_SIZE > MAX_BUFFER_SIZE)
+#error "HCI_READ_PACKET_SIZE exceeds the SPI frame buffer (MAX_BUFFER_SIZE)"
+#endif
+#if ((HCI_MAX_PAYLOAD_SIZE + 4) > MAX_BUFFER_SIZE)
+#error "HCI command packet (HCI_MAX_PAYLOAD_SIZE + 4) exceeds the SPI frame buffer (MAX_BUFFER_SIZE)"
+#endif
+
+/* Payloads shorter than this are clocked polled even in DMA mode */
+#define HCI_TL_SPI_DMA_MIN_SIZE  8U
+#define DMA_XFER_ONGOING         1
+
+/* Private types -------------------------------------------------------------*/
+/* Full duplex bus transfer used for the frame payload (polled or DMA) */
+typedef int32_t (*HCI_TL_SPI_Xfer_t)(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length);
 
 /* Private variables ---------------------------------------------------------*/
 EXTI_HandleTypeDef hexti0;
 
+/* MOSI filler while reading a payload: the BlueNRG expects 0x00 bytes */
+static uint8_t dummy_tx_buf[MAX_BUFFER_SIZE];
+
+/* Updated with the EXTI line masked (frame in progress) */
+static HCI_TL_SPI_Stats_t spi_stats;
+
+#if (USE_BSP_SPI1_DMA == 1U)
+static volatile int32_t dma_xfer_status;
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
+
 /* Private function prototypes -----------------------------------------------*/
 static void HCI_TL_SPI_Enable_IRQ(void);
 static void HCI_TL_SPI_Disable_IRQ(void);
+static uint32_t HCI_TL_SPI_Lock(void);
+static void HCI_TL_SPI_Unlock(uint32_t prev);
 static int32_t IsDataAvailable(void);
+static int32_t HCI_TL_SPI_WaitIrq(GPIO_PinState Level, uint32_t Timeout, HCI_TL_SPI_Wait_t* pWait);
+static void HCI_TL_SPI_WaitIrqLow(void);
 
 /******************** IO Operation and BUS services ***************************/
 /**
@@ -58,6 +97,34 @@ static void HCI_TL_SPI_Disable_IRQ(void)
   HAL_NVIC_DisableIRQ(HCI_TL_SPI_EXTI_IRQn);
 }
 
+/**
+ * @brief  Holds off the bottom half (PendSV) during a thread mode access.
+ *         Masks HCI_TL_SPI_BH_IT_PRIORITY only: every peripheral IRQ still runs.
+ *         Not to be called from the bottom half itself (BASEPRI is not
+ *         restored on exception return). Nests: a mask already raised by the
+ *         caller (or an outer lock) is kept, never lowered.
+ * @param  None
+ * @retval BASEPRI before the call, for HCI_TL_SPI_Unlock()
+ */
+static uint32_t HCI_TL_SPI_Lock(void)
+{
+  const uint32_t prev = __get_BASEPRI();
+
+  __set_BASEPRI_MAX(HCI_TL_SPI_BH_IT_PRIORITY << (8U - __NVIC_PRIO_BITS));
+  return prev;
+}
+
+/**
+ * @brief  Restores the mask HCI_TL_SPI_Lock() replaced: a pending bottom half
+ *         runs once the outermost lock is released.
+ * @param  prev : value returned by the matching HCI_TL_SPI_Lock()
+ * @retval None
+ */
+static void HCI_TL_SPI_Unlock(uint32_t prev)
+{
+  __set_BASEPRI(prev);
+}
+
 /**
  * @brief  Initializes the peripherals communication with the BlueNRG
  *         Expansion Board (via SPI, I2C, USART, ...)
@@ -125,37 +192,44 @@ int32_t HCI_TL_SPI_Reset(void)
   HAL_GPIO_WritePin(HCI_TL_RST_PORT, HCI_TL_RST_PIN, GPIO_PIN_RESET);
   HAL_Delay(5);
   HAL_GPIO_WritePin(HCI_TL_RST_PORT, HCI_TL_RST_PIN, GPIO_PIN_SET);
-  HAL_Delay(5);
+  /* No settle delay: bluenrg_init() waits for aci_blue_initialized_event() */
   return 0;
 }
 
 /**
- * @brief  Reads from BlueNRG SPI buffer and store data into local buffer.
+ * @brief  Reads one frame from the BlueNRG SPI buffer.
  *
  * @param  buffer : Buffer where data from SPI are stored
  * @param  size   : Buffer size
+ * @param  xfer   : Bus transfer used for the payload
  * @retval int32_t: Number of read bytes
  */
-int32_t HCI_TL_SPI_Receive(uint8_t* buffer, uint16_t size)
+static int32_t HCI_TL_SPI_ReceiveFrame(uint8_t* buffer, uint16_t size, HCI_TL_SPI_Xfer_t xfer)
 {
   uint16_t byte_count;
-  uint8_t len = 0;
-  uint8_t char_00 = 0x00;
-  volatile uint8_t read_char;
+  uint16_t len = 0;
 
   uint8_t header_master[HEADER_SIZE] = {0x0b, 0x00, 0x00, 0x00, 0x00};
   uint8_t header_slave[HEADER_SIZE];
 
+  PROFILE_BEGIN(PROFILE_ZONE_SPI_RX);
+
   HCI_TL_SPI_Disable_IRQ();
 
   /* CS reset */
   HAL_GPIO_WritePin(HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_RESET);
 
   /* Read the header */
-  BSP_SPI1_SendRecv(header_master, header_slave, HEADER_SIZE);
-
-  /* device is ready */
-  byte_count = (header_slave[4] << 8)| header_slave[3];
+  if(BSP_SPI1_SendRecv(header_master, header_slave, HEADER_SIZE) == BSP_ERROR_NONE)
+  {
+    spi_stats.wire_bytes += HEADER_SIZE;
+    /* device is ready */
+    byte_count = (header_slave[4] << 8)| header_slave[3];
+  }
+  else
+  {
+    byte_count = 0;
+  }
 
   if(byte_count > 0)
   {
@@ -166,40 +240,40 @@ int32_t HCI_TL_SPI_Receive(uint8_t* buffer, uint16_t size)
       byte_count = size;
     }
 
-    for(len = 0; len < byte_count; len++)
+    /* Clock the whole payload out in a single transfer (MOSI held at 0x00) */
+    if(xfer(dummy_tx_buf, buffer, byte_count) == BSP_ERROR_NONE)
     {
-      BSP_SPI1_SendRecv(&char_00, (uint8_t*)&read_char, 1);
-      buffer[len] = read_char;
+      len = byte_count;
+      spi_stats.rx_frames++;
+      spi_stats.rx_bytes += len;
+      spi_stats.wire_bytes += byte_count;
     }
   }
-
-  /**
-   * To be aligned to the SPI protocol.
-   * Can bring to a delay inside the frame, due to the BlueNRG-2 that needs
-   * to check if the header is received or not.
-   */
-  uint32_t tickstart = HAL_GetTick();
-  while ((HAL_GetTick() - tickstart) < TIMEOUT_IRQ_HIGH) {
-    if (HAL_GPIO_ReadPin(HCI_TL_SPI_IRQ_PORT, HCI_TL_SPI_IRQ_PIN)==GPIO_PIN_RESET) {
-      break;
-    }
+  else
+  {
+    spi_stats.rx_empty++;
   }
+
+  HCI_TL_SPI_WaitIrqLow();
   HCI_TL_SPI_Enable_IRQ();
 
   /* Release CS line */
   HAL_GPIO_WritePin(HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET);
 
+  PROFILE_END(PROFILE_ZONE_SPI_RX);
+
   return len;
 }
 
 /**
- * @brief  Writes data from local buffer to SPI.
+ * @brief  Writes one frame from local buffer to SPI.
  *
  * @param  buffer : data buffer to be written
  * @param  size   : size of first data buffer to be written
- * @retval int32_t: Number of read bytes
+ * @param  xfer   : Bus transfer used for the payload
+ * @retval int32_t: 0 on success, -2 if BlueNRG buffer is too small, -3 on timeout
  */
-int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
+static int32_t HCI_TL_SPI_SendFrame(uint8_t* buffer, uint16_t size, HCI_TL_SPI_Xfer_t xfer)
 {
   int32_t result;
   uint16_t rx_bytes;
@@ -210,12 +284,12 @@ int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
   static uint8_t read_char_buf[MAX_BUFFER_SIZE];
   uint32_t tickstart = HAL_GetTick();
 
+  /* No frame read by the bottom half in the middle of this write */
+  const uint32_t basepri = HCI_TL_SPI_Lock();
   HCI_TL_SPI_Disable_IRQ();
 
   do
   {
-    uint32_t tickstart_data_available = HAL_GetTick();
-
     result = 0;
 
     /* CS reset */
@@ -223,16 +297,9 @@ int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
 
     /*
      * Wait until BlueNRG-2 is ready.
-     * When ready it will raise the IRQ pin.
+     * When ready it will raise the IRQ pin (rising edge: wakes the core).
      */
-    while(!IsDataAvailable())
-    {
-      if((HAL_GetTick() - tickstart_data_available) > TIMEOUT_DURATION)
-      {
-        result = -3;
-        break;
-      }
-    }
+    result = HCI_TL_SPI_WaitIrq(GPIO_PIN_SET, TIMEOUT_DURATION, &spi_stats.ready_wait);
     if(result == -3)
     {
       /* The break causes the exiting from the "while", so the CS line must be released */
@@ -241,24 +308,46 @@ int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
     }
 
     /* Read header */
-    BSP_SPI1_SendRecv(header_master, header_slave, HEADER_SIZE);
-
-    rx_bytes = (((uint16_t)header_slave[2])<<8) | ((uint16_t)header_slave[1]);
+    if(BSP_SPI1_SendRecv(header_master, header_slave, HEADER_SIZE) == BSP_ERROR_NONE)
+    {
+      spi_stats.wire_bytes += HEADER_SIZE;
+      rx_bytes = (((uint16_t)header_slave[2])<<8) | ((uint16_t)header_slave[1]);
+    }
+    else
+    {
+      /* Retried like a full buffer until TIMEOUT_DURATION */
+      rx_bytes = 0;
+    }
 
     if(rx_bytes >= size)
     {
       /* Buffer is big enough */
-      BSP_SPI1_SendRecv(buffer, read_char_buf, size);
+      if(xfer(buffer, read_char_buf, size) != BSP_ERROR_NONE)
+      {
+        result = -3;
+      }
+      else
+      {
+        spi_stats.wire_bytes += size;
+      }
     }
     else
     {
       /* Buffer is too small */
       result = -2;
+      spi_stats.tx_retries++;
     }
 
     /* Release CS line */
     HAL_GPIO_WritePin(HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET);
 
+    if(result == -2)
+    {
+      /* The BlueNRG frees its buffer over the next radio events: sleep until
+         the next interrupt (SysTick at the latest) instead of hammering the bus */
+      __WFE();
+    }
+
     if((HAL_GetTick() - tickstart) > TIMEOUT_DURATION)
     {
       result = -3;
@@ -266,22 +355,125 @@ int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
     }
   } while(result < 0);
 
-  /**
-   * To be aligned to the SPI protocol.
-   * Can bring to a delay inside the frame, due to the BlueNRG-2 that needs
-   * to check if the header is received or not.
-   */
-  tickstart = HAL_GetTick();
-  while ((HAL_GetTick() - tickstart) < TIMEOUT_IRQ_HIGH) {
-    if (HAL_GPIO_ReadPin(HCI_TL_SPI_IRQ_PORT, HCI_TL_SPI_IRQ_PIN)==GPIO_PIN_RESET) {
-      break;
-    }
+  if(result == 0)
+  {
+    spi_stats.tx_frames++;
+    spi_stats.tx_bytes += size;
   }
+  else
+  {
+    spi_stats.tx_timeouts++;
+  }
+
+  HCI_TL_SPI_WaitIrqLow();
   HCI_TL_SPI_Enable_IRQ();
+  HCI_TL_SPI_Unlock(basepri);
 
   return result;
 }
 
+/**
+ * @brief  Reads from BlueNRG SPI buffer and store data into local buffer.
+ *
+ * @param  buffer : Buffer where data from SPI are stored
+ * @param  size   : Buffer size
+ * @retval int32_t: Number of read bytes
+ */
+int32_t HCI_TL_SPI_Receive(uint8_t* buffer, uint16_t size)
+{
+  return HCI_TL_SPI_ReceiveFrame(buffer, size, BSP_SPI1_SendRecv);
+}
+
+/**
+ * @brief  Writes data from local buffer to SPI.
+ *
+ * @param  buffer : data buffer to be written
+ * @param  size   : size of first data buffer to be written
+ * @retval int32_t: Number of read bytes
+ */
+int32_t HCI_TL_SPI_Send(uint8_t* buffer, uint16_t size)
+{
+  return HCI_TL_SPI_SendFrame(buffer, size, BSP_SPI1_SendRecv);
+}
+
+#if (USE_BSP_SPI1_DMA == 1U)
+/**
+ * @brief  DMA transfer completion, called from the DMA interrupt.
+ *
+ * @param  Status : BSP status of the transfer
+ * @retval None
+ */
+static void HCI_TL_SPI_DMA_XferCplt(int32_t Status)
+{
+  dma_xfer_status = Status;
+}
+
+/**
+ * @brief  Full duplex payload transfer through DMA.
+ *         Short payloads are sent polled: below HCI_TL_SPI_DMA_MIN_SIZE the
+ *         DMA setup costs more than clocking the bytes directly.
+ *
+ * @param  pTxData : data to send
+ * @param  pRxData : data received
+ * @param  Length  : number of bytes to exchange
+ * @retval int32_t : BSP status
+ */
+static int32_t HCI_TL_SPI_SendRecv_DMA(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length)
+{
+  uint32_t tickstart;
+
+  if(Length < HCI_TL_SPI_DMA_MIN_SIZE)
+  {
+    return BSP_SPI1_SendRecv(pTxData, pRxData, Length);
+  }
+
+  dma_xfer_status = DMA_XFER_ONGOING;
+  if(BSP_SPI1_SendRecv_DMA(pTxData, pRxData, Length, HCI_TL_SPI_DMA_XferCplt) != BSP_ERROR_NONE)
+  {
+    return BSP_ERROR_BUS_FAILURE;
+  }
+
+  /* The DMA interrupt pre-empts the PendSV bottom half, so this also works from there.
+     Its completion interrupt (or SysTick) wakes the core */
+  tickstart = HAL_GetTick();
+  while(dma_xfer_status == DMA_XFER_ONGOING)
+  {
+    if((HAL_GetTick() - tickstart) > TIMEOUT_DURATION)
+    {
+      BSP_SPI1_AbortDMA();
+      return BSP_ERROR_BUS_FAILURE;
+    }
+    __WFE();
+  }
+
+  return dma_xfer_status;
+}
+
+/**
+ * @brief  Reads from BlueNRG SPI buffer, payload transferred by DMA.
+ *
+ * @param  buffer : Buffer where data from SPI are stored
+ * @param  size   : Buffer size
+ * @retval int32_t: Number of read bytes
+ */
+int32_t HCI_TL_SPI_Receive_DMA(uint8_t* buffer, uint16_t size)
+{
+  return HCI_TL_SPI_ReceiveFrame(buffer, size, HCI_TL_SPI_SendRecv_DMA);
+}
+
+/**
+ * @brief  Writes data from local buffer to SPI, payload transferred by DMA.
+ *
+ * @param  buffer : data buffer to be written
+ * @param  size   : size of first data buffer to be written
+ * @retval int32_t: 0 on success, -2 if BlueNRG buffer is too small, -3 on timeout
+ */
+int32_t HCI_TL_SPI_Send_DMA(uint8_t* buffer, uint16_t size)
+{
+  return HCI_TL_SPI_SendFrame(buffer, size, HCI_TL_SPI_SendRecv_DMA);
+}
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
+
 /**
  * @brief  Reports if the BlueNRG has data for the host micro.
  *
@@ -293,6 +485,98 @@ static int32_t IsDataAvailable(void)
   return (HAL_GPIO_ReadPin(HCI_TL_SPI_EXTI_PORT, HCI_TL_SPI_EXTI_PIN) == GPIO_PIN_SET);
 }
 
+/**
+ * @brief  End of frame handshake: waits for the BlueNRG to pull IRQ low.
+ *         To be aligned to the SPI protocol.
+ *         Can bring to a delay inside the frame, due to the BlueNRG-2 that needs
+ *         to check if the header is received or not.
+ *
+ * @param  None
+ * @retval None
+ */
+static void HCI_TL_SPI_WaitIrqLow(void)
+{
+  if(HCI_TL_SPI_WaitIrq(GPIO_PIN_RESET, TIMEOUT_IRQ_HIGH, &spi_stats.low_wait) != 0)
+  {
+    spi_stats.irq_low_timeouts++;
+  }
+}
+
+/**
+ * @brief  Waits for the BlueNRG IRQ line to reach a level, with the core asleep.
+ *         The line is polled for HCI_TL_SPI_WAIT_SPIN_US, then the core waits
+ *         in WFE between checks. SEVONPEND (hci_tl_lowlevel_init) turns the
+ *         EXTI0 rising edge into a wake-up event even while the line is masked
+ *         in the NVIC; any interrupt, SysTick included, wakes it as well, so the
+ *         timeout is checked at least every ms. DMA, UART log and sensor
+ *         interrupts keep running meanwhile.
+ *
+ * @param  Level   : GPIO_PIN_SET (data or buffer ready), GPIO_PIN_RESET (end of frame)
+ * @param  Timeout : in ms
+ * @param  pWait   : time statistics updated with this wait
+ * @retval int32_t : 0 when the level is reached, -3 on timeout
+ */
+static int32_t HCI_TL_SPI_WaitIrq(GPIO_PinState Level, uint32_t Timeout, HCI_TL_SPI_Wait_t* pWait)
+{
+  const uint32_t start = app_port_cycles();
+  const uint32_t spin_cycles = HCI_TL_SPI_WAIT_SPIN_US * app_port_cycles_per_us();
+  const uint32_t tickstart = HAL_GetTick();
+  int32_t result = 0;
+  uint32_t us;
+
+  while(HAL_GPIO_ReadPin(HCI_TL_SPI_IRQ_PORT, HCI_TL_SPI_IRQ_PIN) != Level)
+  {
+    if((HAL_GetTick() - tickstart) > Timeout)
+    {
+      result = -3;
+      break;
+    }
+    if((app_port_cycles() - start) >= spin_cycles)
+    {
+      __WFE();
+    }
+  }
+
+  us = (app_port_cycles() - start) / app_port_cycles_per_us();
+  pWait->count++;
+  pWait->total_us += us;
+  if(us > pWait->max_us)
+  {
+    pWait->max_us = us;
+  }
+  return result;
+}
+
+/**
+ * @brief  Copies the SPI transport counters.
+ *
+ * @param  pStats : destination
+ * @retval None
+ */
+void HCI_TL_SPI_GetStats(HCI_TL_SPI_Stats_t* pStats)
+{
+  if(pStats != NULL)
+  {
+    /* Counters are updated by the bottom half */
+    const uint32_t basepri = HCI_TL_SPI_Lock();
+    *pStats = spi_stats;
+    HCI_TL_SPI_Unlock(basepri);
+  }
+}
+
+/**
+ * @brief  Clears the SPI transport counters.
+ *
+ * @param  None
+ * @retval None
+ */
+void HCI_TL_SPI_ResetStats(void)
+{
+  const uint32_t basepri = HCI_TL_SPI_Lock();
+  memset(&spi_stats, 0, sizeof(spi_stats));
+  HCI_TL_SPI_Unlock(basepri);
+}
+
 /***************************** hci_tl_interface main functions *****************************/
 /**
  * @brief  Register hci_tl_interface IO bus services
@@ -310,8 +594,13 @@ void hci_tl_lowlevel_init(void)
   /* Register IO bus services */
   fops.Init    = HCI_TL_SPI_Init;
   fops.DeInit  = HCI_TL_SPI_DeInit;
+#if (USE_BSP_SPI1_DMA == 1U)
+  fops.Send    = HCI_TL_SPI_Send_DMA;
+  fops.Receive = HCI_TL_SPI_Receive_DMA;
+#else
   fops.Send    = HCI_TL_SPI_Send;
   fops.Receive = HCI_TL_SPI_Receive;
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
   fops.Reset   = HCI_TL_SPI_Reset;
   fops.GetTick = BSP_GetTick;
 
@@ -324,8 +613,12 @@ void hci_tl_lowlevel_init(void)
   /* Register event irq handler */
   HAL_EXTI_GetHandle(&hexti0, EXTI_LINE_0);
   HAL_EXTI_RegisterCallback(&hexti0, HAL_EXTI_COMMON_CB_ID, hci_tl_lowlevel_isr);
-  HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(EXTI0_IRQn, HCI_TL_SPI_EXTI_IT_PRIORITY, 0);
   HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+  /* Frames are read by hci_tl_lowlevel_bottom_half() */
+  HAL_NVIC_SetPriority(PendSV_IRQn, HCI_TL_SPI_BH_IT_PRIORITY, 0);
+  /* IRQ line waits sleep in WFE: a pending EXTI0, even masked, must wake them */
+  HAL_PWR_EnableSEVOnPend();
 
   /* USER CODE BEGIN hci_tl_lowlevel_init 3 */
 
@@ -335,22 +628,64 @@ void hci_tl_lowlevel_init(void)
 
 /**
   * @brief HCI Transport Layer Low Level Interrupt Service Routine
+  *        Only records the edge and pends the bottom half: the SPI frames,
+  *        with their end of frame wait (up to TIMEOUT_IRQ_HIGH), are read at
+  *        the lowest priority so that no other interrupt waits for them.
   *
   * @param  None
   * @retval None
   */
 void hci_tl_lowlevel_isr(void)
 {
+  PROFILE_BEGIN(PROFILE_ZONE_HCI_ISR);
+
+  event_pump_isr_edge();
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+
+  /* USER CODE BEGIN hci_tl_lowlevel_isr */
+
+  /* USER CODE END hci_tl_lowlevel_isr */
+
+  PROFILE_END(PROFILE_ZONE_HCI_ISR);
+}
+
+/**
+  * @brief HCI Transport Layer deferred reader (PendSV, HCI_TL_SPI_BH_IT_PRIORITY)
+  *        Reads every frame the BlueNRG has pending into the HCI RX queue.
+  *        Pre-empts thread mode only: it cannot interrupt a frame written by
+  *        HCI_TL_SPI_SendFrame(), which holds it off with HCI_TL_SPI_Lock().
+  *
+  * @param  None
+  * @retval None
+  */
+void hci_tl_lowlevel_bottom_half(void)
+{
+  uint32_t empty_reads = 0;
+
+  PROFILE_BEGIN(PROFILE_ZONE_HCI_BH);
+
   /* Call hci_notify_asynch_evt() */
   while(IsDataAvailable())
   {
+    const uint32_t rx_empty = spi_stats.rx_empty;
+
     if (hci_notify_asynch_evt(NULL))
     {
-      return;
+      /* RX pool full: event_pump_run() re-pends once it has been drained */
+      break;
     }
-  }
 
-  /* USER CODE BEGIN hci_tl_lowlevel_isr */
+    /* A stuck line would keep this loop (and the CPU) here forever: mask it
+       and let the main loop reset the controller (app_recovery.c) */
+    empty_reads = (spi_stats.rx_empty != rx_empty) ? (empty_reads + 1U) : 0U;
+    if (empty_reads >= HCI_TL_SPI_STUCK_READS)
+    {
+      HCI_TL_SPI_Disable_IRQ();
+      spi_stats.irq_stuck++;
+      recovery_report(RECOVERY_CAUSE_IRQ_STUCK);
+      break;
+    }
+  }
 
-  /* USER CODE END hci_tl_lowlevel_isr */
+  PROFILE_END(PROFILE_ZONE_HCI_BH);
 }
@@ -32,6 +32,11 @@
 #define HCI_TL_SPI_EXTI_PORT  GPIOA
 #define HCI_TL_SPI_EXTI_PIN   GPIO_PIN_0
 #define HCI_TL_SPI_EXTI_IRQn  EXTI0_IRQn
+/* Must stay below BUS_SPI1_DMA_IT_PRIORITY and TICK_INT_PRIORITY (lower urgency) */
+#define HCI_TL_SPI_EXTI_IT_PRIORITY  2U
+/* PendSV bottom half reading the frames: lowest urgency, below every peripheral.
+   Must match NVIC.PendSV_IRQn in the .ioc (HAL_MspInit) */
+#define HCI_TL_SPI_BH_IT_PRIORITY    15U
 
 #define HCI_TL_SPI_IRQ_PORT   GPIOA
 #define HCI_TL_SPI_IRQ_PIN    GPIO_PIN_0
@@ -42,6 +47,34 @@
 #define HCI_TL_RST_PORT       GPIOA
 #define HCI_TL_RST_PIN        GPIO_PIN_8
 
+/* Exported types ------------------------------------------------------------*/
+/* Time spent waiting on the IRQ line for one handshake step */
+typedef struct
+{
+  uint32_t count;            /* Waits */
+  uint32_t total_us;         /* Sum of the wait times, mean = total_us / count */
+  uint32_t max_us;           /* Longest wait */
+} HCI_TL_SPI_Wait_t;
+
+/* SPI transport counters. wire_bytes counts the bytes of the transfers that
+   completed: 5-byte headers of all attempts (retries included) plus the
+   payloads; a failed or aborted transfer is not counted. */
+typedef struct
+{
+  uint32_t rx_frames;        /* Read frames with a payload */
+  uint32_t rx_empty;         /* Read frames where the BlueNRG had nothing to send */
+  uint32_t rx_bytes;         /* Payload bytes read */
+  uint32_t tx_frames;        /* Write frames accepted by the BlueNRG */
+  uint32_t tx_bytes;         /* Payload bytes written */
+  uint32_t tx_retries;       /* Write attempts refused, BlueNRG buffer too small (-2) */
+  uint32_t tx_timeouts;      /* Writes abandoned on timeout (-3) */
+  uint32_t irq_low_timeouts; /* End of frame without the IRQ line going low */
+  uint32_t irq_stuck;        /* IRQ line held high over HCI_TL_SPI_STUCK_READS empty reads */
+  HCI_TL_SPI_Wait_t ready_wait; /* Write: CS low to IRQ high (BlueNRG ready) */
+  HCI_TL_SPI_Wait_t low_wait;   /* End of frame: IRQ back low */
+  uint32_t wire_bytes;       /* Total bytes exchanged on SPI */
+} HCI_TL_SPI_Stats_t;
+
 /* Exported variables --------------------------------------------------------*/
 extern EXTI_HandleTypeDef     hexti0;
 #define H_EXTI_0 hexti0
@@ -52,6 +85,12 @@ int32_t HCI_TL_SPI_DeInit  (void);
 int32_t HCI_TL_SPI_Receive (uint8_t* buffer, uint16_t size);
 int32_t HCI_TL_SPI_Send    (uint8_t* buffer, uint16_t size);
 int32_t HCI_TL_SPI_Reset   (void);
+void    HCI_TL_SPI_GetStats(HCI_TL_SPI_Stats_t* pStats);
+void    HCI_TL_SPI_ResetStats(void);
+#if (USE_BSP_SPI1_DMA == 1U)
+int32_t HCI_TL_SPI_Receive_DMA (uint8_t* buffer, uint16_t size);
+int32_t HCI_TL_SPI_Send_DMA    (uint8_t* buffer, uint16_t size);
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 
 /**
  * @brief  Register hci_tl_interface IO bus services
@@ -69,6 +108,14 @@ void hci_tl_lowlevel_init(void);
  */
 void hci_tl_lowlevel_isr(void);
 
+/**
+ * @brief HCI Transport Layer deferred reader, called from PendSV_Handler
+ *
+ * @param  None
+ * @retval None
+ */
+void hci_tl_lowlevel_bottom_half(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,67 @@
+/*
+ * app_adv.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_ADV_H_
+#define INC_APP_ADV_H_
+
+/* Fast burst after boot / disconnect: 20 .. 30 ms (x 0.625 ms) */
+#define ADV_FAST_INTERV_MIN				( 32U )
+#define ADV_FAST_INTERV_MAX				( 48U )
+/* Length of the fast burst before stepping down to ADV_INTERV_MIN / MAX (bluenrg_conf.h) */
+#define ADV_FAST_WINDOW_MS				( 30000U )
+/* Wait before trying again when the controller refused to start advertising */
+#define ADV_RETRY_MS							( 1000U )
+/* High duty cycle directed advertising: at most 3.75 ms between events, 1.28 s long (LL) */
+#define ADV_DIRECTED_EVENT_US			( 3750U )
+/* Random advDelay added by the LL to every advertising event: 0 .. 10 ms */
+#define ADV_DELAY_AVG_US					( 5000U )
+
+typedef enum
+{
+	ADV_PHASE_OFF = 0,
+	ADV_PHASE_DIRECTED,			/* To the last bonded central, APP_SECURITY only */
+	ADV_PHASE_FAST,
+	ADV_PHASE_SLOW,
+	ADV_PHASE_COUNT
+} adv_phase_t;
+
+/* Why advertising is (re)started */
+typedef enum
+{
+	ADV_REASON_BOOT = 0,
+	ADV_REASON_DISCONNECT,	/* Fast burst, directed first when possible */
+	ADV_REASON_ROOM,				/* Connected, table entries left: slow only */
+	ADV_REASON_FAILED,			/* Connection attempt failed: resume the current phase */
+} adv_reason_t;
+
+typedef struct
+{
+	uint32_t starts;				/* aci_gap_set_discoverable / set_direct_connectable calls */
+	uint32_t time_ms;				/* Time spent advertising in this phase */
+	uint32_t connects;			/* Connections made while in this phase */
+} adv_phase_stats_t;
+
+typedef struct
+{
+	adv_phase_stats_t phase[ADV_PHASE_COUNT];
+	/* Time to reconnect: advertising request (boot / disconnect) to connection complete */
+	uint32_t reconnects;
+	uint32_t reconnect_sum_ms;
+	uint32_t reconnect_min_ms;
+	uint32_t reconnect_max_ms;
+	uint32_t failures;			/* ACI start / stop errors */
+} adv_stats_t;
+
+extern void adv_request( adv_reason_t reason );
+extern void adv_poll( void );
+extern bool adv_is_ready( void );
+extern void adv_on_connection_complete( uint8_t status );
+extern adv_phase_t adv_get_phase( void );
+extern void adv_get_stats( adv_stats_t * p_stats );
+extern void adv_print_stats( void );
+
+#endif /* INC_APP_ADV_H_ */
@@ -0,0 +1,45 @@
+/*
+ * app_bench.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_BENCH_H_
+#define INC_APP_BENCH_H_
+
+/* Control RX commands (health_control_rx)
+ *   { BENCH_CMD_START, size, count LSB, count MSB } : stream count notifications of size bytes
+ *   { BENCH_CMD_STOP }                              : abort, report what was sent */
+#define BENCH_CMD_START				( 0xB0U )
+#define BENCH_CMD_STOP				( 0xB1U )
+#define BENCH_CMD_START_LEN		( 4U )
+
+/* Notifications sent per bench_run() call, bounds the main loop latency */
+#define BENCH_BURST_MAX				( 8U )
+
+/* Payload starts with the 32-bit sequence number (LSB first) */
+#define BENCH_SEQ_LEN					( 4U )
+
+typedef struct
+{
+	uint16_t size;					/* Notification payload, bytes */
+	uint16_t count;					/* Notifications requested */
+	uint32_t sent;					/* Notifications accepted by the controller */
+	uint32_t busy_retries;	/* Controller out of TX buffers */
+	uint32_t elapsed_ms;		/* First to last accepted notification */
+	uint16_t conn_interval;	/* x 1.25 ms, at the end of the run */
+	uint8_t  tx_phy;
+	uint16_t att_mtu;
+} bench_result_t;
+
+extern bool bench_handle_command( const uint8_t * data, uint16_t len );
+extern void bench_run( void );
+extern bool bench_is_ready( void );
+extern bool bench_is_running( void );
+extern void bench_on_pool_available( void );
+extern void bench_on_disconnect( void );
+extern void bench_get_result( bench_result_t * p_result );
+extern void bench_print_result( void );
+
+#endif /* INC_APP_BENCH_H_ */
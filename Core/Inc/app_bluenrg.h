@@ -10,9 +10,18 @@
 
 #define INVALID_CONNECTION_HANDLE  ( 0xFFFF )
 
-extern volatile uint16_t connection_handle;
+/* Longest wait for aci_blue_initialized_event() after the controller reset */
+#define BLUENRG_READY_TIMEOUT_MS		( 500U )
+/* aci_blue_initialized_event() Reason_Code of a normal start (application mode) */
+#define BLUENRG_INIT_REASON_NORMAL	( 0x01U )
 
 extern tBleStatus bluenrg_init( void );
-extern tBleStatus bluenrg_start_advertising( void );
+extern tBleStatus bluenrg_restart( void );
+extern void bluenrg_on_initialized( uint8_t reason );
+extern tBleStatus bluenrg_start_advertising( uint16_t interval_min, uint16_t interval_max );
+extern tBleStatus bluenrg_start_directed_advertising( uint8_t peer_addr_type, const uint8_t peer_addr[6] );
+extern tBleStatus bluenrg_stop_advertising( void );
+extern bool bluenrg_is_advertising( void );
+extern void bluenrg_on_advertising_stopped( void );
 
 #endif /* INC_APP_BLUENRG_H_ */
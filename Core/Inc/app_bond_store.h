@@ -0,0 +1,50 @@
+/*
+ * app_bond_store.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_BOND_STORE_H_
+#define INC_APP_BOND_STORE_H_
+
+/* Flash sector 7 (128 KB, last of the STM32F411RE), kept out of FLASH in STM32F411RETX_FLASH.ld */
+#define BOND_STORE_SECTOR					( FLASH_SECTOR_7 )
+#define BOND_STORE_BASE						( 0x08060000UL )
+#define BOND_STORE_SIZE						( 128UL * 1024UL )
+
+/* Bonded centrals remembered (the BlueNRG-2 security database holds the keys) */
+#define BOND_STORE_PEERS_MAX			( 8U )
+/* Failed flash writes of one change retried before giving up until the next change */
+#define BOND_STORE_WRITE_RETRIES	( 3U )
+
+/* One bonded central, identity address as reported by aci_gap_get_bonded_devices() */
+typedef struct
+{
+	uint8_t addr_type;
+	uint8_t addr[6];
+	uint8_t cccd;				/* LINK_CCCD_xx of this central, restored when it reconnects */
+} bond_store_peer_t;
+
+typedef struct
+{
+	uint32_t records;			/* Records written since the last sector erase */
+	uint32_t writes;			/* bond_store_commit() flash writes */
+	uint32_t erases;			/* Sector erases (wear) */
+	uint32_t errors;			/* Program / erase failures */
+	uint32_t deferred;		/* Commits held back: sector erase needed while connected */
+} bond_store_stats_t;
+
+extern void bond_store_init( void );
+extern bool bond_store_find( uint8_t addr_type, const uint8_t addr[6] );
+extern bool bond_store_add( uint8_t addr_type, const uint8_t addr[6] );
+extern void bond_store_set( const bond_store_peer_t * p_peers, uint8_t count );
+extern uint8_t bond_store_count( void );
+extern bool bond_store_last( bond_store_peer_t * p_peer );
+extern bool bond_store_same( const bond_store_peer_t * p_peers, uint8_t count );
+extern uint8_t bond_store_get_cccd( uint8_t addr_type, const uint8_t addr[6] );
+extern void bond_store_set_cccd( uint8_t addr_type, const uint8_t addr[6], uint8_t cccd );
+extern void bond_store_commit( bool erase_allowed );
+extern void bond_store_get_stats( bond_store_stats_t * p_stats );
+
+#endif /* INC_APP_BOND_STORE_H_ */
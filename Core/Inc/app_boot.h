@@ -0,0 +1,35 @@
+/*
+ * app_boot.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_BOOT_H_
+#define INC_APP_BOOT_H_
+
+/* Boot timeline marks, in the order they are reached on a cold boot */
+typedef enum
+{
+	BOOT_PHASE_CLOCK = 0,				/* SystemClock_Config() done: reference of the timeline */
+	BOOT_PHASE_PERIPHERALS,			/* MX_xxx_Init(), log_init() */
+	BOOT_PHASE_CONTROLLER_RESET,	/* hci_init(): BlueNRG reset pin released */
+	BOOT_PHASE_CONTROLLER_READY,	/* aci_blue_initialized_event() */
+	BOOT_PHASE_CONFIG,					/* aci_hal_write_config_data() (public address) */
+	BOOT_PHASE_GATT_INIT,
+	BOOT_PHASE_GAP_INIT,
+	BOOT_PHASE_SECURITY,				/* security_init(), APP_SECURITY only */
+	BOOT_PHASE_SERVICES,				/* add_services() */
+	BOOT_PHASE_FIRST_ADV,				/* First advertising started (adv_poll) */
+	BOOT_PHASE_COUNT
+} boot_phase_t;
+
+/* boot_get_us() of a phase not reached */
+#define BOOT_PHASE_NOT_REACHED		( 0xFFFFFFFFUL )
+
+extern void boot_timeline_start( void );
+extern void boot_mark( boot_phase_t phase );
+extern uint32_t boot_get_us( boot_phase_t phase );
+extern void boot_print_timeline( void );
+
+#endif /* INC_APP_BOOT_H_ */
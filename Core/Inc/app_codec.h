@@ -0,0 +1,45 @@
+/*
+ * app_codec.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Standalone: needs only the C library, so app_codec.c builds on the
+ * central side as it is (the sampler's names in app_sampler.h alias these).
+ */
+
+#ifndef INC_APP_CODEC_H_
+#define INC_APP_CODEC_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Longest varint of a 16 / 32-bit value (7 bits per byte) */
+#define CODEC_VARINT16_MAX				( 3U )
+#define CODEC_VARINT32_MAX				( 5U )
+
+/* Sample frame layout, see app_sampler.h */
+#define CODEC_CHANNELS						( 2U )
+#define CODEC_FRAME_VERSION_RAW		( 0x01U )
+#define CODEC_FRAME_VERSION_DELTA	( 0x02U )
+#define CODEC_FRAME_HEADER_LEN		( 6U )
+#define CODEC_RECORD_RAW_LEN			( 1U + ( 2U * CODEC_CHANNELS ) )
+/* Worst case coded record: dt <= UINT8_MAX, 16-bit difference */
+#define CODEC_RECORD_DELTA_MAX		( 2U + ( CODEC_VARINT16_MAX * CODEC_CHANNELS ) )
+
+/* Decoded sample of a sampler frame (reference decoder) */
+typedef struct
+{
+	uint32_t ts_ms;
+	uint16_t value[CODEC_CHANNELS];
+} codec_sample_t;
+
+extern uint32_t codec_zigzag_encode( int32_t value );
+extern int32_t codec_zigzag_decode( uint32_t value );
+extern uint8_t codec_varint_put( uint32_t value, uint8_t * p_out );
+extern uint8_t codec_varint_get( const uint8_t * p_in, uint16_t len, uint32_t * p_value );
+
+extern uint8_t codec_put_sample( uint32_t dt_ms, const uint16_t * p_value, uint16_t * p_prev, uint8_t * p_out );
+extern int32_t codec_decode_sample_frame( const uint8_t * p_frame, uint16_t len, codec_sample_t * p_samples, uint16_t max_samples );
+
+#endif /* INC_APP_CODEC_H_ */
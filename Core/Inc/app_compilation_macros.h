@@ -0,0 +1,78 @@
+/*
+ * app_compilation_macros.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_COMPILATION_MACROS_H_
+#define INC_APP_COMPILATION_MACROS_H_
+
+/* ============================================================================
+ * Platform (selects the line ending used by app_debug.h)
+ * ==========================================================================*/
+#if !defined( APP_PLATFORM_WINDOWS ) && !defined( APP_PLATFORM_LINUX )
+#define APP_PLATFORM_WINDOWS
+#endif
+
+/* Application layer built for a PC against a software controller instead of
+ * the NUCLEO board: app_port.h functions become externals (see app_port.h) */
+#ifndef APP_HOST_BUILD
+#define APP_HOST_BUILD								( 0 )
+#endif
+
+/* ============================================================================
+ * Feature flags (0: disabled, 1: enabled)
+ * ==========================================================================*/
+
+/* IRQ edge -> callback latency histograms of the HCI event pump (DWT cycle counter) */
+#ifndef APP_EVENT_PUMP_STATS
+#define APP_EVENT_PUMP_STATS					( 1 )
+#endif
+
+/* Cycle counter profiling zones, PROFILE_BEGIN / PROFILE_END (app_profile.c) */
+#ifndef APP_PROFILE
+#define APP_PROFILE										( 1 )
+#endif
+
+/* LOG_xxx through the DMA driven log queue (app_log.c) instead of blocking fprintf */
+#ifndef APP_LOG_ASYNC
+#if ( 1 == APP_HOST_BUILD )
+#define APP_LOG_ASYNC									( 0 )
+#else
+#define APP_LOG_ASYNC									( 1 )
+#endif
+#endif
+
+/* Notification throughput benchmark: health_bench_tx characteristic and control RX commands (app_bench.c) */
+#ifndef APP_BENCH
+#define APP_BENCH											( 1 )
+#endif
+
+/* TIM3 / ADC1 / DMA sampling, packed into health_data_tx notifications (app_sampler.c) */
+#ifndef APP_SAMPLER
+#define APP_SAMPLER										( 1 )
+#endif
+
+/* Delta / zig-zag varint coded sampler frames (SAMPLER_FRAME_VERSION_DELTA, app_codec.c) */
+#ifndef APP_SAMPLER_CODEC
+#define APP_SAMPLER_CODEC							( 1 )
+#endif
+
+/* READ characteristics served by the controller, published on change (app_read_cache.c)
+ * instead of GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP round trips */
+#ifndef APP_READ_CACHE
+#define APP_READ_CACHE								( 1 )
+#endif
+
+/* LE Secure Connections bonding, bonded peers kept in flash sector 7 (app_security.c, app_bond_store.c) */
+#ifndef APP_SECURITY
+#define APP_SECURITY									( 1 )
+#endif
+
+/* Switch connection parameter profiles on notification TX queue depth (app_conn_profile.c) */
+#ifndef APP_CONN_PROFILE_AUTO
+#define APP_CONN_PROFILE_AUTO					( 1 )
+#endif
+
+#endif /* INC_APP_COMPILATION_MACROS_H_ */
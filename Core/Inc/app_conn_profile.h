@@ -0,0 +1,43 @@
+/*
+ * app_conn_profile.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_CONN_PROFILE_H_
+#define INC_APP_CONN_PROFILE_H_
+
+/* Named connection parameter sets, see g_conn_profiles[] */
+typedef enum
+{
+	CONN_PROFILE_LOW_LATENCY = 0,		/* Bulk transfer: shortest interval, no slave latency */
+	CONN_PROFILE_BALANCED,					/* bluenrg_conf.h L2CAP_INTERV_MIN/MAX, L2CAP_TIMEOUT_MULTIPLIER */
+	CONN_PROFILE_LOW_POWER,					/* Idle: long interval with slave latency */
+	CONN_PROFILE_COUNT
+} conn_profile_t;
+
+typedef struct
+{
+	const char *	name;
+	uint16_t			interval_min;		/* x 1.25 ms */
+	uint16_t			interval_max;		/* x 1.25 ms */
+	uint16_t			latency;				/* Connection events the slave may skip */
+	uint16_t			timeout;				/* Supervision timeout, x 10 ms */
+} conn_profile_params_t;
+
+/* Automatic switching on TX queue depth (conn_profile_poll) */
+#define CONN_PROFILE_TX_DEPTH_HIGH				( TX_QUEUE_DEPTH / 2U )	/* At or above: LOW_LATENCY */
+#define CONN_PROFILE_TX_DEPTH_LOW					( 0U )									/* At or below: LOW_POWER */
+/* Quiet time after connect, and between two automatic requests */
+#define CONN_PROFILE_AUTO_HOLDOFF_MS			( 5000U )
+
+extern void conn_profile_on_connect( uint16_t conn_handle );
+extern void conn_profile_on_disconnect( uint16_t conn_handle );
+extern tBleStatus conn_profile_request( uint16_t conn_handle, conn_profile_t profile );
+extern void conn_profile_poll( void );
+extern void conn_profile_on_update_resp( uint16_t conn_handle, bool accepted );
+extern void conn_profile_on_update_complete( uint16_t conn_handle );
+extern conn_profile_t conn_profile_get( uint16_t conn_handle );
+
+#endif /* INC_APP_CONN_PROFILE_H_ */
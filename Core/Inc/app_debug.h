@@ -28,12 +28,18 @@
  * ============================================================================
  */
 
+#if ( 1 == APP_LOG_ASYNC )
+/* Queue the formatted line, USART2 DMA sends it later (app_log.c). stream is not used. */
+#define LOG_PRINT_STD(stream, prefix, fmt, ...) \
+    log_printf(prefix fmt _NEXT_LINE_, ##__VA_ARGS__)
+#else
 /* Print directly to output if the calling macro permits it */
 #define LOG_PRINT_STD(stream, prefix, fmt, ...) \
     do { \
         fprintf((stream), prefix fmt _NEXT_LINE_, ##__VA_ARGS__); \
         fflush((stream)); \
     } while (false)
+#endif // of ( 1 == APP_LOG_ASYNC )
 
 /* Base error logger: always enabled */
 #define LOG_ERROR(fmt, ...) \
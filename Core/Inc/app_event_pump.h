@@ -0,0 +1,31 @@
+/*
+ * app_event_pump.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_EVENT_PUMP_H_
+#define INC_APP_EVENT_PUMP_H_
+
+/* Latency histograms, all measured from the BlueNRG IRQ rising edge */
+typedef enum
+{
+	EVENT_PUMP_HIST_CALLBACK = 0,		/* Edge -> App_UserEvtRx() */
+	EVENT_PUMP_HIST_READ_REPLY,			/* Edge -> aci_gatt_allow_read() returned */
+	EVENT_PUMP_HIST_COUNT
+} event_pump_hist_t;
+
+/* log2(us) buckets: bucket N holds samples in [2^(N-1), 2^N) us, bucket 0 is < 1 us */
+#define EVENT_PUMP_HIST_BUCKETS		( 16 )
+
+extern void event_pump_init( void );
+extern void event_pump_isr_edge( void );
+extern bool event_pump_is_pending( void );
+extern void event_pump_run( void );
+
+extern void event_pump_evt_begin( void );
+extern void event_pump_mark( event_pump_hist_t hist );
+extern void event_pump_print_stats( void );
+
+#endif /* INC_APP_EVENT_PUMP_H_ */
@@ -0,0 +1,93 @@
+/*
+ * app_gatt_db.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_GATT_DB_H_
+#define INC_APP_GATT_DB_H_
+
+/* BlueNRG-2 GATT database characteristic VALUE storage limit
+ * Design-time constant used by preprocessor validation.
+ *
+ * As per X-CUBE-NRG2 documentation:
+ *   Char_Value_Length valid range: 1 .. 512 bytes
+ */
+#define BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH   (512U)
+
+/*
+ * BlueNRG attribute handle layout of one characteristic:
+ *   H     : Characteristic Declaration (handle returned by aci_gatt_add_char)
+ *   H + 1 : Characteristic Value
+ *   H + 2 : CCCD (NOTIFY / INDICATE only)
+ */
+#define GATT_DB_VALUE_HANDLE( char_handle )		( (uint16_t)( (char_handle) + 1U ) )
+#define GATT_DB_CCCD_HANDLE( char_handle )		( (uint16_t)( (char_handle) + 2U ) )
+
+/* Number of rows of a const descriptor table */
+#define GATT_DB_ARRAY_COUNT( a )		( sizeof( a ) / sizeof( ( a )[0] ) )
+
+/* Size of the handle -> characteristic dispatch table (attribute handles of all registered services) */
+#ifndef GATT_DB_MAX_HANDLES
+#define GATT_DB_MAX_HANDLES				( 64U )
+#endif /* GATT_DB_MAX_HANDLES */
+
+/* Value read request: must refresh the value with aci_gatt_update_char_value() */
+typedef tBleStatus (*gatt_db_read_handler_t)( void * ctx );
+/* Value or CCCD write, conn_handle is the writing client */
+typedef tBleStatus (*gatt_db_write_handler_t)( uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length );
+
+/* One characteristic row: everything aci_gatt_add_char() needs, plus its handlers */
+typedef struct
+{
+	const char *		name;						/* Used in logs only */
+	const uint8_t *	uuid;						/* Little-endian, 2 or 16 bytes depending on uuid_type */
+	uint8_t					uuid_type;			/* UUID_TYPE_16 / UUID_TYPE_128 */
+	uint16_t				value_len;			/* MAX size of the VALUE attribute (not including CCCD) */
+	uint8_t					properties;			/* CHAR_PROP_xxx */
+	uint8_t					permissions;		/* ATTR_PERMISSION_xxx */
+	uint8_t					evt_mask;				/* GATT_xxx event mask */
+	uint8_t					enc_key_size;		/* 0 when permissions is ATTR_PERMISSION_NONE, else 7..16 */
+	uint8_t					is_variable;		/* 0 : fixed length, 1 : variable length */
+	uint16_t *			p_handle;				/* Receives the declaration handle */
+	gatt_db_read_handler_t	on_read;				/* H + 1 read (GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP), may be NULL */
+	gatt_db_write_handler_t	on_write;				/* H + 1 write (GATT_NOTIFY_ATTRIBUTE_WRITE), may be NULL */
+	gatt_db_write_handler_t	on_cccd_write;	/* H + 2 write (NOTIFY / INDICATE), may be NULL */
+	void *									ctx;						/* Passed back to the handlers */
+} gatt_char_desc_t;
+
+/* One service row, owning a const table of characteristics */
+typedef struct
+{
+	const char *							name;
+	const uint8_t *						uuid;
+	uint8_t										uuid_type;
+	uint8_t										service_type;		/* PRIMARY_SERVICE / SECONDARY_SERVICE */
+	const gatt_char_desc_t *	chars;
+	uint8_t										char_count;
+	uint16_t *								p_handle;				/* Receives the service handle */
+} gatt_service_desc_t;
+
+/* Which attribute of a characteristic a handle refers to */
+typedef enum
+{
+	GATT_DB_ATTR_NONE = 0,
+	GATT_DB_ATTR_DECL,
+	GATT_DB_ATTR_VALUE,
+	GATT_DB_ATTR_CCCD
+} gatt_db_attr_t;
+
+/* One dispatch slot per attribute handle */
+typedef struct
+{
+	const gatt_char_desc_t *	p_char;
+	gatt_db_attr_t						attr;
+} gatt_db_handle_entry_t;
+
+extern uint8_t gatt_db_char_attr_records( const gatt_char_desc_t * p_char );
+extern uint8_t gatt_db_service_attr_records( const gatt_service_desc_t * p_service );
+extern tBleStatus gatt_db_register( const gatt_service_desc_t * p_services, uint8_t service_count );
+extern const gatt_db_handle_entry_t * gatt_db_lookup( uint16_t attr_handle );
+
+#endif /* INC_APP_GATT_DB_H_ */
@@ -0,0 +1,18 @@
+/*
+ * app_hci_dispatch.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_HCI_DISPATCH_H_
+#define INC_APP_HCI_DISPATCH_H_
+
+extern void hci_dispatch_init( void );
+
+/* Return true when a handler was found and called */
+extern bool hci_dispatch_event( uint8_t evt_code, void * data );
+extern bool hci_dispatch_le_meta( uint8_t subevent, void * data );
+extern bool hci_dispatch_vendor( uint16_t ecode, void * data );
+
+#endif /* INC_APP_HCI_DISPATCH_H_ */
@@ -47,13 +47,32 @@
 /* ============================================================================
  * Application infrastructure
  * ==========================================================================*/
+#include "app_port.h"
+#include "app_log.h"
 #include "app_debug.h"
 #include "app_LED_report_error.h"
 
 /* ============================================================================
  * Application modules
  * ==========================================================================*/
+#include <app_boot.h>
 #include <app_bluenrg.h>
+#include <app_event_pump.h>
+#include <app_profile.h>
+#include <app_gatt_db.h>
+#include <app_hci_dispatch.h>
+#include <app_link.h>
+#include <app_tx_queue.h>
+#include <app_rx_queue.h>
+#include <app_conn_profile.h>
+#include <app_bond_store.h>
+#include <app_security.h>
+#include <app_adv.h>
+#include <app_recovery.h>
+#include <app_bench.h>
+#include <app_sampler.h>
+#include <app_codec.h>
+#include <app_read_cache.h>
 #include <app_services.h>
 
 #endif /* INC_APP_INCLUDES_H_ */
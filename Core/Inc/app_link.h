@@ -0,0 +1,81 @@
+/*
+ * app_link.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_LINK_H_
+#define INC_APP_LINK_H_
+
+/* Simultaneous centrals served (BlueNRG-2 controller supports up to 8 links) */
+#define LINK_MAX_CONNECTIONS			( 4U )
+
+/* Client Characteristic Configuration bits kept per connection (link_info_t.cccd) */
+#define LINK_CCCD_DATA_TX					( 1U << 0 )		/* health_data_tx notifications */
+#define LINK_CCCD_BENCH_TX				( 1U << 1 )		/* health_bench_tx notifications */
+
+/* ATT_MTU before (or without) an MTU exchange, BLE Core spec */
+#define LINK_ATT_MTU_DEFAULT			( 23U )
+/* Largest ATT_MTU supported by BlueNRG-2 */
+#define LINK_ATT_MTU_MAX					( 247U )
+/* Notification header: ATT opcode (1) + attribute handle (2) */
+#define LINK_ATT_NOTIFY_OVERHEAD	( 3U )
+
+/* LE Data Length Extension: largest LL payload and its airtime on 1M PHY */
+#define LINK_LL_OCTETS_DEFAULT		( 27U )
+#define LINK_LL_TIME_DEFAULT			( 328U )
+#define LINK_LL_OCTETS_MAX				( 251U )
+#define LINK_LL_TIME_MAX					( 2120U )
+
+/* PHY values used by the HCI LE PHY commands / events */
+#define LINK_PHY_1M								( 0x01U )
+#define LINK_PHY_2M								( 0x02U )
+
+/* Peer LE features (hci_le_read_remote_features), bit numbers of the LE feature mask */
+#define LINK_LE_FEATURE_DLE				( 5U )
+#define LINK_LE_FEATURE_2M_PHY		( 8U )
+
+/* Link state and agreed parameters of one connection (entry of the connection table) */
+typedef struct
+{
+	uint16_t conn_handle;		/* INVALID_CONNECTION_HANDLE: free entry */
+	uint16_t cccd;					/* LINK_CCCD_xx enabled by this client */
+	uint16_t att_mtu;				/* Negotiated ATT_MTU */
+	uint16_t max_tx_octets;	/* LL payload, hci_le_data_length_change_event */
+	uint16_t max_tx_time;		/* us */
+	uint16_t max_rx_octets;
+	uint16_t max_rx_time;		/* us */
+	uint8_t  tx_phy;				/* LINK_PHY_xx, hci_le_phy_update_complete_event */
+	uint8_t  rx_phy;
+	uint8_t  peer_features[8];	/* LE feature mask of the peer, 0 until read */
+	uint16_t conn_interval;	/* x 1.25 ms, connection complete / connection update complete */
+	uint16_t conn_latency;	/* Connection events */
+	uint16_t supervision_timeout;	/* x 10 ms */
+	uint32_t notified;			/* Notifications sent while this client was subscribed */
+} link_info_t;
+
+extern bool link_on_connect( uint16_t conn_handle );
+extern void link_on_disconnect( uint16_t conn_handle );
+extern void link_on_att_mtu( uint16_t conn_handle, uint16_t att_mtu );
+extern void link_on_remote_features( uint16_t conn_handle, const uint8_t features[8] );
+extern void link_on_data_length( uint16_t conn_handle, uint16_t tx_octets, uint16_t tx_time, uint16_t rx_octets, uint16_t rx_time );
+extern void link_on_phy( uint16_t conn_handle, uint8_t tx_phy, uint8_t rx_phy );
+extern void link_on_conn_params( uint16_t conn_handle, uint16_t interval, uint16_t latency, uint16_t timeout );
+
+extern void link_set_cccd( uint16_t conn_handle, uint16_t cccd_bit, bool enabled );
+extern void link_on_notified( uint16_t cccd_bit );
+
+extern int32_t link_slot( uint16_t conn_handle );
+extern uint16_t link_handle_at( uint32_t slot );
+extern uint32_t link_count( void );
+extern bool link_is_connected( uint16_t conn_handle );
+extern bool link_any_subscribed( uint16_t cccd_bit );
+extern uint16_t link_first_subscribed( uint16_t cccd_bit );
+extern uint16_t link_get_att_mtu( uint16_t conn_handle );
+extern uint16_t link_get_max_notify_len( uint16_t conn_handle );
+extern uint16_t link_get_fanout_notify_len( uint16_t cccd_bit );
+extern bool link_get_info( uint16_t conn_handle, link_info_t * p_info );
+extern void link_print_info( uint16_t conn_handle );
+
+#endif /* INC_APP_LINK_H_ */
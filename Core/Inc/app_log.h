@@ -0,0 +1,34 @@
+/*
+ * app_log.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_LOG_H_
+#define INC_APP_LOG_H_
+
+/* Number of queued lines, power of two */
+#define LOG_SLOT_COUNT				( 32U )
+/* Longest line, including the line ending (longer lines are truncated) */
+#define LOG_LINE_MAX					( 96U )
+/* Bulk mode: longest wait for a free slot before the line is dropped anyway
+ * (one LOG_LINE_MAX line at 115200 baud takes about 8 ms) */
+#define LOG_BULK_WAIT_MS			( 50U )
+
+typedef struct
+{
+	uint32_t written;			/* Lines queued */
+	uint32_t dropped;			/* Lines lost because every slot was in use */
+	uint32_t truncated;		/* Lines cut to LOG_LINE_MAX */
+	uint32_t waited;			/* Bulk mode lines that waited for a free slot */
+} log_stats_t;
+
+extern void log_init( UART_HandleTypeDef * huart );
+extern void log_printf( const char * fmt, ... ) __attribute__(( format( printf, 1, 2 ) ));
+extern void log_bulk_begin( void );
+extern void log_bulk_end( void );
+extern void log_get_stats( log_stats_t * p_stats );
+extern void log_print_stats( void );
+
+#endif /* INC_APP_LOG_H_ */
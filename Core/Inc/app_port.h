@@ -0,0 +1,73 @@
+/*
+ * app_port.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * The few MCU services the application modules use directly (time base,
+ * cycle counter, BlueNRG IRQ line). Everything else reaches the hardware
+ * through the BlueNRG middleware (aci_xxx / hci_xxx).
+ *
+ * APP_HOST_BUILD = 1 turns these into plain functions so the application
+ * layer can be linked against a software controller on a PC, which then
+ * provides them along with the aci_xxx / hci_xxx entry points.
+ */
+
+#ifndef INC_APP_PORT_H_
+#define INC_APP_PORT_H_
+
+#if ( 1 == APP_HOST_BUILD )
+
+extern uint32_t app_port_tick_ms( void );
+extern void app_port_cycle_counter_init( void );
+extern uint32_t app_port_cycles( void );
+extern uint32_t app_port_cycles_per_us( void );
+extern bool app_port_hci_irq_active( void );
+extern void app_port_hci_irq_repend( void );
+
+#else
+
+/* Milliseconds since reset (SysTick) */
+static inline uint32_t app_port_tick_ms( void )
+{
+	return HAL_GetTick();
+}
+
+/* Free running core cycle counter (DWT), left running when already enabled
+ * (boot timeline reference, app_boot.c) */
+static inline void app_port_cycle_counter_init( void )
+{
+	if( 0U != ( DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk ) )
+	{
+		return;
+	}
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t app_port_cycles( void )
+{
+	return DWT->CYCCNT;
+}
+
+static inline uint32_t app_port_cycles_per_us( void )
+{
+	return SystemCoreClock / 1000000U;
+}
+
+/* BlueNRG IRQ line high: the controller has data to read */
+static inline bool app_port_hci_irq_active( void )
+{
+	return ( GPIO_PIN_SET == HAL_GPIO_ReadPin( HCI_TL_SPI_IRQ_PORT, HCI_TL_SPI_IRQ_PIN ) );
+}
+
+/* Run hci_tl_lowlevel_isr() again without a new edge */
+static inline void app_port_hci_irq_repend( void )
+{
+	HAL_NVIC_SetPendingIRQ( HCI_TL_SPI_EXTI_IRQn );
+}
+
+#endif /* ( 1 == APP_HOST_BUILD ) */
+
+#endif /* INC_APP_PORT_H_ */
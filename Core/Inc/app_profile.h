@@ -0,0 +1,61 @@
+/*
+ * app_profile.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_PROFILE_H_
+#define INC_APP_PROFILE_H_
+
+/* Profiled code paths, one row each in the statistics table */
+typedef enum
+{
+	PROFILE_ZONE_EVT_PROC = 0,		/* hci_user_evt_proc() */
+	PROFILE_ZONE_USER_EVT_RX,			/* App_UserEvtRx() */
+	PROFILE_ZONE_READ_REQ,				/* Read_Request_CB() */
+	PROFILE_ZONE_SPI_RX,					/* HCI_TL_SPI_Receive() frame */
+	PROFILE_ZONE_GATT_UPDATE,			/* aci_gatt_update_char_value() */
+	PROFILE_ZONE_HCI_ISR,					/* hci_tl_lowlevel_isr(): EXTI0 time, blocks IRQs of lower urgency */
+	PROFILE_ZONE_HCI_BH,					/* hci_tl_lowlevel_bottom_half(): PendSV, blocks thread mode only */
+	PROFILE_ZONE_COUNT
+} profile_zone_t;
+
+/* Histogram bucket b counts durations of less than 2^b cycles */
+#define PROFILE_HIST_BUCKETS			( 24U )
+
+/* Control RX commands (health_control_rx) */
+#define PROFILE_CMD_DUMP					( 0xC0U )		/* Print the table over the log UART */
+#define PROFILE_CMD_RESET					( 0xC1U )		/* Clear the table */
+
+typedef struct
+{
+	uint32_t count;
+	uint32_t min;							/* Cycles */
+	uint32_t max;							/* Cycles */
+	uint64_t sum;							/* Cycles, mean = sum / count */
+	uint32_t bucket[PROFILE_HIST_BUCKETS];
+} profile_zone_stats_t;
+
+#if ( 1 == APP_PROFILE )
+
+/* Scoped zone: BEGIN and END of the same zone in the same block.
+ * Each zone must be recorded from one context only (main loop or one ISR). */
+#define PROFILE_BEGIN( zone )			const uint32_t profile_start_##zone = app_port_cycles()
+#define PROFILE_END( zone )				profile_record( ( zone ), app_port_cycles() - profile_start_##zone )
+
+#else
+
+#define PROFILE_BEGIN( zone )			do { } while( false )
+#define PROFILE_END( zone )				do { } while( false )
+
+#endif /* ( 1 == APP_PROFILE ) */
+
+extern void profile_init( void );
+extern void profile_record( profile_zone_t zone, uint32_t cycles );
+extern void profile_reset( void );
+extern bool profile_handle_command( const uint8_t * data, uint16_t len );
+extern void profile_get_stats( profile_zone_t zone, profile_zone_stats_t * p_stats );
+extern void profile_print_stats( void );
+
+#endif /* INC_APP_PROFILE_H_ */
@@ -0,0 +1,38 @@
+/*
+ * app_read_cache.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_READ_CACHE_H_
+#define INC_APP_READ_CACHE_H_
+
+/* Largest number of published characteristics */
+#define READ_CACHE_MAX_ENTRIES		( 8U )
+/* Sensor values are compared with the published ones at this period */
+#define READ_CACHE_POLL_MS				( 1000U )
+
+/* One READ characteristic served by the controller from its GATT DB */
+typedef struct
+{
+	const char * name;
+	bool ( *sample )( int16_t * p_value );			/* Current sensor value, false if none yet */
+	tBleStatus ( *publish )( int16_t value );		/* Writes the value into the controller GATT DB */
+	uint16_t deadband;													/* Republish when the value moves by more than this */
+} read_cache_desc_t;
+
+typedef struct
+{
+	uint32_t polls;
+	uint32_t published;			/* aci_gatt_update_char_value() calls */
+	uint32_t suppressed;		/* Changes within the deadband, nothing sent */
+	uint32_t failed;
+} read_cache_stats_t;
+
+extern tBleStatus read_cache_init( const read_cache_desc_t * p_desc, uint32_t count );
+extern void read_cache_poll( void );
+extern void read_cache_get_stats( read_cache_stats_t * p_stats );
+extern void read_cache_print_stats( void );
+
+#endif /* INC_APP_READ_CACHE_H_ */
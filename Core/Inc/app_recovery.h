@@ -0,0 +1,52 @@
+/*
+ * app_recovery.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_RECOVERY_H_
+#define INC_APP_RECOVERY_H_
+
+/* Consecutive ACI commands ending in BLE_STATUS_TIMEOUT (no command complete
+ * within the middleware timeout) that declare the controller hung */
+#define RECOVERY_HCI_TIMEOUT_LIMIT		( 2U )
+/* Wait before the next restart when one failed, doubled up to the max */
+#define RECOVERY_RETRY_MS							( 100U )
+#define RECOVERY_RETRY_MAX_MS					( 5000U )
+/* Disconnect reason given to the links lost with the controller (connection timeout) */
+#define RECOVERY_DISCONNECT_REASON		( 0x08U )
+
+/* Control RX command: restart the controller as on a real fault (time to recover) */
+#define RECOVERY_CMD_INJECT						( 0xE0U )
+
+typedef enum
+{
+	RECOVERY_CAUSE_INIT = 0,				/* bluenrg_init() failed at boot */
+	RECOVERY_CAUSE_HCI_TIMEOUT,			/* RECOVERY_HCI_TIMEOUT_LIMIT command timeouts in a row */
+	RECOVERY_CAUSE_IRQ_STUCK,				/* IRQ line high with nothing to read (hci_tl_interface.c) */
+	RECOVERY_CAUSE_INJECTED,				/* RECOVERY_CMD_INJECT */
+	RECOVERY_CAUSE_COUNT
+} recovery_cause_t;
+
+typedef struct
+{
+	uint32_t faults[RECOVERY_CAUSE_COUNT];
+	uint32_t restarts;					/* bluenrg_restart() calls */
+	uint32_t failed;						/* ... that did not bring the controller back */
+	/* Time to recover: fault detected to advertising again */
+	uint32_t recovered;
+	uint32_t ttr_sum_ms;
+	uint32_t ttr_min_ms;
+	uint32_t ttr_max_ms;
+} recovery_stats_t;
+
+extern void recovery_report( recovery_cause_t cause );
+extern void recovery_on_hci_status( tBleStatus status );
+extern bool recovery_poll( void );
+extern void recovery_on_advertising( void );
+extern bool recovery_handle_command( const uint8_t * data, uint16_t len );
+extern void recovery_get_stats( recovery_stats_t * p_stats );
+extern void recovery_print_stats( void );
+
+#endif /* INC_APP_RECOVERY_H_ */
@@ -0,0 +1,40 @@
+/*
+ * app_rx_queue.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_RX_QUEUE_H_
+#define INC_APP_RX_QUEUE_H_
+
+/* Ring capacity, power of two */
+#define RX_QUEUE_DEPTH				( 8U )
+/* Largest control RX write kept by a slot (health_control_rx value length) */
+#define RX_QUEUE_FRAME_MAX		( 20U )
+
+/* One control RX write, read in place by the command processor */
+typedef struct
+{
+	uint16_t conn_handle;		/* Writing client */
+	uint16_t len;
+	uint8_t  data[RX_QUEUE_FRAME_MAX];
+} rx_frame_t;
+
+typedef struct
+{
+	uint32_t received;		/* Accepted by rx_queue_push() */
+	uint32_t processed;		/* Handled by the command processor */
+	uint32_t rejected;		/* Not a known command (health_control_process) */
+	uint32_t overflow;		/* Ring full, write lost */
+	uint32_t oversize;		/* Longer than RX_QUEUE_FRAME_MAX, write lost */
+	uint32_t high_water;	/* Deepest backlog seen */
+} rx_queue_stats_t;
+
+extern tBleStatus rx_queue_push( uint16_t conn_handle, const uint8_t * data, uint16_t len );
+extern void rx_queue_process( void );
+extern bool rx_queue_is_ready( void );
+extern void rx_queue_get_stats( rx_queue_stats_t * p_stats );
+extern void rx_queue_print_stats( void );
+
+#endif /* INC_APP_RX_QUEUE_H_ */
@@ -0,0 +1,67 @@
+/*
+ * app_sampler.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_SAMPLER_H_
+#define INC_APP_SAMPLER_H_
+
+/* TIM3 update -> ADC1 scan of SAMPLER_CHANNELS channels every SAMPLER_PERIOD_MS */
+#define SAMPLER_PERIOD_MS					( 10U )
+#define SAMPLER_CHANNELS					( CODEC_CHANNELS )			/* PC0 (ADC1_IN10, Arduino A5), internal temperature sensor */
+#define SAMPLER_CH_ANALOG					( 0U )
+#define SAMPLER_CH_TEMPERATURE		( 1U )
+
+/* Samples per DMA half buffer: one half complete interrupt every 100 ms */
+#define SAMPLER_HALF_SAMPLES			( 10U )
+
+/* Samples waiting to be packed, power of two */
+#define SAMPLER_RING_DEPTH				( 64U )
+
+/* A frame that is not full is sent once its first sample is this old */
+#ifndef SAMPLER_FLUSH_MS
+#define SAMPLER_FLUSH_MS					( 250U )
+#endif
+
+/* Notification frame on health_data_tx (little-endian):
+ *   [0]    SAMPLER_FRAME_VERSION
+ *   [1]    sample count n
+ *   [2..5] time of the first sample, ms since sampler_start()
+ *   n x    { dt (ms since the previous sample, 0 for the first), value[SAMPLER_CHANNELS] (uint16) } */
+#define SAMPLER_FRAME_VERSION			( CODEC_FRAME_VERSION_RAW )
+#define SAMPLER_FRAME_HEADER_LEN	( CODEC_FRAME_HEADER_LEN )
+#define SAMPLER_RECORD_LEN				( CODEC_RECORD_RAW_LEN )
+
+/* Same header, records delta / zig-zag / varint coded (APP_SAMPLER_CODEC, app_codec.c):
+ *   n x    { varint( dt ), varint( zigzag( value[ch] - previous value[ch] ) ) per channel }
+ * The first sample of a frame is coded against 0 (keyframe) */
+#define SAMPLER_FRAME_VERSION_DELTA	( CODEC_FRAME_VERSION_DELTA )
+#define SAMPLER_RECORD_DELTA_MAX	( CODEC_RECORD_DELTA_MAX )
+
+/* Other notifications on health_data_tx, told apart from sample frames by [0]:
+ *   [0]    SAMPLER_FRAME_EVENT_BUTTON
+ *   [1..3] "hlg" (user button pressed, main.c) */
+#define SAMPLER_FRAME_EVENT_BUTTON	( 0x80U )
+
+typedef struct
+{
+	uint32_t samples;				/* Scans completed by the ADC */
+	uint32_t dropped;				/* Ring full: samples lost before packing */
+	uint32_t frames;				/* Frames handed to the TX queue */
+	uint32_t packed;				/* Samples sent in those frames */
+	uint32_t frame_retries;	/* TX queue full, frame kept for the next pass */
+	uint32_t frame_bytes;		/* Bytes of those frames, headers included */
+} sampler_stats_t;
+
+extern void sampler_init( void );
+extern void sampler_start( void );
+extern void sampler_stop( void );
+extern void sampler_poll( void );
+extern bool sampler_get_latest( uint32_t channel, uint16_t * p_raw );
+extern bool sampler_get_temperature( int16_t * p_celsius );
+extern void sampler_get_stats( sampler_stats_t * p_stats );
+extern void sampler_print_stats( void );
+
+#endif /* INC_APP_SAMPLER_H_ */
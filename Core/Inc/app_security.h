@@ -0,0 +1,59 @@
+/*
+ * app_security.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_SECURITY_H_
+#define INC_APP_SECURITY_H_
+
+/* Smallest LTK accepted, also the key size required by protected characteristics
+ * (LE Secure Connections always produces a 16 byte key) */
+#define SECURITY_ENC_KEY_SIZE_MIN		( MAX_ENCRY_KEY_SIZE )
+
+/* Permissions of the characteristics that need an encrypted link */
+#if ( 1 == APP_SECURITY )
+#define SECURITY_ATTR_PERMISSION		( ATTR_PERMISSION_ENCRY_WRITE )
+#define SECURITY_ATTR_KEY_SIZE			( SECURITY_ENC_KEY_SIZE_MIN )
+#else
+#define SECURITY_ATTR_PERMISSION		( ATTR_PERMISSION_NONE )
+#define SECURITY_ATTR_KEY_SIZE			( 0U )
+#endif /* ( 1 == APP_SECURITY ) */
+
+/* Control RX command: forget every bond (controller database and flash copy) */
+#define SECURITY_CMD_CLEAR_BONDS		( 0xD0U )
+
+/* Connect to encryption enabled, in ms */
+typedef struct
+{
+	uint32_t count;
+	uint32_t sum_ms;
+	uint32_t min_ms;
+	uint32_t max_ms;
+} security_latency_t;
+
+typedef struct
+{
+	security_latency_t resumed;		/* Bonded central, LL encryption with the stored LTK */
+	security_latency_t paired;		/* Full LE Secure Connections pairing on this connection */
+	uint32_t known_peers;					/* Connections from a central found in the bond store */
+	uint32_t pairing_failed;
+	uint32_t bond_lost;						/* Central lost its keys, rebond allowed */
+	uint32_t resynced;						/* Bond store rewritten from the controller list at boot */
+} security_stats_t;
+
+extern tBleStatus security_init( void );
+extern void security_on_connect( uint16_t conn_handle, uint8_t peer_addr_type, const uint8_t peer_addr[6] );
+extern void security_on_disconnect( uint16_t conn_handle );
+extern void security_on_pairing_complete( uint16_t conn_handle, uint8_t status, uint8_t reason );
+extern void security_on_encryption_change( uint16_t conn_handle, uint8_t status, bool enabled );
+extern void security_on_cccd_write( uint16_t conn_handle );
+extern void security_on_bond_lost( void );
+extern void security_poll( void );
+extern bool security_get_last_peer( bond_store_peer_t * p_peer );
+extern bool security_handle_command( const uint8_t * data, uint16_t len );
+extern void security_get_stats( security_stats_t * p_stats );
+extern void security_print_stats( void );
+
+#endif /* INC_APP_SECURITY_H_ */
@@ -8,8 +8,6 @@
 #ifndef INC_APP_SERVICES_H_
 #define INC_APP_SERVICES_H_
 
-extern volatile bool g_restart_adv;
-extern volatile bool notification_enabled;
 extern tBleStatus add_services(void);
 
 #endif /* INC_APP_SERVICES_H_ */
@@ -0,0 +1,33 @@
+/*
+ * app_tx_queue.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ */
+
+#ifndef INC_APP_TX_QUEUE_H_
+#define INC_APP_TX_QUEUE_H_
+
+/* Ring capacity, power of two */
+#define TX_QUEUE_DEPTH				( 16U )
+
+typedef struct
+{
+	uint32_t enqueued;		/* Accepted by tx_queue_push() */
+	uint32_t sent;				/* Accepted by the controller */
+	uint32_t retried;			/* Controller out of buffers, kept for the next pool available event */
+	/* One writer each (SPSC): added together only when printed */
+	uint32_t dropped_full;	/* Queue full, producer side */
+	uint32_t dropped_tx;		/* Rejected by health_data_tx(), consumer side */
+} tx_queue_stats_t;
+
+extern tBleStatus tx_queue_push( const uint8_t * data, uint16_t len );
+extern void tx_queue_pump( void );
+extern bool tx_queue_is_ready( void );
+extern uint32_t tx_queue_depth( void );
+extern void tx_queue_on_pool_available( void );
+extern void tx_queue_on_disconnect( void );
+extern void tx_queue_get_stats( tx_queue_stats_t * p_stats );
+extern void tx_queue_print_stats( void );
+
+#endif /* INC_APP_TX_QUEUE_H_ */
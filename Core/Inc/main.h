@@ -56,6 +56,10 @@ void Error_Handler(void);
 /* USER CODE BEGIN EFP */
 
 extern volatile bool g_btn_event;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+extern ADC_HandleTypeDef hadc1;
+extern DMA_HandleTypeDef hdma_adc1;
+extern TIM_HandleTypeDef htim3;
 
 /* USER CODE END EFP */
 
@@ -79,6 +83,12 @@ extern volatile bool g_btn_event;
 #define TCK_GPIO_Port GPIOA
 
 /* USER CODE BEGIN Private defines */
+/* USART2 TX DMA (log output): lowest urgency of the application interrupts */
+#define USART2_DMA_IT_PRIORITY 3U
+/* ADC1 DMA (sensor sampling): half buffer every 100 ms, same level as the log */
+#define SAMPLER_DMA_IT_PRIORITY 3U
+#define SENSOR_AIN_Pin GPIO_PIN_0
+#define SENSOR_AIN_GPIO_Port GPIOC
 
 /* USER CODE END Private defines */
 
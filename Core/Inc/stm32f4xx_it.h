@@ -58,7 +58,11 @@ void SysTick_Handler(void);
 void EXTI0_IRQHandler(void);
 void EXTI15_10_IRQHandler(void);
 /* USER CODE BEGIN EFP */
-
+void DMA2_Stream0_IRQHandler(void);
+void DMA2_Stream3_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
+void USART2_IRQHandler(void);
+void DMA2_Stream4_IRQHandler(void);
 /* USER CODE END EFP */
 
 #ifdef __cplusplus
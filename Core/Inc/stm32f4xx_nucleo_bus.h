@@ -84,6 +84,11 @@ typedef struct
   pSPI_CallbackTypeDef  pMspDeInitCb;
 }BSP_SPI_Cb_t;
 #endif /* (USE_HAL_SPI_REGISTER_CALLBACKS == 1U) */
+
+#if (USE_BSP_SPI1_DMA == 1U)
+/* Called from the DMA interrupt when a BSP_SPI1_SendRecv_DMA transfer ends */
+typedef void (*BSP_SPI_XferCpltCb_t)(int32_t Status);
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 /**
   * @}
   */
@@ -93,6 +98,10 @@ typedef struct
   */
 
 extern SPI_HandleTypeDef hspi1;
+#if (USE_BSP_SPI1_DMA == 1U)
+extern DMA_HandleTypeDef hdma_spi1_rx;
+extern DMA_HandleTypeDef hdma_spi1_tx;
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 
 /**
   * @}
@@ -109,6 +118,10 @@ int32_t BSP_SPI1_DeInit(void);
 int32_t BSP_SPI1_Send(uint8_t *pData, uint16_t Length);
 int32_t BSP_SPI1_Recv(uint8_t *pData, uint16_t Length);
 int32_t BSP_SPI1_SendRecv(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length);
+#if (USE_BSP_SPI1_DMA == 1U)
+int32_t BSP_SPI1_SendRecv_DMA(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length, BSP_SPI_XferCpltCb_t XferCpltCb);
+int32_t BSP_SPI1_AbortDMA(void);
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
 int32_t BSP_SPI1_RegisterDefaultMspCallbacks (void);
 int32_t BSP_SPI1_RegisterMspCallbacks (BSP_SPI_Cb_t *Callbacks);
@@ -50,6 +50,10 @@
 
 /* IRQ priorities */
 #define BSP_BUTTON_USER_IT_PRIORITY         15U
+#define BUS_SPI1_DMA_IT_PRIORITY            1U
+
+/* SPI1 DMA define (0: polled transfers only, 1: DMA transfers available) */
+#define USE_BSP_SPI1_DMA                    1U
 
 /* I2C1 Frequency in Hz  */
 #define BUS_I2C1_FREQUENCY                  100000U /* Frequency of I2C1 = 100 KHz*/
@@ -0,0 +1,300 @@
+/*
+ * app_adv.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Advertising scheduler.
+ *
+ * After boot or a disconnect the device advertises in a short burst so that
+ * a central scanning nearby finds it within a few tens of ms:
+ *   1. DIRECTED : high duty cycle directed advertising to the last bonded
+ *                 central (APP_SECURITY, only while nobody is connected).
+ *                 The LL ends it after 1.28 s with an advertising timeout.
+ *   2. FAST     : ADV_FAST_INTERV_MIN / MAX for ADV_FAST_WINDOW_MS.
+ *   3. SLOW     : ADV_INTERV_MIN / MAX (bluenrg_conf.h) until a connection.
+ * While other centrals are connected and table entries are left, only the
+ * SLOW phase is used.
+ *
+ * adv_request() only records what is wanted. The ACI calls are made by
+ * adv_poll() from the main loop. The time spent in each phase gives the
+ * advertising event count (duty cycle) and the time from the request to
+ * the connection gives the time to reconnect (adv_stats_t).
+ */
+
+#include "app_includes.h"
+
+/* Mean advertising event period of each phase in us, for the event estimate */
+static const uint32_t g_adv_event_us[ADV_PHASE_COUNT] =
+{
+	[ADV_PHASE_OFF]				= 0,
+	[ADV_PHASE_DIRECTED]	= ADV_DIRECTED_EVENT_US,
+	[ADV_PHASE_FAST]			= ( ( ADV_FAST_INTERV_MIN + ADV_FAST_INTERV_MAX ) * 625U / 2U ) + ADV_DELAY_AVG_US,
+	[ADV_PHASE_SLOW]			= ( ( ADV_INTERV_MIN + ADV_INTERV_MAX ) * 625U / 2U ) + ADV_DELAY_AVG_US,
+};
+
+static const char * const g_adv_phase_name[ADV_PHASE_COUNT] =
+{
+	[ADV_PHASE_OFF]				= "off",
+	[ADV_PHASE_DIRECTED]	= "directed",
+	[ADV_PHASE_FAST]			= "fast",
+	[ADV_PHASE_SLOW]			= "slow",
+};
+
+/* Set by adv_request(), cleared by a connection or a full table */
+static bool g_wanted = false;
+static adv_phase_t g_phase = ADV_PHASE_OFF;
+/* Phase started by the controller (false: adv_poll() must start it) */
+static bool g_started = false;
+static uint32_t g_phase_tick = 0;
+/* Boot / disconnect request not yet followed by a connection */
+static bool g_reconnect_pending = false;
+static uint32_t g_request_tick = 0;
+/* Start refused by the controller: no new attempt before ADV_RETRY_MS */
+static bool g_retry_wait = false;
+static uint32_t g_retry_tick = 0;
+
+static adv_stats_t g_adv_stats;
+
+/* Time spent in the current phase, added to its statistics */
+static void adv_account( void )
+{
+	if( ( ADV_PHASE_OFF != g_phase ) && g_started )
+	{
+		g_adv_stats.phase[g_phase].time_ms += app_port_tick_ms() - g_phase_tick;
+	}
+}
+
+static void adv_enter( adv_phase_t phase )
+{
+	adv_account();
+	g_phase = phase;
+	g_started = false;
+}
+
+static tBleStatus adv_start( void )
+{
+	tBleStatus ret = BLE_STATUS_FAILED;
+
+	switch( g_phase )
+	{
+#if ( 1 == APP_SECURITY )
+		case ADV_PHASE_DIRECTED:
+		{
+			bond_store_peer_t peer;
+			if( security_get_last_peer( &peer ) )
+			{
+				ret = bluenrg_start_directed_advertising( peer.addr_type, peer.addr );
+			}
+			break;
+		}
+#endif /* ( 1 == APP_SECURITY ) */
+		case ADV_PHASE_FAST:
+			ret = bluenrg_start_advertising( ADV_FAST_INTERV_MIN, ADV_FAST_INTERV_MAX );
+			break;
+		case ADV_PHASE_SLOW:
+			ret = bluenrg_start_advertising( ADV_INTERV_MIN, ADV_INTERV_MAX );
+			break;
+		default:
+			break;
+	}
+	return ret;
+}
+
+void adv_request( adv_reason_t reason )
+{
+	g_wanted = true;
+
+	switch( reason )
+	{
+		case ADV_REASON_BOOT:
+		case ADV_REASON_DISCONNECT:
+			g_reconnect_pending = true;
+			g_request_tick = app_port_tick_ms();
+			/* Restart the burst, also over a running slow phase */
+			if( bluenrg_is_advertising() && ( BLE_STATUS_SUCCESS != bluenrg_stop_advertising() ) )
+			{
+				g_adv_stats.failures++;
+			}
+#if ( 1 == APP_SECURITY )
+			if( ( 0U == link_count() ) && security_get_last_peer( NULL ) )
+			{
+				adv_enter( ADV_PHASE_DIRECTED );
+			}
+			else
+#endif /* ( 1 == APP_SECURITY ) */
+			{
+				adv_enter( ADV_PHASE_FAST );
+			}
+			break;
+
+		case ADV_REASON_ROOM:
+			if( ADV_PHASE_OFF == g_phase )
+			{
+				g_phase = ADV_PHASE_SLOW;
+				g_started = false;
+			}
+			break;
+
+		case ADV_REASON_FAILED:
+		default:
+			/* Same phase again (adv_poll() restarts it), directed only once */
+			adv_enter( ( ( ADV_PHASE_OFF == g_phase ) || ( ADV_PHASE_DIRECTED == g_phase ) ) ? ADV_PHASE_FAST : g_phase );
+			break;
+	}
+}
+
+/* Main loop: start the wanted phase, step down when its window is over */
+void adv_poll( void )
+{
+	if( false == g_wanted )
+	{
+		return;
+	}
+
+	if( LINK_MAX_CONNECTIONS <= link_count() )
+	{
+		/* Table full: no more centrals */
+		if( bluenrg_is_advertising() && ( BLE_STATUS_SUCCESS != bluenrg_stop_advertising() ) )
+		{
+			g_adv_stats.failures++;
+		}
+		adv_enter( ADV_PHASE_OFF );
+		g_wanted = false;
+		return;
+	}
+
+	if( g_started )
+	{
+		if( ( ADV_PHASE_DIRECTED == g_phase ) && ( false == bluenrg_is_advertising() ) )
+		{
+			/* 1.28 s over without the bonded central: everybody else now */
+			adv_enter( ADV_PHASE_FAST );
+		}
+		else if( ( ADV_PHASE_FAST == g_phase ) && ( ( app_port_tick_ms() - g_phase_tick ) >= ADV_FAST_WINDOW_MS ) )
+		{
+			if( BLE_STATUS_SUCCESS != bluenrg_stop_advertising() )
+			{
+				g_adv_stats.failures++;
+			}
+			adv_enter( ADV_PHASE_SLOW );
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	if( bluenrg_is_advertising() )
+	{
+		/* Still on from an earlier phase */
+		return;
+	}
+	if( g_retry_wait && ( ( app_port_tick_ms() - g_retry_tick ) < ADV_RETRY_MS ) )
+	{
+		return;
+	}
+	if( BLE_STATUS_SUCCESS != adv_start() )
+	{
+		g_adv_stats.failures++;
+		if( ADV_PHASE_DIRECTED == g_phase )
+		{
+			/* No usable bonded central: undirected straight away */
+			adv_enter( ADV_PHASE_FAST );
+		}
+		else
+		{
+			g_retry_wait = true;
+			g_retry_tick = app_port_tick_ms();
+		}
+		return;
+	}
+	g_retry_wait = false;
+	g_started = true;
+	g_phase_tick = app_port_tick_ms();
+	g_adv_stats.phase[g_phase].starts++;
+	boot_mark( BOOT_PHASE_FIRST_ADV );
+	recovery_on_advertising();
+	LOG_DEBUG("Advertising %s", g_adv_phase_name[g_phase]);
+}
+
+/* True when adv_poll() has an ACI call to make now */
+bool adv_is_ready( void )
+{
+	return g_wanted && ( false == g_started ) && ( false == g_retry_wait );
+}
+
+/* hci_le_connection_complete_event(): advertising has stopped either way */
+void adv_on_connection_complete( uint8_t status )
+{
+	const uint32_t now = app_port_tick_ms();
+
+	if( BLE_STATUS_SUCCESS != status )
+	{
+		/* Includes the directed advertising timeout (0x3C) */
+		adv_request( ADV_REASON_FAILED );
+		return;
+	}
+
+	if( ADV_PHASE_OFF != g_phase )
+	{
+		g_adv_stats.phase[g_phase].connects++;
+	}
+	if( g_reconnect_pending )
+	{
+		const uint32_t ms = now - g_request_tick;
+
+		g_reconnect_pending = false;
+		if( ( 0U == g_adv_stats.reconnects ) || ( ms < g_adv_stats.reconnect_min_ms ) )
+		{
+			g_adv_stats.reconnect_min_ms = ms;
+		}
+		if( ms > g_adv_stats.reconnect_max_ms )
+		{
+			g_adv_stats.reconnect_max_ms = ms;
+		}
+		g_adv_stats.reconnect_sum_ms += ms;
+		g_adv_stats.reconnects++;
+		LOG_DEBUG("Reconnected after %lu ms (%s)", (unsigned long)ms, g_adv_phase_name[g_phase]);
+	}
+	adv_enter( ADV_PHASE_OFF );
+	g_wanted = false;
+}
+
+adv_phase_t adv_get_phase( void )
+{
+	return g_phase;
+}
+
+void adv_get_stats( adv_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_adv_stats;
+	}
+}
+
+void adv_print_stats( void )
+{
+	uint32_t i;
+
+	for( i = ADV_PHASE_DIRECTED; ADV_PHASE_COUNT > i; i++ )
+	{
+		const adv_phase_stats_t * p = &g_adv_stats.phase[i];
+		/* Advertising events sent, about time / mean event period */
+		const uint32_t events = (uint32_t)( ( (uint64_t)p->time_ms * 1000U ) / g_adv_event_us[i] );
+
+		LOG_DEBUG("Adv : %s starts=%lu time=%lu ms connects=%lu events~%lu",
+		          g_adv_phase_name[i],
+		          (unsigned long)p->starts,
+		          (unsigned long)p->time_ms,
+		          (unsigned long)p->connects,
+		          (unsigned long)events);
+	}
+	LOG_DEBUG("Adv : reconnect n=%lu min=%lu avg=%lu max=%lu ms failures=%lu",
+	          (unsigned long)g_adv_stats.reconnects,
+	          (unsigned long)g_adv_stats.reconnect_min_ms,
+	          (unsigned long)( ( 0U != g_adv_stats.reconnects ) ? ( g_adv_stats.reconnect_sum_ms / g_adv_stats.reconnects ) : 0U ),
+	          (unsigned long)g_adv_stats.reconnect_max_ms,
+	          (unsigned long)g_adv_stats.failures);
+}
@@ -0,0 +1,232 @@
+/*
+ * app_bench.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Notification throughput benchmark.
+ *
+ * Started by a control RX write (BENCH_CMD_START), streams notifications on
+ * the health_bench_tx characteristic as fast as the controller accepts them,
+ * straight through aci_gatt_update_char_value() (no TX queue, no per packet
+ * log). When the controller runs out of TX buffers the run waits for
+ * aci_gatt_tx_pool_available_event() and counts a busy retry.
+ *
+ * The result gives bytes per second and notifications per connection event
+ * for the connection interval, PHY and ATT_MTU in force at the end of the run.
+ */
+
+#include "app_includes.h"
+
+#if ( 1 == APP_BENCH )
+
+typedef enum
+{
+	BENCH_IDLE = 0,
+	BENCH_RUNNING,
+	BENCH_BLOCKED,		/* Waiting for aci_gatt_tx_pool_available_event() */
+} bench_state_t;
+
+extern uint16_t health_service_handle;
+extern uint16_t health_bench_tx_char_handle;
+
+static volatile bench_state_t g_bench_state = BENCH_IDLE;
+static bench_result_t g_bench_result;
+static uint32_t g_bench_start_tick = 0;
+static uint32_t g_bench_last_tick = 0;
+
+static uint8_t g_bench_buf[LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD];
+
+/* Link parameters of the first benchmark subscriber, kept when it has gone */
+static void bench_capture_link( void )
+{
+	link_info_t info;
+
+	if( link_get_info( link_first_subscribed( LINK_CCCD_BENCH_TX ), &info ) )
+	{
+		g_bench_result.conn_interval = info.conn_interval;
+		g_bench_result.tx_phy = info.tx_phy;
+		g_bench_result.att_mtu = info.att_mtu;
+	}
+}
+
+static void bench_finish( const char * why )
+{
+	g_bench_state = BENCH_IDLE;
+	g_bench_result.elapsed_ms = g_bench_last_tick - g_bench_start_tick;
+
+	bench_capture_link();
+
+	LOG_DEBUG("Bench %s", why);
+	bench_print_result();
+}
+
+static tBleStatus bench_start( uint16_t size, uint16_t count )
+{
+	/* Every subscriber receives the same notification: smallest ATT_MTU */
+	const uint16_t max_len = link_get_fanout_notify_len( LINK_CCCD_BENCH_TX );
+
+	if( BENCH_IDLE != g_bench_state )
+	{
+		LOG_WARN("Bench already running");
+		return BLE_STATUS_FAILED;
+	}
+	if( false == link_any_subscribed( LINK_CCCD_BENCH_TX ) )
+	{
+		LOG_WARN("Bench: notifications not enabled");
+		return BLE_STATUS_FAILED;
+	}
+	if( ( BENCH_SEQ_LEN > size ) || ( max_len < size ) || ( 0U == count ) )
+	{
+		LOG_WARN("Bench: size %u (%u..%u) / count %u invalid", size, (unsigned)BENCH_SEQ_LEN, max_len, count);
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+
+	BLUENRG_memset( &g_bench_result, 0, sizeof( g_bench_result ) );
+	g_bench_result.size = size;
+	g_bench_result.count = count;
+	bench_capture_link();
+	/* Recognisable filler after the sequence number */
+	for( uint16_t i = 0; sizeof( g_bench_buf ) > i; i++ )
+	{
+		g_bench_buf[i] = (uint8_t)i;
+	}
+	g_bench_state = BENCH_RUNNING;
+	LOG_DEBUG("Bench start: %u x %u bytes", count, size);
+
+	return BLE_STATUS_SUCCESS;
+}
+
+/* Returns true when the control RX write was a benchmark command */
+bool bench_handle_command( const uint8_t * data, uint16_t len )
+{
+	if( ( NULL == data ) || ( 0U == len ) )
+	{
+		return false;
+	}
+
+	if( ( BENCH_CMD_START == data[0] ) && ( BENCH_CMD_START_LEN == len ) )
+	{
+		(void)bench_start( data[1], (uint16_t)( data[2] | ( (uint16_t)data[3] << 8 ) ) );
+		return true;
+	}
+
+	if( ( BENCH_CMD_STOP == data[0] ) && ( 1U == len ) )
+	{
+		if( BENCH_IDLE != g_bench_state )
+		{
+			bench_finish( "stopped" );
+		}
+		return true;
+	}
+
+	return false;
+}
+
+void bench_run( void )
+{
+	uint32_t burst;
+
+	for( burst = 0; ( BENCH_BURST_MAX > burst ) && ( BENCH_RUNNING == g_bench_state ); burst++ )
+	{
+		const uint32_t seq = g_bench_result.sent;
+
+		g_bench_buf[0] = (uint8_t)( seq );
+		g_bench_buf[1] = (uint8_t)( seq >> 8 );
+		g_bench_buf[2] = (uint8_t)( seq >> 16 );
+		g_bench_buf[3] = (uint8_t)( seq >> 24 );
+
+		PROFILE_BEGIN( PROFILE_ZONE_GATT_UPDATE );
+		tBleStatus ret = aci_gatt_update_char_value( health_service_handle, health_bench_tx_char_handle, 0,
+		                                             (uint8_t)g_bench_result.size, g_bench_buf );
+		PROFILE_END( PROFILE_ZONE_GATT_UPDATE );
+		if( BLE_STATUS_INSUFFICIENT_RESOURCES == ret )
+		{
+			g_bench_result.busy_retries++;
+			g_bench_state = BENCH_BLOCKED;
+			break;
+		}
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_WARN("Bench: aci_gatt_update_char_value FAILED (%d)", ret);
+			bench_finish( "aborted" );
+			break;
+		}
+
+		g_bench_last_tick = app_port_tick_ms();
+		if( 0U == g_bench_result.sent )
+		{
+			g_bench_start_tick = g_bench_last_tick;
+		}
+		g_bench_result.sent++;
+		link_on_notified( LINK_CCCD_BENCH_TX );
+
+		if( g_bench_result.count <= g_bench_result.sent )
+		{
+			bench_finish( "done" );
+		}
+	}
+}
+
+/* True when bench_run() has work it can do right now */
+bool bench_is_ready( void )
+{
+	return ( BENCH_RUNNING == g_bench_state );
+}
+
+bool bench_is_running( void )
+{
+	return ( BENCH_IDLE != g_bench_state );
+}
+
+void bench_on_pool_available( void )
+{
+	if( BENCH_BLOCKED == g_bench_state )
+	{
+		g_bench_state = BENCH_RUNNING;
+	}
+}
+
+/* Called after link_on_disconnect(): the run ends with its last subscriber */
+void bench_on_disconnect( void )
+{
+	if( ( BENCH_IDLE != g_bench_state ) && ( false == link_any_subscribed( LINK_CCCD_BENCH_TX ) ) )
+	{
+		bench_finish( "interrupted by disconnect" );
+	}
+}
+
+void bench_get_result( bench_result_t * p_result )
+{
+	if( NULL != p_result )
+	{
+		*p_result = g_bench_result;
+	}
+}
+
+void bench_print_result( void )
+{
+	const bench_result_t * r = &g_bench_result;
+	const uint32_t bytes = r->sent * r->size;
+	/* Connection interval in us: x 1250 */
+	const uint32_t interval_us = (uint32_t)r->conn_interval * 1250U;
+	const uint32_t events = ( 0U == interval_us ) ? 0U : (uint32_t)( ( (uint64_t)r->elapsed_ms * 1000U ) / interval_us );
+
+	LOG_DEBUG("Bench : %lu/%u x %u bytes in %lu ms, busy retries=%lu",
+	          (unsigned long)r->sent, r->count, r->size,
+	          (unsigned long)r->elapsed_ms, (unsigned long)r->busy_retries);
+	if( 0U != r->elapsed_ms )
+	{
+		LOG_DEBUG("Bench : %lu bytes/s", (unsigned long)( ( (uint64_t)bytes * 1000U ) / r->elapsed_ms ));
+	}
+	if( 0U != events )
+	{
+		/* Hundredths of a notification per connection event */
+		const uint32_t per_evt_x100 = ( r->sent * 100U ) / events;
+		LOG_DEBUG("Bench : %lu.%02lu notifications per connection event",
+		          (unsigned long)( per_evt_x100 / 100U ), (unsigned long)( per_evt_x100 % 100U ));
+	}
+	LOG_DEBUG("Bench : interval=%u x1.25ms phy=%u att_mtu=%u", r->conn_interval, r->tx_phy, r->att_mtu);
+}
+
+#endif /* ( 1 == APP_BENCH ) */
@@ -26,7 +26,40 @@ uint8_t SERVER_BADDR[CONFIG_DATA_PUBADDR_LEN] =
   0xC0, 0xFF, 0xEE, 0xC0, 0xFF, 0xEE
 };
 
-tBleStatus bluenrg_init(void)
+/* Discoverable mode set, until the next connection complete */
+static bool g_advertising = false;
+
+/* Set by aci_blue_initialized_event(): the controller firmware is up */
+static volatile bool g_controller_ready = false;
+static uint8_t g_init_reason = 0;
+
+/* Pump controller events until aci_blue_initialized_event() or the timeout */
+static tBleStatus bluenrg_wait_ready( uint32_t timeout_ms )
+{
+	const uint32_t start = app_port_tick_ms();
+
+	while( false == g_controller_ready )
+	{
+		if( ( app_port_tick_ms() - start ) > timeout_ms )
+		{
+			return BLE_STATUS_TIMEOUT;
+		}
+		(void)hci_user_evt_proc();
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+void bluenrg_on_initialized( uint8_t reason )
+{
+	g_init_reason = reason;
+	g_controller_ready = true;
+}
+
+/*
+ * Controller bring-up: reset, wait ready, then GAP / GATT / security / services.
+ * Run at boot by bluenrg_init() and again by bluenrg_restart() after a fault.
+ */
+static tBleStatus bluenrg_setup(void)
 {
 	tBleStatus ret = BLE_STATUS_SUCCESS;
 	uint8_t bdaddr[CONFIG_DATA_PUBADDR_LEN];
@@ -50,33 +83,30 @@ tBleStatus bluenrg_init(void)
      * ------------------------------------------------------------------ */
 		/* Initialise HCI */
 		extern void App_UserEvtRx(void *pData);
+		g_controller_ready = false;
+		/* Also resets the controller through its reset pin (HCI_TL_SPI_Reset) */
 		hci_init(App_UserEvtRx, NULL);
+		boot_mark(BOOT_PHASE_CONTROLLER_RESET);
 
-		/* Reset HCI */
-		ret = hci_reset();
+    /*
+     * Wait for the controller firmware instead of a fixed delay.
+     *
+     * After a reset the BlueNRG-2 raises its IRQ with aci_blue_initialized_event()
+     * once its internal state machines are up. No command is accepted before,
+     * so pump the events until it arrives. This replaces the hci_reset()
+     * command plus a 100 ms busy pump: the pin reset above already restarted
+     * the whole controller.
+     */
+		ret = bluenrg_wait_ready(BLUENRG_READY_TIMEOUT_MS);
 		if(BLE_STATUS_SUCCESS != ret)
 		{
-			LOG_DEBUG("hci_reset : FAILED (%d)", ret);
+			LOG_DEBUG("aci_blue_initialized_event : TIMEOUT (%u ms)", BLUENRG_READY_TIMEOUT_MS);
 			break;
 		}
-
-		/* check reset complete */
-		/* DO NOT REMOVE: allow controller firmware to settle */
-    /*
-     * Pump BLE stack for 100 ms
-     *
-     * Needed because:
-     * - BLE controller firmware has just been reset
-     * - Internal BlueNRG state machines are not ready yet
-     * - Give the controller time to settle and drain mandatory HCI Events like
-     *   reset complete, command complete, etc., must be drained
-     * - This is intentional busy pumping
-     */
-		uint32_t start = HAL_GetTick();
-    while (100U >= (HAL_GetTick() - start))
+		boot_mark(BOOT_PHASE_CONTROLLER_READY);
+		if(BLUENRG_INIT_REASON_NORMAL != g_init_reason)
 		{
-			/* Keep BLE event processing alive. Do not exit delay based on the function's return value. */
-		    (void)hci_user_evt_proc();
+			LOG_WARN("Controller started with reason 0x%02X", g_init_reason);
 		}
 
 		/* Configure device address */
@@ -86,6 +116,7 @@ tBleStatus bluenrg_init(void)
 			LOG_DEBUG("aci_hal_write_config_data : FAILED (%d)", ret);
 			break;
 		}
+		boot_mark(BOOT_PHASE_CONFIG);
 
 		/* Initialise GATT server */
 		ret = aci_gatt_init();
@@ -94,6 +125,7 @@ tBleStatus bluenrg_init(void)
 			LOG_DEBUG("aci_gatt_init : FAILED (%d)", ret);
 			break;
 		}
+		boot_mark(BOOT_PHASE_GATT_INIT);
 
 		/* Initialise GAP server */
     ret = aci_gap_init(GAP_PERIPHERAL_ROLE, PRIVACY_DISABLED, DEVICE_NAME_LEN, &service_handle, &device_name_char_handle, &appearance_char_handle);
@@ -102,6 +134,18 @@ tBleStatus bluenrg_init(void)
 			LOG_DEBUG("aci_gap_init : FAILED (%d)", ret);
 			break;
 		}
+		boot_mark(BOOT_PHASE_GAP_INIT);
+
+#if ( 1 == APP_SECURITY )
+		/* Pairing / bonding parameters, bonded peers from flash */
+		ret = security_init();
+		if(BLE_STATUS_SUCCESS != ret)
+		{
+			LOG_DEBUG("security_init : FAILED (%d)", ret);
+			break;
+		}
+		boot_mark(BOOT_PHASE_SECURITY);
+#endif /* ( 1 == APP_SECURITY ) */
 
 		/* Update device name characteristic value */
 		/* If this is set to 0 and the attribute value is of variable length. */
@@ -119,13 +163,41 @@ tBleStatus bluenrg_init(void)
 			LOG_DEBUG("add_services : FAILED (%d)", ret);
 			break;
 		}
+		boot_mark(BOOT_PHASE_SERVICES);
 	}while( false );
 
 	return ret;
 }
 
+tBleStatus bluenrg_init(void)
+{
+	/* Before hci_init(): it enables the BlueNRG IRQ that feeds the pump */
+	event_pump_init();
+	profile_init();
+	/* Event table indexes used by App_UserEvtRx(), the tables never change */
+	hci_dispatch_init();
+
+	return bluenrg_setup();
+}
+
+/*
+ * Fault recovery (app_recovery.c): hard reset of the controller and replay of
+ * the boot configuration. Host side state (statistics, profiling, bond store)
+ * is kept; the caller has already dropped the connections.
+ */
+tBleStatus bluenrg_restart(void)
+{
+	/* The reset ends advertising without any event */
+	g_advertising = false;
+	/* Fresh SPI peripheral (and DMA) in case the bus itself is wedged */
+	(void)BSP_SPI1_DeInit();
+
+	return bluenrg_setup();
+}
+
 // Earlier name bluenrg_process
-tBleStatus bluenrg_start_advertising( void )
+/* Undirected connectable advertising, intervals x 0.625 ms (app_adv.c picks them) */
+tBleStatus bluenrg_start_advertising( uint16_t interval_min, uint16_t interval_max )
 {
 	tBleStatus ret = BLE_STATUS_SUCCESS;
 
@@ -147,13 +219,67 @@ tBleStatus bluenrg_start_advertising( void )
 		const uint8_t * const pServiceUuidList = (const uint8_t *)NULL;
 
 		/* Set device in General Discoverable mode */
-		ret = aci_gap_set_discoverable(ADV_DATA_TYPE, ADV_INTERV_MIN, ADV_INTERV_MAX, PUBLIC_ADDR, NO_WHITE_LIST_USE, sizeof(LocalName), LocalName, ServiceUuidLength, ( uint8_t *)pServiceUuidList, L2CAP_INTERV_MIN, L2CAP_INTERV_MAX);
+		ret = aci_gap_set_discoverable(ADV_DATA_TYPE, interval_min, interval_max, PUBLIC_ADDR, NO_WHITE_LIST_USE, sizeof(LocalName), LocalName, ServiceUuidLength, ( uint8_t *)pServiceUuidList, L2CAP_INTERV_MIN, L2CAP_INTERV_MAX);
+		/* Command timeouts feed the fault detection */
+		recovery_on_hci_status(ret);
 //	ret = aci_gap_set_discoverable(ADV_DATA_TYPE, 0, 0, PUBLIC_ADDR, NO_WHITE_LIST_USE, sizeof(LocalName), LocalName, ServiceUuidLength, ( uint8_t *)pServiceUuidList, 0, 0);
 		if(BLE_STATUS_SUCCESS != ret)
 		{
 			LOG_DEBUG("aci_gap_set_discoverable : FAILED (%d)", ret);
 			break;
 		}
+		g_advertising = true;
+	} while( false );
+	return ret;
+}
+
+/* High duty cycle directed advertising to one central, ended by the LL after 1.28 s */
+tBleStatus bluenrg_start_directed_advertising( uint8_t peer_addr_type, const uint8_t peer_addr[6] )
+{
+	tBleStatus ret = BLE_STATUS_SUCCESS;
+	uint8_t addr[6];
+
+	do
+	{
+		BLUENRG_memcpy(addr, peer_addr, sizeof(addr));
+		/* Advertising intervals are only used by low duty cycle directed advertising */
+		ret = aci_gap_set_direct_connectable(PUBLIC_ADDR, HIGH_DUTY_CYCLE_DIRECTED_ADV, peer_addr_type, addr, ADV_FAST_INTERV_MIN, ADV_FAST_INTERV_MAX);
+		/* Command timeouts feed the fault detection */
+		recovery_on_hci_status(ret);
+		if(BLE_STATUS_SUCCESS != ret)
+		{
+			LOG_DEBUG("aci_gap_set_direct_connectable : FAILED (%d)", ret);
+			break;
+		}
+		g_advertising = true;
 	} while( false );
 	return ret;
 }
+
+tBleStatus bluenrg_stop_advertising( void )
+{
+	tBleStatus ret = aci_gap_set_non_discoverable();
+
+	recovery_on_hci_status(ret);
+
+	if(BLE_STATUS_SUCCESS != ret)
+	{
+		LOG_DEBUG("aci_gap_set_non_discoverable : FAILED (%d)", ret);
+	}
+	else
+	{
+		g_advertising = false;
+	}
+	return ret;
+}
+
+bool bluenrg_is_advertising( void )
+{
+	return g_advertising;
+}
+
+/* The controller leaves discoverable mode on every connection complete */
+void bluenrg_on_advertising_stopped( void )
+{
+	g_advertising = false;
+}
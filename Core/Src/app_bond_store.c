@@ -0,0 +1,341 @@
+/*
+ * app_bond_store.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Wear-levelled flash copy of the bonded central list.
+ *
+ * The BlueNRG-2 keeps the bonding keys (LTK, IRK, CSRK) in its own security
+ * database and there is no ACI command to load keys into it, so this store
+ * holds the peer identity addresses and their CCCD bits only. It lets the
+ * application recognise a returning central at connect time without an SPI
+ * round trip, and give it back its subscriptions.
+ *
+ * Layout: an append-only log of bond_store_record_t in BOND_STORE_SECTOR.
+ * Every change writes a complete record after the last one, the valid record
+ * with the highest sequence number wins. The sector is erased only when it is
+ * full (about 1600 changes), then the current list is written first.
+ *
+ * NOTE: the F411 has a single flash bank. A sector erase stalls every code
+ * fetch, interrupts included, for up to 2 s: bond_store_commit() runs from the
+ * main loop only.
+ */
+
+#include "app_includes.h"
+
+#if ( 1 == APP_SECURITY )
+
+#define BOND_STORE_MAGIC				( 0xB0D5A11EUL )
+#define BOND_STORE_ERASED				( 0xFFFFFFFFUL )
+
+typedef struct
+{
+	uint32_t					magic;
+	uint32_t					seq;
+	uint8_t						count;
+	uint8_t						reserved[3];
+	bond_store_peer_t	peers[BOND_STORE_PEERS_MAX];
+	uint32_t					crc;			/* CRC-32 of every field above */
+} bond_store_record_t;
+
+#define BOND_STORE_RECORDS				( BOND_STORE_SIZE / sizeof( bond_store_record_t ) )
+
+/* Programmed one word at a time */
+typedef char STATIC_ASSERT_bond_store_record_words[ ( 0U == ( sizeof( bond_store_record_t ) % 4U ) ) ? 1 : -1 ];
+
+static bond_store_record_t g_bonds;
+/* Next free record slot, BOND_STORE_RECORDS when the sector is full */
+static uint32_t g_next_slot = 0;
+static bool g_dirty = false;
+/* Failed writes of the pending change */
+static uint32_t g_write_failures = 0;
+static bond_store_stats_t g_bond_stats;
+
+static uint32_t bond_store_addr( uint32_t slot )
+{
+	return (uint32_t)( BOND_STORE_BASE + ( slot * sizeof( bond_store_record_t ) ) );
+}
+
+static const bond_store_record_t * bond_store_slot( uint32_t slot )
+{
+	return (const bond_store_record_t *)(uintptr_t)bond_store_addr( slot );
+}
+
+/* Bitwise CRC-32 (reflected, 0xEDB88320): records are small and rare */
+static uint32_t bond_store_crc( const bond_store_record_t * p_record )
+{
+	const uint8_t * p = (const uint8_t *)p_record;
+	uint32_t crc = 0xFFFFFFFFUL;
+	uint32_t i, bit;
+
+	for( i = 0; offsetof( bond_store_record_t, crc ) > i; i++ )
+	{
+		crc ^= p[i];
+		for( bit = 0; 8U > bit; bit++ )
+		{
+			crc = ( crc >> 1 ) ^ ( 0xEDB88320UL & ( 0U - ( crc & 1U ) ) );
+		}
+	}
+	return ~crc;
+}
+
+static bool bond_store_valid( const bond_store_record_t * p_record )
+{
+	return ( BOND_STORE_MAGIC == p_record->magic )
+	    && ( BOND_STORE_PEERS_MAX >= p_record->count )
+	    && ( bond_store_crc( p_record ) == p_record->crc );
+}
+
+static bool bond_store_erase( void )
+{
+	FLASH_EraseInitTypeDef erase;
+	uint32_t sector_error = 0;
+
+	erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+	erase.Banks = 0;
+	erase.Sector = BOND_STORE_SECTOR;
+	erase.NbSectors = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+	if( HAL_OK != HAL_FLASHEx_Erase( &erase, &sector_error ) )
+	{
+		return false;
+	}
+	g_bond_stats.erases++;
+	g_next_slot = 0;
+	return true;
+}
+
+static bool bond_store_program( uint32_t slot, const bond_store_record_t * p_record )
+{
+	const uint32_t * p_words = (const uint32_t *)p_record;
+	const uint32_t addr = bond_store_addr( slot );
+	uint32_t i;
+
+	for( i = 0; ( sizeof( *p_record ) / 4U ) > i; i++ )
+	{
+		if( HAL_OK != HAL_FLASH_Program( FLASH_TYPEPROGRAM_WORD, addr + ( i * 4U ), p_words[i] ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Latest valid record, and the first erased slot after it */
+void bond_store_init( void )
+{
+	uint32_t slot;
+
+	BLUENRG_memset( &g_bonds, 0, sizeof( g_bonds ) );
+	g_next_slot = BOND_STORE_RECORDS;
+	g_dirty = false;
+	g_write_failures = 0;
+
+	for( slot = 0; BOND_STORE_RECORDS > slot; slot++ )
+	{
+		const bond_store_record_t * p_record = bond_store_slot( slot );
+
+		if( BOND_STORE_ERASED == p_record->magic )
+		{
+			g_next_slot = slot;
+			break;
+		}
+		if( bond_store_valid( p_record ) && ( p_record->seq >= g_bonds.seq ) )
+		{
+			g_bonds = *p_record;
+		}
+	}
+	g_bond_stats.records = ( BOND_STORE_RECORDS > g_next_slot ) ? g_next_slot : BOND_STORE_RECORDS;
+
+	LOG_DEBUG("Bond store : %u peer(s), seq=%lu, slot %lu/%lu",
+	          g_bonds.count, (unsigned long)g_bonds.seq,
+	          (unsigned long)g_next_slot, (unsigned long)BOND_STORE_RECORDS);
+}
+
+static bond_store_peer_t * bond_store_lookup( uint8_t addr_type, const uint8_t addr[6] )
+{
+	uint8_t i;
+
+	for( i = 0; g_bonds.count > i; i++ )
+	{
+		if( ( addr_type == g_bonds.peers[i].addr_type ) && ( 0 == memcmp( addr, g_bonds.peers[i].addr, 6 ) ) )
+		{
+			return &g_bonds.peers[i];
+		}
+	}
+	return NULL;
+}
+
+bool bond_store_find( uint8_t addr_type, const uint8_t addr[6] )
+{
+	return ( NULL != bond_store_lookup( addr_type, addr ) );
+}
+
+/* New bond: the oldest entry makes room when the list is full */
+bool bond_store_add( uint8_t addr_type, const uint8_t addr[6] )
+{
+	bond_store_peer_t * p_peer;
+
+	if( bond_store_find( addr_type, addr ) )
+	{
+		return false;
+	}
+	if( BOND_STORE_PEERS_MAX <= g_bonds.count )
+	{
+		memmove( &g_bonds.peers[0], &g_bonds.peers[1], ( BOND_STORE_PEERS_MAX - 1U ) * sizeof( bond_store_peer_t ) );
+		g_bonds.count = BOND_STORE_PEERS_MAX - 1U;
+	}
+	p_peer = &g_bonds.peers[g_bonds.count];
+	BLUENRG_memset( p_peer, 0, sizeof( *p_peer ) );
+	p_peer->addr_type = addr_type;
+	BLUENRG_memcpy( p_peer->addr, addr, 6 );
+	g_bonds.count++;
+	g_dirty = true;
+	g_write_failures = 0;
+	return true;
+}
+
+/* Replace the whole list (resynchronisation with the controller, clear) */
+void bond_store_set( const bond_store_peer_t * p_peers, uint8_t count )
+{
+	if( BOND_STORE_PEERS_MAX < count )
+	{
+		count = BOND_STORE_PEERS_MAX;
+	}
+	BLUENRG_memset( g_bonds.peers, 0, sizeof( g_bonds.peers ) );
+	if( 0U != count )
+	{
+		BLUENRG_memcpy( g_bonds.peers, p_peers, count * sizeof( bond_store_peer_t ) );
+	}
+	g_bonds.count = count;
+	g_dirty = true;
+	g_write_failures = 0;
+}
+
+uint8_t bond_store_count( void )
+{
+	return g_bonds.count;
+}
+
+/* Most recently added peer */
+bool bond_store_last( bond_store_peer_t * p_peer )
+{
+	if( 0U == g_bonds.count )
+	{
+		return false;
+	}
+	if( NULL != p_peer )
+	{
+		*p_peer = g_bonds.peers[g_bonds.count - 1U];
+	}
+	return true;
+}
+
+/* True when the list holds exactly these peers, in any order */
+bool bond_store_same( const bond_store_peer_t * p_peers, uint8_t count )
+{
+	uint8_t i;
+
+	if( count != g_bonds.count )
+	{
+		return false;
+	}
+	for( i = 0; count > i; i++ )
+	{
+		if( false == bond_store_find( p_peers[i].addr_type, p_peers[i].addr ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Subscriptions of a bonded central, 0 when it is not in the list */
+uint8_t bond_store_get_cccd( uint8_t addr_type, const uint8_t addr[6] )
+{
+	const bond_store_peer_t * p_peer = bond_store_lookup( addr_type, addr );
+
+	return ( NULL != p_peer ) ? p_peer->cccd : 0U;
+}
+
+/* Written to flash only when the bits change (a record per change, see the wear note above) */
+void bond_store_set_cccd( uint8_t addr_type, const uint8_t addr[6], uint8_t cccd )
+{
+	bond_store_peer_t * p_peer = bond_store_lookup( addr_type, addr );
+
+	if( ( NULL != p_peer ) && ( cccd != p_peer->cccd ) )
+	{
+		p_peer->cccd = cccd;
+		g_dirty = true;
+		g_write_failures = 0;
+	}
+}
+
+/*
+ * Main loop: write the list when it changed.
+ * erase_allowed false: a full sector is left as is (the change stays pending)
+ * since the erase stalls the whole MCU, see security_poll().
+ */
+void bond_store_commit( bool erase_allowed )
+{
+	bool ok;
+
+	if( false == g_dirty )
+	{
+		return;
+	}
+	if( ( BOND_STORE_RECORDS <= g_next_slot ) && ( false == erase_allowed ) )
+	{
+		g_bond_stats.deferred++;
+		return;
+	}
+
+	g_bonds.magic = BOND_STORE_MAGIC;
+	g_bonds.seq++;
+	g_bonds.crc = bond_store_crc( &g_bonds );
+
+	HAL_FLASH_Unlock();
+	ok = true;
+	if( BOND_STORE_RECORDS <= g_next_slot )
+	{
+		ok = bond_store_erase();
+	}
+	if( ok )
+	{
+		ok = bond_store_program( g_next_slot, &g_bonds );
+	}
+	HAL_FLASH_Lock();
+
+	if( ok && bond_store_valid( bond_store_slot( g_next_slot ) ) )
+	{
+		g_next_slot++;
+		g_bond_stats.records = g_next_slot;
+		g_bond_stats.writes++;
+		g_dirty = false;
+		g_write_failures = 0;
+	}
+	else
+	{
+		/* A half written slot is skipped on the next init (bad CRC): move past it */
+		g_bond_stats.errors++;
+		g_next_slot++;
+		g_write_failures++;
+		LOG_WARN("Bond store : write FAILED (slot %lu, try %lu)", (unsigned long)g_next_slot, (unsigned long)g_write_failures);
+		if( BOND_STORE_WRITE_RETRIES <= g_write_failures )
+		{
+			/* Kept in RAM, written with the next change */
+			g_dirty = false;
+		}
+	}
+}
+
+void bond_store_get_stats( bond_store_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_bond_stats;
+	}
+}
+
+#endif /* ( 1 == APP_SECURITY ) */
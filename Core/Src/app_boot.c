@@ -0,0 +1,89 @@
+/*
+ * app_boot.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Boot timeline recorder.
+ *
+ * boot_timeline_start() runs right after SystemClock_Config(), then every init
+ * step calls boot_mark() once. Marks are DWT cycle counts (us resolution at
+ * 64 MHz, wraps after 67 s) relative to the start, plus the HAL tick of the
+ * start so that HAL_Init() and the clock switch are accounted for too.
+ * The timeline is printed when the first advertising starts.
+ */
+
+#include "app_includes.h"
+
+static uint32_t g_boot_cycles[BOOT_PHASE_COUNT];
+static uint32_t g_boot_reached = 0;		/* Bit per boot_phase_t */
+static uint32_t g_boot_start_ms = 0;
+
+typedef char STATIC_ASSERT_boot_phase_bits[ ( 32U >= BOOT_PHASE_COUNT ) ? 1 : -1 ];
+
+static const char * const g_boot_phase_name[BOOT_PHASE_COUNT] =
+{
+	[BOOT_PHASE_CLOCK]							= "clock",
+	[BOOT_PHASE_PERIPHERALS]				= "peripherals",
+	[BOOT_PHASE_CONTROLLER_RESET]		= "controller reset",
+	[BOOT_PHASE_CONTROLLER_READY]		= "controller ready",
+	[BOOT_PHASE_CONFIG]							= "config write",
+	[BOOT_PHASE_GATT_INIT]					= "GATT init",
+	[BOOT_PHASE_GAP_INIT]						= "GAP init",
+	[BOOT_PHASE_SECURITY]						= "security",
+	[BOOT_PHASE_SERVICES]						= "services",
+	[BOOT_PHASE_FIRST_ADV]					= "first advertising",
+};
+
+void boot_timeline_start( void )
+{
+	app_port_cycle_counter_init();
+	g_boot_start_ms = app_port_tick_ms();
+	g_boot_reached = 0;
+	boot_mark( BOOT_PHASE_CLOCK );
+}
+
+/* First call for a phase wins: later restarts (recovery) do not move it */
+void boot_mark( boot_phase_t phase )
+{
+	if( ( BOOT_PHASE_COUNT <= phase ) || ( 0U != ( g_boot_reached & ( 1UL << phase ) ) ) )
+	{
+		return;
+	}
+	g_boot_cycles[phase] = app_port_cycles();
+	g_boot_reached |= ( 1UL << phase );
+
+	if( BOOT_PHASE_FIRST_ADV == phase )
+	{
+		boot_print_timeline();
+	}
+}
+
+/* Time from BOOT_PHASE_CLOCK, BOOT_PHASE_NOT_REACHED when not marked */
+uint32_t boot_get_us( boot_phase_t phase )
+{
+	if( ( BOOT_PHASE_COUNT <= phase ) || ( 0U == ( g_boot_reached & ( 1UL << phase ) ) ) )
+	{
+		return BOOT_PHASE_NOT_REACHED;
+	}
+	return ( g_boot_cycles[phase] - g_boot_cycles[BOOT_PHASE_CLOCK] ) / app_port_cycles_per_us();
+}
+
+void boot_print_timeline( void )
+{
+	uint32_t previous_us = 0;
+	uint32_t i;
+
+	LOG_DEBUG("Boot : clock configured %lu ms after reset", (unsigned long)g_boot_start_ms);
+	for( i = 0; BOOT_PHASE_COUNT > i; i++ )
+	{
+		const uint32_t us = boot_get_us( (boot_phase_t)i );
+
+		if( BOOT_PHASE_NOT_REACHED == us )
+		{
+			continue;
+		}
+		LOG_DEBUG("Boot : %-18s +%lu us (%lu us)", g_boot_phase_name[i], (unsigned long)us, (unsigned long)( us - previous_us ));
+		previous_us = us;
+	}
+}
@@ -0,0 +1,150 @@
+/*
+ * app_codec.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Delta / zig-zag / varint coding of sampler frames (app_sampler.c).
+ *
+ * Consecutive sensor samples differ by a few LSB: the difference to the
+ * previous sample, zig-zag mapped to an unsigned value (0, -1, 1, -2, ... ->
+ * 0, 1, 2, 3, ...) and written as a varint (7 bits per byte, bit 7 set when
+ * another byte follows) mostly takes one byte instead of two.
+ *
+ * Every frame is a keyframe: its first sample is coded against 0, so each
+ * notification decodes on its own and a lost one costs only its samples.
+ *
+ * codec_decode_sample_frame() is the reference decoder for the central side.
+ * This file includes app_codec.h only: it must stay free of the firmware
+ * headers (the host build compiles it without their include paths).
+ */
+
+#include "app_codec.h"
+
+uint32_t codec_zigzag_encode( int32_t value )
+{
+	return ( (uint32_t)value << 1 ) ^ (uint32_t)( value >> 31 );
+}
+
+int32_t codec_zigzag_decode( uint32_t value )
+{
+	return (int32_t)( value >> 1 ) ^ -(int32_t)( value & 1U );
+}
+
+/* Writes value as a varint, returns the number of bytes (1..CODEC_VARINT32_MAX) */
+uint8_t codec_varint_put( uint32_t value, uint8_t * p_out )
+{
+	uint8_t n = 0;
+
+	while( 0x80U <= value )
+	{
+		p_out[n++] = (uint8_t)( value | 0x80U );
+		value >>= 7;
+	}
+	p_out[n++] = (uint8_t)value;
+
+	return n;
+}
+
+/* Reads one varint, returns the number of bytes used, 0 if truncated or too long */
+uint8_t codec_varint_get( const uint8_t * p_in, uint16_t len, uint32_t * p_value )
+{
+	uint32_t value = 0;
+	uint8_t n;
+
+	for( n = 0; ( n < len ) && ( CODEC_VARINT32_MAX > n ); n++ )
+	{
+		value |= (uint32_t)( p_in[n] & 0x7FU ) << ( 7U * n );
+		if( 0U == ( p_in[n] & 0x80U ) )
+		{
+			*p_value = value;
+			return (uint8_t)( n + 1U );
+		}
+	}
+
+	return 0;
+}
+
+/* Writes one coded record: varint( dt ), then varint( zigzag( value - previous ) )
+ * per channel; p_prev is updated. Returns the number of bytes (<= CODEC_RECORD_DELTA_MAX
+ * for dt <= UINT8_MAX) */
+uint8_t codec_put_sample( uint32_t dt_ms, const uint16_t * p_value, uint16_t * p_prev, uint8_t * p_out )
+{
+	uint8_t n = codec_varint_put( dt_ms, p_out );
+	uint32_t ch;
+
+	for( ch = 0; CODEC_CHANNELS > ch; ch++ )
+	{
+		const int32_t delta = (int32_t)p_value[ch] - (int32_t)p_prev[ch];
+		n += codec_varint_put( codec_zigzag_encode( delta ), &p_out[n] );
+		p_prev[ch] = p_value[ch];
+	}
+
+	return n;
+}
+
+/*
+ * Reference decoder of a sampler notification, either version:
+ *   CODEC_FRAME_VERSION_RAW   : raw records, see app_sampler.h
+ *   CODEC_FRAME_VERSION_DELTA : header as above, then per sample
+ *                                 varint(dt) and per channel varint(zigzag(value - previous))
+ * Returns the number of samples, or -1 when the frame is malformed.
+ */
+int32_t codec_decode_sample_frame( const uint8_t * p_frame, uint16_t len, codec_sample_t * p_samples, uint16_t max_samples )
+{
+	uint16_t pos = CODEC_FRAME_HEADER_LEN;
+	uint32_t ts;
+	uint32_t prev[CODEC_CHANNELS] = { 0 };
+	uint32_t i, ch, v;
+	uint8_t n;
+
+	if( ( NULL == p_frame ) || ( NULL == p_samples ) || ( CODEC_FRAME_HEADER_LEN > len ) || ( max_samples < p_frame[1] ) )
+	{
+		return -1;
+	}
+
+	ts = (uint32_t)p_frame[2] | ( (uint32_t)p_frame[3] << 8 ) | ( (uint32_t)p_frame[4] << 16 ) | ( (uint32_t)p_frame[5] << 24 );
+
+	for( i = 0; p_frame[1] > i; i++ )
+	{
+		if( CODEC_FRAME_VERSION_RAW == p_frame[0] )
+		{
+			if( ( pos + CODEC_RECORD_RAW_LEN ) > len )
+			{
+				return -1;
+			}
+			ts += p_frame[pos++];
+			for( ch = 0; CODEC_CHANNELS > ch; ch++ )
+			{
+				p_samples[i].value[ch] = (uint16_t)( p_frame[pos] | ( p_frame[pos + 1U] << 8 ) );
+				pos += 2U;
+			}
+		}
+		else if( CODEC_FRAME_VERSION_DELTA == p_frame[0] )
+		{
+			if( 0U == ( n = codec_varint_get( &p_frame[pos], len - pos, &v ) ) )
+			{
+				return -1;
+			}
+			pos += n;
+			ts += v;
+			for( ch = 0; CODEC_CHANNELS > ch; ch++ )
+			{
+				if( 0U == ( n = codec_varint_get( &p_frame[pos], len - pos, &v ) ) )
+				{
+					return -1;
+				}
+				pos += n;
+				prev[ch] = (uint32_t)( (int32_t)prev[ch] + codec_zigzag_decode( v ) );
+				p_samples[i].value[ch] = (uint16_t)prev[ch];
+			}
+		}
+		else
+		{
+			return -1;
+		}
+		p_samples[i].ts_ms = ts;
+	}
+
+	return ( pos == len ) ? (int32_t)p_frame[1] : -1;
+}
@@ -0,0 +1,211 @@
+/*
+ * app_conn_profile.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Connection parameter manager.
+ *
+ * As a peripheral we can only ASK the central for new parameters
+ * (aci_l2cap_connection_parameter_update_req). The central answers with
+ * aci_l2cap_connection_update_resp_event() and, when it applies them,
+ * hci_le_connection_update_complete_event() reports what was agreed
+ * (recorded in link_info_t, see link_on_conn_params()).
+ *
+ * State is kept per connection (same slot as the link table, link_slot()).
+ * Only one request is outstanding at a time on each link. With
+ * APP_CONN_PROFILE_AUTO the profile of every connection follows the
+ * notification TX queue depth: LOW_LATENCY while a burst is queued,
+ * LOW_POWER once it has drained.
+ */
+
+#include "app_includes.h"
+
+/* Supervision timeout must exceed (1 + latency) * interval_max * 2 */
+static const conn_profile_params_t g_conn_profiles[CONN_PROFILE_COUNT] =
+{
+	[CONN_PROFILE_LOW_LATENCY]	= { "low-latency",	6,								12,									0, 400 },
+	[CONN_PROFILE_BALANCED]			= { "balanced",			L2CAP_INTERV_MIN,	L2CAP_INTERV_MAX,		0, L2CAP_TIMEOUT_MULTIPLIER },
+	[CONN_PROFILE_LOW_POWER]		= { "low-power",		80,								160,								4, 600 },
+};
+
+typedef struct
+{
+	bool						active;						/* Connected, conn_handle is link_handle_at( slot ) */
+	/* Profile last accepted by the central, and the one being requested */
+	conn_profile_t	current;
+	conn_profile_t	requested;
+	bool						request_pending;
+	/* HAL tick of connect / of the last request, for the automatic hold-off */
+	uint32_t				last_change_tick;
+} conn_profile_state_t;
+
+/* Indexed like the link table (link_slot()) */
+static conn_profile_state_t g_states[LINK_MAX_CONNECTIONS];
+
+static conn_profile_state_t * conn_profile_find( uint16_t conn_handle )
+{
+	const int32_t slot = link_slot( conn_handle );
+
+	if( ( 0 > slot ) || ( false == g_states[slot].active ) )
+	{
+		return NULL;
+	}
+	return &g_states[slot];
+}
+
+void conn_profile_on_connect( uint16_t conn_handle )
+{
+	const int32_t slot = link_slot( conn_handle );
+
+	if( 0 > slot )
+	{
+		return;
+	}
+	g_states[slot].active = true;
+	g_states[slot].current = CONN_PROFILE_BALANCED;
+	g_states[slot].requested = CONN_PROFILE_BALANCED;
+	g_states[slot].request_pending = false;
+	g_states[slot].last_change_tick = app_port_tick_ms();
+}
+
+/* Called before link_on_disconnect() while the link slot is still valid */
+void conn_profile_on_disconnect( uint16_t conn_handle )
+{
+	conn_profile_state_t * p_state = conn_profile_find( conn_handle );
+
+	if( NULL != p_state )
+	{
+		p_state->active = false;
+		p_state->request_pending = false;
+	}
+}
+
+tBleStatus conn_profile_request( uint16_t conn_handle, conn_profile_t profile )
+{
+	tBleStatus ret = BLE_STATUS_SUCCESS;
+	conn_profile_state_t * p_state = conn_profile_find( conn_handle );
+
+	do
+	{
+		if( CONN_PROFILE_COUNT <= profile )
+		{
+			ret = BLE_STATUS_INVALID_PARAMS;
+			break;
+		}
+
+		if( NULL == p_state )
+		{
+			ret = BLE_STATUS_NOT_ALLOWED;
+			break;
+		}
+
+		/* L2CAP signalling allows a single outstanding request */
+		if( p_state->request_pending )
+		{
+			ret = BLE_STATUS_BUSY;
+			break;
+		}
+
+		const conn_profile_params_t * p = &g_conn_profiles[profile];
+		ret = aci_l2cap_connection_parameter_update_req(conn_handle, p->interval_min, p->interval_max, p->latency, p->timeout);
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_WARN("aci_l2cap_connection_parameter_update_req : FAILED (%d) profile=%s conn=0x%04X", ret, p->name, conn_handle);
+			break;
+		}
+
+		p_state->requested = profile;
+		p_state->request_pending = true;
+		p_state->last_change_tick = app_port_tick_ms();
+		LOG_DEBUG("Conn profile %s requested conn=0x%04X", p->name, conn_handle);
+	} while( false );
+
+	return ret;
+}
+
+/* Main loop hook: automatic profile selection from the TX queue depth */
+void conn_profile_poll( void )
+{
+#if ( 1 == APP_CONN_PROFILE_AUTO )
+	conn_profile_t wanted;
+	const uint32_t depth = tx_queue_depth();
+	uint32_t i;
+
+#if ( 1 == APP_BENCH )
+	/* Bypasses the TX queue: keep the parameters the run was started with */
+	if( bench_is_running() )
+	{
+		return;
+	}
+#endif /* ( 1 == APP_BENCH ) */
+
+	if( CONN_PROFILE_TX_DEPTH_HIGH <= depth )
+	{
+		wanted = CONN_PROFILE_LOW_LATENCY;
+	}
+	else if( CONN_PROFILE_TX_DEPTH_LOW >= depth )
+	{
+		wanted = CONN_PROFILE_LOW_POWER;
+	}
+	else
+	{
+		/* Between the thresholds: keep what we have (hysteresis) */
+		return;
+	}
+
+	/* The TX queue is shared: every connection follows the same profile */
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		const conn_profile_state_t * p_state = &g_states[i];
+
+		if( ( false == p_state->active ) || p_state->request_pending )
+		{
+			continue;
+		}
+		if( ( wanted == p_state->current ) || ( ( app_port_tick_ms() - p_state->last_change_tick ) < CONN_PROFILE_AUTO_HOLDOFF_MS ) )
+		{
+			continue;
+		}
+		(void)conn_profile_request( link_handle_at( i ), wanted );
+	}
+#endif /* ( 1 == APP_CONN_PROFILE_AUTO ) */
+}
+
+/* L2CAP response (or procedure timeout, accepted = false) */
+void conn_profile_on_update_resp( uint16_t conn_handle, bool accepted )
+{
+	conn_profile_state_t * p_state = conn_profile_find( conn_handle );
+
+	if( ( NULL == p_state ) || ( false == p_state->request_pending ) )
+	{
+		return;
+	}
+
+	if( false == accepted )
+	{
+		LOG_WARN("Conn profile %s rejected conn=0x%04X", g_conn_profiles[p_state->requested].name, conn_handle);
+		/* Stay where we are, the hold-off delays the next automatic try */
+		p_state->request_pending = false;
+	}
+}
+
+/* LL connection update applied: the requested profile is now in effect */
+void conn_profile_on_update_complete( uint16_t conn_handle )
+{
+	conn_profile_state_t * p_state = conn_profile_find( conn_handle );
+
+	if( ( NULL == p_state ) || ( false == p_state->request_pending ) )
+	{
+		return;
+	}
+	p_state->current = p_state->requested;
+	p_state->request_pending = false;
+}
+
+/* CONN_PROFILE_COUNT when the connection is unknown */
+conn_profile_t conn_profile_get( uint16_t conn_handle )
+{
+	const conn_profile_state_t * p_state = conn_profile_find( conn_handle );
+	return ( NULL != p_state ) ? p_state->current : CONN_PROFILE_COUNT;
+}
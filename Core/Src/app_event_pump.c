@@ -0,0 +1,163 @@
+/*
+ * app_event_pump.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Event driven HCI pump.
+ *
+ * The BlueNRG IRQ line is serviced by hci_tl_lowlevel_isr(), which calls
+ * event_pump_isr_edge() and pends hci_tl_lowlevel_bottom_half() (PendSV) to
+ * queue the received packets. The main loop then drains
+ * the queue through hci_user_evt_proc() straight away instead of waiting for
+ * the next 100 ms poll, and sleeps (WFI) while nothing is pending.
+ */
+
+#include "app_includes.h"
+
+/* Set from the EXTI0 ISR, cleared by the main loop before draining */
+static volatile bool g_evt_pending = false;
+
+#if ( 1 == APP_EVENT_PUMP_STATS )
+typedef struct
+{
+	uint32_t bucket[EVENT_PUMP_HIST_BUCKETS];
+	uint32_t count;
+	uint32_t max_us;
+} event_pump_hist_data_t;
+
+static event_pump_hist_data_t g_hist[EVENT_PUMP_HIST_COUNT];
+
+/* CYCCNT of the oldest IRQ edge not yet reported to App_UserEvtRx() */
+static volatile uint32_t g_edge_cycles = 0;
+static volatile bool g_edge_armed = false;
+/* Edge of the event currently being dispatched */
+static uint32_t g_cur_edge_cycles = 0;
+static bool g_cur_edge_valid = false;
+
+static void hist_add( event_pump_hist_t hist, uint32_t cycles )
+{
+	const uint32_t cycles_per_us = app_port_cycles_per_us();
+	const uint32_t us = cycles / cycles_per_us;
+	event_pump_hist_data_t * h = &g_hist[hist];
+
+	/* Bucket = number of significant bits of the latency in us */
+	uint32_t idx = ( 0U == us ) ? 0U : ( 32U - (uint32_t)__builtin_clz( us ) );
+	if( EVENT_PUMP_HIST_BUCKETS <= idx )
+	{
+		idx = EVENT_PUMP_HIST_BUCKETS - 1U;
+	}
+	h->bucket[idx]++;
+	h->count++;
+	if( us > h->max_us )
+	{
+		h->max_us = us;
+	}
+}
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+
+void event_pump_init( void )
+{
+#if ( 1 == APP_EVENT_PUMP_STATS )
+	/* Free running cycle counter used as latency time base */
+	app_port_cycle_counter_init();
+	BLUENRG_memset( g_hist, 0, sizeof( g_hist ) );
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+	g_evt_pending = false;
+}
+
+/* Called from hci_tl_lowlevel_isr() on every BlueNRG IRQ edge */
+void event_pump_isr_edge( void )
+{
+#if ( 1 == APP_EVENT_PUMP_STATS )
+	if( false == g_edge_armed )
+	{
+		g_edge_cycles = app_port_cycles();
+		g_edge_armed = true;
+	}
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+	g_evt_pending = true;
+}
+
+bool event_pump_is_pending( void )
+{
+	return g_evt_pending;
+}
+
+void event_pump_run( void )
+{
+	while( g_evt_pending )
+	{
+		/* Clear first: an edge arriving while draining re-arms the flag */
+		g_evt_pending = false;
+		PROFILE_BEGIN( PROFILE_ZONE_EVT_PROC );
+		hci_user_evt_proc();
+		PROFILE_END( PROFILE_ZONE_EVT_PROC );
+
+		/* The bottom half stops reading when the RX pool is full. The IRQ line
+		 * then stays high with no new edge to re-trigger it, so re-pend EXTI0
+		 * (and through it the bottom half) once the queue has been drained. */
+		if( app_port_hci_irq_active() )
+		{
+			app_port_hci_irq_repend();
+		}
+	}
+}
+
+/* Called at the start of App_UserEvtRx() for each dispatched event */
+void event_pump_evt_begin( void )
+{
+#if ( 1 == APP_EVENT_PUMP_STATS )
+	g_cur_edge_valid = false;
+	if( g_edge_armed )
+	{
+		g_cur_edge_cycles = g_edge_cycles;
+		g_cur_edge_valid = true;
+		g_edge_armed = false;
+		hist_add( EVENT_PUMP_HIST_CALLBACK, app_port_cycles() - g_cur_edge_cycles );
+	}
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+}
+
+/* Records the time since the IRQ edge of the event being dispatched */
+void event_pump_mark( event_pump_hist_t hist )
+{
+#if ( 1 == APP_EVENT_PUMP_STATS )
+	if( g_cur_edge_valid && ( EVENT_PUMP_HIST_COUNT > hist ) )
+	{
+		hist_add( hist, app_port_cycles() - g_cur_edge_cycles );
+	}
+#else
+	(void)hist;
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+}
+
+void event_pump_print_stats( void )
+{
+#if ( 1 == APP_EVENT_PUMP_STATS )
+	static const char * const hist_name[EVENT_PUMP_HIST_COUNT] = { "irq->callback", "irq->allow_read" };
+	HCI_TL_SPI_Stats_t spi;
+	uint32_t i, b;
+
+	for( i = 0; EVENT_PUMP_HIST_COUNT > i; i++ )
+	{
+		const event_pump_hist_data_t * h = &g_hist[i];
+		LOG_DEBUG("Latency %s : n=%lu max=%luus", hist_name[i], (unsigned long)h->count, (unsigned long)h->max_us);
+		for( b = 0; EVENT_PUMP_HIST_BUCKETS > b; b++ )
+		{
+			if( 0U != h->bucket[b] )
+			{
+				LOG_DEBUG("  < %6luus : %lu", (unsigned long)( 1UL << b ), (unsigned long)h->bucket[b]);
+			}
+		}
+	}
+
+	/* Bus cost of the HCI traffic: wire bytes include headers and refused attempts */
+	HCI_TL_SPI_GetStats( &spi );
+	LOG_DEBUG("SPI rx : frames=%lu empty=%lu bytes=%lu", (unsigned long)spi.rx_frames, (unsigned long)spi.rx_empty, (unsigned long)spi.rx_bytes);
+	LOG_DEBUG("SPI tx : frames=%lu bytes=%lu retries=%lu timeouts=%lu", (unsigned long)spi.tx_frames, (unsigned long)spi.tx_bytes, (unsigned long)spi.tx_retries, (unsigned long)spi.tx_timeouts);
+	LOG_DEBUG("SPI wire=%lu bytes, irq low timeouts=%lu stuck=%lu", (unsigned long)spi.wire_bytes, (unsigned long)spi.irq_low_timeouts, (unsigned long)spi.irq_stuck);
+	LOG_DEBUG("SPI wait ready : n=%lu total=%luus max=%luus", (unsigned long)spi.ready_wait.count, (unsigned long)spi.ready_wait.total_us, (unsigned long)spi.ready_wait.max_us);
+	LOG_DEBUG("SPI wait low : n=%lu total=%luus max=%luus", (unsigned long)spi.low_wait.count, (unsigned long)spi.low_wait.total_us, (unsigned long)spi.low_wait.max_us);
+#endif /* ( 1 == APP_EVENT_PUMP_STATS ) */
+}
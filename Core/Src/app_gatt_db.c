@@ -0,0 +1,490 @@
+/*
+ * app_gatt_db.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Table driven GATT database builder.
+ *
+ * Services and characteristics are described by const tables (see
+ * app_services.c). gatt_db_register() walks them once, validates every row,
+ * computes Max_Attribute_Records per service and stores the handles returned
+ * by the stack through the p_handle pointers of each row.
+ *
+ * After a controller restart (app_recovery.c) the same tables are replayed:
+ * rows already validated are sent straight to the stack, and every handle
+ * must come back unchanged since connected clients may have cached them.
+ */
+
+#include "app_includes.h"
+
+/*
+ * Handle indexed dispatch table, filled by gatt_db_register().
+ *
+ * The stack assigns handles sequentially, so the registered services occupy
+ * one contiguous range starting at the first service handle. Slot
+ * (attr_handle - g_handle_base) tells which characteristic and which of its
+ * attributes a handle belongs to, in constant time.
+ */
+static gatt_db_handle_entry_t g_handle_table[GATT_DB_MAX_HANDLES];
+static uint16_t g_handle_base = 0;
+static uint16_t g_handle_count = 0;
+
+/* Tables registered once: later calls are replays of a validated plan */
+static bool g_db_built = false;
+
+/*
+ * Validate parameters before calling aci_gatt_add_char().
+ *
+ * Rationale:
+ * - aci_gatt_add_char() returns generic error codes
+ * - Caller-side validation is required to identify invalid parameters
+ * - Prevents silent GATT database misconfiguration
+ *
+ * Notes:
+ * - Char_Value_Length limits are stack-specific
+ * - On BlueNRG-2, the maximum characteristic value length is 512 bytes
+ * - This limit is documented but not enforced by the API or compiler
+ * - X-CUBE-NRG2 does not expose this limit as a macro
+ */
+
+/* BlueNRG-2 GATT database VALUE storage limit (not ATT MTU, not API limit)
+ * Runtime mirror of the same limit (typed)
+ */
+static const uint16_t g_max_char_value_length = BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH;
+
+static tBleStatus validate_add_char_params(
+  uint8_t        uuid_type,
+  const uint8_t *uuid,
+  uint16_t       char_len,
+  uint8_t        properties,
+  uint8_t        permissions,
+  uint8_t        min_key_size,
+  bool           is_variable
+)
+{
+  tBleStatus ret = BLE_STATUS_SUCCESS;
+
+  do
+  {
+    /* UUID type */
+    if( (UUID_TYPE_16 != uuid_type) && (UUID_TYPE_128 != uuid_type) )
+    {
+      LOG_WARN("add_char: invalid UUID type (%u)", uuid_type);
+      ret = BLE_STATUS_INVALID_PARAMS;
+      break;
+    }
+
+    /* UUID pointer */
+    if( NULL == uuid )
+    {
+      LOG_WARN("add_char: UUID pointer is NULL");
+      ret = BLE_STATUS_NULL_PARAM;
+      break;
+    }
+
+    /* Properties must not be zero */
+    if( 0U == properties )
+    {
+      LOG_WARN("add_char: properties is zero");
+      ret = BLE_STATUS_INVALID_PARAMS;
+      break;
+    }
+
+		 /* --------------------------------------------------------------------
+		 * Characteristic length vs variable flag validation
+		 *
+		 * Rules:
+		 * - Fixed-length characteristic (is_variable == false):
+		 *     char_len is typically sizeof(value)
+		 *     MUST be non-zero and <= max allowed length
+		 *
+		 * - Variable-length characteristic (is_variable == true):
+		 *     char_len represents MAX allowed value length
+		 *     MUST be non-zero and <= max allowed length
+		 * -------------------------------------------------------------------- */
+    if( 0U == char_len )
+    {
+		  LOG_WARN("add_char: %s-length characteristic with zero length", ( false == is_variable ) ? "fixed" : "variable");
+      ret = BLE_STATUS_INVALID_PARAMS;
+      break;
+    }
+
+    if( g_max_char_value_length < char_len )
+    {
+      LOG_WARN("add_char: Char_Value_Length too large (%u > %u)", char_len, g_max_char_value_length);
+      ret = BLE_STATUS_INVALID_PARAMS;
+      break;
+    }
+
+    /*
+     * IMPORTANT:
+     * ATTR_PERMISSION_NONE is VALID and NORMAL.
+     * Do NOT reject READ / WRITE characteristics because of it.
+     */
+
+    /* --------------------------------------------------------------------
+     * Encryption key size validation
+     *
+     * Rules:
+     * - If encryption IS required:
+     *     min_key_size MUST be within [MIN_ENCRY_KEY_SIZE .. MAX_ENCRY_KEY_SIZE]
+     *
+     * - If encryption is NOT required (ATTR_PERMISSION_NONE):
+     *     min_key_size is ignored by the stack
+     *     0 is the recommended value
+     * -------------------------------------------------------------------- */
+    if( ATTR_PERMISSION_NONE != permissions )
+    {
+	    /* Minimum encryption key size — lower bound */
+      if( MIN_ENCRY_KEY_SIZE > min_key_size )
+      {
+        LOG_WARN("add_char: min_key_size too small (%u < %u)", min_key_size, MIN_ENCRY_KEY_SIZE);
+        ret = BLE_INSUFFICIENT_ENC_KEYSIZE;
+        break;
+      }
+
+	    /* Minimum encryption key size — upper bound (BLE spec max = 16) */
+      if( MAX_ENCRY_KEY_SIZE < min_key_size )
+      {
+        LOG_WARN("add_char: min_key_size too large (%u > %u)", min_key_size, MAX_ENCRY_KEY_SIZE);
+        ret = BLE_STATUS_INVALID_PARAMS;
+        break;
+      }
+    }
+    else
+    {
+      if( 0U != min_key_size )
+      {
+        LOG_WARN("add_char: min_key_size ignored because ATTR_PERMISSION_NONE is set (%u)", min_key_size);
+      }
+    }
+  } while( false );
+
+  return ret;
+}
+
+/* Maximum reasonable attribute records per single service.
+ * This is a sanity limit to catch configuration bugs, not a stack limit.
+ */
+static const uint8_t g_max_service_attribute_records = 20U;
+
+static tBleStatus validate_add_service_params(
+  uint8_t              uuid_type,
+  const uint8_t        *uuid,
+  uint8_t              service_type,
+  uint8_t              max_attribute_records,
+  const uint16_t       *service_handle
+)
+{
+  /* UUID type */
+  if( (UUID_TYPE_16 != uuid_type) && (UUID_TYPE_128 != uuid_type) )
+  {
+    LOG_WARN("add_service: invalid UUID type (%u)", uuid_type);
+    return BLE_STATUS_INVALID_PARAMS;
+  }
+
+  /* UUID pointer */
+  if( NULL == uuid )
+  {
+    LOG_WARN("add_service: UUID pointer is NULL");
+    return BLE_STATUS_NULL_PARAM;
+  }
+
+  /* Service type */
+  if( (PRIMARY_SERVICE != service_type) && (SECONDARY_SERVICE != service_type) )
+  {
+    LOG_WARN("add_service: invalid service type (%u)", service_type);
+    return BLE_STATUS_INVALID_PARAMS;
+  }
+
+  /* Attribute record count */
+  if( 0U == max_attribute_records )
+  {
+    LOG_WARN("add_service: Max_Attribute_Records is zero");
+    return BLE_STATUS_INVALID_PARAMS;
+  }
+
+  if( max_attribute_records > g_max_service_attribute_records )
+  {
+    LOG_WARN("add_service: Max_Attribute_Records too large (%u > %u)",
+             max_attribute_records,
+             g_max_service_attribute_records);
+    return BLE_STATUS_INVALID_PARAMS;
+  }
+
+  /* Service handle pointer */
+  if( NULL == service_handle )
+  {
+    LOG_WARN("add_service: service_handle pointer is NULL");
+    return BLE_STATUS_NULL_PARAM;
+  }
+
+  return BLE_STATUS_SUCCESS;
+}
+
+/*
+ * ============================================================================
+ * GATT Attribute Record Accounting (BlueNRG-2 / X-CUBE-BLE2)
+ * ============================================================================
+ *
+ * - Max_Attribute_Records is NOT a global pool for the entire GATT database.
+ * - It is specified PER SERVICE while calling aci_gatt_add_service().
+ * - Each service must reserve enough attribute records to cover
+ *   ALL attributes belonging to THAT service only.
+ *
+ * Attribute record usage (record COUNT, not byte size):
+ *
+ *   • Primary Service declaration                 : 1 record
+ *
+ *   • Characteristic Declaration                  : 1 record (always)
+ *   • Characteristic Value                        : 1 record (always)
+ *
+ *   • READ characteristic                         : 2 records
+ *       (Declaration + Value)
+ *
+ *   • WRITE / WRITE_NO_RESP characteristic         : 2 records
+ *       (Declaration + Value)
+ *
+ *   • NOTIFY or INDICATE characteristic            : 3 records
+ *       (Declaration + Value + CCCD)
+ *
+ *   • READ + NOTIFY / READ + INDICATE              : 3 records
+ *       (Declaration + Value + CCCD)
+ *
+ *   • Characteristic User Description (optional)   : +1 record
+ *
+ * Notes:
+ *
+ * - Char_Value_Length specifies the MAX size (in bytes) of the
+ *   Characteristic VALUE attribute only.
+ *
+ * - For NOTIFY / INDICATE, the BlueNRG-2 stack automatically creates a
+ *   Client Characteristic Configuration Descriptor (CCCD) during
+ *   aci_gatt_add_char().
+ *
+ * - CCCD is a SEPARATE attribute (fixed 2 bytes) and consumes
+ *   one additional attribute record; it is NOT part of the
+ *   characteristic value.
+ *
+ * - Although a NOTIFY characteristic involves:
+ *   Char_Value_Length bytes (value) + 2 bytes (CCCD),
+ *   these belong to DIFFERENT attributes and must NOT be combined
+ *   while selecting Char_Value_Length.
+ *
+ * - Example (for clarity):
+ *     1 service containing 1 NOTIFY characteristic
+ *       ⇒ 1 (service) + 3 (notify characteristic) = 4 attribute records total.
+ *
+ * - If Max_Attribute_Records for a service is undersized, GATT additions
+ *   may fail silently (for example, missing characteristics or an
+ *   "Unnamed" device shown on the client side).
+ * ============================================================================
+ */
+
+uint8_t gatt_db_char_attr_records( const gatt_char_desc_t * p_char )
+{
+	/* Declaration + Value, plus the CCCD created by the stack for NOTIFY / INDICATE */
+	uint8_t records = 2U;
+	if( 0U != ( p_char->properties & ( CHAR_PROP_NOTIFY | CHAR_PROP_INDICATE ) ) )
+	{
+		records++;
+	}
+	return records;
+}
+
+uint8_t gatt_db_service_attr_records( const gatt_service_desc_t * p_service )
+{
+	/* Service declaration */
+	uint16_t records = 1U;
+	uint8_t i;
+
+	for( i = 0; p_service->char_count > i; i++ )
+	{
+		records += gatt_db_char_attr_records( &p_service->chars[i] );
+	}
+	/* Saturate: validate_add_service_params() rejects anything this large */
+	return ( UINT8_MAX < records ) ? UINT8_MAX : (uint8_t)records;
+}
+
+static tBleStatus gatt_db_add_char( uint16_t service_handle, const gatt_char_desc_t * p_char )
+{
+	tBleStatus ret;
+	Char_UUID_t char_uuid;
+	uint16_t previous_handle = 0;
+
+	do
+	{
+		if( g_db_built )
+		{
+			/* Replay: the row was validated by the first registration */
+			previous_handle = *p_char->p_handle;
+		}
+		else
+		{
+			ret = validate_add_char_params(p_char->uuid_type, p_char->uuid, p_char->value_len, p_char->properties, p_char->permissions, p_char->enc_key_size, p_char->is_variable);
+			if( BLE_STATUS_SUCCESS != ret )
+			{
+				LOG_WARN("validate_add_char_params FAILED (%d) for %s", ret, p_char->name);
+				break;
+			}
+
+			if( NULL == p_char->p_handle )
+			{
+				LOG_WARN("add_char: handle pointer is NULL for %s", p_char->name);
+				ret = BLE_STATUS_NULL_PARAM;
+				break;
+			}
+		}
+
+		BLUENRG_memcpy(&char_uuid, p_char->uuid, ( UUID_TYPE_16 == p_char->uuid_type ) ? 2U : 16U);
+
+		ret = aci_gatt_add_char(service_handle, p_char->uuid_type, &char_uuid, p_char->value_len, p_char->properties, p_char->permissions, p_char->evt_mask, p_char->enc_key_size, p_char->is_variable, p_char->p_handle);
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for %s", ret, p_char->name);
+			break;
+		}
+
+		if( false == g_db_built )
+		{
+			LOG_DEBUG("GATT %s : decl=0x%04X value=0x%04X", p_char->name, *p_char->p_handle, GATT_DB_VALUE_HANDLE(*p_char->p_handle));
+		}
+		else if( previous_handle != *p_char->p_handle )
+		{
+			LOG_WARN("GATT %s moved 0x%04X -> 0x%04X after restart", p_char->name, previous_handle, *p_char->p_handle);
+		}
+	} while( false );
+
+	return ret;
+}
+
+static tBleStatus gatt_db_map_handle( uint16_t attr_handle, const gatt_char_desc_t * p_char, gatt_db_attr_t attr )
+{
+	const uint16_t slot = attr_handle - g_handle_base;
+
+	/* Handles below the base wrap around to large slot values as well */
+	if( GATT_DB_MAX_HANDLES <= slot )
+	{
+		LOG_WARN("gatt_db: handle 0x%04X outside dispatch table (base 0x%04X, size %u)", attr_handle, g_handle_base, GATT_DB_MAX_HANDLES);
+		return BLE_STATUS_OUT_OF_MEMORY;
+	}
+
+	g_handle_table[slot].p_char = p_char;
+	g_handle_table[slot].attr = attr;
+	if( slot >= g_handle_count )
+	{
+		g_handle_count = slot + 1U;
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+static tBleStatus gatt_db_map_char( const gatt_char_desc_t * p_char )
+{
+	const uint16_t decl_handle = *p_char->p_handle;
+	tBleStatus ret;
+
+	ret = gatt_db_map_handle( decl_handle, p_char, GATT_DB_ATTR_DECL );
+	if( BLE_STATUS_SUCCESS == ret )
+	{
+		ret = gatt_db_map_handle( GATT_DB_VALUE_HANDLE( decl_handle ), p_char, GATT_DB_ATTR_VALUE );
+	}
+	if( ( BLE_STATUS_SUCCESS == ret ) && ( 3U == gatt_db_char_attr_records( p_char ) ) )
+	{
+		ret = gatt_db_map_handle( GATT_DB_CCCD_HANDLE( decl_handle ), p_char, GATT_DB_ATTR_CCCD );
+	}
+	return ret;
+}
+
+/*
+ * Constant time handle lookup.
+ * Returns NULL for handles not owned by a registered characteristic
+ * (service declarations, GAP / GATT services, unused slots).
+ */
+const gatt_db_handle_entry_t * gatt_db_lookup( uint16_t attr_handle )
+{
+	const uint16_t slot = attr_handle - g_handle_base;
+
+	if( ( g_handle_count <= slot ) || ( NULL == g_handle_table[slot].p_char ) )
+	{
+		return NULL;
+	}
+	return &g_handle_table[slot];
+}
+
+/*
+ * Register every service of the table, in table order, in a single pass.
+ *
+ * Handles are assigned by the stack sequentially, so the table order IS the
+ * GATT database layout: re-ordering rows changes the handles seen by clients.
+ */
+tBleStatus gatt_db_register( const gatt_service_desc_t * p_services, uint8_t service_count )
+{
+	tBleStatus ret = BLE_STATUS_SUCCESS;
+	Service_UUID_t service_uuid;
+	uint8_t s, c;
+
+	BLUENRG_memset( g_handle_table, 0, sizeof( g_handle_table ) );
+	g_handle_count = 0;
+
+	for( s = 0; ( service_count > s ) && ( BLE_STATUS_SUCCESS == ret ); s++ )
+	{
+		const gatt_service_desc_t * p_service = &p_services[s];
+		const uint8_t Max_Attribute_Records = gatt_db_service_attr_records( p_service );
+		const uint16_t previous_handle = g_db_built ? *p_service->p_handle : 0U;
+
+		if( false == g_db_built )
+		{
+			ret = validate_add_service_params(p_service->uuid_type, p_service->uuid, p_service->service_type, Max_Attribute_Records, p_service->p_handle);
+			if( BLE_STATUS_SUCCESS != ret )
+			{
+				LOG_WARN("validate_add_service_params FAILED (%d) for %s", ret, p_service->name);
+				break;
+			}
+		}
+
+		BLUENRG_memcpy(&service_uuid, p_service->uuid, ( UUID_TYPE_16 == p_service->uuid_type ) ? 2U : 16U);
+
+		ret = aci_gatt_add_service(p_service->uuid_type, &service_uuid, p_service->service_type, Max_Attribute_Records, p_service->p_handle);
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_DEBUG("aci_gatt_add_service : FAILED (%d) for %s", ret, p_service->name);
+			break;
+		}
+
+		if( false == g_db_built )
+		{
+			LOG_DEBUG("GATT %s : handle=0x%04X records=%u", p_service->name, *p_service->p_handle, Max_Attribute_Records);
+		}
+		else if( previous_handle != *p_service->p_handle )
+		{
+			LOG_WARN("GATT %s moved 0x%04X -> 0x%04X after restart", p_service->name, previous_handle, *p_service->p_handle);
+		}
+
+		/* First service anchors the dispatch table */
+		if( 0U == s )
+		{
+			g_handle_base = *p_service->p_handle;
+		}
+
+		for( c = 0; p_service->char_count > c; c++ )
+		{
+			ret = gatt_db_add_char( *p_service->p_handle, &p_service->chars[c] );
+			if( BLE_STATUS_SUCCESS != ret )
+			{
+				break;
+			}
+			ret = gatt_db_map_char( &p_service->chars[c] );
+			if( BLE_STATUS_SUCCESS != ret )
+			{
+				break;
+			}
+		}
+	}
+
+	if( BLE_STATUS_SUCCESS == ret )
+	{
+		g_db_built = true;
+	}
+	return ret;
+}
@@ -0,0 +1,191 @@
+/*
+ * app_hci_dispatch.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Constant time lookup of the middleware event tables
+ * (hci_events_table, hci_le_meta_events_table, hci_vendor_specific_events_table).
+ *
+ * The tables are const and owned by the BlueNRG middleware, so the indexes are
+ * built once by hci_dispatch_init() instead of scanning the tables for every
+ * received packet. Each index slot holds a table position (uint8_t), not a
+ * function pointer, to keep the RAM cost low. Every lookup checks the event
+ * code of the table entry it lands on, so an index that was not built (or a
+ * stale slot) drops the event instead of calling the wrong handler.
+ */
+
+#include "app_includes.h"
+
+#define HCI_DISPATCH_NONE				( 0xFFU )
+
+#define HCI_EVENTS_COUNT				( sizeof(hci_events_table) / sizeof(hci_events_table_type) )
+#define HCI_LE_META_EVENTS_COUNT		( sizeof(hci_le_meta_events_table) / sizeof(hci_le_meta_events_table_type) )
+#define HCI_VENDOR_EVENTS_COUNT			( sizeof(hci_vendor_specific_events_table) / sizeof(hci_vendor_specific_events_table_type) )
+
+typedef char STATIC_ASSERT_hci_events_count[ ( HCI_EVENTS_COUNT < HCI_DISPATCH_NONE ) ? 1 : -1 ];
+typedef char STATIC_ASSERT_hci_le_meta_events_count[ ( HCI_LE_META_EVENTS_COUNT < HCI_DISPATCH_NONE ) ? 1 : -1 ];
+typedef char STATIC_ASSERT_hci_vendor_events_count[ ( HCI_VENDOR_EVENTS_COUNT < HCI_DISPATCH_NONE ) ? 1 : -1 ];
+
+/* HCI event codes are 8-bit: direct index */
+static uint8_t g_evt_index[256];
+
+/* LE meta subevent codes are small (0x01 .. 0x3F in BT 5.x): direct index */
+#define HCI_LE_META_INDEX_SIZE			( 64U )
+static uint8_t g_le_meta_index[HCI_LE_META_INDEX_SIZE];
+
+/*
+ * Vendor ecodes are grouped per stack layer in bits [11:10]
+ * (0x00xx HAL, 0x04xx GAP, 0x08xx L2CAP, 0x0Cxx GATT) with a small
+ * sequence number in the low bits. Key = group(2 bits) : low 5 bits.
+ * Codes that do not fit the key go to a sorted overflow list searched by
+ * bisection.
+ */
+#define HCI_VENDOR_INDEX_SIZE			( 128U )
+#define HCI_VENDOR_KEY( ecode )			( (uint8_t)( ( ( ( ecode ) >> 5U ) & 0x60U ) | ( ( ecode ) & 0x1FU ) ) )
+#define HCI_VENDOR_KEY_EXACT( ecode )	( 0U == ( ( ecode ) & 0xF3E0U ) )
+static uint8_t g_vendor_index[HCI_VENDOR_INDEX_SIZE];
+static uint8_t g_vendor_overflow[HCI_VENDOR_EVENTS_COUNT];
+static uint8_t g_vendor_overflow_count = 0;
+
+static void vendor_overflow_insert( uint8_t table_pos )
+{
+	const uint16_t ecode = hci_vendor_specific_events_table[table_pos].evt_code;
+	uint8_t i = g_vendor_overflow_count;
+
+	/* Insertion sort on ecode: runs once at init */
+	while( ( 0U < i ) && ( hci_vendor_specific_events_table[g_vendor_overflow[i - 1U]].evt_code > ecode ) )
+	{
+		g_vendor_overflow[i] = g_vendor_overflow[i - 1U];
+		i--;
+	}
+	g_vendor_overflow[i] = table_pos;
+	g_vendor_overflow_count++;
+}
+
+void hci_dispatch_init( void )
+{
+	uint8_t i;
+
+	BLUENRG_memset( g_evt_index, HCI_DISPATCH_NONE, sizeof( g_evt_index ) );
+	BLUENRG_memset( g_le_meta_index, HCI_DISPATCH_NONE, sizeof( g_le_meta_index ) );
+	BLUENRG_memset( g_vendor_index, HCI_DISPATCH_NONE, sizeof( g_vendor_index ) );
+	g_vendor_overflow_count = 0;
+
+	/* Walk backwards so that, like the linear scan, the first table entry wins on duplicates */
+	for( i = HCI_EVENTS_COUNT; 0U < i; i-- )
+	{
+		const uint16_t code = hci_events_table[i - 1U].evt_code;
+		if( sizeof( g_evt_index ) > code )
+		{
+			g_evt_index[code] = i - 1U;
+		}
+	}
+
+	for( i = HCI_LE_META_EVENTS_COUNT; 0U < i; i-- )
+	{
+		const uint16_t code = hci_le_meta_events_table[i - 1U].evt_code;
+		if( HCI_LE_META_INDEX_SIZE > code )
+		{
+			g_le_meta_index[code] = i - 1U;
+		}
+		else
+		{
+			LOG_WARN("hci_dispatch: LE meta subevent 0x%02X outside index", code);
+		}
+	}
+
+	for( i = 0; HCI_VENDOR_EVENTS_COUNT > i; i++ )
+	{
+		const uint16_t ecode = hci_vendor_specific_events_table[i].evt_code;
+		const uint8_t key = HCI_VENDOR_KEY( ecode );
+
+		if( HCI_VENDOR_KEY_EXACT( ecode ) && ( HCI_DISPATCH_NONE == g_vendor_index[key] ) )
+		{
+			g_vendor_index[key] = i;
+		}
+		else if( !HCI_VENDOR_KEY_EXACT( ecode ) )
+		{
+			vendor_overflow_insert( i );
+		}
+	}
+
+	if( 0U != g_vendor_overflow_count )
+	{
+		LOG_DEBUG("hci_dispatch: %u vendor events in overflow list", g_vendor_overflow_count);
+	}
+}
+
+bool hci_dispatch_event( uint8_t evt_code, void * data )
+{
+	const uint8_t pos = g_evt_index[evt_code];
+
+	if( ( HCI_EVENTS_COUNT <= pos ) || ( evt_code != hci_events_table[pos].evt_code ) )
+	{
+		return false;
+	}
+	hci_events_table[pos].process( data );
+	return true;
+}
+
+bool hci_dispatch_le_meta( uint8_t subevent, void * data )
+{
+	if( HCI_LE_META_INDEX_SIZE <= subevent )
+	{
+		return false;
+	}
+
+	const uint8_t pos = g_le_meta_index[subevent];
+	if( ( HCI_LE_META_EVENTS_COUNT <= pos ) || ( subevent != hci_le_meta_events_table[pos].evt_code ) )
+	{
+		return false;
+	}
+	hci_le_meta_events_table[pos].process( data );
+	return true;
+}
+
+bool hci_dispatch_vendor( uint16_t ecode, void * data )
+{
+	uint8_t pos = HCI_DISPATCH_NONE;
+
+	if( HCI_VENDOR_KEY_EXACT( ecode ) )
+	{
+		pos = g_vendor_index[HCI_VENDOR_KEY( ecode )];
+		if( ( HCI_VENDOR_EVENTS_COUNT <= pos ) || ( hci_vendor_specific_events_table[pos].evt_code != ecode ) )
+		{
+			pos = HCI_DISPATCH_NONE;
+		}
+	}
+
+	/* Overflow list: empty with the current middleware tables */
+	if( ( HCI_DISPATCH_NONE == pos ) && ( 0U != g_vendor_overflow_count ) )
+	{
+		uint8_t lo = 0;
+		uint8_t hi = g_vendor_overflow_count;
+		while( lo < hi )
+		{
+			const uint8_t mid = (uint8_t)( ( lo + hi ) / 2U );
+			const uint16_t code = hci_vendor_specific_events_table[g_vendor_overflow[mid]].evt_code;
+			if( code == ecode )
+			{
+				pos = g_vendor_overflow[mid];
+				break;
+			}
+			if( code < ecode )
+			{
+				lo = mid + 1U;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+	}
+
+	if( HCI_DISPATCH_NONE == pos )
+	{
+		return false;
+	}
+	hci_vendor_specific_events_table[pos].process( data );
+	return true;
+}
@@ -0,0 +1,382 @@
+/*
+ * app_link.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Per connection link state: a fixed table of LINK_MAX_CONNECTIONS entries,
+ * one per connected central, holding its CCCD bits, ATT_MTU, data length,
+ * PHY and connection parameters.
+ *
+ * ATT_MTU: starts at 23 on every connection. link_on_connect() starts an MTU
+ * exchange (aci_gatt_exchange_config) so that the client does not have to,
+ * and aci_att_exchange_mtu_resp_event() reports the agreed value whichever
+ * side initiated it.
+ *
+ * Data length / PHY: the link starts with 27 byte LL payloads on 1M PHY.
+ * link_on_connect() reads the peer LE features, then link_on_remote_features()
+ * asks for the largest data length and for 2M PHY, each only when the peer
+ * advertises support for it. The agreed values are recorded from
+ * hci_le_data_length_change_event() and hci_le_phy_update_complete_event().
+ */
+
+#include "app_includes.h"
+
+/* Connection table, one entry per central. Looked up by handle with a scan of
+ * LINK_MAX_CONNECTIONS entries (handles are assigned by the controller) */
+static link_info_t g_links[LINK_MAX_CONNECTIONS];
+static bool g_links_ready = false;
+
+/* Values every new connection starts with */
+static void link_reset( link_info_t * p_link, uint16_t conn_handle )
+{
+	BLUENRG_memset( p_link, 0, sizeof( *p_link ) );
+	p_link->conn_handle = conn_handle;
+	p_link->att_mtu = LINK_ATT_MTU_DEFAULT;
+	p_link->max_tx_octets = LINK_LL_OCTETS_DEFAULT;
+	p_link->max_tx_time = LINK_LL_TIME_DEFAULT;
+	p_link->max_rx_octets = LINK_LL_OCTETS_DEFAULT;
+	p_link->max_rx_time = LINK_LL_TIME_DEFAULT;
+	p_link->tx_phy = LINK_PHY_1M;
+	p_link->rx_phy = LINK_PHY_1M;
+}
+
+static void link_table_init( void )
+{
+	uint32_t i;
+
+	if( g_links_ready )
+	{
+		return;
+	}
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		link_reset( &g_links[i], INVALID_CONNECTION_HANDLE );
+	}
+	g_links_ready = true;
+}
+
+static link_info_t * link_find( uint16_t conn_handle )
+{
+	const int32_t slot = link_slot( conn_handle );
+	return ( 0 > slot ) ? NULL : &g_links[slot];
+}
+
+static bool link_peer_has_feature( const link_info_t * p_link, uint8_t feature_bit )
+{
+	return ( 0U != ( p_link->peer_features[feature_bit / 8U] & ( 1U << ( feature_bit % 8U ) ) ) );
+}
+
+/* Table index of a connection, -1 when unknown */
+int32_t link_slot( uint16_t conn_handle )
+{
+	uint32_t i;
+
+	if( ( INVALID_CONNECTION_HANDLE == conn_handle ) || ( false == g_links_ready ) )
+	{
+		return -1;
+	}
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( conn_handle == g_links[i].conn_handle )
+		{
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+/* Handle of a table entry, INVALID_CONNECTION_HANDLE when free */
+uint16_t link_handle_at( uint32_t slot )
+{
+	if( ( LINK_MAX_CONNECTIONS <= slot ) || ( false == g_links_ready ) )
+	{
+		return INVALID_CONNECTION_HANDLE;
+	}
+	return g_links[slot].conn_handle;
+}
+
+uint32_t link_count( void )
+{
+	uint32_t i, count = 0;
+
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( INVALID_CONNECTION_HANDLE != link_handle_at( i ) )
+		{
+			count++;
+		}
+	}
+	return count;
+}
+
+bool link_is_connected( uint16_t conn_handle )
+{
+	return ( 0 <= link_slot( conn_handle ) );
+}
+
+/* Takes a free entry, false when the table is full */
+bool link_on_connect( uint16_t conn_handle )
+{
+	tBleStatus ret;
+	link_info_t * p_link;
+
+	link_table_init();
+	p_link = link_find( conn_handle );
+	if( NULL == p_link )
+	{
+		uint32_t i;
+		/* Free entries carry the invalid handle */
+		for( i = 0; ( LINK_MAX_CONNECTIONS > i ) && ( NULL == p_link ); i++ )
+		{
+			if( INVALID_CONNECTION_HANDLE == g_links[i].conn_handle )
+			{
+				p_link = &g_links[i];
+			}
+		}
+	}
+	if( NULL == p_link )
+	{
+		LOG_WARN("Connection table full, conn=0x%04X refused", conn_handle);
+		return false;
+	}
+
+	link_reset( p_link, conn_handle );
+
+	/* Ask for the largest MTU, the result comes with aci_att_exchange_mtu_resp_event() */
+	ret = aci_gatt_exchange_config( conn_handle );
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("aci_gatt_exchange_config : FAILED (%d) conn=0x%04X", ret, conn_handle);
+	}
+
+	/* DLE / 2M PHY requests wait for the peer features (link_on_remote_features) */
+	ret = hci_le_read_remote_features( conn_handle );
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("hci_le_read_remote_features : FAILED (%d) conn=0x%04X", ret, conn_handle);
+	}
+
+	return true;
+}
+
+void link_on_disconnect( uint16_t conn_handle )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL != p_link )
+	{
+		link_reset( p_link, INVALID_CONNECTION_HANDLE );
+	}
+}
+
+void link_on_remote_features( uint16_t conn_handle, const uint8_t features[8] )
+{
+	tBleStatus ret;
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	BLUENRG_memcpy( p_link->peer_features, features, sizeof( p_link->peer_features ) );
+
+	if( link_peer_has_feature( p_link, LINK_LE_FEATURE_DLE ) )
+	{
+		ret = hci_le_set_data_length( conn_handle, LINK_LL_OCTETS_MAX, LINK_LL_TIME_MAX );
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_WARN("hci_le_set_data_length : FAILED (%d) conn=0x%04X", ret, conn_handle);
+		}
+	}
+
+	if( link_peer_has_feature( p_link, LINK_LE_FEATURE_2M_PHY ) )
+	{
+		/* ALL_PHYS = 0 : TX and RX preferences both given, PHY_options unused on LE 2M */
+		ret = hci_le_set_phy( conn_handle, 0x00, LINK_PHY_2M, LINK_PHY_2M, 0x0000 );
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_WARN("hci_le_set_phy : FAILED (%d) conn=0x%04X", ret, conn_handle);
+		}
+	}
+}
+
+void link_on_data_length( uint16_t conn_handle, uint16_t tx_octets, uint16_t tx_time, uint16_t rx_octets, uint16_t rx_time )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	p_link->max_tx_octets = tx_octets;
+	p_link->max_tx_time = tx_time;
+	p_link->max_rx_octets = rx_octets;
+	p_link->max_rx_time = rx_time;
+	LOG_DEBUG("Data length TX %u B / %u us, RX %u B / %u us conn=0x%04X", tx_octets, tx_time, rx_octets, rx_time, conn_handle);
+}
+
+void link_on_phy( uint16_t conn_handle, uint8_t tx_phy, uint8_t rx_phy )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	p_link->tx_phy = tx_phy;
+	p_link->rx_phy = rx_phy;
+	LOG_DEBUG("PHY TX %uM RX %uM conn=0x%04X", tx_phy, rx_phy, conn_handle);
+}
+
+void link_on_att_mtu( uint16_t conn_handle, uint16_t att_mtu )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		LOG_WARN("ATT_MTU for unknown conn=0x%04X", conn_handle);
+		return;
+	}
+
+	/* Clamp to what both the spec and the controller allow */
+	if( LINK_ATT_MTU_DEFAULT > att_mtu )
+	{
+		att_mtu = LINK_ATT_MTU_DEFAULT;
+	}
+	if( LINK_ATT_MTU_MAX < att_mtu )
+	{
+		att_mtu = LINK_ATT_MTU_MAX;
+	}
+	p_link->att_mtu = att_mtu;
+	LOG_DEBUG("ATT_MTU=%u conn=0x%04X", att_mtu, conn_handle);
+}
+
+void link_on_conn_params( uint16_t conn_handle, uint16_t interval, uint16_t latency, uint16_t timeout )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	p_link->conn_interval = interval;
+	p_link->conn_latency = latency;
+	p_link->supervision_timeout = timeout;
+	LOG_DEBUG("Conn params interval=%u latency=%u timeout=%u conn=0x%04X", interval, latency, timeout, conn_handle);
+}
+
+/* CCCD write of one client */
+void link_set_cccd( uint16_t conn_handle, uint16_t cccd_bit, bool enabled )
+{
+	link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	if( enabled )
+	{
+		p_link->cccd |= cccd_bit;
+	}
+	else
+	{
+		p_link->cccd &= (uint16_t)~cccd_bit;
+	}
+}
+
+/* aci_gatt_update_char_value() notifies every subscribed client: count it for each */
+void link_on_notified( uint16_t cccd_bit )
+{
+	uint32_t i;
+
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( ( INVALID_CONNECTION_HANDLE != link_handle_at( i ) ) && ( 0U != ( g_links[i].cccd & cccd_bit ) ) )
+		{
+			g_links[i].notified++;
+		}
+	}
+}
+
+bool link_any_subscribed( uint16_t cccd_bit )
+{
+	return ( INVALID_CONNECTION_HANDLE != link_first_subscribed( cccd_bit ) );
+}
+
+uint16_t link_first_subscribed( uint16_t cccd_bit )
+{
+	uint32_t i;
+
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( ( INVALID_CONNECTION_HANDLE != link_handle_at( i ) ) && ( 0U != ( g_links[i].cccd & cccd_bit ) ) )
+		{
+			return g_links[i].conn_handle;
+		}
+	}
+	return INVALID_CONNECTION_HANDLE;
+}
+
+uint16_t link_get_att_mtu( uint16_t conn_handle )
+{
+	const link_info_t * p_link = link_find( conn_handle );
+	return ( NULL != p_link ) ? p_link->att_mtu : LINK_ATT_MTU_DEFAULT;
+}
+
+/* Largest value that fits in a single notification PDU */
+uint16_t link_get_max_notify_len( uint16_t conn_handle )
+{
+	return link_get_att_mtu( conn_handle ) - LINK_ATT_NOTIFY_OVERHEAD;
+}
+
+/* Largest value every subscribed client can take in one notification (smallest ATT_MTU wins) */
+uint16_t link_get_fanout_notify_len( uint16_t cccd_bit )
+{
+	uint16_t att_mtu = LINK_ATT_MTU_MAX;
+	bool any = false;
+	uint32_t i;
+
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( ( INVALID_CONNECTION_HANDLE != link_handle_at( i ) ) && ( 0U != ( g_links[i].cccd & cccd_bit ) ) )
+		{
+			if( g_links[i].att_mtu < att_mtu )
+			{
+				att_mtu = g_links[i].att_mtu;
+			}
+			any = true;
+		}
+	}
+	return ( any ? att_mtu : LINK_ATT_MTU_DEFAULT ) - LINK_ATT_NOTIFY_OVERHEAD;
+}
+
+bool link_get_info( uint16_t conn_handle, link_info_t * p_info )
+{
+	const link_info_t * p_link = link_find( conn_handle );
+
+	if( ( NULL == p_link ) || ( NULL == p_info ) )
+	{
+		return false;
+	}
+	*p_info = *p_link;
+	return true;
+}
+
+void link_print_info( uint16_t conn_handle )
+{
+	const link_info_t * p_link = link_find( conn_handle );
+
+	if( NULL == p_link )
+	{
+		return;
+	}
+	LOG_DEBUG("Link 0x%04X : MTU=%u LL TX %u B/%u us RX %u B/%u us PHY TX %uM RX %uM",
+	          conn_handle, p_link->att_mtu,
+	          p_link->max_tx_octets, p_link->max_tx_time,
+	          p_link->max_rx_octets, p_link->max_rx_time,
+	          p_link->tx_phy, p_link->rx_phy);
+	LOG_DEBUG("Link 0x%04X : interval=%u latency=%u timeout=%u cccd=0x%04X notified=%lu",
+	          conn_handle, p_link->conn_interval, p_link->conn_latency, p_link->supervision_timeout,
+	          p_link->cccd, (unsigned long)p_link->notified);
+}
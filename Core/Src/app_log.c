@@ -0,0 +1,251 @@
+/*
+ * app_log.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Asynchronous logging backend for the LOG_xxx macros (app_debug.h).
+ *
+ * Lines are formatted straight into a slot of a bounded multi-producer /
+ * single-consumer queue (sequence numbered slots, lock free: producers may be
+ * the main loop or interrupt handlers). The consumer sends one slot at a time
+ * with HAL_UART_Transmit_DMA(); the next slot is started from the UART TX
+ * complete interrupt, so nothing on the event path waits for the UART.
+ *
+ * When every slot is in use the line is dropped and counted, never waited on,
+ * except between log_bulk_begin() and log_bulk_end(): a statistics dump is
+ * longer than the queue, so there the main loop waits for the UART to free a
+ * slot (up to LOG_BULK_WAIT_MS per line). Lines from interrupt handlers are
+ * still dropped, they cannot wait for the UART interrupt.
+ */
+
+#include "app_includes.h"
+#include <stdarg.h>
+
+typedef char STATIC_ASSERT_log_slot_count_pow2[ ( 0U == ( LOG_SLOT_COUNT & ( LOG_SLOT_COUNT - 1U ) ) ) ? 1 : -1 ];
+
+typedef struct
+{
+	/* pos      : free for the producer reserving position pos
+	 * pos + 1  : written, ready to be sent
+	 * pos + N  : sent, free for position pos + N */
+	volatile uint32_t seq;
+	uint16_t len;
+	char buf[LOG_LINE_MAX];
+} log_slot_t;
+
+static log_slot_t g_log_slots[LOG_SLOT_COUNT];
+
+/* Next position to reserve (producers) / to send (consumer) */
+static volatile uint32_t g_log_enq_pos = 0;
+static uint32_t g_log_deq_pos = 0;
+
+/* 1 while a DMA transfer is in flight: owner of g_log_deq_pos */
+static volatile uint32_t g_log_tx_busy = 0;
+
+static UART_HandleTypeDef * g_log_huart = NULL;
+
+/* log_bulk_begin() nesting */
+static uint32_t g_log_bulk = 0;
+
+static log_stats_t g_log_stats;
+
+static bool log_slot_ready( void )
+{
+	const log_slot_t * p_slot = &g_log_slots[g_log_deq_pos & ( LOG_SLOT_COUNT - 1U )];
+	return ( __atomic_load_n( &p_slot->seq, __ATOMIC_ACQUIRE ) == ( g_log_deq_pos + 1U ) );
+}
+
+/* Caller owns g_log_tx_busy */
+static bool log_start_next( void )
+{
+	if( ( NULL == g_log_huart ) || ( false == log_slot_ready() ) )
+	{
+		return false;
+	}
+
+	log_slot_t * p_slot = &g_log_slots[g_log_deq_pos & ( LOG_SLOT_COUNT - 1U )];
+	return ( HAL_OK == HAL_UART_Transmit_DMA( g_log_huart, (uint8_t *)p_slot->buf, p_slot->len ) );
+}
+
+/* Start the DMA if it is idle and a line is ready */
+static void log_kick( void )
+{
+	do
+	{
+		uint32_t expected = 0;
+		if( !__atomic_compare_exchange_n( &g_log_tx_busy, &expected, 1U, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED ) )
+		{
+			/* Transfer in flight: the TX complete interrupt picks the line up */
+			return;
+		}
+		if( log_start_next() )
+		{
+			return;
+		}
+		__atomic_store_n( &g_log_tx_busy, 0U, __ATOMIC_RELEASE );
+		/* A producer may have published after the check and seen busy = 1 */
+	} while( ( NULL != g_log_huart ) && log_slot_ready() );
+}
+
+/*
+ * Queue full: true when the caller may try again (bulk mode, thread mode,
+ * within LOG_BULK_WAIT_MS of *p_wait_start, set on the first wait).
+ */
+static bool log_wait_slot( bool * p_waiting, uint32_t * p_wait_start )
+{
+	if( ( 0U == g_log_bulk ) || ( 0U != __get_IPSR() ) )
+	{
+		return false;
+	}
+	if( false == *p_waiting )
+	{
+		*p_waiting = true;
+		*p_wait_start = app_port_tick_ms();
+		__atomic_fetch_add( &g_log_stats.waited, 1U, __ATOMIC_RELAXED );
+	}
+	else if( LOG_BULK_WAIT_MS < ( app_port_tick_ms() - *p_wait_start ) )
+	{
+		return false;
+	}
+	/* The UART TX complete interrupt frees the slot */
+	log_kick();
+	return true;
+}
+
+void log_init( UART_HandleTypeDef * huart )
+{
+	uint32_t i;
+
+	for( i = 0; LOG_SLOT_COUNT > i; i++ )
+	{
+		g_log_slots[i].seq = i;
+	}
+	g_log_enq_pos = 0;
+	g_log_deq_pos = 0;
+	g_log_tx_busy = 0;
+	g_log_bulk = 0;
+	BLUENRG_memset( &g_log_stats, 0, sizeof( g_log_stats ) );
+	g_log_huart = huart;
+}
+
+void log_printf( const char * fmt, ... )
+{
+	log_slot_t * p_slot;
+	uint32_t pos;
+	bool waiting = false;
+	uint32_t wait_start = 0;
+	va_list args;
+	int len;
+
+	if( NULL == g_log_huart )
+	{
+		/* log_init() not called yet */
+		return;
+	}
+
+	/* Reserve a slot */
+	pos = __atomic_load_n( &g_log_enq_pos, __ATOMIC_RELAXED );
+	for( ;; )
+	{
+		p_slot = &g_log_slots[pos & ( LOG_SLOT_COUNT - 1U )];
+		const int32_t diff = (int32_t)( __atomic_load_n( &p_slot->seq, __ATOMIC_ACQUIRE ) - pos );
+
+		if( 0 == diff )
+		{
+			if( __atomic_compare_exchange_n( &g_log_enq_pos, &pos, pos + 1U, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+			{
+				break;
+			}
+			/* Lost the race, pos now holds the current value */
+		}
+		else if( 0 > diff )
+		{
+			/* Slot still waiting to be sent: queue full */
+			if( false == log_wait_slot( &waiting, &wait_start ) )
+			{
+				__atomic_fetch_add( &g_log_stats.dropped, 1U, __ATOMIC_RELAXED );
+				return;
+			}
+			pos = __atomic_load_n( &g_log_enq_pos, __ATOMIC_RELAXED );
+		}
+		else
+		{
+			pos = __atomic_load_n( &g_log_enq_pos, __ATOMIC_RELAXED );
+		}
+	}
+
+	/* Format in place */
+	va_start( args, fmt );
+	len = vsnprintf( p_slot->buf, sizeof( p_slot->buf ), fmt, args );
+	va_end( args );
+
+	if( 0 > len )
+	{
+		len = 0;
+	}
+	else if( (int)sizeof( p_slot->buf ) <= len )
+	{
+		/* Keep the line ending so the next line starts on its own line */
+		len = sizeof( p_slot->buf ) - 1U;
+		BLUENRG_memcpy( &p_slot->buf[len - ( sizeof( _NEXT_LINE_ ) - 1U )], _NEXT_LINE_, sizeof( _NEXT_LINE_ ) - 1U );
+		__atomic_fetch_add( &g_log_stats.truncated, 1U, __ATOMIC_RELAXED );
+	}
+	p_slot->len = (uint16_t)len;
+	__atomic_fetch_add( &g_log_stats.written, 1U, __ATOMIC_RELAXED );
+
+	/* Publish */
+	__atomic_store_n( &p_slot->seq, pos + 1U, __ATOMIC_RELEASE );
+
+	log_kick();
+}
+
+void HAL_UART_TxCpltCallback( UART_HandleTypeDef * huart )
+{
+	if( huart != g_log_huart )
+	{
+		return;
+	}
+
+	/* Release the slot that was just sent */
+	log_slot_t * p_slot = &g_log_slots[g_log_deq_pos & ( LOG_SLOT_COUNT - 1U )];
+	__atomic_store_n( &p_slot->seq, g_log_deq_pos + LOG_SLOT_COUNT, __ATOMIC_RELEASE );
+	g_log_deq_pos++;
+
+	if( false == log_start_next() )
+	{
+		__atomic_store_n( &g_log_tx_busy, 0U, __ATOMIC_RELEASE );
+		log_kick();
+	}
+}
+
+/* Main loop only: the lines logged until log_bulk_end() wait for room instead of being dropped */
+void log_bulk_begin( void )
+{
+	g_log_bulk++;
+}
+
+void log_bulk_end( void )
+{
+	if( 0U != g_log_bulk )
+	{
+		g_log_bulk--;
+	}
+}
+
+void log_get_stats( log_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_log_stats;
+	}
+}
+
+void log_print_stats( void )
+{
+	LOG_DEBUG("Log : written=%lu dropped=%lu truncated=%lu waited=%lu",
+	          (unsigned long)g_log_stats.written,
+	          (unsigned long)g_log_stats.dropped,
+	          (unsigned long)g_log_stats.truncated,
+	          (unsigned long)g_log_stats.waited);
+}
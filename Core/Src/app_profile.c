@@ -0,0 +1,144 @@
+/*
+ * app_profile.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Hot path profiling on the DWT cycle counter (app_port_cycles()).
+ *
+ * PROFILE_BEGIN / PROFILE_END (app_profile.h) bracket a code path and add its
+ * duration to a static per zone table: count, min, max, sum and a log2
+ * histogram. With APP_PROFILE = 0 the macros expand to nothing and the table
+ * is not built.
+ *
+ * The table is printed on disconnect and on the PROFILE_CMD_DUMP control RX
+ * command.
+ */
+
+#include "app_includes.h"
+
+#if ( 1 == APP_PROFILE )
+static const char * const g_zone_name[PROFILE_ZONE_COUNT] =
+{
+	[PROFILE_ZONE_EVT_PROC]			= "hci_user_evt_proc",
+	[PROFILE_ZONE_USER_EVT_RX]	= "App_UserEvtRx",
+	[PROFILE_ZONE_READ_REQ]			= "Read_Request_CB",
+	[PROFILE_ZONE_SPI_RX]				= "HCI_TL_SPI_Receive",
+	[PROFILE_ZONE_GATT_UPDATE]	= "aci_gatt_update_char_value",
+	[PROFILE_ZONE_HCI_ISR]			= "hci_tl_lowlevel_isr",
+	[PROFILE_ZONE_HCI_BH]				= "hci_tl_lowlevel_bottom_half",
+};
+
+static profile_zone_stats_t g_profile[PROFILE_ZONE_COUNT];
+#endif /* ( 1 == APP_PROFILE ) */
+
+void profile_init( void )
+{
+#if ( 1 == APP_PROFILE )
+	app_port_cycle_counter_init();
+	profile_reset();
+#endif /* ( 1 == APP_PROFILE ) */
+}
+
+void profile_record( profile_zone_t zone, uint32_t cycles )
+{
+#if ( 1 == APP_PROFILE )
+	if( PROFILE_ZONE_COUNT <= zone )
+	{
+		return;
+	}
+
+	profile_zone_stats_t * z = &g_profile[zone];
+	/* Bucket = number of significant bits of the duration */
+	uint32_t idx = ( 0U == cycles ) ? 0U : ( 32U - (uint32_t)__builtin_clz( cycles ) );
+	if( PROFILE_HIST_BUCKETS <= idx )
+	{
+		idx = PROFILE_HIST_BUCKETS - 1U;
+	}
+
+	if( ( 0U == z->count ) || ( cycles < z->min ) )
+	{
+		z->min = cycles;
+	}
+	if( cycles > z->max )
+	{
+		z->max = cycles;
+	}
+	z->sum += cycles;
+	z->count++;
+	z->bucket[idx]++;
+#else
+	(void)zone;
+	(void)cycles;
+#endif /* ( 1 == APP_PROFILE ) */
+}
+
+void profile_reset( void )
+{
+#if ( 1 == APP_PROFILE )
+	BLUENRG_memset( g_profile, 0, sizeof( g_profile ) );
+#endif /* ( 1 == APP_PROFILE ) */
+}
+
+/* Returns true when the control RX write was a profiling command */
+bool profile_handle_command( const uint8_t * data, uint16_t len )
+{
+	if( ( NULL == data ) || ( 1U != len ) )
+	{
+		return false;
+	}
+
+	if( PROFILE_CMD_DUMP == data[0] )
+	{
+		profile_print_stats();
+		return true;
+	}
+	if( PROFILE_CMD_RESET == data[0] )
+	{
+		profile_reset();
+		return true;
+	}
+
+	return false;
+}
+
+void profile_get_stats( profile_zone_t zone, profile_zone_stats_t * p_stats )
+{
+	if( ( NULL == p_stats ) || ( PROFILE_ZONE_COUNT <= zone ) )
+	{
+		return;
+	}
+#if ( 1 == APP_PROFILE )
+	*p_stats = g_profile[zone];
+#else
+	BLUENRG_memset( p_stats, 0, sizeof( *p_stats ) );
+#endif /* ( 1 == APP_PROFILE ) */
+}
+
+void profile_print_stats( void )
+{
+#if ( 1 == APP_PROFILE )
+	const uint32_t cycles_per_us = app_port_cycles_per_us();
+	uint32_t i, b;
+
+	for( i = 0; PROFILE_ZONE_COUNT > i; i++ )
+	{
+		const profile_zone_stats_t * z = &g_profile[i];
+		if( 0U == z->count )
+		{
+			continue;
+		}
+		const uint32_t mean = (uint32_t)( z->sum / z->count );
+		LOG_DEBUG("Profile %s : n=%lu min=%lu mean=%lu max=%lu cycles (max %luus)", g_zone_name[i],
+		          (unsigned long)z->count, (unsigned long)z->min, (unsigned long)mean,
+		          (unsigned long)z->max, (unsigned long)( z->max / cycles_per_us ));
+		for( b = 0; PROFILE_HIST_BUCKETS > b; b++ )
+		{
+			if( 0U != z->bucket[b] )
+			{
+				LOG_DEBUG("  < %8lu : %lu", (unsigned long)( 1UL << b ), (unsigned long)z->bucket[b]);
+			}
+		}
+	}
+#endif /* ( 1 == APP_PROFILE ) */
+}
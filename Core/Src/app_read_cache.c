@@ -0,0 +1,133 @@
+/*
+ * app_read_cache.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Publish on change for READ characteristics.
+ *
+ * With GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP every central read is an
+ * SPI event into Read_Request_CB(), an aci_gatt_update_char_value() and an
+ * aci_gatt_allow_read(), all inside the connection event. Here the
+ * characteristics are registered with GATT_DONT_NOTIFY_EVENTS instead: the
+ * controller answers reads from its GATT DB, and the application only writes
+ * the value there when the sensor moved by more than the deadband.
+ */
+
+#include "app_includes.h"
+
+typedef struct
+{
+	int16_t value;			/* Value in the controller GATT DB */
+	bool valid;					/* false: not published yet, or the last publish failed */
+} read_cache_state_t;
+
+static const read_cache_desc_t * g_cache_desc = NULL;
+static uint32_t g_cache_count = 0;
+static read_cache_state_t g_cache_state[READ_CACHE_MAX_ENTRIES];
+static uint32_t g_cache_last_poll = 0;
+
+/* Zero at boot only: a controller restart (app_recovery.c) re-runs
+ * read_cache_init() and the counters span every restart */
+static read_cache_stats_t g_cache_stats;
+
+static void read_cache_update( uint32_t i )
+{
+	const read_cache_desc_t * p_desc = &g_cache_desc[i];
+	read_cache_state_t * p_state = &g_cache_state[i];
+	int16_t value;
+
+	if( false == p_desc->sample( &value ) )
+	{
+		return;
+	}
+
+	if( p_state->valid )
+	{
+		const int32_t diff = (int32_t)value - (int32_t)p_state->value;
+		if( ( ( 0 <= diff ) ? diff : -diff ) <= (int32_t)p_desc->deadband )
+		{
+			if( 0 != diff )
+			{
+				g_cache_stats.suppressed++;
+			}
+			return;
+		}
+	}
+
+	tBleStatus ret = p_desc->publish( value );
+	/* Command timeouts feed the fault detection */
+	recovery_on_hci_status( ret );
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		/* Retried on the next poll */
+		LOG_WARN("read_cache: %s publish FAILED (%d)", p_desc->name, ret);
+		p_state->valid = false;
+		g_cache_stats.failed++;
+		return;
+	}
+
+	p_state->value = value;
+	p_state->valid = true;
+	g_cache_stats.published++;
+}
+
+/* Registers the table (flash resident) and publishes every initial value */
+tBleStatus read_cache_init( const read_cache_desc_t * p_desc, uint32_t count )
+{
+	uint32_t i;
+
+	if( ( NULL == p_desc ) || ( READ_CACHE_MAX_ENTRIES < count ) )
+	{
+		LOG_WARN("read_cache_init: invalid table (%lu entries, max %u)", (unsigned long)count, (unsigned)READ_CACHE_MAX_ENTRIES);
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+
+	g_cache_desc = p_desc;
+	g_cache_count = count;
+	/* New GATT DB: every value is published again */
+	BLUENRG_memset( g_cache_state, 0, sizeof( g_cache_state ) );
+
+	for( i = 0; g_cache_count > i; i++ )
+	{
+		read_cache_update( i );
+	}
+	g_cache_last_poll = app_port_tick_ms();
+
+	return BLE_STATUS_SUCCESS;
+}
+
+void read_cache_poll( void )
+{
+	uint32_t i;
+	const uint32_t now = app_port_tick_ms();
+
+	if( ( NULL == g_cache_desc ) || ( READ_CACHE_POLL_MS > ( now - g_cache_last_poll ) ) )
+	{
+		return;
+	}
+	g_cache_last_poll = now;
+	g_cache_stats.polls++;
+
+	for( i = 0; g_cache_count > i; i++ )
+	{
+		read_cache_update( i );
+	}
+}
+
+void read_cache_get_stats( read_cache_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_cache_stats;
+	}
+}
+
+void read_cache_print_stats( void )
+{
+	LOG_DEBUG("Read cache : polls=%lu published=%lu suppressed=%lu failed=%lu",
+	          (unsigned long)g_cache_stats.polls,
+	          (unsigned long)g_cache_stats.published,
+	          (unsigned long)g_cache_stats.suppressed,
+	          (unsigned long)g_cache_stats.failed);
+}
@@ -0,0 +1,220 @@
+/*
+ * app_recovery.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Controller fault recovery.
+ *
+ * A hung BlueNRG-2 shows up as ACI commands ending in BLE_STATUS_TIMEOUT
+ * (recovery_on_hci_status()) or as an IRQ line held high with nothing to
+ * read (hci_tl_lowlevel_bottom_half(), PendSV). Either cause, or a failed
+ * bluenrg_init() at boot, is only recorded by recovery_report(). recovery_poll() then, from the
+ * main loop:
+ *   1. ends every connection through the normal disconnect path, since the
+ *      controller reset drops them without any event,
+ *   2. calls bluenrg_restart(): reset pin, aci_blue_initialized_event() wait
+ *      and replay of the GAP / GATT / security setup (app_gatt_db.c replays
+ *      the validated service tables and checks the handles did not move),
+ *   3. restarts advertising with a fast burst.
+ * A restart that fails is retried after RECOVERY_RETRY_MS, doubled up to
+ * RECOVERY_RETRY_MAX_MS, instead of stopping the device.
+ */
+
+#include "app_includes.h"
+
+/* Bit per recovery_cause_t, set from any context (PendSV bottom half included) */
+static volatile uint32_t g_pending_causes = 0;
+/* Consecutive BLE_STATUS_TIMEOUT results */
+static uint32_t g_hci_timeouts = 0;
+
+/* Controller down: recovery_poll() restarts it */
+static bool g_down = false;
+static uint32_t g_fault_tick = 0;
+static uint32_t g_retry_tick = 0;
+static uint32_t g_retry_ms = 0;
+/* Restarted, time to recover closed by the first advertising */
+static bool g_ttr_pending = false;
+
+static recovery_stats_t g_rec_stats;
+
+typedef char STATIC_ASSERT_recovery_cause_bits[ ( 32U >= RECOVERY_CAUSE_COUNT ) ? 1 : -1 ];
+
+static const char * const g_recovery_cause_name[RECOVERY_CAUSE_COUNT] =
+{
+	[RECOVERY_CAUSE_INIT]					= "init",
+	[RECOVERY_CAUSE_HCI_TIMEOUT]	= "hci timeout",
+	[RECOVERY_CAUSE_IRQ_STUCK]		= "irq stuck",
+	[RECOVERY_CAUSE_INJECTED]			= "injected",
+};
+
+void recovery_report( recovery_cause_t cause )
+{
+	if( RECOVERY_CAUSE_COUNT > cause )
+	{
+		__disable_irq();
+		g_pending_causes |= ( 1UL << cause );
+		__enable_irq();
+	}
+}
+
+/* Result of an ACI command: a success clears the timeout run */
+void recovery_on_hci_status( tBleStatus status )
+{
+	if( BLE_STATUS_TIMEOUT != status )
+	{
+		g_hci_timeouts = 0;
+		return;
+	}
+	g_hci_timeouts++;
+	if( RECOVERY_HCI_TIMEOUT_LIMIT <= g_hci_timeouts )
+	{
+		recovery_report( RECOVERY_CAUSE_HCI_TIMEOUT );
+	}
+}
+
+/* Fault seen: count it and release everything tied to the old controller state */
+static void recovery_enter( uint32_t causes )
+{
+	uint32_t i;
+
+	for( i = 0; RECOVERY_CAUSE_COUNT > i; i++ )
+	{
+		if( 0U != ( causes & ( 1UL << i ) ) )
+		{
+			g_rec_stats.faults[i]++;
+			LOG_WARN("Recovery : controller fault (%s)", g_recovery_cause_name[i]);
+		}
+	}
+	g_down = true;
+	g_fault_tick = app_port_tick_ms();
+	g_retry_ms = 0;
+	g_ttr_pending = false;
+
+	/* No advertising or connection survives the reset */
+	bluenrg_on_advertising_stopped();
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		const uint16_t conn_handle = link_handle_at( i );
+		if( INVALID_CONNECTION_HANDLE != conn_handle )
+		{
+			hci_disconnection_complete_event( BLE_STATUS_SUCCESS, conn_handle, RECOVERY_DISCONNECT_REASON );
+		}
+	}
+}
+
+/*
+ * Main loop. Returns false while the controller is down: the caller must not
+ * issue ACI commands until it returns true again.
+ */
+bool recovery_poll( void )
+{
+	tBleStatus ret;
+
+	if( false == g_down )
+	{
+		if( 0U == g_pending_causes )
+		{
+			return true;
+		}
+		__disable_irq();
+		const uint32_t causes = g_pending_causes;
+		g_pending_causes = 0;
+		__enable_irq();
+		recovery_enter( causes );
+	}
+
+	if( ( app_port_tick_ms() - g_retry_tick ) < g_retry_ms )
+	{
+		return false;
+	}
+
+	g_rec_stats.restarts++;
+	ret = bluenrg_restart();
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		g_rec_stats.failed++;
+		g_retry_tick = app_port_tick_ms();
+		g_retry_ms = ( 0U == g_retry_ms ) ? RECOVERY_RETRY_MS : ( 2U * g_retry_ms );
+		if( RECOVERY_RETRY_MAX_MS < g_retry_ms )
+		{
+			g_retry_ms = RECOVERY_RETRY_MAX_MS;
+		}
+		LOG_WARN("Recovery : restart FAILED (%d), next in %lu ms", ret, (unsigned long)g_retry_ms);
+		return false;
+	}
+
+	/* Timeouts and stuck IRQ reports of the old controller are stale now */
+	__disable_irq();
+	g_pending_causes = 0;
+	__enable_irq();
+	g_hci_timeouts = 0;
+	g_down = false;
+	g_ttr_pending = true;
+	LOG_DEBUG("Recovery : controller up after %lu ms", (unsigned long)( app_port_tick_ms() - g_fault_tick ));
+
+	adv_request( ADV_REASON_BOOT );
+	return true;
+}
+
+/* Called by adv_poll() on every advertising start */
+void recovery_on_advertising( void )
+{
+	uint32_t ttr_ms;
+
+	if( false == g_ttr_pending )
+	{
+		return;
+	}
+	g_ttr_pending = false;
+	ttr_ms = app_port_tick_ms() - g_fault_tick;
+
+	if( ( 0U == g_rec_stats.recovered ) || ( ttr_ms < g_rec_stats.ttr_min_ms ) )
+	{
+		g_rec_stats.ttr_min_ms = ttr_ms;
+	}
+	if( ttr_ms > g_rec_stats.ttr_max_ms )
+	{
+		g_rec_stats.ttr_max_ms = ttr_ms;
+	}
+	g_rec_stats.ttr_sum_ms += ttr_ms;
+	g_rec_stats.recovered++;
+	LOG_DEBUG("Recovery : advertising again %lu ms after the fault", (unsigned long)ttr_ms);
+}
+
+bool recovery_handle_command( const uint8_t * data, uint16_t len )
+{
+	if( ( NULL == data ) || ( 1U != len ) || ( RECOVERY_CMD_INJECT != data[0] ) )
+	{
+		return false;
+	}
+	/* Runs from rx_queue_process(): the restart happens on the next recovery_poll() */
+	recovery_report( RECOVERY_CAUSE_INJECTED );
+	return true;
+}
+
+void recovery_get_stats( recovery_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_rec_stats;
+	}
+}
+
+void recovery_print_stats( void )
+{
+	const uint32_t avg_ms = ( 0U != g_rec_stats.recovered ) ? ( g_rec_stats.ttr_sum_ms / g_rec_stats.recovered ) : 0U;
+
+	LOG_DEBUG("Recovery : init=%lu hci_timeout=%lu irq_stuck=%lu injected=%lu restarts=%lu failed=%lu",
+	          (unsigned long)g_rec_stats.faults[RECOVERY_CAUSE_INIT],
+	          (unsigned long)g_rec_stats.faults[RECOVERY_CAUSE_HCI_TIMEOUT],
+	          (unsigned long)g_rec_stats.faults[RECOVERY_CAUSE_IRQ_STUCK],
+	          (unsigned long)g_rec_stats.faults[RECOVERY_CAUSE_INJECTED],
+	          (unsigned long)g_rec_stats.restarts,
+	          (unsigned long)g_rec_stats.failed);
+	LOG_DEBUG("Recovery : recovered=%lu ttr min=%lums avg=%lums max=%lums",
+	          (unsigned long)g_rec_stats.recovered,
+	          (unsigned long)g_rec_stats.ttr_min_ms,
+	          (unsigned long)avg_ms,
+	          (unsigned long)g_rec_stats.ttr_max_ms);
+}
@@ -0,0 +1,126 @@
+/*
+ * app_rx_queue.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Control RX frame queue and command processor.
+ *
+ * Fixed capacity single-producer / single-consumer ring of frame slots:
+ *   - Producer : rx_queue_push(), from aci_gatt_attribute_modified_event()
+ *                (HCI event callback context).
+ *   - Consumer : rx_queue_process(), main loop only.
+ *
+ * The write is copied once, straight from the HCI event into its slot (the
+ * event packet goes back to the transport pool when the callback returns).
+ * The command processor then reads the frame in place, so back-to-back
+ * write-without-response packets queue up instead of overwriting each other
+ * and the event callback only pays for that single copy.
+ *
+ * A full ring drops the new write and counts it (rx_queue_stats_t.overflow).
+ */
+
+#include "app_includes.h"
+
+typedef char STATIC_ASSERT_rx_queue_depth_pow2[ ( 0U == ( RX_QUEUE_DEPTH & ( RX_QUEUE_DEPTH - 1U ) ) ) ? 1 : -1 ];
+
+static rx_frame_t g_rx_ring[RX_QUEUE_DEPTH];
+
+/* Free running indexes: head written by the producer only, tail by the consumer only */
+static volatile uint32_t g_rx_head = 0;
+static volatile uint32_t g_rx_tail = 0;
+
+static rx_queue_stats_t g_rx_stats;
+
+extern tBleStatus health_control_process(const rx_frame_t * p_frame);
+
+tBleStatus rx_queue_push( uint16_t conn_handle, const uint8_t * data, uint16_t len )
+{
+	const uint32_t head = g_rx_head;
+	uint32_t depth;
+	rx_frame_t * p_frame;
+
+	if( ( NULL == data ) || ( 0U == len ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	if( RX_QUEUE_FRAME_MAX < len )
+	{
+		g_rx_stats.oversize++;
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	depth = head - g_rx_tail;
+	if( RX_QUEUE_DEPTH <= depth )
+	{
+		g_rx_stats.overflow++;
+		return BLE_STATUS_INSUFFICIENT_RESOURCES;
+	}
+
+	p_frame = &g_rx_ring[head & ( RX_QUEUE_DEPTH - 1U )];
+	p_frame->conn_handle = conn_handle;
+	p_frame->len = len;
+	BLUENRG_memcpy( p_frame->data, data, len );
+	/* Frame must be visible before the consumer sees the new head */
+	__DMB();
+	g_rx_head = head + 1U;
+
+	g_rx_stats.received++;
+	if( g_rx_stats.high_water < ( depth + 1U ) )
+	{
+		g_rx_stats.high_water = depth + 1U;
+	}
+
+	return BLE_STATUS_SUCCESS;
+}
+
+/* Command processor: hand every queued frame to health_control_process() */
+void rx_queue_process( void )
+{
+	uint32_t tail = g_rx_tail;
+
+	while( tail != g_rx_head )
+	{
+		/* Frame read after the head was observed */
+		__DMB();
+		const rx_frame_t * p_frame = &g_rx_ring[tail & ( RX_QUEUE_DEPTH - 1U )];
+
+		if( BLE_STATUS_SUCCESS == health_control_process( p_frame ) )
+		{
+			g_rx_stats.processed++;
+		}
+		else
+		{
+			g_rx_stats.rejected++;
+		}
+
+		/* Slot is free for the producer only after the frame has been used */
+		__DMB();
+		tail++;
+		g_rx_tail = tail;
+	}
+}
+
+/* True when rx_queue_process() has work to do */
+bool rx_queue_is_ready( void )
+{
+	return ( g_rx_tail != g_rx_head );
+}
+
+void rx_queue_get_stats( rx_queue_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_rx_stats;
+	}
+}
+
+void rx_queue_print_stats( void )
+{
+	LOG_DEBUG("RX queue : received=%lu processed=%lu rejected=%lu overflow=%lu oversize=%lu high_water=%lu",
+	          (unsigned long)g_rx_stats.received,
+	          (unsigned long)g_rx_stats.processed,
+	          (unsigned long)g_rx_stats.rejected,
+	          (unsigned long)g_rx_stats.overflow,
+	          (unsigned long)g_rx_stats.oversize,
+	          (unsigned long)g_rx_stats.high_water);
+}
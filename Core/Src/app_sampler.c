@@ -0,0 +1,371 @@
+/*
+ * app_sampler.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Timer driven sensor sampling.
+ *
+ *   TIM3 update (TRGO) --> ADC1 scan --> DMA2 Stream4, circular, double buffer
+ *
+ * The DMA half / full complete interrupts copy the finished half into a
+ * single-producer / single-consumer sample ring, each sample stamped from its
+ * sequence number (SAMPLER_PERIOD_MS apart, gaps show up as larger deltas).
+ *
+ * sampler_poll() (main loop) packs the ring into frames that fill the
+ * negotiated ATT_MTU - 3, with one byte time deltas (see app_sampler.h), and
+ * hands them to the health data TX queue. At ATT_MTU 247 one notification
+ * carries 47 samples instead of one read round trip per value, and about 77
+ * of a slowly changing input with the delta / varint coding (APP_SAMPLER_CODEC,
+ * host/tests/test_frame_fill.c); noisy inputs code no smaller than raw.
+ */
+
+#include "app_includes.h"
+
+typedef char STATIC_ASSERT_sampler_ring_pow2[ ( 0U == ( SAMPLER_RING_DEPTH & ( SAMPLER_RING_DEPTH - 1U ) ) ) ? 1 : -1 ];
+
+/* Frame buffers are queued by reference (zero copy): with one more buffer
+ * than TX queue slots, the buffer being filled is never still queued */
+#define SAMPLER_FRAME_POOL				( TX_QUEUE_DEPTH + 1U )
+#define SAMPLER_FRAME_MAX					( LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD )
+
+/* Internal temperature sensor, STM32F411 datasheet: V25 = 760 mV, 2.5 mV/degC */
+#define SAMPLER_VDDA_MV						( 3300U )
+#define SAMPLER_ADC_FULL_SCALE		( 4095U )
+#define SAMPLER_TS_V25_MV					( 760 )
+#define SAMPLER_TS_SLOPE_UV				( 2500 )
+
+#if ( 1 == APP_SAMPLER_CODEC )
+#define SAMPLER_FRAME_VERSION_USED	SAMPLER_FRAME_VERSION_DELTA
+#define SAMPLER_RECORD_MAX					SAMPLER_RECORD_DELTA_MAX
+#else
+#define SAMPLER_FRAME_VERSION_USED	SAMPLER_FRAME_VERSION
+#define SAMPLER_RECORD_MAX					SAMPLER_RECORD_LEN
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+
+typedef struct
+{
+	uint32_t ts_ms;
+	uint16_t value[SAMPLER_CHANNELS];
+} sample_t;
+
+/* Filled by DMA, two halves of SAMPLER_HALF_SAMPLES scans */
+static uint16_t g_adc_dma[2U * SAMPLER_HALF_SAMPLES * SAMPLER_CHANNELS];
+
+static sample_t g_sample_ring[SAMPLER_RING_DEPTH];
+/* Free running indexes: head written by the DMA ISR only, tail by the main loop only */
+static volatile uint32_t g_sample_head = 0;
+static volatile uint32_t g_sample_tail = 0;
+
+/* Scan sequence number since sampler_start() */
+static uint32_t g_sample_seq = 0;
+
+static volatile uint16_t g_latest[SAMPLER_CHANNELS];
+static volatile bool g_latest_valid = false;
+
+static uint8_t g_frame_pool[SAMPLER_FRAME_POOL][SAMPLER_FRAME_MAX];
+static uint32_t g_frame_idx = 0;		/* Pool entry being filled */
+static uint16_t g_frame_len = 0;		/* 0: no frame open */
+static uint32_t g_frame_last_ts = 0;
+static uint32_t g_frame_open_tick = 0;
+#if ( 1 == APP_SAMPLER_CODEC )
+static uint16_t g_frame_prev[SAMPLER_CHANNELS];		/* Delta reference */
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+
+static sampler_stats_t g_sampler_stats;
+
+/* DMA ISR: one finished half of g_adc_dma */
+static void sampler_take( const uint16_t * p_half )
+{
+	uint32_t i, ch;
+	uint32_t head = g_sample_head;
+
+	for( i = 0; SAMPLER_HALF_SAMPLES > i; i++ )
+	{
+		const uint16_t * p_scan = &p_half[i * SAMPLER_CHANNELS];
+
+		for( ch = 0; SAMPLER_CHANNELS > ch; ch++ )
+		{
+			g_latest[ch] = p_scan[ch];
+		}
+		g_sampler_stats.samples++;
+
+		if( SAMPLER_RING_DEPTH <= ( head - g_sample_tail ) )
+		{
+			g_sampler_stats.dropped++;
+		}
+		else
+		{
+			sample_t * p_sample = &g_sample_ring[head & ( SAMPLER_RING_DEPTH - 1U )];
+			p_sample->ts_ms = g_sample_seq * SAMPLER_PERIOD_MS;
+			for( ch = 0; SAMPLER_CHANNELS > ch; ch++ )
+			{
+				p_sample->value[ch] = p_scan[ch];
+			}
+			head++;
+		}
+		g_sample_seq++;
+	}
+	g_latest_valid = true;
+
+	/* Samples must be visible before the consumer sees the new head */
+	__DMB();
+	g_sample_head = head;
+}
+
+void HAL_ADC_ConvHalfCpltCallback( ADC_HandleTypeDef * hadc )
+{
+	if( &hadc1 == hadc )
+	{
+		sampler_take( &g_adc_dma[0] );
+	}
+}
+
+void HAL_ADC_ConvCpltCallback( ADC_HandleTypeDef * hadc )
+{
+	if( &hadc1 == hadc )
+	{
+		sampler_take( &g_adc_dma[SAMPLER_HALF_SAMPLES * SAMPLER_CHANNELS] );
+	}
+}
+
+void sampler_init( void )
+{
+	ADC_ChannelConfTypeDef sConfig = {0};
+	TIM_MasterConfigTypeDef sMasterConfig = {0};
+
+	/* TIM3: 10 kHz count, update every SAMPLER_PERIOD_MS, TRGO on update.
+	 * APB1 is HCLK / 2, so the timer clock is HCLK. */
+	htim3.Instance = TIM3;
+	htim3.Init.Prescaler = ( HAL_RCC_GetHCLKFreq() / 10000U ) - 1U;
+	htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim3.Init.Period = ( SAMPLER_PERIOD_MS * 10U ) - 1U;
+	htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if( HAL_OK != HAL_TIM_Base_Init( &htim3 ) )
+	{
+		Error_Handler();
+	}
+	sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+	sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if( HAL_OK != HAL_TIMEx_MasterConfigSynchronization( &htim3, &sMasterConfig ) )
+	{
+		Error_Handler();
+	}
+
+	/* ADC1: one scan of every channel per TIM3 trigger, results by DMA */
+	hadc1.Instance = ADC1;
+	hadc1.Init.ClockPrescaler = ADC_CLOCK_SYNC_PCLK_DIV4;
+	hadc1.Init.Resolution = ADC_RESOLUTION_12B;
+	hadc1.Init.ScanConvMode = ENABLE;
+	hadc1.Init.ContinuousConvMode = DISABLE;
+	hadc1.Init.DiscontinuousConvMode = DISABLE;
+	hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_RISING;
+	hadc1.Init.ExternalTrigConv = ADC_EXTERNALTRIGCONV_T3_TRGO;
+	hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+	hadc1.Init.NbrOfConversion = SAMPLER_CHANNELS;
+	hadc1.Init.DMAContinuousRequests = ENABLE;
+	hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+	if( HAL_OK != HAL_ADC_Init( &hadc1 ) )
+	{
+		Error_Handler();
+	}
+
+	sConfig.Channel = ADC_CHANNEL_10;
+	sConfig.Rank = SAMPLER_CH_ANALOG + 1U;
+	sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;
+	if( HAL_OK != HAL_ADC_ConfigChannel( &hadc1, &sConfig ) )
+	{
+		Error_Handler();
+	}
+	/* Temperature sensor needs >= 10 us of sampling time */
+	sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
+	sConfig.Rank = SAMPLER_CH_TEMPERATURE + 1U;
+	sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
+	if( HAL_OK != HAL_ADC_ConfigChannel( &hadc1, &sConfig ) )
+	{
+		Error_Handler();
+	}
+}
+
+void sampler_start( void )
+{
+	g_sample_seq = 0;
+	g_sample_tail = g_sample_head;
+	g_frame_len = 0;
+
+	if( HAL_OK != HAL_ADC_Start_DMA( &hadc1, (uint32_t *)g_adc_dma, sizeof( g_adc_dma ) / sizeof( g_adc_dma[0] ) ) )
+	{
+		LOG_WARN("sampler: HAL_ADC_Start_DMA FAILED");
+		return;
+	}
+	if( HAL_OK != HAL_TIM_Base_Start( &htim3 ) )
+	{
+		LOG_WARN("sampler: HAL_TIM_Base_Start FAILED");
+		(void)HAL_ADC_Stop_DMA( &hadc1 );
+	}
+}
+
+void sampler_stop( void )
+{
+	(void)HAL_TIM_Base_Stop( &htim3 );
+	(void)HAL_ADC_Stop_DMA( &hadc1 );
+}
+
+/* Hands the open frame to the TX queue, false when the queue is full */
+static bool sampler_flush( void )
+{
+	uint8_t * p_frame = g_frame_pool[g_frame_idx];
+
+	if( BLE_STATUS_SUCCESS != tx_queue_push( p_frame, g_frame_len ) )
+	{
+		g_sampler_stats.frame_retries++;
+		return false;
+	}
+
+	g_sampler_stats.frames++;
+	g_sampler_stats.packed += p_frame[1];
+	g_sampler_stats.frame_bytes += g_frame_len;
+	g_frame_idx = ( g_frame_idx + 1U ) % SAMPLER_FRAME_POOL;
+	g_frame_len = 0;
+	return true;
+}
+
+void sampler_poll( void )
+{
+	uint32_t tail = g_sample_tail;
+	uint16_t max_len;
+#if ( 0 == APP_SAMPLER_CODEC )
+	uint32_t ch;
+#endif /* ( 0 == APP_SAMPLER_CODEC ) */
+
+	if( false == link_any_subscribed( LINK_CCCD_DATA_TX ) )
+	{
+		/* Nobody listening: keep only the latest values (sampler_get_latest) */
+		g_sample_tail = g_sample_head;
+		g_frame_len = 0;
+		return;
+	}
+
+	/* Frames are notified to every subscriber: smallest ATT_MTU */
+	max_len = link_get_fanout_notify_len( LINK_CCCD_DATA_TX );
+	if( SAMPLER_FRAME_MAX < max_len )
+	{
+		max_len = SAMPLER_FRAME_MAX;
+	}
+	if( ( SAMPLER_FRAME_HEADER_LEN + SAMPLER_RECORD_MAX ) > max_len )
+	{
+		return;
+	}
+
+	while( tail != g_sample_head )
+	{
+		/* Sample read after the head was observed */
+		__DMB();
+		const sample_t * p_sample = &g_sample_ring[tail & ( SAMPLER_RING_DEPTH - 1U )];
+		uint8_t * p_frame = g_frame_pool[g_frame_idx];
+
+		/* Close the open frame when full or when the delta does not fit a byte */
+		if( ( 0U != g_frame_len ) &&
+		    ( ( ( g_frame_len + SAMPLER_RECORD_MAX ) > max_len ) || ( UINT8_MAX < ( p_sample->ts_ms - g_frame_last_ts ) ) ) )
+		{
+			if( false == sampler_flush() )
+			{
+				break;
+			}
+			p_frame = g_frame_pool[g_frame_idx];
+		}
+
+		if( 0U == g_frame_len )
+		{
+			p_frame[0] = SAMPLER_FRAME_VERSION_USED;
+			p_frame[1] = 0;
+			p_frame[2] = (uint8_t)( p_sample->ts_ms );
+			p_frame[3] = (uint8_t)( p_sample->ts_ms >> 8 );
+			p_frame[4] = (uint8_t)( p_sample->ts_ms >> 16 );
+			p_frame[5] = (uint8_t)( p_sample->ts_ms >> 24 );
+			g_frame_len = SAMPLER_FRAME_HEADER_LEN;
+			g_frame_last_ts = p_sample->ts_ms;
+			g_frame_open_tick = app_port_tick_ms();
+#if ( 1 == APP_SAMPLER_CODEC )
+			/* Keyframe: first sample coded against 0 */
+			BLUENRG_memset( g_frame_prev, 0, sizeof( g_frame_prev ) );
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+		}
+
+#if ( 1 == APP_SAMPLER_CODEC )
+		g_frame_len += codec_put_sample( p_sample->ts_ms - g_frame_last_ts, p_sample->value, g_frame_prev, &p_frame[g_frame_len] );
+#else
+		p_frame[g_frame_len++] = (uint8_t)( p_sample->ts_ms - g_frame_last_ts );
+		for( ch = 0; SAMPLER_CHANNELS > ch; ch++ )
+		{
+			p_frame[g_frame_len++] = (uint8_t)( p_sample->value[ch] );
+			p_frame[g_frame_len++] = (uint8_t)( p_sample->value[ch] >> 8 );
+		}
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+		p_frame[1]++;
+		g_frame_last_ts = p_sample->ts_ms;
+
+		/* Slot is free for the producer only after the sample has been used */
+		__DMB();
+		tail++;
+		g_sample_tail = tail;
+	}
+
+	/* Bounded latency for a frame that is filling slowly */
+	if( ( 0U != g_frame_len ) && ( SAMPLER_FLUSH_MS <= ( app_port_tick_ms() - g_frame_open_tick ) ) )
+	{
+		(void)sampler_flush();
+	}
+}
+
+bool sampler_get_latest( uint32_t channel, uint16_t * p_raw )
+{
+	if( ( NULL == p_raw ) || ( SAMPLER_CHANNELS <= channel ) || ( false == g_latest_valid ) )
+	{
+		return false;
+	}
+	*p_raw = g_latest[channel];
+	return true;
+}
+
+/* Latest internal temperature sensor reading, whole degrees C */
+bool sampler_get_temperature( int16_t * p_celsius )
+{
+	uint16_t raw;
+
+	if( ( NULL == p_celsius ) || ( false == sampler_get_latest( SAMPLER_CH_TEMPERATURE, &raw ) ) )
+	{
+		return false;
+	}
+
+	const int32_t mv = (int32_t)( ( (uint32_t)raw * SAMPLER_VDDA_MV ) / SAMPLER_ADC_FULL_SCALE );
+	*p_celsius = (int16_t)( ( ( ( mv - SAMPLER_TS_V25_MV ) * 1000 ) / SAMPLER_TS_SLOPE_UV ) + 25 );
+	return true;
+}
+
+void sampler_get_stats( sampler_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_sampler_stats;
+	}
+}
+
+void sampler_print_stats( void )
+{
+	LOG_DEBUG("Sampler : samples=%lu dropped=%lu frames=%lu packed=%lu frame retries=%lu",
+	          (unsigned long)g_sampler_stats.samples,
+	          (unsigned long)g_sampler_stats.dropped,
+	          (unsigned long)g_sampler_stats.frames,
+	          (unsigned long)g_sampler_stats.packed,
+	          (unsigned long)g_sampler_stats.frame_retries);
+	if( 0U != g_sampler_stats.packed )
+	{
+		/* Hundredths of a byte per sample, header included */
+		const uint32_t per_sample_x100 = ( g_sampler_stats.frame_bytes * 100U ) / g_sampler_stats.packed;
+		LOG_DEBUG("Sampler : %lu.%02lu bytes per sample (raw record %u)",
+		          (unsigned long)( per_sample_x100 / 100U ), (unsigned long)( per_sample_x100 % 100U ),
+		          (unsigned)SAMPLER_RECORD_LEN);
+	}
+}
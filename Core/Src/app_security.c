@@ -0,0 +1,411 @@
+/*
+ * app_security.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * LE Secure Connections pairing with bonding.
+ *
+ * The BlueNRG-2 stores the keys of every bonded central in its own security
+ * database and looks them up by itself, so a returning central re-encrypts
+ * with a single LL encryption procedure instead of a new pairing. The flash
+ * bond store (app_bond_store.c) keeps the bonded identity addresses on the
+ * STM32 side, resynchronised from aci_gap_get_bonded_devices() at boot.
+ *
+ * aci_gap_slave_security_req() is sent on every connection so the central
+ * starts encryption straight away. The time from connection complete to
+ * hci_encryption_change_event() is recorded separately for resumed bonds and
+ * for fresh pairings (security_stats_t). A pairing encrypts the link before
+ * aci_gap_pairing_complete_event() (key distribution runs encrypted), so an
+ * unknown peer is only classified once pairing completes, or as resumed if
+ * it disconnects without pairing (a central using a private address).
+ *
+ * The CCCD bits of a bonded central persist across connections (Core spec
+ * Vol 3 Part G 3.3.3.3): they are kept next to its address in the bond store
+ * and given back to the link table once the reconnection is encrypted.
+ *
+ * IO capability is NoInputNoOutput: Just Works, no MITM protection.
+ */
+
+#include "app_includes.h"
+
+#if ( 1 == APP_SECURITY )
+
+/* Indexed like the link table (link_slot()) */
+typedef struct
+{
+	bool			active;
+	bool			known;					/* Peer address found in the bond store */
+	bool			paired;					/* aci_gap_pairing_complete_event() seen */
+	bool			encrypted;
+	bool			pending;				/* Encrypted, not classified yet */
+	uint32_t	connect_tick;
+	uint32_t	encrypt_ms;			/* Connect to encryption enabled */
+	uint8_t		peer_addr_type;
+	uint8_t		peer_addr[6];
+} security_state_t;
+
+static security_state_t g_sec[LINK_MAX_CONNECTIONS];
+static security_stats_t g_sec_stats;
+
+/* Last bonded central seen encrypted, target of directed advertising (app_adv.c) */
+static bond_store_peer_t g_last_peer;
+static bool g_last_peer_valid = false;
+
+/* Bond store loaded from flash (first security_init() only) */
+static bool g_store_loaded = false;
+
+/* LINK_CCCD_xx are kept in the 8 bit bond_store_peer_t.cccd */
+typedef char STATIC_ASSERT_security_cccd_bits[ ( 0xFFU >= ( LINK_CCCD_DATA_TX | LINK_CCCD_BENCH_TX ) ) ? 1 : -1 ];
+
+static security_state_t * security_find( uint16_t conn_handle )
+{
+	const int32_t slot = link_slot( conn_handle );
+
+	if( ( 0 > slot ) || ( false == g_sec[slot].active ) )
+	{
+		return NULL;
+	}
+	return &g_sec[slot];
+}
+
+static void security_set_last_peer( const security_state_t * p_sec )
+{
+	BLUENRG_memset( &g_last_peer, 0, sizeof( g_last_peer ) );
+	g_last_peer.addr_type = p_sec->peer_addr_type;
+	BLUENRG_memcpy( g_last_peer.addr, p_sec->peer_addr, 6 );
+	g_last_peer_valid = true;
+}
+
+/* Subscriptions of this link, as kept in the bond store */
+static void security_save_cccd( uint16_t conn_handle, const security_state_t * p_sec )
+{
+	link_info_t info;
+
+	if( link_get_info( conn_handle, &info ) )
+	{
+		bond_store_set_cccd( p_sec->peer_addr_type, p_sec->peer_addr, (uint8_t)info.cccd );
+	}
+}
+
+static void security_latency_add( security_latency_t * p_lat, uint32_t ms )
+{
+	if( ( 0U == p_lat->count ) || ( ms < p_lat->min_ms ) )
+	{
+		p_lat->min_ms = ms;
+	}
+	if( ms > p_lat->max_ms )
+	{
+		p_lat->max_ms = ms;
+	}
+	p_lat->sum_ms += ms;
+	p_lat->count++;
+}
+
+static void security_latency_print( const char * name, const security_latency_t * p_lat )
+{
+	LOG_DEBUG("Security : %s n=%lu min=%lu avg=%lu max=%lu ms", name,
+	          (unsigned long)p_lat->count,
+	          (unsigned long)p_lat->min_ms,
+	          (unsigned long)( ( 0U != p_lat->count ) ? ( p_lat->sum_ms / p_lat->count ) : 0U ),
+	          (unsigned long)p_lat->max_ms);
+}
+
+/* The controller database is authoritative: rewrite the flash copy when they differ */
+/* Largest aci_gap_get_bonded_devices() answer: one HCI payload of entries after
+ * Status and Num_of_Addresses. The controller may hold more bonds than the store. */
+#define SECURITY_BONDED_ENTRIES_MAX		( ( HCI_MAX_PAYLOAD_SIZE - 2U ) / sizeof( Bonded_Device_Entry_t ) )
+
+static void security_resync_bonds( void )
+{
+	Bonded_Device_Entry_t entries[SECURITY_BONDED_ENTRIES_MAX];
+	bond_store_peer_t peers[BOND_STORE_PEERS_MAX];
+	uint8_t count = 0;
+	uint8_t i;
+
+	tBleStatus ret = aci_gap_get_bonded_devices( &count, entries );
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("aci_gap_get_bonded_devices : FAILED (%d)", ret);
+		return;
+	}
+	/* Keep the newest bonds (end of the controller list) */
+	if( BOND_STORE_PEERS_MAX < count )
+	{
+		memmove( entries, &entries[count - BOND_STORE_PEERS_MAX], BOND_STORE_PEERS_MAX * sizeof( Bonded_Device_Entry_t ) );
+		count = BOND_STORE_PEERS_MAX;
+	}
+
+	BLUENRG_memset( peers, 0, sizeof( peers ) );
+	for( i = 0; count > i; i++ )
+	{
+		peers[i].addr_type = entries[i].Address_Type;
+		BLUENRG_memcpy( peers[i].addr, entries[i].Address, 6 );
+		peers[i].cccd = bond_store_get_cccd( peers[i].addr_type, peers[i].addr );
+	}
+	if( false == bond_store_same( peers, count ) )
+	{
+		LOG_DEBUG("Bond store : resync %u -> %u peer(s)", bond_store_count(), count);
+		bond_store_set( peers, count );
+		g_sec_stats.resynced++;
+	}
+}
+
+/* After aci_gap_init(): pairing parameters, then the bond store */
+tBleStatus security_init( void )
+{
+	tBleStatus ret = BLE_STATUS_SUCCESS;
+
+	do
+	{
+		ret = aci_gap_set_io_capability( IO_CAP_NO_INPUT_NO_OUTPUT );
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_DEBUG("aci_gap_set_io_capability : FAILED (%d)", ret);
+			break;
+		}
+
+		/* Identity_Address_Type 0 : public address (CONFIG_DATA_PUBADDR) */
+		ret = aci_gap_set_authentication_requirement( BONDING, MITM_PROTECTION_NOT_REQUIRED, SC_IS_SUPPORTED, KEYPRESS_IS_NOT_SUPPORTED,
+		                                              SECURITY_ENC_KEY_SIZE_MIN, MAX_ENCRY_KEY_SIZE,
+		                                              DONOT_USE_FIXED_PIN_FOR_PAIRING, 0, 0x00 );
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_DEBUG("aci_gap_set_authentication_requirement : FAILED (%d)", ret);
+			break;
+		}
+
+		/* Flash copy read once: a controller restart (app_recovery.c) keeps the
+		 * RAM copy, including a bond not yet committed by security_poll() */
+		if( false == g_store_loaded )
+		{
+			bond_store_init();
+			g_store_loaded = true;
+		}
+		security_resync_bonds();
+		/* Until a bonded central connects: the newest bond */
+		g_last_peer_valid = bond_store_last( &g_last_peer );
+	} while( false );
+
+	return ret;
+}
+
+void security_on_connect( uint16_t conn_handle, uint8_t peer_addr_type, const uint8_t peer_addr[6] )
+{
+	const int32_t slot = link_slot( conn_handle );
+	security_state_t * p_sec;
+
+	if( 0 > slot )
+	{
+		return;
+	}
+	p_sec = &g_sec[slot];
+	BLUENRG_memset( p_sec, 0, sizeof( *p_sec ) );
+	p_sec->active = true;
+	p_sec->connect_tick = app_port_tick_ms();
+	p_sec->peer_addr_type = peer_addr_type;
+	BLUENRG_memcpy( p_sec->peer_addr, peer_addr, 6 );
+	/* Public / static random identity only: a resolvable private address never matches */
+	p_sec->known = bond_store_find( peer_addr_type, peer_addr );
+	if( p_sec->known )
+	{
+		g_sec_stats.known_peers++;
+	}
+
+	/* Ask the central to encrypt now: LTK of a bonded central, else pairing */
+	tBleStatus ret = aci_gap_slave_security_req( conn_handle );
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("aci_gap_slave_security_req : FAILED (%d) conn=0x%04X", ret, conn_handle);
+	}
+}
+
+/* Called before link_on_disconnect() while the link slot is still valid */
+void security_on_disconnect( uint16_t conn_handle )
+{
+	security_state_t * p_sec = security_find( conn_handle );
+
+	if( NULL != p_sec )
+	{
+		if( p_sec->pending )
+		{
+			/* Encrypted without pairing: the controller knew the keys */
+			security_latency_add( &g_sec_stats.resumed, p_sec->encrypt_ms );
+		}
+		p_sec->active = false;
+	}
+}
+
+void security_on_pairing_complete( uint16_t conn_handle, uint8_t status, uint8_t reason )
+{
+	security_state_t * p_sec = security_find( conn_handle );
+
+	if( NULL == p_sec )
+	{
+		return;
+	}
+	if( SM_PAIRING_SUCCESS != status )
+	{
+		g_sec_stats.pairing_failed++;
+		LOG_WARN("Pairing FAILED (%d) reason=0x%02X conn=0x%04X", status, reason, conn_handle);
+		return;
+	}
+
+	p_sec->paired = true;
+	security_set_last_peer( p_sec );
+	if( p_sec->pending )
+	{
+		p_sec->pending = false;
+		security_latency_add( &g_sec_stats.paired, p_sec->encrypt_ms );
+	}
+	/* Written to flash from the main loop (security_poll) */
+	if( bond_store_add( p_sec->peer_addr_type, p_sec->peer_addr ) )
+	{
+		LOG_DEBUG("Bonded conn=0x%04X (%u peer(s))", conn_handle, bond_store_count());
+	}
+	/* Subscribed before pairing: kept for the next connection too */
+	security_save_cccd( conn_handle, p_sec );
+}
+
+void security_on_encryption_change( uint16_t conn_handle, uint8_t status, bool enabled )
+{
+	security_state_t * p_sec = security_find( conn_handle );
+	uint32_t ms;
+
+	if( ( NULL == p_sec ) || ( BLE_STATUS_SUCCESS != status ) || ( false == enabled ) || p_sec->encrypted )
+	{
+		if( BLE_STATUS_SUCCESS != status )
+		{
+			LOG_WARN("Encryption FAILED (%d) conn=0x%04X", status, conn_handle);
+		}
+		return;
+	}
+
+	p_sec->encrypted = true;
+	ms = app_port_tick_ms() - p_sec->connect_tick;
+	p_sec->encrypt_ms = ms;
+	if( p_sec->known )
+	{
+		security_latency_add( &g_sec_stats.resumed, ms );
+		security_set_last_peer( p_sec );
+		/* Bonded central: its subscriptions of the last connection are back */
+		const uint8_t cccd = bond_store_get_cccd( p_sec->peer_addr_type, p_sec->peer_addr );
+		if( 0U != cccd )
+		{
+			link_set_cccd( conn_handle, cccd, true );
+			LOG_DEBUG("CCCD 0x%02X restored conn=0x%04X", cccd, conn_handle);
+		}
+	}
+	else if( p_sec->paired )
+	{
+		security_latency_add( &g_sec_stats.paired, ms );
+	}
+	else
+	{
+		/* Classified by aci_gap_pairing_complete_event() or the disconnect */
+		p_sec->pending = true;
+	}
+	LOG_DEBUG("Encrypted conn=0x%04X after %lu ms", conn_handle, (unsigned long)ms);
+}
+
+/* After link_set_cccd(): a bonded central's subscriptions are remembered */
+void security_on_cccd_write( uint16_t conn_handle )
+{
+	const security_state_t * p_sec = security_find( conn_handle );
+
+	if( ( NULL != p_sec ) && p_sec->encrypted && ( p_sec->known || p_sec->paired ) )
+	{
+		security_save_cccd( conn_handle, p_sec );
+	}
+}
+
+/* The central has lost its keys: let it pair again on the links not yet encrypted */
+void security_on_bond_lost( void )
+{
+	uint32_t i;
+
+	g_sec_stats.bond_lost++;
+	for( i = 0; LINK_MAX_CONNECTIONS > i; i++ )
+	{
+		if( g_sec[i].active && ( false == g_sec[i].encrypted ) )
+		{
+			(void)aci_gap_allow_rebond( link_handle_at( i ) );
+		}
+	}
+}
+
+/*
+ * Main loop hook: flash write of a new bond.
+ *
+ * Programming a record stalls code fetch for a few hundred us. Erasing the
+ * full sector stalls it, interrupts included, for up to 2 s: the sampler DMA
+ * ring overruns and the SPI bottom half cannot read, so the controller
+ * buffers back up and a connected central may time out. The erase is
+ * therefore held back while any central is connected.
+ */
+void security_poll( void )
+{
+	bond_store_commit( 0U == link_count() );
+}
+
+bool security_get_last_peer( bond_store_peer_t * p_peer )
+{
+	if( g_last_peer_valid && ( NULL != p_peer ) )
+	{
+		*p_peer = g_last_peer;
+	}
+	return g_last_peer_valid;
+}
+
+/* Returns true when the control RX write was a security command */
+bool security_handle_command( const uint8_t * data, uint16_t len )
+{
+	if( ( NULL == data ) || ( 1U != len ) || ( SECURITY_CMD_CLEAR_BONDS != data[0] ) )
+	{
+		return false;
+	}
+
+	tBleStatus ret = aci_gap_clear_security_db();
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("aci_gap_clear_security_db : FAILED (%d)", ret);
+	}
+	else
+	{
+		bond_store_set( NULL, 0 );
+		g_last_peer_valid = false;
+		LOG_DEBUG("Bonds cleared");
+	}
+	return true;
+}
+
+void security_get_stats( security_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_sec_stats;
+	}
+}
+
+void security_print_stats( void )
+{
+	bond_store_stats_t store;
+
+	bond_store_get_stats( &store );
+	security_latency_print( "resumed", &g_sec_stats.resumed );
+	security_latency_print( "paired", &g_sec_stats.paired );
+	LOG_DEBUG("Security : known=%lu pairing_failed=%lu bond_lost=%lu resynced=%lu",
+	          (unsigned long)g_sec_stats.known_peers,
+	          (unsigned long)g_sec_stats.pairing_failed,
+	          (unsigned long)g_sec_stats.bond_lost,
+	          (unsigned long)g_sec_stats.resynced);
+	LOG_DEBUG("Bond store : peers=%u records=%lu writes=%lu erases=%lu errors=%lu deferred=%lu",
+	          bond_store_count(),
+	          (unsigned long)store.records,
+	          (unsigned long)store.writes,
+	          (unsigned long)store.erases,
+	          (unsigned long)store.errors,
+	          (unsigned long)store.deferred);
+}
+
+#endif /* ( 1 == APP_SECURITY ) */
@@ -30,7 +30,10 @@
 /* Do not change this: Maximum allowed length of char value that can be passed to aci_gatt_update_char_value */
 #define BLUENRG_MAX_CHAR_VALUE_UPDATE_LEN   (UINT8_MAX)
 
-#define DEF_DATA_TX_CHAR_VALUE_LENGTH				( 20 )
+/* Sized for the largest ATT_MTU: one notification carries ATT_MTU - 3 bytes.
+ * The characteristic is variable length, the actual limit per connection is
+ * checked in health_data_tx() against the negotiated MTU. */
+#define DEF_DATA_TX_CHAR_VALUE_LENGTH				( LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD )
 
 static const uint16_t u16HealthNotifyMaxValueLen = DEF_DATA_TX_CHAR_VALUE_LENGTH;
 
@@ -39,8 +42,6 @@ static const uint16_t u16HealthNotifyMaxValueLen = DEF_DATA_TX_CHAR_VALUE_LENGTH
 #   endif // of (DEF_DATA_TX_CHAR_VALUE_LENGTH > BLUENRG_MAX_CHAR_VALUE_UPDATE_LEN)
 #define DEF_CONTROL_RX_CHAR_VALUE_LENGTH		( 20 )
 
-static const uint16_t u16ControlRxCharValueLength = DEF_CONTROL_RX_CHAR_VALUE_LENGTH;
-
 const uint16_t TEST_BPM_SENSOR_DATA					=	 80;
 const uint16_t TEST_WEIGHT_SENSOR_DATA			=	 75;
 
@@ -76,6 +77,11 @@ const uint8_t HEALTH_DATA_TX_CHAR_UUID[16] 			= { 0x39, 0xea, 0x83, 0x31, 0xa4,
 /* 128-bit Health Control Rx Characteristic UUID (derived from Health Service UUID, little-endian, with byte[12] incremented by 2) */
 const uint8_t HEALTH_CONTROL_RX_CHAR_UUID[16] 	= { 0x39, 0xea, 0x83, 0x31, 0xa4, 0x1e, 0x4c, 0xbf, 0xa5, 0x99, 0x5a, 0xfc, (HEALTH_SERVICE_UUID[12] + 4), 0xd2, 0x68, 0x51 };
 
+#if ( 1 == APP_BENCH )
+/* 128-bit Health Bench Tx Characteristic UUID (derived from Health Service UUID, little-endian, with byte[12] incremented by 5) */
+const uint8_t HEALTH_BENCH_TX_CHAR_UUID[16] 		= { 0x39, 0xea, 0x83, 0x31, 0xa4, 0x1e, 0x4c, 0xbf, 0xa5, 0x99, 0x5a, 0xfc, (HEALTH_SERVICE_UUID[12] + 5), 0xd2, 0x68, 0x51 };
+#endif // of ( 1 == APP_BENCH )
+
 const uint16_t TEST_TEMPERATURE_SENSOR_DATA	=	 17;
 const uint16_t TEST_HUMIDITY_SENSOR_DATA		=	 48;
 
@@ -93,82 +99,33 @@ uint16_t health_bpm_char_handle;
 uint16_t health_weight_char_handle;
 uint16_t health_data_tx_char_handle;
 uint16_t health_control_rx_char_handle;
+#if ( 1 == APP_BENCH )
+uint16_t health_bench_tx_char_handle;
+#endif // of ( 1 == APP_BENCH )
 
 uint16_t weather_service_handle;
 uint16_t weather_temperature_char_handle;
 uint16_t weather_humidity_char_handle;
 
-/* ---- START: BLE connection tracking variables ---- */
-
-/* Current BLE connection handle */
 /* NOTE:
- * BlueNRG-2 supports only a single active BLE connection.
- * The application therefore tracks connection state globally
- * using connection_handle instead of per-connection context.
- *
- * OWNERSHIP: BLE link-level (shared across all services)
+ * Connection state (handle, CCCD bits, ATT_MTU, ...) is kept per connection
+ * in the link table (app_link.c), up to LINK_MAX_CONNECTIONS centrals.
  */
-volatile uint16_t connection_handle = INVALID_CONNECTION_HANDLE;  /* invalid when not connected */
-
-/* ---- END:: BLE connection tracking variables ---- */
-
-/* Global scope flags */
-
-/*
- * Assigned by the BLE controller. Valid only while a connection exists.
- * OWNERSHIP: Health TX only (CCCD state)
- */
-volatile bool notification_enabled = false;
-
-/* Set in disconnection callback, consumed in main loop */
-volatile bool g_restart_adv = false;
-
-/*
- * Validate parameters before calling aci_gatt_add_char().
- *
- * Rationale:
- * - aci_gatt_add_char() returns generic error codes
- * - Caller-side validation is required to identify invalid parameters
- * - Prevents silent GATT database misconfiguration
- *
- * Notes:
- * - Char_Value_Length limits are stack-specific
- * - On BlueNRG-2, the maximum characteristic value length is 512 bytes
- * - This limit is documented but not enforced by the API or compiler
- * - X-CUBE-NRG2 does not expose this limit as a macro
- */
-
-/* --------------------------------------------------------------------
- * Compile-time validation of GATT database storage limits
- *
- * These are design-time constants used when building the GATT database.
- *
- * Enforces BlueNRG-2 characteristic VALUE storage limit:
- *   Char_Value_Length ≤ 512 bytes
- *
- * This limit is:
- *   ✓ NOT an ATT MTU limit
- *   ✓ NOT a link-layer transport limit
- *   ✓ NOT a fragmentation rule
- *
- * Violations indicate a build-time configuration error.
- * -------------------------------------------------------------------- */
-
-/* BlueNRG-2 GATT database characteristic VALUE storage limit
- * Design-time constant used by preprocessor validation.
- *
- * As per X-CUBE-NRG2 documentation:
- *   Char_Value_Length valid range: 1 .. 512 bytes
- */
-#define BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH   (512U)
-
-/* BlueNRG-2 GATT database VALUE storage limit (not ATT MTU, not API limit)
- * Runtime mirror of the same limit (typed)
- */
-static const uint16_t g_max_char_value_length = BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH;
 
 /* --------------------------------------------------------------------
- * Compile-time validation against GATT database storage limit
+ * Compile-time validation of GATT database storage limits
+ *
+ * These are design-time constants used when building the GATT database.
+ *
+ * Enforces BlueNRG-2 characteristic VALUE storage limit:
+ *   Char_Value_Length ≤ 512 bytes
+ *
+ * This limit is:
+ *   ✓ NOT an ATT MTU limit
+ *   ✓ NOT a link-layer transport limit
+ *   ✓ NOT a fragmentation rule
+ *
+ * Violations indicate a build-time configuration error.
  * -------------------------------------------------------------------- */
 # if (DEF_DATA_TX_CHAR_VALUE_LENGTH > BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH)
 #  error "DEF_DATA_TX_CHAR_VALUE_LENGTH exceeds BlueNRG GATT DB value storage limit (512)"
@@ -178,542 +135,201 @@ static const uint16_t g_max_char_value_length = BLUENRG_GATT_MAX_CHAR_VALUE_LENG
 #  error "DEF_CONTROL_RX_CHAR_VALUE_LENGTH exceeds BlueNRG GATT DB value storage limit (512)"
 # endif // of (DEF_CONTROL_RX_CHAR_VALUE_LENGTH > BLUENRG_GATT_MAX_CHAR_VALUE_LENGTH)
 
-static tBleStatus validate_add_char_params(
-  uint8_t        uuid_type,
-  const uint8_t *uuid,
-  uint16_t       char_len,
-  uint8_t        properties,
-  uint8_t        permissions,
-  uint8_t        min_key_size,
-  bool           is_variable
-)
-{
-  tBleStatus ret = BLE_STATUS_SUCCESS;
-
-  do
-  {
-    /* UUID type */
-    if( (UUID_TYPE_16 != uuid_type) && (UUID_TYPE_128 != uuid_type) )
-    {
-      LOG_WARN("add_char: invalid UUID type (%u)", uuid_type);
-      ret = BLE_STATUS_INVALID_PARAMS;
-      break;
-    }
-
-    /* UUID pointer */
-    if( NULL == uuid )
-    {
-      LOG_WARN("add_char: UUID pointer is NULL");
-      ret = BLE_STATUS_NULL_PARAM;
-      break;
-    }
-
-    /* Properties must not be zero */
-    if( 0U == properties )
-    {
-      LOG_WARN("add_char: properties is zero");
-      ret = BLE_STATUS_INVALID_PARAMS;
-      break;
-    }
-
-		 /* --------------------------------------------------------------------
-		 * Characteristic length vs variable flag validation
-		 *
-		 * Rules:
-		 * - Fixed-length characteristic (is_variable == false):
-		 *     char_len is typically sizeof(value)
-		 *     MUST be non-zero and <= max allowed length
-		 *
-		 * - Variable-length characteristic (is_variable == true):
-		 *     char_len represents MAX allowed value length
-		 *     MUST be non-zero and <= max allowed length
-		 * -------------------------------------------------------------------- */
-    if( 0U == char_len )
-    {
-		  LOG_WARN("add_char: %s-length characteristic with zero length", ( false == is_variable ) ? "fixed" : "variable");
-      ret = BLE_STATUS_INVALID_PARAMS;
-      break;
-    }
-
-    if( g_max_char_value_length < char_len )
-    {
-      LOG_WARN("add_char: Char_Value_Length too large (%u > %u)", char_len, g_max_char_value_length);
-      ret = BLE_STATUS_INVALID_PARAMS;
-      break;
-    }
-
-    /*
-     * IMPORTANT:
-     * ATTR_PERMISSION_NONE is VALID and NORMAL.
-     * Do NOT reject READ / WRITE characteristics because of it.
-     */
-
-    /* --------------------------------------------------------------------
-     * Encryption key size validation
-     *
-     * Rules:
-     * - If encryption IS required:
-     *     min_key_size MUST be within [MIN_ENCRY_KEY_SIZE .. MAX_ENCRY_KEY_SIZE]
-     *
-     * - If encryption is NOT required (ATTR_PERMISSION_NONE):
-     *     min_key_size is ignored by the stack
-     *     0 is the recommended value
-     * -------------------------------------------------------------------- */
-    if( ATTR_PERMISSION_NONE != permissions )
-    {
-	    /* Minimum encryption key size — lower bound */
-      if( MIN_ENCRY_KEY_SIZE > min_key_size )
-      {
-        LOG_WARN("add_char: min_key_size too small (%u < %u)", min_key_size, MIN_ENCRY_KEY_SIZE);
-        ret = BLE_INSUFFICIENT_ENC_KEYSIZE;
-        break;
-      }
-
-	    /* Minimum encryption key size — upper bound (BLE spec max = 16) */
-      if( MAX_ENCRY_KEY_SIZE < min_key_size )
-      {
-        LOG_WARN("add_char: min_key_size too large (%u > %u)", min_key_size, MAX_ENCRY_KEY_SIZE);
-        ret = BLE_STATUS_INVALID_PARAMS;
-        break;
-      }
-    }
-    else
-    {
-      if( 0U != min_key_size )
-      {
-        LOG_WARN("add_char: min_key_size ignored because ATTR_PERMISSION_NONE is set (%u)", min_key_size);
-      }
-    }
-  } while( false );
-
-  return ret;
-}
+#if ( 1 == APP_READ_CACHE )
+/* Controller answers reads from its GATT DB, values published on change (app_read_cache.c) */
+#define READ_CHAR_EVT_MASK			GATT_DONT_NOTIFY_EVENTS
+#else
+/* Every read goes through Read_Request_CB() */
+#define READ_CHAR_EVT_MASK			GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP
+#endif // of ( 1 == APP_READ_CACHE )
+
+/* Attribute handlers, dispatched by handle through gatt_db_lookup() */
+static tBleStatus bpm_read_handler(void * ctx);
+static tBleStatus weight_read_handler(void * ctx);
+static tBleStatus temperature_read_handler(void * ctx);
+static tBleStatus humidity_read_handler(void * ctx);
+static tBleStatus control_rx_write_handler(uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length);
+static tBleStatus cccd_notify_write_handler(uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length);
 
-/* Maximum reasonable attribute records per single service.
- * This is a sanity limit to catch configuration bugs, not a stack limit.
+/*
+ * GATT database description (flash resident).
+ *
+ * One row per characteristic, registered in table order by gatt_db_register().
+ * Attribute records per service and CCCD slots are derived from the rows,
+ * see gatt_db_service_attr_records().
+ *
+ * Char_Value_Length (value_len) informs maximum size (in bytes) of the
+ * characteristic VALUE attribute stored in GATT DB.
+ *
+ * Minimum required LTK size (enc_key_size, in bytes) for encrypted access:
+ * 0  = no encryption required (ATTR_PERMISSION_NONE)
+ * 7-16 = minimum acceptable key size enforced during pairing
  */
-static const uint8_t g_max_service_attribute_records = 20U;
-
-static tBleStatus validate_add_service_params(
-  uint8_t              uuid_type,
-  const Service_UUID_t *uuid,
-  uint8_t              service_type,
-  uint8_t              max_attribute_records,
-  const uint16_t       *service_handle
-)
+static const gatt_char_desc_t health_service_chars[] =
 {
-  /* UUID type */
-  if( (UUID_TYPE_16 != uuid_type) && (UUID_TYPE_128 != uuid_type) )
-  {
-    LOG_WARN("add_service: invalid UUID type (%u)", uuid_type);
-    return BLE_STATUS_INVALID_PARAMS;
-  }
-
-  /* UUID pointer */
-  if( NULL == uuid )
-  {
-    LOG_WARN("add_service: UUID pointer is NULL");
-    return BLE_STATUS_NULL_PARAM;
-  }
-
-  /* Service type */
-  if( (PRIMARY_SERVICE != service_type) && (SECONDARY_SERVICE != service_type) )
-  {
-    LOG_WARN("add_service: invalid service type (%u)", service_type);
-    return BLE_STATUS_INVALID_PARAMS;
-  }
-
-  /* Attribute record count */
-  if( 0U == max_attribute_records )
-  {
-    LOG_WARN("add_service: Max_Attribute_Records is zero");
-    return BLE_STATUS_INVALID_PARAMS;
-  }
-
-  if( max_attribute_records > g_max_service_attribute_records )
-  {
-    LOG_WARN("add_service: Max_Attribute_Records too large (%u > %u)",
-             max_attribute_records,
-             g_max_service_attribute_records);
-    return BLE_STATUS_INVALID_PARAMS;
-  }
-
-  /* Service handle pointer */
-  if( NULL == service_handle )
-  {
-    LOG_WARN("add_service: service_handle pointer is NULL");
-    return BLE_STATUS_NULL_PARAM;
-  }
-
-  return BLE_STATUS_SUCCESS;
-}
+	/* BPM characteristic (READ) : value supplied on read request, or published on change */
+	{
+		.name = "health_bpm",
+		.uuid = HEALTH_BPM_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = 2,
+		.properties = CHAR_PROP_READ,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = READ_CHAR_EVT_MASK,
+		.enc_key_size = 0,
+		.is_variable = 0,
+		.p_handle = &health_bpm_char_handle,
+		.on_read = bpm_read_handler,
+	},
+	/* Weight characteristic (READ) */
+	{
+		.name = "health_weight",
+		.uuid = HEALTH_WEIGHT_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = 2,
+		.properties = CHAR_PROP_READ,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = READ_CHAR_EVT_MASK,
+		.enc_key_size = 0,
+		.is_variable = 0,
+		.p_handle = &health_weight_char_handle,
+		.on_read = weight_read_handler,
+	},
+	/* Data TX characteristic (NOTIFY + CCCD) */
+	{
+		.name = "health_data_tx",
+		.uuid = HEALTH_DATA_TX_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = DEF_DATA_TX_CHAR_VALUE_LENGTH,
+		.properties = CHAR_PROP_NOTIFY,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = GATT_DONT_NOTIFY_EVENTS,
+		.enc_key_size = 0,
+		.is_variable = 1,
+		.p_handle = &health_data_tx_char_handle,
+		.on_cccd_write = cccd_notify_write_handler,
+		.ctx = (void *)(uintptr_t)LINK_CCCD_DATA_TX,
+	},
+	/* Control RX characteristic (WRITE / WRITE_NO_RESP) */
+	{
+		.name = "health_control_rx",
+		.uuid = HEALTH_CONTROL_RX_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = DEF_CONTROL_RX_CHAR_VALUE_LENGTH,
+		.properties = CHAR_PROP_WRITE | CHAR_PROP_WRITE_WITHOUT_RESP,
+		.permissions = SECURITY_ATTR_PERMISSION,		/* Commands only over an encrypted link */
+		.evt_mask = GATT_NOTIFY_ATTRIBUTE_WRITE,
+		.enc_key_size = SECURITY_ATTR_KEY_SIZE,
+		.is_variable = 1,
+		.p_handle = &health_control_rx_char_handle,
+		.on_write = control_rx_write_handler,
+	},
+#if ( 1 == APP_BENCH )
+	/* Benchmark TX characteristic (NOTIFY + CCCD) : streamed by app_bench.c */
+	{
+		.name = "health_bench_tx",
+		.uuid = HEALTH_BENCH_TX_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = DEF_DATA_TX_CHAR_VALUE_LENGTH,
+		.properties = CHAR_PROP_NOTIFY,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = GATT_DONT_NOTIFY_EVENTS,
+		.enc_key_size = 0,
+		.is_variable = 1,
+		.p_handle = &health_bench_tx_char_handle,
+		.on_cccd_write = cccd_notify_write_handler,
+		.ctx = (void *)(uintptr_t)LINK_CCCD_BENCH_TX,
+	},
+#endif // of ( 1 == APP_BENCH )
+};
+
+static const gatt_char_desc_t weather_service_chars[] =
+{
+	/* Temperature characteristic (READ) */
+	{
+		.name = "weather_temperature",
+		.uuid = WEATHER_TEMPERATURE_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = 2,
+		.properties = CHAR_PROP_READ,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = READ_CHAR_EVT_MASK,
+		.enc_key_size = 0,
+		.is_variable = 0,
+		.p_handle = &weather_temperature_char_handle,
+		.on_read = temperature_read_handler,
+	},
+	/* Humidity characteristic (READ) */
+	{
+		.name = "weather_humidity",
+		.uuid = WEATHER_HUMIDITY_CHAR_UUID, .uuid_type = UUID_TYPE_128,
+		.value_len = 2,
+		.properties = CHAR_PROP_READ,
+		.permissions = ATTR_PERMISSION_NONE,
+		.evt_mask = READ_CHAR_EVT_MASK,
+		.enc_key_size = 0,
+		.is_variable = 0,
+		.p_handle = &weather_humidity_char_handle,
+		.on_read = humidity_read_handler,
+	},
+};
+
+static const gatt_service_desc_t app_gatt_services[] =
+{
+	{
+		.name = "health_service",
+		.uuid = HEALTH_SERVICE_UUID, .uuid_type = UUID_TYPE_128,
+		.service_type = PRIMARY_SERVICE,
+		.chars = health_service_chars,
+		.char_count = GATT_DB_ARRAY_COUNT( health_service_chars ),
+		.p_handle = &health_service_handle,
+	},
+	{
+		.name = "weather_service",
+		.uuid = WEATHER_SERVICE_UUID, .uuid_type = UUID_TYPE_128,
+		.service_type = PRIMARY_SERVICE,
+		.chars = weather_service_chars,
+		.char_count = GATT_DB_ARRAY_COUNT( weather_service_chars ),
+		.p_handle = &weather_service_handle,
+	},
+};
+
+static bool bpm_sample(int16_t * p_value);
+static bool weight_sample(int16_t * p_value);
+static bool temperature_sample(int16_t * p_value);
+static bool humidity_sample(int16_t * p_value);
+tBleStatus update_bpm_data(int16_t new_data);
+tBleStatus update_weight_data(int16_t new_data);
+tBleStatus update_temperature_data(int16_t new_data);
+tBleStatus update_humidity_data(int16_t new_data);
+
+#if ( 1 == APP_READ_CACHE )
+/* READ characteristics published into the controller GATT DB on change */
+static const read_cache_desc_t app_read_cache[] =
+{
+	{ .name = "health_bpm",						.sample = bpm_sample,					.publish = update_bpm_data,					.deadband = 0 },
+	{ .name = "health_weight",				.sample = weight_sample,			.publish = update_weight_data,			.deadband = 0 },
+	{ .name = "weather_temperature",	.sample = temperature_sample,	.publish = update_temperature_data,	.deadband = 1 },
+	{ .name = "weather_humidity",			.sample = humidity_sample,		.publish = update_humidity_data,		.deadband = 1 },
+};
+#endif // of ( 1 == APP_READ_CACHE )
 
 /* Add enabled services to the GATT database */
 tBleStatus add_services(void)
 {
-	tBleStatus ret;
-	do
+	tBleStatus ret = gatt_db_register( app_gatt_services, GATT_DB_ARRAY_COUNT( app_gatt_services ) );
+#if ( 1 == APP_READ_CACHE )
+	if( BLE_STATUS_SUCCESS == ret )
 	{
-		Service_UUID_t	health_service_uuid;
-		Char_UUID_t			health_bpm_char_uuid;
-		Char_UUID_t			health_weight_char_uuid;
-		Char_UUID_t			health_data_tx_char_uuid;
-		Char_UUID_t			health_control_rx_char_uuid;
-
-		Service_UUID_t	weather_service_uuid;
-		Char_UUID_t			weather_temperature_char_uuid;
-		Char_UUID_t			weather_humidity_char_uuid;
-
-		/* Add health service */
-		BLUENRG_memcpy(health_service_uuid.Service_UUID_128, HEALTH_SERVICE_UUID, sizeof(HEALTH_SERVICE_UUID));
-
-		/*
-		 * ============================================================================
-		 * GATT Attribute Record Accounting (BlueNRG-2 / X-CUBE-BLE2)
-		 * ============================================================================
-		 *
-		 * - Max_Attribute_Records is NOT a global pool for the entire GATT database.
-		 * - It is specified PER SERVICE while calling aci_gatt_add_service().
-		 * - Each service must reserve enough attribute records to cover
-		 *   ALL attributes belonging to THAT service only.
-		 *
-		 * Attribute record usage (record COUNT, not byte size):
-		 *
-		 *   • Primary Service declaration                 : 1 record
-		 *
-		 *   • Characteristic Declaration                  : 1 record (always)
-		 *   • Characteristic Value                        : 1 record (always)
-		 *
-		 *   • READ characteristic                         : 2 records
-		 *       (Declaration + Value)
-		 *
-		 *   • WRITE / WRITE_NO_RESP characteristic         : 2 records
-		 *       (Declaration + Value)
-		 *
-		 *   • NOTIFY or INDICATE characteristic            : 3 records
-		 *       (Declaration + Value + CCCD)
-		 *
-		 *   • READ + NOTIFY / READ + INDICATE              : 3 records
-		 *       (Declaration + Value + CCCD)
-		 *
-		 *   • Characteristic User Description (optional)   : +1 record
-		 *
-		 * Notes:
-		 *
-		 * - Char_Value_Length specifies the MAX size (in bytes) of the
-		 *   Characteristic VALUE attribute only.
-		 *
-		 * - For NOTIFY / INDICATE, the BlueNRG-2 stack automatically creates a
-		 *   Client Characteristic Configuration Descriptor (CCCD) during
-		 *   aci_gatt_add_char().
-		 *
-		 * - CCCD is a SEPARATE attribute (fixed 2 bytes) and consumes
-		 *   one additional attribute record; it is NOT part of the
-		 *   characteristic value.
-		 *
-		 * - Although a NOTIFY characteristic involves:
-		 *   Char_Value_Length bytes (value) + 2 bytes (CCCD),
-		 *   these belong to DIFFERENT attributes and must NOT be combined
-		 *   while selecting Char_Value_Length.
-		 *
-		 * - Example (for clarity):
-		 *     1 service containing 1 NOTIFY characteristic
-		 *       ⇒ 1 (service) + 3 (notify characteristic) = 4 attribute records total.
-		 *
-		 * - If Max_Attribute_Records for a service is undersized, GATT additions
-		 *   may fail silently (for example, missing characteristics or an
-		 *   "Unnamed" device shown on the client side).
-		 * ============================================================================
-		 */
-
-		/* Health Service attribute record allocation:
-		 *
-		 * 1  Primary Service
-		 * 2  BPM characteristic (READ)
-		 * 2  Weight characteristic (READ)
-		 * 3  Data TX characteristic (NOTIFY + CCCD)
-		 * 2  Control RX characteristic (WRITE / WRITE_NO_RESP)
-		 *   ----------------------------------------------
-		 * = 12 attribute records (for this service only)
-		 */
-		#define HEALTH_SERVICE_ATTR_RECORDS_BASE   (1U) /* Primary Service */
-
-		# define HEALTH_SERVICE_ATTR_RECORDS_READ  (4U) /* 2 READ chars */
-
-		# define HEALTH_SERVICE_ATTR_RECORDS_TX    (3U)
-
-		# define HEALTH_SERVICE_ATTR_RECORDS_RX    (2U)
-
-		#define HEALTH_SERVICE_ATTR_RECORDS \
-			(HEALTH_SERVICE_ATTR_RECORDS_BASE + \
-			 HEALTH_SERVICE_ATTR_RECORDS_READ + \
-			 HEALTH_SERVICE_ATTR_RECORDS_TX + \
-			 HEALTH_SERVICE_ATTR_RECORDS_RX)
-
-		assert_param(HEALTH_SERVICE_ATTR_RECORDS <= UINT8_MAX);
-
-		assert_param(HEALTH_SERVICE_ATTR_RECORDS_READ == 4U);
-
-		assert_param(HEALTH_SERVICE_ATTR_RECORDS_TX == 3U);
-
-		assert_param(HEALTH_SERVICE_ATTR_RECORDS_RX == 2U);
-
-		uint8_t Max_Attribute_Records = HEALTH_SERVICE_ATTR_RECORDS;
-		ret = validate_add_service_params(
-		        UUID_TYPE_128,
-		        &health_service_uuid,
-		        PRIMARY_SERVICE,
-		        Max_Attribute_Records,
-		        &health_service_handle);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-		  LOG_WARN("validate_add_service_params FAILED (%d) for health_service", ret);
-		  break;
-		}
-		ret = aci_gatt_add_service(UUID_TYPE_128, &health_service_uuid, PRIMARY_SERVICE, Max_Attribute_Records, &health_service_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_service : FAILED (%d) for health_service", ret);
-			break;
-		}
-
-		uint8_t Char_Properties;
-		uint16_t Char_Value_Length;
-		uint8_t GATT_Evt_Mask;
-		uint8_t Security_Permissions;
-		uint8_t Enc_Key_Size;
-		uint8_t Is_Variable;
-
-		/* Add BPM characteristic (READ) to health service */
-		BLUENRG_memcpy(health_bpm_char_uuid.Char_UUID_128, HEALTH_BPM_CHAR_UUID, sizeof(HEALTH_BPM_CHAR_UUID));
-
-		Char_Properties = CHAR_PROP_READ; /* Earlier set to CHAR_PROP_NOTIFY */
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		Char_Value_Length = ( CHAR_PROP_NOTIFY == Char_Properties ) ? 1 : 2;
-		GATT_Evt_Mask = ( CHAR_PROP_NOTIFY == Char_Properties ) ? GATT_DONT_NOTIFY_EVENTS : GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP;
-		/* Attribute Permission impacts whether:
-		 * Encryption required, LTK required, MITM required
-		 */
-		Security_Permissions = ATTR_PERMISSION_NONE;
-		/* Minimum required LTK size (in bytes) for encrypted access to this attribute.
-		 * 0  = no encryption required
-		 * 7-16 = minimum acceptable key size enforced during pairing
-		 * Actual LTK is generated by the BLE stack during pairing and must be >= this value.
-		 */
-		Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16;
-		/* 0 means Fixed Length */
-		Is_Variable = 0;
-
-		ret = validate_add_char_params(UUID_TYPE_128, health_bpm_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_DEBUG("validate_add_char_params FAILED (%d) for health_bpm_char_handle", ret);
-			break;
-		}
-
-		ret = aci_gatt_add_char(health_service_handle, UUID_TYPE_128, &health_bpm_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &health_bpm_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for health_bpm_char_handle", ret);
-			break;
-		}
-
-		/* Add Weight characteristic (READ) to health service */
-		BLUENRG_memcpy(health_weight_char_uuid.Char_UUID_128, HEALTH_WEIGHT_CHAR_UUID, sizeof(HEALTH_WEIGHT_CHAR_UUID));
-
-		/* Add characteristic */
-		/* Char_Properties is set to CHAR_PROP_READ */
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		/* Char_Value_Length = ( CHAR_PROP_NOTIFY == Char_Properties ) ? 1 : 2 */
-		/* GATT_Evt_Mask = ( CHAR_PROP_NOTIFY == Char_Properties ) ? GATT_DONT_NOTIFY_EVENTS : GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP*/
-		/* Already set to ATTR_PERMISSION_NONE, hence commented: uint8_t Security_Permissions = ATTR_PERMISSION_NONE; */
-		/* Already set to 16, hence commented: Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16; */
-		/* 0 means Fixed Length. */
-		/* Is_Variable = 0; */
-		ret = validate_add_char_params(UUID_TYPE_128, health_weight_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_WARN("validate_add_char_params FAILED (%d) for health_weight_char_handle", ret);
-			break;
-		}
-
-		ret = aci_gatt_add_char(health_service_handle, UUID_TYPE_128, &health_weight_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &health_weight_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for health_weight_char_handle", ret);
-			break;
-		}
-
-		/* Add data tx characteristic (NOTIFY) to health service */
-		BLUENRG_memcpy(health_data_tx_char_uuid.Char_UUID_128, HEALTH_DATA_TX_CHAR_UUID, sizeof(HEALTH_DATA_TX_CHAR_UUID));
-
-		/* Add characteristic */
-		Char_Properties = CHAR_PROP_NOTIFY;
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		Char_Value_Length = u16HealthNotifyMaxValueLen;
-		GATT_Evt_Mask = GATT_DONT_NOTIFY_EVENTS;
-		Security_Permissions = ATTR_PERMISSION_NONE;
-		Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16;
-		/* 0 means Fixed Length, 1 means Variable length. */
-		Is_Variable = 1;
-
-		ret = validate_add_char_params(UUID_TYPE_128, health_data_tx_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_DEBUG("validate_add_char_params FAILED (%d) for health_data_tx_char_uuid", ret);
-			break;
-		}
-
-		ret = aci_gatt_add_char(health_service_handle, UUID_TYPE_128, &health_data_tx_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &health_data_tx_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for health_data_tx_char_handle", ret);
-			break;
-		}
-
-		/* Add Control RX characteristic (WRITE / WRITE_NO_RESP) to health service */
-		BLUENRG_memcpy(health_control_rx_char_uuid.Char_UUID_128, HEALTH_CONTROL_RX_CHAR_UUID, sizeof(HEALTH_CONTROL_RX_CHAR_UUID));
-
-		/* Add characteristic */
-		Char_Properties = CHAR_PROP_WRITE | CHAR_PROP_WRITE_WITHOUT_RESP;
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		Char_Value_Length = u16ControlRxCharValueLength;
-		GATT_Evt_Mask = GATT_NOTIFY_ATTRIBUTE_WRITE;
-		Security_Permissions = ATTR_PERMISSION_NONE;
-		Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16;
-		/* Variable-length control RX characteristic used. Passed value 0 means Fixed Length, and passed value 1 means Variable length. */
-		Is_Variable = 1;
-		ret = validate_add_char_params(UUID_TYPE_128, health_control_rx_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_DEBUG("validate_add_char_params FAILED (%d) for health_control_rx_char_uuid", ret);
-			break;
-		}
-		ret = aci_gatt_add_char(health_service_handle, UUID_TYPE_128, &health_control_rx_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &health_control_rx_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for health_control_rx_char_handle", ret);
-			break;
-		}
-
-		/* Add weather service */
-		BLUENRG_memcpy(weather_service_uuid.Service_UUID_128, WEATHER_SERVICE_UUID, sizeof(WEATHER_SERVICE_UUID));
-
-		/* Weather Service attribute record allocation:
-		 *
-		 * 1  Primary Service
-		 * 2  Temperature characteristic (READ)
-		 * 2  Humidity characteristic (READ)
-		 *   --------------------------------------
-		 * = 5 attribute records (for this service only)
-		 */
-		#define WEATHER_SERVICE_ATTR_RECORDS_BASE   (1U)
-
-		#  define WEATHER_SERVICE_ATTR_RECORDS_READ (4U)
-
-		#  define WEATHER_SERVICE_ATTR_RECORDS_TX   (3U) /* NOTIFY + CCCD */
-
-		#  define WEATHER_SERVICE_ATTR_RECORDS_RX   (2U) /* WRITE */
-
-		#define WEATHER_SERVICE_ATTR_RECORDS \
-			( WEATHER_SERVICE_ATTR_RECORDS_BASE + \
-				WEATHER_SERVICE_ATTR_RECORDS_READ + \
-				WEATHER_SERVICE_ATTR_RECORDS_TX   + \
-				WEATHER_SERVICE_ATTR_RECORDS_RX )
-
-		assert_param(WEATHER_SERVICE_ATTR_RECORDS <= UINT8_MAX);
-
-		assert_param(WEATHER_SERVICE_ATTR_RECORDS_READ == 4U);
-
-		assert_param(WEATHER_SERVICE_ATTR_RECORDS_TX == 3U);
-
-		assert_param(WEATHER_SERVICE_ATTR_RECORDS_RX == 2U);
-
-		Max_Attribute_Records = WEATHER_SERVICE_ATTR_RECORDS;
-
-		ret = validate_add_service_params(
-		        UUID_TYPE_128,
-		        &weather_service_uuid,
-		        PRIMARY_SERVICE,
-		        Max_Attribute_Records,
-		        &weather_service_handle);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-		  LOG_DEBUG("validate_add_service_params FAILED (%d) for weather_service", ret);
-		  break;
-		}
-		ret = aci_gatt_add_service(UUID_TYPE_128, &weather_service_uuid, PRIMARY_SERVICE, Max_Attribute_Records, &weather_service_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_service : FAILED (%d) for weather_service", ret);
-			break;
-		}
-
-		/* Add temperature characteristic (READ) to weather service */
-		BLUENRG_memcpy(weather_temperature_char_uuid.Char_UUID_128, WEATHER_TEMPERATURE_CHAR_UUID, sizeof(WEATHER_TEMPERATURE_CHAR_UUID));
-
-		/* Add characteristic */
-		Char_Properties = CHAR_PROP_READ;
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		Char_Value_Length = ( CHAR_PROP_NOTIFY == Char_Properties ) ? 1 : 2;
-		GATT_Evt_Mask = ( CHAR_PROP_NOTIFY == Char_Properties ) ? GATT_DONT_NOTIFY_EVENTS : GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP;
-		Security_Permissions = ATTR_PERMISSION_NONE;
-		Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16;
-		/* 0 means Fixed Length. */
-		Is_Variable = 0;
-		ret = validate_add_char_params(UUID_TYPE_128, weather_temperature_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_DEBUG("validate_add_char_params FAILED (%d) for weather_temperature_char_uuid", ret);
-			break;
-		}
-
-		ret = aci_gatt_add_char(weather_service_handle, UUID_TYPE_128, &weather_temperature_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &weather_temperature_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for weather_temperature_char_handle", ret);
-			break;
-		}
-
-		/* Add humidity characteristic (READ) to weather service */
-		BLUENRG_memcpy(weather_humidity_char_uuid.Char_UUID_128, WEATHER_HUMIDITY_CHAR_UUID, sizeof(WEATHER_HUMIDITY_CHAR_UUID));
-
-		/* Add characteristic */
-		/* Char_Properties is set to CHAR_PROP_READ */
-		/* Char_Value_Length informs maximum size (in bytes) of the characteristic VALUE attribute stored in GATT DB. */
-		/* Char_Value_Length = ( CHAR_PROP_NOTIFY == Char_Properties ) ? 1 : 2 */
-		/* GATT_Evt_Mask = ( CHAR_PROP_NOTIFY == Char_Properties ) ? GATT_DONT_NOTIFY_EVENTS : GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP*/
-		/* Already set to ATTR_PERMISSION_NONE, hence commented: uint8_t Security_Permissions = ATTR_PERMISSION_NONE; */
-		/* Already set to 16, hence commented: Enc_Key_Size = ( ATTR_PERMISSION_NONE == Security_Permissions ) ? 0 : 16; */
-		/* 0 means Fixed Length. */
-		/* Is_Variable = 0; */
-		ret = validate_add_char_params(UUID_TYPE_128, weather_humidity_char_uuid.Char_UUID_128, Char_Value_Length, Char_Properties, Security_Permissions, Enc_Key_Size, Is_Variable);
-		if( BLE_STATUS_SUCCESS != ret )
-		{
-			LOG_DEBUG("validate_add_char_params FAILED (%d) for weather_humidity_char_uuid", ret);
-			break;
-		}
-
-		ret = aci_gatt_add_char(weather_service_handle, UUID_TYPE_128, &weather_humidity_char_uuid, Char_Value_Length, Char_Properties, Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, &weather_humidity_char_handle);
-		if(BLE_STATUS_SUCCESS != ret)
-		{
-			LOG_DEBUG("aci_gatt_add_char : FAILED (%d) for weather_humidity_char_handle", ret);
-			break;
-		}
-
-	} while( false );
-
+		/* Initial values: reads are served by the controller from now on */
+		ret = read_cache_init( app_read_cache, GATT_DB_ARRAY_COUNT( app_read_cache ) );
+	}
+#endif // of ( 1 == APP_READ_CACHE )
 	return ret;
 }
 
-uint8_t health_control_data_rx[DEF_CONTROL_RX_CHAR_VALUE_LENGTH];
-
-/* Last successfully received control RX length (0 = no valid data) */
-static uint16_t g_health_control_rx_len = 0;
+/* Every control RX write must fit in a frame slot of the RX queue */
+typedef char STATIC_ASSERT_health_control_rx_size[ (DEF_CONTROL_RX_CHAR_VALUE_LENGTH <= RX_QUEUE_FRAME_MAX) ? 1 : -1 ];
 
-typedef char STATIC_ASSERT_health_control_rx_size[ (sizeof(health_control_data_rx) == DEF_CONTROL_RX_CHAR_VALUE_LENGTH) ? 1 : -1 ];
-
-tBleStatus health_control_rx(uint8_t *data_rx, uint16_t rx_bytes_len)
+/*
+ * Control RX write, HCI event callback context: only queues the frame.
+ * Commands are run later by health_control_process() from the main loop.
+ */
+tBleStatus health_control_rx(uint16_t conn_handle, const uint8_t *data_rx, uint16_t rx_bytes_len)
 {
 	tBleStatus ret = BLE_STATUS_SUCCESS;
 
@@ -735,27 +351,48 @@ tBleStatus health_control_rx(uint8_t *data_rx, uint16_t rx_bytes_len)
 			break;
 		}
 
-		/* Internal buffer size validation */
-		const uint16_t buf_len = sizeof(health_control_data_rx);
-		if( buf_len < rx_bytes_len )
+		/* Copy exactly what was written, once, into the next RX queue slot */
+		ret = rx_queue_push(conn_handle, data_rx, rx_bytes_len);
+		if( BLE_STATUS_SUCCESS != ret )
 		{
-			LOG_WARN("health_control_rx: buffer too small (%u < %u)", buf_len, rx_bytes_len);
-			ret = BLE_STATUS_INVALID_PARAMS;
+			/* Counted in the RX queue statistics: no log at write rate */
 			break;
 		}
+	} while(false);
 
-		/* Copy exactly what was written */
-		BLUENRG_memcpy(health_control_data_rx, data_rx, rx_bytes_len);
-		g_health_control_rx_len = rx_bytes_len;
-		LOG_DEBUG("health_control_rx: received %u bytes", rx_bytes_len);
+	return ret;
+}
 
-	} while(false);
-	if(BLE_STATUS_SUCCESS != ret)
+/* Command processor, main loop context (rx_queue_process) */
+tBleStatus health_control_process(const rx_frame_t * p_frame)
+{
+	bool handled = false;
+
+	LOG_DEBUG("health_control_rx: %u bytes conn=0x%04X", p_frame->len, p_frame->conn_handle);
+
+#if ( 1 == APP_BENCH )
+	/* Benchmark start / stop, see app_bench.h */
+	handled = bench_handle_command(p_frame->data, p_frame->len);
+#endif // of ( 1 == APP_BENCH )
+	if( false == handled )
 	{
-		BLUENRG_memset(health_control_data_rx, 0, sizeof(health_control_data_rx));
-		g_health_control_rx_len = 0;
+		/* Profiling table dump / reset, see app_profile.h */
+		handled = profile_handle_command(p_frame->data, p_frame->len);
 	}
-	return ret;
+#if ( 1 == APP_SECURITY )
+	if( false == handled )
+	{
+		/* Bond database clear, see app_security.h */
+		handled = security_handle_command(p_frame->data, p_frame->len);
+	}
+#endif // of ( 1 == APP_SECURITY )
+	if( false == handled )
+	{
+		/* Controller restart (fault injection), see app_recovery.h */
+		handled = recovery_handle_command(p_frame->data, p_frame->len);
+	}
+
+	return handled ? BLE_STATUS_SUCCESS : BLE_STATUS_INVALID_PARAMS;
 }
 
 tBleStatus health_data_tx(const uint8_t * data_tx, uint16_t tx_bytes_len)
@@ -789,14 +426,14 @@ tBleStatus health_data_tx(const uint8_t * data_tx, uint16_t tx_bytes_len)
     }
 
     /* ---- PROTOCOL GUARD ---- */
-    if( INVALID_CONNECTION_HANDLE == connection_handle )
+    if( 0U == link_count() )
     {
-      LOG_WARN("health_data_tx: invalid connection handle");
+      LOG_WARN("health_data_tx: not connected");
       ret = BLE_STATUS_FAILED;
       break;
     }
 
-    if( false == notification_enabled )
+    if( false == link_any_subscribed(LINK_CCCD_DATA_TX) )
     {
       LOG_WARN("health_data_tx: notifications not enabled");
       ret = BLE_STATUS_FAILED;
@@ -811,11 +448,17 @@ tBleStatus health_data_tx(const uint8_t * data_tx, uint16_t tx_bytes_len)
      * Therefore the absolute maximum supported by the API is 255 bytes.
      *
      * Actual transmittable payload over-the-air is limited by (ATT_MTU - 3).
-     * Default ATT_MTU is 23 bytes (20-byte payload) unless MTU exchange
-     * is implemented elsewhere.
-     *
-     * This check enforces ONLY the API limit, not the negotiated ATT MTU.
+     * Default ATT_MTU is 23 bytes (20-byte payload) until the MTU exchange
+     * started in link_on_connect() completes. The controller notifies every
+     * subscribed client with the same value: the smallest ATT_MTU applies.
      */
+    if( link_get_fanout_notify_len(LINK_CCCD_DATA_TX) < tx_bytes_len )
+    {
+      LOG_WARN("health_data_tx: tx length %u exceeds ATT_MTU - 3 (%u)", tx_bytes_len, link_get_fanout_notify_len(LINK_CCCD_DATA_TX));
+      ret = BLE_STATUS_INVALID_PARAMS;
+      break;
+    }
+
     if(BLUENRG_MAX_CHAR_VALUE_UPDATE_LEN < tx_bytes_len)
     {
     	LOG_WARN("health_data_tx: tx length %u exceeds BlueNRG ATT update limit (uint8_t length, MTU-dependent)", tx_bytes_len);
@@ -825,15 +468,25 @@ tBleStatus health_data_tx(const uint8_t * data_tx, uint16_t tx_bytes_len)
     /* Actual number of bytes written to the characteristic value */
     const uint8_t Char_Value_Length = tx_bytes_len;
 
+    PROFILE_BEGIN( PROFILE_ZONE_GATT_UPDATE );
     ret = aci_gatt_update_char_value(health_service_handle, health_data_tx_char_handle, CurrentOffset, Char_Value_Length, (uint8_t *)data_tx);
+    PROFILE_END( PROFILE_ZONE_GATT_UPDATE );
+    /* Command timeouts feed the fault detection */
+    recovery_on_hci_status(ret);
 
     if( BLE_STATUS_SUCCESS != ret )
     {
-      LOG_DEBUG("aci_gatt_update_char_value: health_data_tx FAILED (%d)", ret);
+      /* Controller TX pool full: normal back-pressure, counted by the TX queue */
+      if( BLE_STATUS_INSUFFICIENT_RESOURCES != ret )
+      {
+        LOG_DEBUG("aci_gatt_update_char_value: health_data_tx FAILED (%d)", ret);
+      }
       break;
     }
 
-    LOG_DEBUG("health_data_tx: transmitted %u bytes", tx_bytes_len);
+    link_on_notified(LINK_CCCD_DATA_TX);
+    /* Per packet: compiled out unless __LOG_ENABLE_INFO__ (app_debug.h) */
+    LOG_INFO("health_data_tx: transmitted %u bytes", tx_bytes_len);
 
   } while( false );
 
@@ -924,6 +577,119 @@ tBleStatus update_humidity_data(int16_t new_data)
 	return ret;
 }
 
+/* Current sensor values */
+static bool bpm_sample(int16_t * p_value)
+{
+	*p_value = TEST_BPM_SENSOR_DATA;
+	return true;
+}
+
+static bool weight_sample(int16_t * p_value)
+{
+	*p_value = TEST_WEIGHT_SENSOR_DATA;
+	return true;
+}
+
+static bool temperature_sample(int16_t * p_value)
+{
+#if ( 1 == APP_SAMPLER )
+	/* Latest internal temperature sensor scan, test value until the first one */
+	if( sampler_get_temperature(p_value) )
+	{
+		return true;
+	}
+#endif // of ( 1 == APP_SAMPLER )
+	*p_value = TEST_TEMPERATURE_SENSOR_DATA;
+	return true;
+}
+
+static bool humidity_sample(int16_t * p_value)
+{
+	*p_value = TEST_HUMIDITY_SENSOR_DATA;
+	return true;
+}
+
+static tBleStatus bpm_read_handler(void * ctx)
+{
+	int16_t value;
+	(void)ctx;
+	(void)bpm_sample(&value);
+	return update_bpm_data(value);
+}
+
+static tBleStatus weight_read_handler(void * ctx)
+{
+	int16_t value;
+	(void)ctx;
+	(void)weight_sample(&value);
+	return update_weight_data(value);
+}
+
+static tBleStatus temperature_read_handler(void * ctx)
+{
+	int16_t value;
+	(void)ctx;
+	(void)temperature_sample(&value);
+	return update_temperature_data(value);
+}
+
+static tBleStatus humidity_read_handler(void * ctx)
+{
+	int16_t value;
+	(void)ctx;
+	(void)humidity_sample(&value);
+	return update_humidity_data(value);
+}
+
+static tBleStatus control_rx_write_handler(uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length)
+{
+	(void)ctx;
+	return health_control_rx(conn_handle, data, data_length);
+}
+
+/*
+ * CCCD write for a NOTIFY characteristic.
+ * ctx : LINK_CCCD_xx bit of that characteristic, kept per connection in the link table.
+ */
+static tBleStatus cccd_notify_write_handler(uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length)
+{
+	tBleStatus ret = BLE_STATUS_SUCCESS;
+	const uint16_t cccd_bit = (uint16_t)(uintptr_t)ctx;
+
+	do
+	{
+		if( 2U != data_length )
+		{
+			LOG_WARN("CCCD write with invalid length %u", data_length);
+			ret = BLE_STATUS_INVALID_PARAMS;
+			break;
+		}
+
+		/* CCCD write with LSB first: {0x01, 0x00} = notifications enabled */
+		if( 0U != data[1] )
+		{
+			LOG_WARN("CCCD write with invalid MSB 0x%02X", data[1]);
+			ret = BLE_STATUS_INVALID_PARAMS;
+			break;
+		}
+		/* Reject unsupported CCCD bits (only bit0 is valid for notifications) */
+		if( 0U != ( data[0] & ~0x01U ) )
+		{
+			LOG_WARN("CCCD write with unsupported bits 0x%02X", data[0]);
+			ret = BLE_STATUS_INVALID_PARAMS;
+			break;
+		}
+		const bool enabled = ( 0U != ( data[0] & 0x01U ) ) ? true : false; /* Needed during Enable / Disable */
+		link_set_cccd(conn_handle, cccd_bit, enabled);
+#if ( 1 == APP_SECURITY )
+		security_on_cccd_write(conn_handle);
+#endif // of ( 1 == APP_SECURITY )
+		LOG_DEBUG("Notify %s conn=0x%04X", enabled ? "ENABLED" : "DISABLED", conn_handle);
+	} while(false);
+
+	return ret;
+}
+
 /*
  * Connection_Handle (i.e., WHO is accessing):
  *		Scope:				Link / connection level
@@ -944,6 +710,7 @@ void Read_Request_CB(uint16_t conn_handle,
                      uint16_t offset)
 {
 	tBleStatus ret = BLE_STATUS_SUCCESS;
+	PROFILE_BEGIN( PROFILE_ZONE_READ_REQ );
 
 	do
 	{
@@ -955,55 +722,20 @@ void Read_Request_CB(uint16_t conn_handle,
 			break;
 		}
 
-		/* Decide WHAT attribute is being read
-		 *
-		 * BlueNRG attribute handle layout:
-		 *   H     : Characteristic Declaration
-		 *   H + 1 : Characteristic Value
-		 */
-		if( ( health_bpm_char_handle + 1 ) == attr_handle )
-		{
-			ret = update_bpm_data(TEST_BPM_SENSOR_DATA);
-			if(BLE_STATUS_SUCCESS != ret)
-			{
-				LOG_WARN("update_bpm_data : FAILED (%d)", ret);
-				aci_gatt_deny_read(conn_handle, BLE_STATUS_INVALID_PARAMS);
-				break;
-			}
-		}
-		else if( ( health_weight_char_handle + 1 ) == attr_handle )
+		/* Decide WHAT attribute is being read: one table lookup, whatever the
+		 * number of characteristics (see gatt_db_lookup()) */
+		const gatt_db_handle_entry_t * p_entry = gatt_db_lookup(attr_handle);
+		if( ( NULL == p_entry ) || ( GATT_DB_ATTR_VALUE != p_entry->attr ) || ( NULL == p_entry->p_char->on_read ) )
 		{
-			ret = update_weight_data(TEST_WEIGHT_SENSOR_DATA);
-			if(BLE_STATUS_SUCCESS != ret)
-			{
-				LOG_WARN("update_weight_data : FAILED (%d)", ret);
-				aci_gatt_deny_read(conn_handle, BLE_STATUS_INVALID_PARAMS);
-				break;
-			}
-		}
-		else if( ( weather_temperature_char_handle + 1 ) == attr_handle )
-		{
-			ret = update_temperature_data(TEST_TEMPERATURE_SENSOR_DATA);
-			if(BLE_STATUS_SUCCESS != ret)
-			{
-				LOG_WARN("update_temperature_data : FAILED (%d)", ret);
-				aci_gatt_deny_read(conn_handle, BLE_STATUS_INVALID_PARAMS);
-				break;
-			}
-		}
-		else if( ( weather_humidity_char_handle + 1 ) == attr_handle )
-		{
-			ret = update_humidity_data(TEST_HUMIDITY_SENSOR_DATA);
-			if(BLE_STATUS_SUCCESS != ret)
-			{
-				LOG_WARN("update_humidity_data : FAILED (%d)", ret);
-				aci_gatt_deny_read(conn_handle, BLE_STATUS_INVALID_PARAMS);
-				break;
-			}
+			LOG_WARN("Read_Request_CB : UNKNOWN ATTRIBUTE handle=0x%04X", attr_handle);
+			break;
 		}
-		else
+
+		ret = p_entry->p_char->on_read(p_entry->p_char->ctx);
+		if(BLE_STATUS_SUCCESS != ret)
 		{
-			LOG_WARN("Read_Request_CB : UNKNOWN ATTRIBUTE handle=0x%04X", attr_handle);
+			LOG_WARN("%s read : FAILED (%d)", p_entry->p_char->name, ret);
+			aci_gatt_deny_read(conn_handle, BLE_STATUS_INVALID_PARAMS);
 			break;
 		}
 
@@ -1016,8 +748,11 @@ void Read_Request_CB(uint16_t conn_handle,
 				LOG_WARN("aci_gatt_allow_read : FAILED (%d) conn=0x%04X", ret, conn_handle);
 				break;
 			}
+			/* Must fit in one connection event for the value to go out on time */
+			event_pump_mark(EVENT_PUMP_HIST_READ_REPLY);
 		}
 	}while(false);
+	PROFILE_END( PROFILE_ZONE_READ_REQ );
 }
 
 void aci_gatt_read_permit_req_event(uint16_t Connection_Handle,
@@ -1027,7 +762,7 @@ void aci_gatt_read_permit_req_event(uint16_t Connection_Handle,
 	Read_Request_CB(Connection_Handle, Attribute_Handle, Offset);
 }
 
-tBleStatus Attribute_Modify_CB(uint16_t handle, uint16_t offset, uint16_t data_length, uint8_t *att_data)
+tBleStatus Attribute_Modify_CB(uint16_t conn_handle, uint16_t handle, uint16_t offset, uint16_t data_length, uint8_t *att_data)
 {
 	tBleStatus ret = BLE_STATUS_SUCCESS;
 
@@ -1040,63 +775,45 @@ tBleStatus Attribute_Modify_CB(uint16_t handle, uint16_t offset, uint16_t data_l
 			break;
 		}
 
-		if( INVALID_CONNECTION_HANDLE == connection_handle )
+		if( false == link_is_connected(conn_handle) )
 		{
-			LOG_WARN("Attribute_Modify_CB while disconnected");
+			LOG_WARN("Attribute_Modify_CB from unknown conn=0x%04X", conn_handle);
 			ret = BLE_STATUS_FAILED;
 			break;
 		}
 
 		/*
-		 * For enabling notification the configuration data with LSB first
-		 * is { 0x01, 0x00 }, thus the handle of the attribute for data tx
-		 * is offset by two from the characteristic handle.
-		 *
 		 * Using X-CUBE-NRG2, therefore Characteristic Handle layout:
 		 *		H     : Characteristic Declaration
 		 *		H+1   : Characteristic Value
 		 *		H+2   : CCCD
 		 */
-		if( ( health_control_rx_char_handle + 1U ) == handle )
+		const gatt_db_handle_entry_t * p_entry = gatt_db_lookup(handle);
+		gatt_db_write_handler_t on_write = NULL;
+		if( NULL != p_entry )
 		{
-			ret = health_control_rx(att_data, data_length);
-			if( BLE_STATUS_SUCCESS != ret )
+			if( GATT_DB_ATTR_VALUE == p_entry->attr )
 			{
-				LOG_WARN("health_control_rx FAILED (%d)", ret);
-				break;
+				on_write = p_entry->p_char->on_write;
 			}
-		}
-		else if( ( health_data_tx_char_handle + 2U ) == handle )
-		{
-			if( 2U != data_length )
+			else if( GATT_DB_ATTR_CCCD == p_entry->attr )
 			{
-				LOG_WARN("CCCD write with invalid length %u", data_length);
-				ret = BLE_STATUS_INVALID_PARAMS;
-				break;
+				on_write = p_entry->p_char->on_cccd_write;
 			}
-
-			/* CCCD write with LSB first: {0x01, 0x00} = notifications enabled */
-			/* Add code for notify enable */
-			if( 0U != att_data[1] )
-			{
-				LOG_WARN("CCCD write with invalid MSB 0x%02X", att_data[1]);
-				ret = BLE_STATUS_INVALID_PARAMS;
-				break;
-			}
-			/* Reject unsupported CCCD bits (only bit0 is valid for notifications) */
-			if( 0U != ( att_data[0] & ~0x01U ) )
-			{
-				LOG_WARN("CCCD write with unsupported bits 0x%02X", att_data[0]);
-				ret = BLE_STATUS_INVALID_PARAMS;
-				break;
-			}
-			notification_enabled = ( 0U != ( att_data[0] & 0x01U ) ) ? true : false; /* Needed during Enable / Disable */
-			LOG_DEBUG("Notify %s", notification_enabled ? "ENABLED" : "DISABLED");
 		}
-		else
+
+		if( NULL == on_write )
 		{
 			LOG_WARN("Attribute_Modify_CB: unknown handle 0x%04X", handle);
 			ret = BLE_STATUS_FAILED;
+			break;
+		}
+
+		ret = on_write(conn_handle, p_entry->p_char->ctx, att_data, data_length);
+		if( BLE_STATUS_SUCCESS != ret )
+		{
+			LOG_WARN("%s write FAILED (%d)", p_entry->p_char->name, ret);
+			break;
 		}
 	} while(false);
 
@@ -1105,12 +822,8 @@ tBleStatus Attribute_Modify_CB(uint16_t handle, uint16_t offset, uint16_t data_l
 
 void aci_gatt_attribute_modified_event(uint16_t Connection_Handle, uint16_t Attr_Handle, uint16_t Offset, uint16_t Attr_Data_Length, uint8_t Attr_Data[])
 {
-	(void)Connection_Handle; /* handled via global connection_handle */
-
-	/* BlueNRG-2 supports a single active connection only.
-	 * Application tracks connection state via global connection_handle.
-	 */
-	tBleStatus ret = Attribute_Modify_CB(Attr_Handle, Offset, Attr_Data_Length, Attr_Data);
+	/* Per connection state (CCCD bits) is kept in the link table */
+	tBleStatus ret = Attribute_Modify_CB(Connection_Handle, Attr_Handle, Offset, Attr_Data_Length, Attr_Data);
 
 	if( BLE_STATUS_SUCCESS != ret )
 	{
@@ -1118,6 +831,12 @@ void aci_gatt_attribute_modified_event(uint16_t Connection_Handle, uint16_t Attr
 	}
 }
 
+/* Controller firmware started (after reset): commands are accepted from now on */
+void aci_blue_initialized_event(uint8_t Reason_Code)
+{
+	bluenrg_on_initialized(Reason_Code);
+}
+
 void hci_le_connection_complete_event(uint8_t Status,
                                       uint16_t Connection_Handle,
                                       uint8_t Role,
@@ -1128,26 +847,200 @@ void hci_le_connection_complete_event(uint8_t Status,
                                       uint16_t Supervision_Timeout,
                                       uint8_t Master_Clock_Accuracy)
 {
-	connection_handle = Connection_Handle;
-	notification_enabled = false;
-	LOG_DEBUG("Connected handle=0x%04X", Connection_Handle);
+	/* Advertising stops with any connection attempt, successful or not */
+	bluenrg_on_advertising_stopped();
+
+	if( BLE_STATUS_SUCCESS != Status )
+	{
+		LOG_WARN("Connection FAILED (%d)", Status);
+		adv_on_connection_complete(Status);
+		return;
+	}
+
+	adv_on_connection_complete(Status);
+	LOG_DEBUG("Connected handle=0x%04X (%lu/%u)", Connection_Handle, (unsigned long)( link_count() + 1U ), LINK_MAX_CONNECTIONS);
+	if( false == link_on_connect(Connection_Handle) )
+	{
+		/* More centrals than table entries: refuse this one (remote user terminated) */
+		(void)aci_gap_terminate(Connection_Handle, 0x13);
+		return;
+	}
+	link_on_conn_params(Connection_Handle, Conn_Interval, Conn_Latency, Supervision_Timeout);
+	conn_profile_on_connect(Connection_Handle);
+#if ( 1 == APP_SECURITY )
+	security_on_connect(Connection_Handle, Peer_Address_Type, Peer_Address);
+#endif // of ( 1 == APP_SECURITY )
+
+	/* Keep advertising (slow) while table entries are left for more centrals */
+	if( LINK_MAX_CONNECTIONS > link_count() )
+	{
+		adv_request(ADV_REASON_ROOM);
+	}
+}
+
+void hci_le_connection_update_complete_event(uint8_t Status,
+                                             uint16_t Connection_Handle,
+                                             uint16_t Conn_Interval,
+                                             uint16_t Conn_Latency,
+                                             uint16_t Supervision_Timeout)
+{
+	if( BLE_STATUS_SUCCESS != Status )
+	{
+		LOG_WARN("Connection update FAILED (%d) conn=0x%04X", Status, Connection_Handle);
+		conn_profile_on_update_resp(Connection_Handle, false);
+		return;
+	}
+	link_on_conn_params(Connection_Handle, Conn_Interval, Conn_Latency, Supervision_Timeout);
+	conn_profile_on_update_complete(Connection_Handle);
+}
+
+/* Central answer to aci_l2cap_connection_parameter_update_req (0 = accepted) */
+void aci_l2cap_connection_update_resp_event(uint16_t Connection_Handle,
+                                            uint16_t Result)
+{
+	conn_profile_on_update_resp(Connection_Handle, ( 0U == Result ) ? true : false);
+}
+
+/* No L2CAP response from the central within 30 s */
+void aci_l2cap_proc_timeout_event(uint16_t Connection_Handle,
+                                  uint8_t Data_Length,
+                                  uint8_t Data[])
+{
+	(void)Data_Length;
+	(void)Data;
+	conn_profile_on_update_resp(Connection_Handle, false);
 }
 
 void hci_disconnection_complete_event(uint8_t Status,
                                       uint16_t Connection_Handle,
                                       uint8_t Reason)
 {
-	connection_handle = INVALID_CONNECTION_HANDLE;
-	BLUENRG_memset(health_control_data_rx, 0, sizeof(health_control_data_rx));
-	g_health_control_rx_len = 0;
-	notification_enabled = false; /* Needed during disconnection */
-	/* Global / file-scope flag */
-	g_restart_adv = true;
-	LOG_DEBUG("Disconnected handle=0x%04X", Connection_Handle);
+	if( false == link_is_connected(Connection_Handle) )
+	{
+		/* Refused in hci_le_connection_complete_event() (table full) */
+		return;
+	}
+	tx_queue_on_disconnect();
+	LOG_DEBUG("Disconnected handle=0x%04X reason=0x%02X", Connection_Handle, Reason);
+	link_print_info(Connection_Handle);
+	conn_profile_on_disconnect(Connection_Handle);
+#if ( 1 == APP_SECURITY )
+	security_on_disconnect(Connection_Handle);
+#endif // of ( 1 == APP_SECURITY )
+	/* Drops the CCCD bits of this client (a bonded one gets them back from the bond store) */
+	link_on_disconnect(Connection_Handle);
+	/* Fast advertising burst to get the central back */
+	adv_request(ADV_REASON_DISCONNECT);
+#if ( 1 == APP_BENCH )
+	bench_on_disconnect();
+#endif // of ( 1 == APP_BENCH )
+	if( 0U != link_count() )
+	{
+		/* Other centrals still connected: keep the statistics running */
+		return;
+	}
+	/* About 25 lines, more than LOG_SLOT_COUNT: wait for the UART instead of
+	 * dropping them. No central is connected, only advertising waits. */
+	log_bulk_begin();
+	event_pump_print_stats();
+	tx_queue_print_stats();
+	rx_queue_print_stats();
+	adv_print_stats();
+	recovery_print_stats();
+#if ( 1 == APP_READ_CACHE )
+	read_cache_print_stats();
+#endif // of ( 1 == APP_READ_CACHE )
+#if ( 1 == APP_SAMPLER )
+	sampler_print_stats();
+#endif // of ( 1 == APP_SAMPLER )
+#if ( 1 == APP_SECURITY )
+	security_print_stats();
+#endif // of ( 1 == APP_SECURITY )
+	log_print_stats();
+	profile_print_stats();
+	log_bulk_end();
+}
+
+#if ( 1 == APP_SECURITY )
+void aci_gap_pairing_complete_event(uint16_t Connection_Handle,
+                                    uint8_t Status,
+                                    uint8_t Reason)
+{
+	security_on_pairing_complete(Connection_Handle, Status, Reason);
+}
+
+void hci_encryption_change_event(uint8_t Status,
+                                 uint16_t Connection_Handle,
+                                 uint8_t Encryption_Enabled)
+{
+	security_on_encryption_change(Connection_Handle, Status, ( 0U != Encryption_Enabled ) ? true : false);
+}
+
+/* Bonded central asked to pair again: it lost its keys */
+void aci_gap_bond_lost_event(void)
+{
+	security_on_bond_lost();
+}
+#endif // of ( 1 == APP_SECURITY )
+
+void hci_le_read_remote_used_features_complete_event(uint8_t Status,
+                                                     uint16_t Connection_Handle,
+                                                     uint8_t LE_Features[8])
+{
+	if( BLE_STATUS_SUCCESS != Status )
+	{
+		LOG_WARN("Read remote features FAILED (%d) conn=0x%04X", Status, Connection_Handle);
+		return;
+	}
+	link_on_remote_features(Connection_Handle, LE_Features);
+}
+
+void hci_le_data_length_change_event(uint16_t Connection_Handle,
+                                     uint16_t MaxTxOctets,
+                                     uint16_t MaxTxTime,
+                                     uint16_t MaxRxOctets,
+                                     uint16_t MaxRxTime)
+{
+	link_on_data_length(Connection_Handle, MaxTxOctets, MaxTxTime, MaxRxOctets, MaxRxTime);
+}
+
+void hci_le_phy_update_complete_event(uint8_t Status,
+                                      uint16_t Connection_Handle,
+                                      uint8_t TX_PHY,
+                                      uint8_t RX_PHY)
+{
+	if( BLE_STATUS_SUCCESS != Status )
+	{
+		LOG_WARN("PHY update FAILED (%d) conn=0x%04X", Status, Connection_Handle);
+		return;
+	}
+	link_on_phy(Connection_Handle, TX_PHY, RX_PHY);
+}
+
+/* ATT_MTU agreed with the client, whichever side started the exchange */
+void aci_att_exchange_mtu_resp_event(uint16_t Connection_Handle,
+                                     uint16_t Server_RX_MTU)
+{
+	link_on_att_mtu(Connection_Handle, Server_RX_MTU);
+}
+
+/* Controller freed TX buffers: let the notification queue (and a blocked benchmark) resume */
+void aci_gatt_tx_pool_available_event(uint16_t Connection_Handle,
+                                      uint16_t Available_Buffers)
+{
+	(void)Connection_Handle;
+	(void)Available_Buffers;
+	tx_queue_on_pool_available();
+#if ( 1 == APP_BENCH )
+	bench_on_pool_available();
+#endif // of ( 1 == APP_BENCH )
 }
 
 void App_UserEvtRx(void *pData)
 {
+	event_pump_evt_begin();
+	PROFILE_BEGIN( PROFILE_ZONE_USER_EVT_RX );
+
 	do
 	{
 		if( NULL == pData )
@@ -1182,7 +1075,7 @@ void App_UserEvtRx(void *pData)
 				{
 			    /* NOTE:
 			     *   - Do NOT log here
-			     *   - Do NOT update connection_handle here
+			     *   - Do NOT update the link table here
 			     *   - Ownership is with hci_le_connection_complete_event()
 			     */
 			    /* Validate connection-complete payload length. */
@@ -1192,21 +1085,11 @@ void App_UserEvtRx(void *pData)
 						LOG_WARN("LE Conn Complete with invalid length %u", event_pckt->plen);
 						break;
 			    }
-					// #NOTE: connection_handle is set inside hci_le_connection_complete_event
+					// #NOTE: the link table entry is taken inside hci_le_connection_complete_event
 					// #NOTE: cast evt->data using (evt_le_connection_complete *) to get connection complete data structure values.
 				}
-        /* Process each meta data event */
-  			const int MaxItemsInMetaEvtTable = sizeof(hci_le_meta_events_table) / sizeof(hci_le_meta_events_table_type);
-  			uint32_t i;
-  			for(i = 0; MaxItemsInMetaEvtTable > i; i++)
-  			{
-  				if(evt->subevent == hci_le_meta_events_table[i].evt_code)
-  				{
-  					hci_le_meta_events_table[i].process((void *)evt->data);
-  					handled = true;
-  					break;
-  				}
-  			}
+        /* Process each meta data event (direct index, see app_hci_dispatch.c) */
+  			handled = hci_dispatch_le_meta(evt->subevent, (void *)evt->data);
   			if(false == handled)
   			{
   			    LOG_WARN("Unhandled LE Meta subevent=0x%02X", evt->subevent);
@@ -1219,17 +1102,7 @@ void App_UserEvtRx(void *pData)
     		/* Get Event Vendor */
     		evt_blue_aci *blue_evt = (evt_blue_aci *)event_pckt->data;
         /* Process each Event Vendor event */
-  			const int MaxItemsInVendorSpecificEvtTable = sizeof(hci_vendor_specific_events_table) / sizeof(hci_vendor_specific_events_table_type);
-  			uint32_t i;
-  			for(i = 0; MaxItemsInVendorSpecificEvtTable > i; i++)
-  			{
-  				if(blue_evt->ecode == hci_vendor_specific_events_table[i].evt_code)
-  				{
-  					hci_vendor_specific_events_table[i].process((void *)blue_evt->data);
-  					handled = true;
-  					break;
-  				}
-  				}
+  			handled = hci_dispatch_vendor(blue_evt->ecode, (void *)blue_evt->data);
   			if(false == handled)
 				{
   				LOG_WARN("Unhandled Vendor event ecode=0x%04X", blue_evt->ecode);
@@ -1238,18 +1111,7 @@ void App_UserEvtRx(void *pData)
     	}
     	default:
     	{
-    		bool handled = false;
-  			const int MaxItemsInEventsTable = sizeof(hci_events_table) / sizeof(hci_events_table_type);
-  			uint32_t i;
-  			for(i = 0; MaxItemsInEventsTable > i; i++)
-  			{
-  				if(event_pckt->evt == hci_events_table[i].evt_code)
-  				{
-  					hci_events_table[i].process((void *)event_pckt->data);
-  					handled = true;
-  					break;
-  				}
-  			}
+    		bool handled = hci_dispatch_event(event_pckt->evt, (void *)event_pckt->data);
   			if(false == handled)
   			{
   				LOG_WARN("Unhandled HCI event evt=0x%02X", event_pckt->evt);
@@ -1258,6 +1120,7 @@ void App_UserEvtRx(void *pData)
     	}
     }
 	}while( false );
+	PROFILE_END( PROFILE_ZONE_USER_EVT_RX );
 }
 
 static uint32_t g_last_btn_tick = (uint32_t)(0);
@@ -1268,7 +1131,7 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 	{
 		if ( B1_Pin == GPIO_Pin )
 		{
-			uint32_t now = HAL_GetTick();
+			uint32_t now = app_port_tick_ms();
 
 			#define BUTTON_DEBOUNCE_MS		( 100 )
 			/* Debounce check */
@@ -0,0 +1,141 @@
+/*
+ * app_tx_queue.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Health data TX notification queue.
+ *
+ * Fixed capacity single-producer / single-consumer ring of buffer references:
+ *   - Producer : tx_queue_push(), from ONE context (main loop or one ISR).
+ *   - Consumer : tx_queue_pump(), main loop only.
+ *
+ * Zero copy: only the pointer and length are queued. The buffer must stay
+ * valid and unchanged until the notification is sent (static or pool owned).
+ *
+ * When the controller runs out of TX buffers, aci_gatt_update_char_value()
+ * returns BLE_STATUS_INSUFFICIENT_RESOURCES. The head entry is kept and the
+ * pump stops until aci_gatt_tx_pool_available_event() reopens it.
+ */
+
+#include "app_includes.h"
+
+typedef char STATIC_ASSERT_tx_queue_depth_pow2[ ( 0U == ( TX_QUEUE_DEPTH & ( TX_QUEUE_DEPTH - 1U ) ) ) ? 1 : -1 ];
+
+typedef struct
+{
+	const uint8_t * data;
+	uint16_t len;
+} tx_desc_t;
+
+static tx_desc_t g_tx_ring[TX_QUEUE_DEPTH];
+
+/* Free running indexes: head written by the producer only, tail by the consumer only */
+static volatile uint32_t g_tx_head = 0;
+static volatile uint32_t g_tx_tail = 0;
+
+/* Set when the controller has no TX buffer left */
+static volatile bool g_tx_blocked = false;
+
+static tx_queue_stats_t g_tx_stats;
+
+extern tBleStatus health_data_tx(const uint8_t * data_tx, uint16_t tx_bytes_len);
+
+tBleStatus tx_queue_push( const uint8_t * data, uint16_t len )
+{
+	const uint32_t head = g_tx_head;
+
+	if( TX_QUEUE_DEPTH <= ( head - g_tx_tail ) )
+	{
+		g_tx_stats.dropped_full++;
+		return BLE_STATUS_INSUFFICIENT_RESOURCES;
+	}
+
+	g_tx_ring[head & ( TX_QUEUE_DEPTH - 1U )].data = data;
+	g_tx_ring[head & ( TX_QUEUE_DEPTH - 1U )].len = len;
+	/* Descriptor must be visible before the consumer sees the new head */
+	__DMB();
+	g_tx_head = head + 1U;
+	g_tx_stats.enqueued++;
+
+	return BLE_STATUS_SUCCESS;
+}
+
+/* Send as many queued notifications as the controller accepts */
+void tx_queue_pump( void )
+{
+	uint32_t tail = g_tx_tail;
+
+	while( ( tail != g_tx_head ) && ( false == g_tx_blocked ) )
+	{
+		/* Descriptor read after the head was observed */
+		__DMB();
+		const tx_desc_t * p_desc = &g_tx_ring[tail & ( TX_QUEUE_DEPTH - 1U )];
+
+		tBleStatus ret = health_data_tx( p_desc->data, p_desc->len );
+		if( BLE_STATUS_INSUFFICIENT_RESOURCES == ret )
+		{
+			/* Keep the entry, resume on aci_gatt_tx_pool_available_event() */
+			g_tx_blocked = true;
+			g_tx_stats.retried++;
+			break;
+		}
+
+		if( BLE_STATUS_SUCCESS == ret )
+		{
+			g_tx_stats.sent++;
+		}
+		else
+		{
+			/* Not connected, notifications disabled or invalid length: retrying cannot help */
+			g_tx_stats.dropped_tx++;
+		}
+
+		/* Slot is free for the producer only after the descriptor has been used */
+		__DMB();
+		tail++;
+		g_tx_tail = tail;
+	}
+}
+
+/* True when tx_queue_pump() has work it can do right now */
+bool tx_queue_is_ready( void )
+{
+	return ( g_tx_tail != g_tx_head ) && ( false == g_tx_blocked );
+}
+
+/* Entries waiting to be sent */
+uint32_t tx_queue_depth( void )
+{
+	return g_tx_head - g_tx_tail;
+}
+
+void tx_queue_on_pool_available( void )
+{
+	g_tx_blocked = false;
+}
+
+void tx_queue_on_disconnect( void )
+{
+	/* The controller released its buffers with the link */
+	g_tx_blocked = false;
+}
+
+void tx_queue_get_stats( tx_queue_stats_t * p_stats )
+{
+	if( NULL != p_stats )
+	{
+		*p_stats = g_tx_stats;
+	}
+}
+
+void tx_queue_print_stats( void )
+{
+	LOG_DEBUG("TX queue : enqueued=%lu sent=%lu retried=%lu dropped=%lu (full=%lu tx=%lu)",
+	          (unsigned long)g_tx_stats.enqueued,
+	          (unsigned long)g_tx_stats.sent,
+	          (unsigned long)g_tx_stats.retried,
+	          (unsigned long)( g_tx_stats.dropped_full + g_tx_stats.dropped_tx ),
+	          (unsigned long)g_tx_stats.dropped_full,
+	          (unsigned long)g_tx_stats.dropped_tx);
+}
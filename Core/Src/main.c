@@ -46,6 +46,12 @@ UART_HandleTypeDef huart2;
 
 volatile bool g_btn_event = false;   /* One clean event */
 
+DMA_HandleTypeDef hdma_usart2_tx;
+
+ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+TIM_HandleTypeDef htim3;
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -91,6 +97,8 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+	/* Reference of the boot timeline (app_boot.c) */
+	boot_timeline_start();
 
   /* USER CODE END SysInit */
 
@@ -99,25 +107,32 @@ int main(void)
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
 
+	/* LOG_xxx output is queued and sent by DMA from here on */
+	log_init(&huart2);
 	LOG_DEBUG("Serial port initialised...");
+	boot_mark( BOOT_PHASE_PERIPHERALS );
 
-	HAL_GPIO_WritePin(BLE_RESET_GPIO_Port, BLE_RESET_Pin, GPIO_PIN_RESET );
-	HAL_Delay(20);
-	HAL_GPIO_WritePin(BLE_RESET_GPIO_Port, BLE_RESET_Pin, GPIO_PIN_SET );
-	HAL_Delay(50);
+	/* BlueNRG reset pulse and readiness wait: hci_init() / bluenrg_init() */
 
   /* Enable BLE Mode */
   tBleStatus ret = BLE_STATUS_SUCCESS;
   if( BLE_STATUS_SUCCESS != ( ret = bluenrg_init() ) )
   {
-  	LED_Report8BitError( ret );
+  	/* Reset and set up again by recovery_poll(), which then starts advertising */
+  	LOG_WARN("bluenrg_init FAILED (%d)", ret);
+  	recovery_report( RECOVERY_CAUSE_INIT );
+  }
+  else
+  {
+		/* Fast burst first, started by adv_poll() */
+		adv_request( ADV_REASON_BOOT );
   }
-	if( BLE_STATUS_SUCCESS != ( ret = bluenrg_start_advertising() ) )
-	{
-		LED_Report8BitError( ret );
-	}
 
-	uint32_t u32LastBleTick = HAL_GetTick();
+#if ( 1 == APP_SAMPLER )
+	/* Sensors : TIM3 paced ADC1 scans */
+	sampler_init();
+	sampler_start();
+#endif /* ( 1 == APP_SAMPLER ) */
 
   /* USER CODE END 2 */
 
@@ -128,44 +143,68 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-  	/* Pump BLE stack at least every 100 ms */
-  	const uint32_t u32Now = HAL_GetTick();
-    if (100U <= (u32Now - u32LastBleTick))
-		{
-      u32LastBleTick = u32Now;
-			/* Keep BLE event processing alive. Do not exit delay based on the function's return value. */
-			/* Transport / Pump */
-			(void)hci_user_evt_proc();
-		}
-		/* Global / file-scope flag */
-		if(g_restart_adv)
+		/* Controller fault : nothing else may talk to the BlueNRG until the
+		 * restart succeeds. Spins between retries, the outage is short. */
+		if( false == recovery_poll() )
 		{
-			g_restart_adv = false;
-
-			if(INVALID_CONNECTION_HANDLE == connection_handle)
-			{
-				tBleStatus ret = bluenrg_start_advertising();
-				if(BLE_STATUS_SUCCESS != ret)
-				{
-					LOG_WARN("Restart advertising failed (%d)", ret);
-				}
-			}
+			continue;
 		}
+		/* Transport / Pump : drain every event queued by the BlueNRG IRQ */
+		event_pump_run();
+		/* Control RX : run the commands queued by the event callbacks */
+		rx_queue_process();
+#if ( 1 == APP_SAMPLER )
+		/* Sensors : pack sampled values into notification frames */
+		sampler_poll();
+#endif /* ( 1 == APP_SAMPLER ) */
+#if ( 1 == APP_READ_CACHE )
+		/* Read characteristics : publish values that changed */
+		read_cache_poll();
+#endif /* ( 1 == APP_READ_CACHE ) */
+		/* Notifications : send what the controller can take */
+		tx_queue_pump();
+#if ( 1 == APP_BENCH )
+		/* Benchmark : stream while a run is active */
+		bench_run();
+#endif /* ( 1 == APP_BENCH ) */
+		/* Connection parameters : follow the TX backlog */
+		conn_profile_poll();
+#if ( 1 == APP_SECURITY )
+		/* Bonds : flash copy of a new bond (the sector erase, up to 2 s with
+		 * interrupts stalled, waits for no central connected: security_poll()) */
+		security_poll();
+#endif /* ( 1 == APP_SECURITY ) */
+
+		/* Advertising : start / step down the burst while the link table has room */
+		adv_poll();
 		/* Get Button state */
 		if(g_btn_event)
 		{
 			g_btn_event = false;
-			if( ( INVALID_CONNECTION_HANDLE != connection_handle ) && notification_enabled )
+			if( link_any_subscribed(LINK_CCCD_DATA_TX) )
 			{
-				extern tBleStatus health_data_tx(const uint8_t * data_tx, uint8_t tx_bytes_len);
-				const uint8_t tx_health_data[] = { 'h', 'l', 'g' };
-				tBleStatus ret = health_data_tx(tx_health_data, sizeof(tx_health_data));
+				/* Queued by reference: must outlive the transmission. Own frame
+				 * version, so the central does not parse it as sampler data */
+				static const uint8_t tx_health_data[] = { SAMPLER_FRAME_EVENT_BUTTON, 'h', 'l', 'g' };
+				tBleStatus ret = tx_queue_push(tx_health_data, sizeof(tx_health_data));
 				if(BLE_STATUS_SUCCESS != ret)
 				{
-					LOG_DEBUG("health_data_tx skipped (%d)", ret);
+					LOG_DEBUG("tx_queue_push dropped (%d)", ret);
 				}
 			}
 		}
+		/* Sleep until the next interrupt. IRQs are masked around the check so
+		 * an event raised between the test and WFI still wakes the core. */
+		__disable_irq();
+		if( !event_pump_is_pending() && !rx_queue_is_ready() && !tx_queue_is_ready() && !adv_is_ready() && !g_btn_event
+#if ( 1 == APP_BENCH )
+				&& !bench_is_ready()
+#endif /* ( 1 == APP_BENCH ) */
+			)
+		{
+			__WFI();
+		}
+		__enable_irq();
   }
   /* USER CODE END 3 */
 }
@@ -338,7 +377,7 @@ static void MX_GPIO_Init(void)
   HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
 
   /* EXTI interrupt init*/
-  HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(EXTI0_IRQn, 2, 0);
   HAL_NVIC_EnableIRQ(EXTI0_IRQn);
 
   HAL_NVIC_SetPriority(EXTI15_10_IRQn, 0, 0);
@@ -39,6 +39,10 @@ __weak HAL_StatusTypeDef MX_SPI1_Init(SPI_HandleTypeDef* hspi);
   */
 
 SPI_HandleTypeDef hspi1;
+#if (USE_BSP_SPI1_DMA == 1U)
+DMA_HandleTypeDef hdma_spi1_rx;
+DMA_HandleTypeDef hdma_spi1_tx;
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 /**
   * @}
   */
@@ -51,6 +55,9 @@ SPI_HandleTypeDef hspi1;
 static uint32_t IsSPI1MspCbValid = 0;
 #endif /* USE_HAL_SPI_REGISTER_CALLBACKS */
 static uint32_t SPI1InitCounter = 0;
+#if (USE_BSP_SPI1_DMA == 1U)
+static volatile BSP_SPI_XferCpltCb_t SPI1XferCpltCb = NULL;
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
 
 /**
   * @}
@@ -198,6 +205,86 @@ int32_t BSP_SPI1_SendRecv(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length)
   return ret;
 }
 
+#if (USE_BSP_SPI1_DMA == 1U)
+/**
+  * @brief  Start a full duplex DMA transfer to/from SPI BUS
+  * @note   The function returns as soon as the transfer is started.
+  *         XferCpltCb is invoked from the DMA interrupt with the final
+  *         BSP status once all Length bytes have been exchanged.
+  * @param  pTxData: Pointer to data buffer to send (must stay valid until completion)
+  * @param  pRxData: Pointer to data buffer to receive (must stay valid until completion)
+  * @param  Length: Length of data in byte
+  * @param  XferCpltCb: Completion callback
+  * @retval BSP status
+  */
+int32_t BSP_SPI1_SendRecv_DMA(uint8_t *pTxData, uint8_t *pRxData, uint16_t Length, BSP_SPI_XferCpltCb_t XferCpltCb)
+{
+  int32_t ret = BSP_ERROR_NONE;
+
+  if((XferCpltCb == NULL) || (Length == 0U))
+  {
+    return BSP_ERROR_WRONG_PARAM;
+  }
+
+  SPI1XferCpltCb = XferCpltCb;
+  if(HAL_SPI_TransmitReceive_DMA(&hspi1, pTxData, pRxData, Length) != HAL_OK)
+  {
+    SPI1XferCpltCb = NULL;
+    ret = BSP_ERROR_BUSY;
+  }
+  return ret;
+}
+
+/**
+  * @brief  Abort an ongoing DMA transfer on SPI BUS
+  * @note   The completion callback of the aborted transfer is not invoked.
+  * @retval BSP status
+  */
+int32_t BSP_SPI1_AbortDMA(void)
+{
+  int32_t ret = BSP_ERROR_NONE;
+
+  SPI1XferCpltCb = NULL;
+  if(HAL_SPI_Abort(&hspi1) != HAL_OK)
+  {
+    ret = BSP_ERROR_PERIPH_FAILURE;
+  }
+  return ret;
+}
+
+/**
+  * @brief  SPI full duplex DMA transfer completed
+  * @param  hspi: SPI handle
+  * @retval None
+  */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  BSP_SPI_XferCpltCb_t cb = SPI1XferCpltCb;
+
+  if((hspi->Instance == SPI1) && (cb != NULL))
+  {
+    SPI1XferCpltCb = NULL;
+    cb(BSP_ERROR_NONE);
+  }
+}
+
+/**
+  * @brief  SPI DMA transfer error
+  * @param  hspi: SPI handle
+  * @retval None
+  */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  BSP_SPI_XferCpltCb_t cb = SPI1XferCpltCb;
+
+  if((hspi->Instance == SPI1) && (cb != NULL))
+  {
+    SPI1XferCpltCb = NULL;
+    cb(BSP_ERROR_PERIPH_FAILURE);
+  }
+}
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
+
 #if (USE_HAL_SPI_REGISTER_CALLBACKS == 1U)
 /**
   * @brief Register Default BSP SPI1 Bus Msp Callbacks
@@ -324,7 +411,48 @@ static void SPI1_MspInit(SPI_HandleTypeDef* spiHandle)
     HAL_GPIO_Init(BUS_SPI1_SCK_GPIO_PORT, &GPIO_InitStruct);
 
   /* USER CODE BEGIN SPI1_MspInit 1 */
+#if (USE_BSP_SPI1_DMA == 1U)
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    /* SPI1_RX Init: DMA2 Stream0 Channel3 */
+    hdma_spi1_rx.Instance = DMA2_Stream0;
+    hdma_spi1_rx.Init.Channel = DMA_CHANNEL_3;
+    hdma_spi1_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_spi1_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_spi1_rx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_spi1_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_spi1_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_spi1_rx.Init.Mode = DMA_NORMAL;
+    hdma_spi1_rx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_spi1_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_spi1_rx) == HAL_OK)
+    {
+      __HAL_LINKDMA(spiHandle, hdmarx, hdma_spi1_rx);
+    }
+
+    /* SPI1_TX Init: DMA2 Stream3 Channel3 */
+    hdma_spi1_tx.Instance = DMA2_Stream3;
+    hdma_spi1_tx.Init.Channel = DMA_CHANNEL_3;
+    hdma_spi1_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma_spi1_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_spi1_tx.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_spi1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma_spi1_tx.Init.Mode = DMA_NORMAL;
+    hdma_spi1_tx.Init.Priority = DMA_PRIORITY_HIGH;
+    hdma_spi1_tx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&hdma_spi1_tx) == HAL_OK)
+    {
+      __HAL_LINKDMA(spiHandle, hdmatx, hdma_spi1_tx);
+    }
 
+    /* DMA interrupts must be able to pre-empt the BlueNRG EXTI handler,
+     * which may be waiting for the transfer to complete */
+    HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, BUS_SPI1_DMA_IT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+    HAL_NVIC_SetPriority(DMA2_Stream3_IRQn, BUS_SPI1_DMA_IT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA2_Stream3_IRQn);
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
   /* USER CODE END SPI1_MspInit 1 */
 }
 
@@ -348,7 +476,12 @@ static void SPI1_MspDeInit(SPI_HandleTypeDef* spiHandle)
     HAL_GPIO_DeInit(BUS_SPI1_SCK_GPIO_PORT, BUS_SPI1_SCK_GPIO_PIN);
 
   /* USER CODE BEGIN SPI1_MspDeInit 1 */
-
+#if (USE_BSP_SPI1_DMA == 1U)
+    HAL_NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+    HAL_NVIC_DisableIRQ(DMA2_Stream3_IRQn);
+    HAL_DMA_DeInit(spiHandle->hdmarx);
+    HAL_DMA_DeInit(spiHandle->hdmatx);
+#endif /* (USE_BSP_SPI1_DMA == 1U) */
   /* USER CODE END SPI1_MspDeInit 1 */
 }
 
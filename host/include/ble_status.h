@@ -0,0 +1,36 @@
+/*
+ * ble_status.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the status
+ * codes returned by the simulated controller (host/sim).
+ */
+
+#ifndef BLE_STATUS_H__
+#define BLE_STATUS_H__
+
+#include <stdint.h>
+
+typedef uint8_t tBleStatus;
+
+#define BLE_STATUS_SUCCESS								( (tBleStatus)( 0x00 ) )
+#define BLE_STATUS_UNKNOWN_CONNECTION_ID	( (tBleStatus)( 0x02 ) )
+#define BLE_STATUS_FAILED									( (tBleStatus)( 0x41 ) )
+#define BLE_STATUS_INVALID_PARAMS					( (tBleStatus)( 0x42 ) )
+#define BLE_STATUS_BUSY										( (tBleStatus)( 0x43 ) )
+#define BLE_STATUS_PENDING								( (tBleStatus)( 0x45 ) )
+#define BLE_STATUS_NOT_ALLOWED						( (tBleStatus)( 0x46 ) )
+#define BLE_STATUS_ERROR									( (tBleStatus)( 0x47 ) )
+#define BLE_STATUS_OUT_OF_MEMORY					( (tBleStatus)( 0x48 ) )
+#define BLE_STATUS_DEV_NOT_FOUND_IN_DB		( (tBleStatus)( 0x5C ) )
+#define BLE_STATUS_SEC_DB_FULL						( (tBleStatus)( 0x5D ) )
+#define BLE_STATUS_INVALID_HANDLE					( (tBleStatus)( 0x60 ) )
+#define BLE_STATUS_OUT_OF_HANDLE					( (tBleStatus)( 0x62 ) )
+#define BLE_STATUS_INSUFFICIENT_RESOURCES	( (tBleStatus)( 0x64 ) )
+#define BLE_INSUFFICIENT_ENC_KEYSIZE			( (tBleStatus)( 0x65 ) )
+#define BLE_STATUS_NULL_PARAM							( (tBleStatus)( 0x92 ) )
+#define BLE_STATUS_TIMEOUT								( (tBleStatus)( 0xFF ) )
+
+#endif /* BLE_STATUS_H__ */
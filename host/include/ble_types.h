@@ -0,0 +1,18 @@
+/*
+ * ble_types.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name.
+ */
+
+#ifndef BLE_TYPES_H__
+#define BLE_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PACKED( x )				x __attribute__(( packed ))
+
+#endif /* BLE_TYPES_H__ */
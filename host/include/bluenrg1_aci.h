@@ -0,0 +1,20 @@
+/*
+ * bluenrg1_aci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name.
+ */
+
+#ifndef BLUENRG1_ACI_H__
+#define BLUENRG1_ACI_H__
+
+#include "bluenrg1_gap_aci.h"
+#include "bluenrg1_gatt_aci.h"
+#include "bluenrg1_hal_aci.h"
+#include "bluenrg1_l2cap_aci.h"
+#include "link_layer.h"
+#include "bluenrg1_events.h"
+
+#endif /* BLUENRG1_ACI_H__ */
@@ -0,0 +1,89 @@
+/*
+ * bluenrg1_events.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the event
+ * tables walked by app_hci_dispatch.c and the event callbacks. As in the
+ * middleware, every callback has a weak default (host/sim/sim_events.c) that
+ * the application overrides.
+ */
+
+#ifndef BLUENRG1_EVENTS_H__
+#define BLUENRG1_EVENTS_H__
+
+#include "ble_types.h"
+
+typedef struct
+{
+	uint16_t evt_code;
+	void ( * process )( uint8_t * buffer_in );
+} hci_events_table_type;
+
+typedef struct
+{
+	uint16_t evt_code;
+	void ( * process )( uint8_t * buffer_in );
+} hci_le_meta_events_table_type;
+
+typedef struct
+{
+	uint16_t evt_code;
+	void ( * process )( uint8_t * buffer_in );
+} hci_vendor_specific_events_table_type;
+
+/* Sizes of the host/sim/sim_hci.c tables; test_hci_dispatch.c brings its own */
+#ifndef HCI_EVENTS_TABLE_SIZE
+#define HCI_EVENTS_TABLE_SIZE										( 2 )
+#define HCI_LE_META_EVENTS_TABLE_SIZE						( 5 )
+#define HCI_VENDOR_SPECIFIC_EVENTS_TABLE_SIZE		( 9 )
+#endif
+
+extern const hci_events_table_type hci_events_table[HCI_EVENTS_TABLE_SIZE];
+extern const hci_le_meta_events_table_type hci_le_meta_events_table[HCI_LE_META_EVENTS_TABLE_SIZE];
+extern const hci_vendor_specific_events_table_type hci_vendor_specific_events_table[HCI_VENDOR_SPECIFIC_EVENTS_TABLE_SIZE];
+
+/* HCI events */
+void hci_disconnection_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t Reason );
+void hci_encryption_change_event( uint8_t Status, uint16_t Connection_Handle, uint8_t Encryption_Enabled );
+
+/* LE meta events */
+void hci_le_connection_complete_event( uint8_t Status,
+                                       uint16_t Connection_Handle,
+                                       uint8_t Role,
+                                       uint8_t Peer_Address_Type,
+                                       uint8_t Peer_Address[6],
+                                       uint16_t Conn_Interval,
+                                       uint16_t Conn_Latency,
+                                       uint16_t Supervision_Timeout,
+                                       uint8_t Master_Clock_Accuracy );
+void hci_le_connection_update_complete_event( uint8_t Status,
+                                              uint16_t Connection_Handle,
+                                              uint16_t Conn_Interval,
+                                              uint16_t Conn_Latency,
+                                              uint16_t Supervision_Timeout );
+void hci_le_read_remote_used_features_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t LE_Features[8] );
+void hci_le_data_length_change_event( uint16_t Connection_Handle,
+                                      uint16_t MaxTxOctets,
+                                      uint16_t MaxTxTime,
+                                      uint16_t MaxRxOctets,
+                                      uint16_t MaxRxTime );
+void hci_le_phy_update_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t TX_PHY, uint8_t RX_PHY );
+
+/* Vendor events */
+void aci_blue_initialized_event( uint8_t Reason_Code );
+void aci_gap_pairing_complete_event( uint16_t Connection_Handle, uint8_t Status, uint8_t Reason );
+void aci_gap_bond_lost_event( void );
+void aci_l2cap_connection_update_resp_event( uint16_t Connection_Handle, uint16_t Result );
+void aci_l2cap_proc_timeout_event( uint16_t Connection_Handle, uint8_t Data_Length, uint8_t Data[] );
+void aci_gatt_attribute_modified_event( uint16_t Connection_Handle,
+                                        uint16_t Attr_Handle,
+                                        uint16_t Offset,
+                                        uint16_t Attr_Data_Length,
+                                        uint8_t Attr_Data[] );
+void aci_att_exchange_mtu_resp_event( uint16_t Connection_Handle, uint16_t Server_RX_MTU );
+void aci_gatt_read_permit_req_event( uint16_t Connection_Handle, uint16_t Attribute_Handle, uint16_t Offset );
+void aci_gatt_tx_pool_available_event( uint16_t Connection_Handle, uint16_t Available_Buffers );
+
+#endif /* BLUENRG1_EVENTS_H__ */
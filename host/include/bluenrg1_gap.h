@@ -0,0 +1,45 @@
+/*
+ * bluenrg1_gap.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: GAP
+ * roles, AD types and pairing parameters.
+ */
+
+#ifndef BLUENRG1_GAP_H__
+#define BLUENRG1_GAP_H__
+
+#define GAP_PERIPHERAL_ROLE							( 0x01 )
+
+#define PRIVACY_DISABLED								( 0x00 )
+#define DEVICE_NAME_LEN									( 7 )
+
+#define AD_TYPE_FLAGS										( 0x01 )
+#define AD_TYPE_COMPLETE_LOCAL_NAME			( 0x09 )
+
+#define NO_BONDING											( 0x00 )
+#define BONDING													( 0x01 )
+#define MITM_PROTECTION_NOT_REQUIRED		( 0x00 )
+#define MITM_PROTECTION_REQUIRED				( 0x01 )
+#define SC_IS_NOT_SUPPORTED							( 0x00 )
+#define SC_IS_SUPPORTED									( 0x01 )
+#define SC_IS_MANDATORY									( 0x02 )
+#define KEYPRESS_IS_NOT_SUPPORTED				( 0x00 )
+#define KEYPRESS_IS_SUPPORTED						( 0x01 )
+#define USE_FIXED_PIN_FOR_PAIRING				( 0x00 )
+#define DONOT_USE_FIXED_PIN_FOR_PAIRING	( 0x01 )
+
+#define IO_CAP_DISPLAY_ONLY							( 0x00 )
+#define IO_CAP_NO_INPUT_NO_OUTPUT				( 0x03 )
+
+#define MIN_ENCRY_KEY_SIZE							( 7 )
+#define MAX_ENCRY_KEY_SIZE							( 16 )
+
+/* aci_gap_pairing_complete_event() Status */
+#define SM_PAIRING_SUCCESS							( 0x00 )
+#define SM_PAIRING_TIMEOUT							( 0x01 )
+#define SM_PAIRING_FAILED								( 0x02 )
+
+#endif /* BLUENRG1_GAP_H__ */
@@ -0,0 +1,57 @@
+/*
+ * bluenrg1_gap_aci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the GAP
+ * commands used by the application, same prototypes as the middleware.
+ */
+
+#ifndef BLUENRG1_GAP_ACI_H__
+#define BLUENRG1_GAP_ACI_H__
+
+#include "ble_status.h"
+#include "bluenrg1_types.h"
+
+tBleStatus aci_gap_set_non_discoverable( void );
+tBleStatus aci_gap_set_discoverable( uint8_t Advertising_Type,
+                                     uint16_t Advertising_Interval_Min,
+                                     uint16_t Advertising_Interval_Max,
+                                     uint8_t Own_Address_Type,
+                                     uint8_t Advertising_Filter_Policy,
+                                     uint8_t Local_Name_Length,
+                                     uint8_t Local_Name[],
+                                     uint8_t Service_Uuid_length,
+                                     uint8_t Service_Uuid_List[],
+                                     uint16_t Slave_Conn_Interval_Min,
+                                     uint16_t Slave_Conn_Interval_Max );
+tBleStatus aci_gap_set_direct_connectable( uint8_t Own_Address_Type,
+                                           uint8_t Directed_Advertising_Type,
+                                           uint8_t Direct_Address_Type,
+                                           uint8_t Direct_Address[6],
+                                           uint16_t Advertising_Interval_Min,
+                                           uint16_t Advertising_Interval_Max );
+tBleStatus aci_gap_set_io_capability( uint8_t IO_Capability );
+tBleStatus aci_gap_set_authentication_requirement( uint8_t Bonding_Mode,
+                                                   uint8_t MITM_Mode,
+                                                   uint8_t SC_Support,
+                                                   uint8_t KeyPress_Notification_Support,
+                                                   uint8_t Min_Encryption_Key_Size,
+                                                   uint8_t Max_Encryption_Key_Size,
+                                                   uint8_t Use_Fixed_Pin,
+                                                   uint32_t Fixed_Pin,
+                                                   uint8_t Identity_Address_Type );
+tBleStatus aci_gap_slave_security_req( uint16_t Connection_Handle );
+tBleStatus aci_gap_terminate( uint16_t Connection_Handle, uint8_t Reason );
+tBleStatus aci_gap_init( uint8_t Role,
+                         uint8_t privacy_enabled,
+                         uint8_t device_name_char_len,
+                         uint16_t * Service_Handle,
+                         uint16_t * Dev_Name_Char_Handle,
+                         uint16_t * Appearance_Char_Handle );
+tBleStatus aci_gap_clear_security_db( void );
+tBleStatus aci_gap_allow_rebond( uint16_t Connection_Handle );
+tBleStatus aci_gap_get_bonded_devices( uint8_t * Num_of_Addresses, Bonded_Device_Entry_t Bonded_Device_Entry[] );
+
+#endif /* BLUENRG1_GAP_ACI_H__ */
@@ -0,0 +1,74 @@
+/*
+ * bluenrg1_gatt_aci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the GATT
+ * server commands and constants used by the application, same prototypes as
+ * the middleware.
+ */
+
+#ifndef BLUENRG1_GATT_ACI_H__
+#define BLUENRG1_GATT_ACI_H__
+
+#include "ble_status.h"
+#include "bluenrg1_types.h"
+
+#define UUID_TYPE_16														( 0x01 )
+#define UUID_TYPE_128														( 0x02 )
+
+#define PRIMARY_SERVICE													( 0x01 )
+#define SECONDARY_SERVICE												( 0x02 )
+
+#define CHAR_PROP_BROADCAST											( 0x01 )
+#define CHAR_PROP_READ													( 0x02 )
+#define CHAR_PROP_WRITE_WITHOUT_RESP						( 0x04 )
+#define CHAR_PROP_WRITE													( 0x08 )
+#define CHAR_PROP_NOTIFY												( 0x10 )
+#define CHAR_PROP_INDICATE											( 0x20 )
+#define CHAR_PROP_SIGNED_WRITE									( 0x40 )
+#define CHAR_PROP_EXT														( 0x80 )
+
+#define ATTR_PERMISSION_NONE										( 0x00 )
+#define ATTR_PERMISSION_AUTHEN_READ							( 0x01 )
+#define ATTR_PERMISSION_AUTHOR_READ							( 0x02 )
+#define ATTR_PERMISSION_ENCRY_READ							( 0x04 )
+#define ATTR_PERMISSION_AUTHEN_WRITE						( 0x08 )
+#define ATTR_PERMISSION_AUTHOR_WRITE						( 0x10 )
+#define ATTR_PERMISSION_ENCRY_WRITE							( 0x20 )
+
+#define GATT_DONT_NOTIFY_EVENTS									( 0x00 )
+#define GATT_NOTIFY_ATTRIBUTE_WRITE							( 0x01 )
+#define GATT_NOTIFY_WRITE_REQ_AND_WAIT_FOR_APPL_RESP	( 0x02 )
+#define GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP		( 0x04 )
+
+#define CHAR_VALUE_LEN_CONSTANT									( 0x00 )
+#define CHAR_VALUE_LEN_VARIABLE									( 0x01 )
+
+tBleStatus aci_gatt_init( void );
+tBleStatus aci_gatt_add_service( uint8_t Service_UUID_Type,
+                                 Service_UUID_t * Service_UUID,
+                                 uint8_t Service_Type,
+                                 uint8_t Max_Attribute_Records,
+                                 uint16_t * Service_Handle );
+tBleStatus aci_gatt_add_char( uint16_t Service_Handle,
+                              uint8_t Char_UUID_Type,
+                              Char_UUID_t * Char_UUID,
+                              uint16_t Char_Value_Length,
+                              uint8_t Char_Properties,
+                              uint8_t Security_Permissions,
+                              uint8_t GATT_Evt_Mask,
+                              uint8_t Enc_Key_Size,
+                              uint8_t Is_Variable,
+                              uint16_t * Char_Handle );
+tBleStatus aci_gatt_update_char_value( uint16_t Service_Handle,
+                                       uint16_t Char_Handle,
+                                       uint8_t Val_Offset,
+                                       uint8_t Char_Value_Length,
+                                       uint8_t Char_Value[] );
+tBleStatus aci_gatt_allow_read( uint16_t Connection_Handle );
+tBleStatus aci_gatt_deny_read( uint16_t Connection_Handle, uint8_t Error_Code );
+tBleStatus aci_gatt_exchange_config( uint16_t Connection_Handle );
+
+#endif /* BLUENRG1_GATT_ACI_H__ */
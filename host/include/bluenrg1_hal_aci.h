@@ -0,0 +1,20 @@
+/*
+ * bluenrg1_hal_aci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name.
+ */
+
+#ifndef BLUENRG1_HAL_ACI_H__
+#define BLUENRG1_HAL_ACI_H__
+
+#include "ble_status.h"
+
+#define CONFIG_DATA_PUBADDR_OFFSET			( 0x00 )
+#define CONFIG_DATA_PUBADDR_LEN					( 6 )
+
+tBleStatus aci_hal_write_config_data( uint8_t Offset, uint8_t Length, uint8_t Value[] );
+
+#endif /* BLUENRG1_HAL_ACI_H__ */
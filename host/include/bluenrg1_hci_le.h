@@ -0,0 +1,21 @@
+/*
+ * bluenrg1_hci_le.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the HCI
+ * commands used by the application, same prototypes as the middleware.
+ */
+
+#ifndef BLUENRG1_HCI_LE_H__
+#define BLUENRG1_HCI_LE_H__
+
+#include "ble_status.h"
+
+tBleStatus hci_reset( void );
+tBleStatus hci_le_read_remote_features( uint16_t Connection_Handle );
+tBleStatus hci_le_set_data_length( uint16_t Connection_Handle, uint16_t TxOctets, uint16_t TxTime );
+tBleStatus hci_le_set_phy( uint16_t Connection_Handle, uint8_t ALL_PHYS, uint8_t TX_PHYS, uint8_t RX_PHYS, uint16_t PHY_options );
+
+#endif /* BLUENRG1_HCI_LE_H__ */
@@ -0,0 +1,21 @@
+/*
+ * bluenrg1_l2cap_aci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name.
+ */
+
+#ifndef BLUENRG1_L2CAP_ACI_H__
+#define BLUENRG1_L2CAP_ACI_H__
+
+#include "ble_status.h"
+
+tBleStatus aci_l2cap_connection_parameter_update_req( uint16_t Connection_Handle,
+                                                      uint16_t Conn_Interval_Min,
+                                                      uint16_t Conn_Interval_Max,
+                                                      uint16_t Slave_latency,
+                                                      uint16_t Timeout_Multiplier );
+
+#endif /* BLUENRG1_L2CAP_ACI_H__ */
@@ -0,0 +1,34 @@
+/*
+ * bluenrg1_types.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the
+ * parameter types of the ACI commands used by the application.
+ */
+
+#ifndef BLUENRG1_TYPES_H__
+#define BLUENRG1_TYPES_H__
+
+#include "ble_types.h"
+
+typedef PACKED( union )
+{
+	uint16_t Service_UUID_16;
+	uint8_t Service_UUID_128[16];
+} Service_UUID_t;
+
+typedef PACKED( union )
+{
+	uint16_t Char_UUID_16;
+	uint8_t Char_UUID_128[16];
+} Char_UUID_t;
+
+typedef PACKED( struct )
+{
+	uint8_t Address_Type;
+	uint8_t Address[6];
+} Bonded_Device_Entry_t;
+
+#endif /* BLUENRG1_TYPES_H__ */
@@ -0,0 +1,24 @@
+/*
+ * hci.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: HCI
+ * layer entry points, implemented by the simulated controller (host/sim).
+ */
+
+#ifndef HCI_H__
+#define HCI_H__
+
+#include "ble_types.h"
+#include "bluenrg1_events.h"
+
+/* Resets the controller (reset pin) and registers the user event callback */
+void hci_init( void ( * UserEvtRx )( void * pData ), void * pConf );
+/* Delivers every received event packet to the user event callback */
+void hci_user_evt_proc( void );
+/* Transport: reads one frame, non zero when the RX pool is full */
+int32_t hci_notify_asynch_evt( void * pdata );
+
+#endif /* HCI_H__ */
@@ -0,0 +1,83 @@
+/*
+ * hci_const.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: HCI
+ * packet types, event codes and packet layouts.
+ */
+
+#ifndef HCI_CONST_H__
+#define HCI_CONST_H__
+
+#include "ble_types.h"
+
+#define HCI_COMMAND_PKT									( 0x01 )
+#define HCI_ACLDATA_PKT									( 0x02 )
+#define HCI_EVENT_PKT										( 0x04 )
+#define HCI_VENDOR_PKT									( 0xFF )
+
+#define HCI_TYPE_OFFSET									( 0 )
+#define HCI_EVENT_HDR_SIZE							( 2 )
+
+#define EVT_DISCONN_COMPLETE						( 0x05 )
+#define EVT_ENCRYPT_CHANGE							( 0x08 )
+#define EVT_CMD_COMPLETE								( 0x0E )
+#define EVT_CMD_STATUS									( 0x0F )
+
+#define EVT_LE_META_EVENT								( 0x3E )
+#define EVT_LE_META_EVENT_SIZE					( 1 )
+#define EVT_LE_CONN_COMPLETE						( 0x01 )
+#define EVT_LE_CONN_UPDATE_COMPLETE			( 0x03 )
+#define EVT_LE_READ_REMOTE_USED_FEATURES_COMPLETE	( 0x04 )
+#define EVT_LE_DATA_LENGTH_CHANGE				( 0x07 )
+#define EVT_LE_PHY_UPDATE_COMPLETE			( 0x0C )
+
+#define EVT_VENDOR											( 0xFF )
+
+typedef PACKED( struct )
+{
+	uint8_t type;
+	uint8_t data[];
+} hci_uart_pckt;
+
+typedef PACKED( struct )
+{
+	uint8_t type;
+	uint8_t data[];
+} hci_spi_pckt;
+
+typedef PACKED( struct )
+{
+	uint8_t evt;
+	uint8_t plen;
+	uint8_t data[];
+} hci_event_pckt;
+
+typedef PACKED( struct )
+{
+	uint8_t subevent;
+	uint8_t data[];
+} evt_le_meta_event;
+
+typedef PACKED( struct )
+{
+	uint16_t ecode;
+	uint8_t data[];
+} evt_blue_aci;
+
+typedef PACKED( struct )
+{
+	uint8_t status;
+	uint16_t handle;
+	uint8_t role;
+	uint8_t peer_bdaddr_type;
+	uint8_t peer_bdaddr[6];
+	uint16_t interval;
+	uint16_t latency;
+	uint16_t supervision_timeout;
+	uint8_t master_clock_accuracy;
+} evt_le_connection_complete;
+
+#endif /* HCI_CONST_H__ */
@@ -0,0 +1,31 @@
+/*
+ * hci_tl.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name: the IO
+ * bus registration of the transport layer (hci_tl_interface.c).
+ */
+
+#ifndef HCI_TL_H__
+#define HCI_TL_H__
+
+#include "ble_types.h"
+#include "bluenrg_conf.h"
+#include "hci_tl_interface.h"
+
+typedef struct
+{
+	int32_t ( * Init )( void * pConf );
+	int32_t ( * DeInit )( void );
+	int32_t ( * Reset )( void );
+	int32_t ( * Receive )( uint8_t *, uint16_t );
+	int32_t ( * Send )( uint8_t *, uint16_t );
+	int32_t ( * DataAvailable )( void );
+	int32_t ( * GetTick )( void );
+} tHciIO;
+
+void hci_register_io_bus( tHciIO * fops );
+
+#endif /* HCI_TL_H__ */
@@ -0,0 +1,30 @@
+/*
+ * link_layer.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build stand-in for the X-CUBE-BLE2 header of the same name:
+ * advertising types and address types.
+ */
+
+#ifndef LINK_LAYER_H__
+#define LINK_LAYER_H__
+
+#define ADV_IND													( 0 )
+#define ADV_DIRECT_IND									( 1 )
+#define ADV_SCAN_IND										( 2 )
+#define ADV_NONCONN_IND									( 3 )
+
+#define HIGH_DUTY_CYCLE_DIRECTED_ADV		( 1 )
+#define LOW_DUTY_CYCLE_DIRECTED_ADV			( 4 )
+
+#define PUBLIC_ADDR											( 0 )
+#define RANDOM_ADDR											( 1 )
+#define STATIC_RANDOM_ADDR							( 1 )
+
+#define NO_WHITE_LIST_USE								( 0x00 )
+#define WHITE_LIST_FOR_ONLY_CONN				( 0x02 )
+#define WHITE_LIST_FOR_ALL							( 0x03 )
+
+#endif /* LINK_LAYER_H__ */
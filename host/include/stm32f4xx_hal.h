@@ -0,0 +1,315 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host build (APP_HOST_BUILD = 1) stand-in for the STM32F4 HAL: the types,
+ * constants and functions named by the application layer, main.h,
+ * hci_tl_interface.c and the BSP bus header, nothing more.
+ *
+ * Peripherals are plain structures, the functions are provided by the host
+ * simulation (host/sim): virtual time base, flash array, UART and GPIO /
+ * EXTI / SPI / ADC models.
+ */
+
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * Core (CMSIS)
+ * ==========================================================================*/
+#define __IO							volatile
+#define __weak						__attribute__(( weak ))
+#define __NVIC_PRIO_BITS	( 4U )
+
+typedef enum
+{
+	PendSV_IRQn = -2,
+	SysTick_IRQn = -1,
+	EXTI0_IRQn = 6,
+	USART2_IRQn = 38,
+	EXTI15_10_IRQn = 40,
+	DMA2_Stream4_IRQn = 60,
+} IRQn_Type;
+
+typedef struct
+{
+	__IO uint32_t ICSR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSVSET_Msk		( 1UL << 28 )
+
+/* Writes to ICSR pend the PendSV bottom half of hci_tl_interface.c */
+extern SCB_Type * const SCB;
+
+/* Interrupt context of the calling thread: 0 in thread mode (host_ipsr is
+ * set by the models that run "interrupt handlers" on their own thread) */
+extern __thread uint32_t host_ipsr;
+/* Core asleep (WFI / WFE): the models move virtual time to their next event */
+extern void host_cpu_wait( void );
+extern void host_set_basepri( uint32_t basepri );
+extern uint32_t host_get_basepri( void );
+
+static inline uint32_t __get_IPSR( void )
+{
+	return host_ipsr;
+}
+
+/* BASEPRI_MAX: raises the mask only, a lower priority (higher value) or 0 is kept out */
+static inline void __set_BASEPRI_MAX( uint32_t basepri )
+{
+	const uint32_t current = host_get_basepri();
+
+	if( ( 0U != basepri ) && ( ( 0U == current ) || ( basepri < current ) ) )
+	{
+		host_set_basepri( basepri );
+	}
+}
+
+#define __disable_irq()				do { } while( 0 )
+#define __enable_irq()				do { } while( 0 )
+#define __DMB()								__atomic_thread_fence( __ATOMIC_SEQ_CST )
+#define __WFI()								host_cpu_wait()
+#define __WFE()								host_cpu_wait()
+#define __set_BASEPRI( x )		host_set_basepri( x )
+#define __get_BASEPRI()				host_get_basepri()
+
+#define assert_param( expr )	( (void)0 )
+
+/* ============================================================================
+ * HAL common
+ * ==========================================================================*/
+typedef enum
+{
+	HAL_OK = 0x00U,
+	HAL_ERROR = 0x01U,
+	HAL_BUSY = 0x02U,
+	HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+extern uint32_t SystemCoreClock;
+
+extern uint32_t HAL_GetTick( void );
+extern void HAL_Delay( uint32_t Delay );
+
+extern void HAL_NVIC_SetPriority( IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority );
+extern void HAL_NVIC_EnableIRQ( IRQn_Type IRQn );
+extern void HAL_NVIC_DisableIRQ( IRQn_Type IRQn );
+extern void HAL_NVIC_SetPendingIRQ( IRQn_Type IRQn );
+extern void HAL_PWR_EnableSEVOnPend( void );
+
+/* ============================================================================
+ * GPIO / EXTI
+ * ==========================================================================*/
+typedef struct
+{
+	__IO uint32_t IDR;
+	__IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+	uint32_t Pin;
+	uint32_t Mode;
+	uint32_t Pull;
+	uint32_t Speed;
+	uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+extern GPIO_TypeDef host_gpioc;
+#define GPIOA							( &host_gpioa )
+#define GPIOB							( &host_gpiob )
+#define GPIOC							( &host_gpioc )
+
+#define GPIO_PIN_0				( (uint16_t)0x0001 )
+#define GPIO_PIN_1				( (uint16_t)0x0002 )
+#define GPIO_PIN_2				( (uint16_t)0x0004 )
+#define GPIO_PIN_3				( (uint16_t)0x0008 )
+#define GPIO_PIN_5				( (uint16_t)0x0020 )
+#define GPIO_PIN_6				( (uint16_t)0x0040 )
+#define GPIO_PIN_7				( (uint16_t)0x0080 )
+#define GPIO_PIN_8				( (uint16_t)0x0100 )
+#define GPIO_PIN_13				( (uint16_t)0x2000 )
+#define GPIO_PIN_14				( (uint16_t)0x4000 )
+
+#define GPIO_MODE_INPUT					( 0x00000000U )
+#define GPIO_MODE_OUTPUT_PP			( 0x00000001U )
+#define GPIO_MODE_IT_RISING			( 0x10110000U )
+#define GPIO_NOPULL							( 0x00000000U )
+#define GPIO_SPEED_FREQ_LOW			( 0x00000000U )
+#define GPIO_AF5_SPI1						( 0x05U )
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()		do { } while( 0 )
+#define __HAL_RCC_GPIOA_CLK_DISABLE()		do { } while( 0 )
+#define __HAL_RCC_GPIOB_CLK_ENABLE()		do { } while( 0 )
+#define __HAL_RCC_GPIOB_CLK_DISABLE()		do { } while( 0 )
+
+extern void HAL_GPIO_Init( GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init );
+extern void HAL_GPIO_DeInit( GPIO_TypeDef * GPIOx, uint32_t GPIO_Pin );
+extern GPIO_PinState HAL_GPIO_ReadPin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin );
+extern void HAL_GPIO_WritePin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState );
+extern void HAL_GPIO_EXTI_Callback( uint16_t GPIO_Pin );
+
+typedef enum
+{
+	HAL_EXTI_COMMON_CB_ID = 0x00U
+} EXTI_CallbackIDTypeDef;
+
+typedef struct
+{
+	uint32_t Line;
+	void ( * PendingCallback )( void );
+} EXTI_HandleTypeDef;
+
+#define EXTI_LINE_0				( 0x06000000U )
+
+extern HAL_StatusTypeDef HAL_EXTI_GetHandle( EXTI_HandleTypeDef * hexti, uint32_t ExtiLine );
+extern HAL_StatusTypeDef HAL_EXTI_RegisterCallback( EXTI_HandleTypeDef * hexti, EXTI_CallbackIDTypeDef CallbackID, void ( * pPendingCbfn )( void ) );
+
+/* ============================================================================
+ * DMA / SPI / UART / ADC / TIM handles (opaque on the host)
+ * ==========================================================================*/
+typedef struct
+{
+	void * Instance;
+} DMA_HandleTypeDef;
+
+typedef struct
+{
+	void * Instance;
+} SPI_HandleTypeDef;
+
+typedef struct
+{
+	void * Instance;
+} UART_HandleTypeDef;
+
+/* ADC1 and TIM3: the Init fields app_sampler.c sets, read by host/sim/sim_adc.c */
+typedef struct
+{
+	uint32_t ClockPrescaler;
+	uint32_t Resolution;
+	uint32_t DataAlign;
+	uint32_t ScanConvMode;
+	uint32_t EOCSelection;
+	uint32_t ContinuousConvMode;
+	uint32_t NbrOfConversion;
+	uint32_t DiscontinuousConvMode;
+	uint32_t ExternalTrigConv;
+	uint32_t ExternalTrigConvEdge;
+	uint32_t DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct
+{
+	void * Instance;
+	ADC_InitTypeDef Init;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+	uint32_t Channel;
+	uint32_t Rank;
+	uint32_t SamplingTime;
+	uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct
+{
+	uint32_t Prescaler;
+	uint32_t CounterMode;
+	uint32_t Period;
+	uint32_t ClockDivision;
+	uint32_t RepetitionCounter;
+	uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+	void * Instance;
+	TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+	uint32_t MasterOutputTrigger;
+	uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+extern uint8_t host_adc1;
+extern uint8_t host_tim3;
+#define ADC1											( (void *)&host_adc1 )
+#define TIM3											( (void *)&host_tim3 )
+
+#define ENABLE										( 1U )
+#define DISABLE										( 0U )
+
+#define ADC_CLOCK_SYNC_PCLK_DIV4				( 0x00010000U )
+#define ADC_RESOLUTION_12B							( 0x00000000U )
+#define ADC_DATAALIGN_RIGHT							( 0x00000000U )
+#define ADC_EOC_SEQ_CONV								( 0x00000000U )
+#define ADC_EXTERNALTRIGCONVEDGE_RISING	( 0x10000000U )
+#define ADC_EXTERNALTRIGCONV_T3_TRGO		( 0x08000000U )
+#define ADC_CHANNEL_10									( 10U )
+#define ADC_CHANNEL_TEMPSENSOR					( 16U )
+#define ADC_SAMPLETIME_84CYCLES					( 5U )
+#define ADC_SAMPLETIME_480CYCLES				( 7U )
+
+#define TIM_COUNTERMODE_UP							( 0x00000000U )
+#define TIM_CLOCKDIVISION_DIV1					( 0x00000000U )
+#define TIM_AUTORELOAD_PRELOAD_DISABLE	( 0x00000000U )
+#define TIM_TRGO_UPDATE									( 0x00000020U )
+#define TIM_MASTERSLAVEMODE_DISABLE			( 0x00000000U )
+
+extern uint32_t HAL_RCC_GetHCLKFreq( void );
+
+extern HAL_StatusTypeDef HAL_ADC_Init( ADC_HandleTypeDef * hadc );
+extern HAL_StatusTypeDef HAL_ADC_ConfigChannel( ADC_HandleTypeDef * hadc, ADC_ChannelConfTypeDef * sConfig );
+extern HAL_StatusTypeDef HAL_ADC_Start_DMA( ADC_HandleTypeDef * hadc, uint32_t * pData, uint32_t Length );
+extern HAL_StatusTypeDef HAL_ADC_Stop_DMA( ADC_HandleTypeDef * hadc );
+extern void HAL_ADC_ConvHalfCpltCallback( ADC_HandleTypeDef * hadc );
+extern void HAL_ADC_ConvCpltCallback( ADC_HandleTypeDef * hadc );
+
+extern HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef * htim );
+extern HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef * htim );
+extern HAL_StatusTypeDef HAL_TIM_Base_Stop( TIM_HandleTypeDef * htim );
+extern HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization( TIM_HandleTypeDef * htim, TIM_MasterConfigTypeDef * sMasterConfig );
+
+extern HAL_StatusTypeDef HAL_UART_Transmit_DMA( UART_HandleTypeDef * huart, const uint8_t * pData, uint16_t Size );
+extern void HAL_UART_TxCpltCallback( UART_HandleTypeDef * huart );
+
+/* ============================================================================
+ * FLASH
+ * ==========================================================================*/
+typedef struct
+{
+	uint32_t TypeErase;
+	uint32_t Banks;
+	uint32_t Sector;
+	uint32_t NbSectors;
+	uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_TYPEERASE_SECTORS		( 0x00000000U )
+#define FLASH_VOLTAGE_RANGE_3			( 0x00000002U )
+#define FLASH_SECTOR_7						( 7U )
+#define FLASH_TYPEPROGRAM_WORD		( 0x00000002U )
+
+extern HAL_StatusTypeDef HAL_FLASH_Unlock( void );
+extern HAL_StatusTypeDef HAL_FLASH_Lock( void );
+extern HAL_StatusTypeDef HAL_FLASH_Program( uint32_t TypeProgram, uint32_t Address, uint64_t Data );
+extern HAL_StatusTypeDef HAL_FLASHEx_Erase( FLASH_EraseInitTypeDef * pEraseInit, uint32_t * SectorError );
+
+#endif /* STM32F4XX_HAL_H */
@@ -0,0 +1,328 @@
+/*
+ * sim.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Host simulation of the board around the application layer: a virtual time
+ * base, the BlueNRG-2 controller seen through the aci_xxx / hci_xxx entry
+ * points (GATT database, advertising, connections, security database, TX
+ * buffer pool and link layer airtime) and one or more simulated centrals.
+ *
+ * The application sources (Core/Src/app_*.c) are compiled unmodified with
+ * APP_HOST_BUILD = 1. sim_boot() / sim_loop_once() replay main() and its
+ * main loop, the tests drive the centrals and inject events.
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ble_status.h"
+#include "hci_tl_interface.h"
+
+/* ============================================================================
+ * Virtual time (sim_hal.c)
+ * ==========================================================================*/
+#define SIM_NS_PER_US							( 1000ULL )
+#define SIM_NS_PER_MS							( 1000000ULL )
+
+/* Model driven by the clock: run_until() handles everything due up to the
+ * given time, next_due() is the time of its next activity (UINT64_MAX if none) */
+typedef struct
+{
+	void ( * run_until )( uint64_t now_ns );
+	uint64_t ( * next_due )( void );
+} sim_clock_client_t;
+
+extern uint64_t sim_time_ns( void );
+extern void sim_time_advance_ns( uint64_t ns );
+extern void sim_time_advance_to( uint64_t t_ns );
+/* Core asleep: up to the next model activity or the next SysTick */
+extern void sim_time_idle( void );
+extern void sim_clock_register( const sim_clock_client_t * p_client );
+extern uint64_t sim_clock_next_due( void );
+
+/* Flash sector 7 (bond store), erased to 0xFF */
+extern void sim_flash_erase_all( void );
+
+/* ============================================================================
+ * HCI layer (sim_hci.c)
+ * ==========================================================================*/
+/* Room in the middleware RX packet pool (HCI_READ_PACKET_NUM_MAX) */
+extern bool sim_hci_rx_room( void );
+/* One event packet { 0x04, evt, plen, data } into the RX pool, with the IRQ edge */
+extern bool sim_hci_rx_push( const uint8_t * pkt, uint16_t len );
+extern uint32_t sim_hci_rx_count( void );
+
+/* ============================================================================
+ * Controller (sim_controller.c)
+ * ==========================================================================*/
+#define SIM_GATT_MAX_HANDLES				( 256U )
+#define SIM_ATTR_VALUE_MAX					( 512U )
+#define SIM_GATT_CALLS_MAX					( 32U )
+#define SIM_MAX_CONNECTIONS					( 8U )
+#define SIM_BOND_MAX								( 8U )
+#define SIM_TX_POOL_DEFAULT					( 10U )
+/* Largest ATT_MTU of the BlueNRG-2 stack */
+#define SIM_ATT_MTU_MAX							( 247U )
+
+typedef enum
+{
+	SIM_ATTR_FREE = 0,
+	SIM_ATTR_SERVICE,
+	SIM_ATTR_CHAR_DECL,
+	SIM_ATTR_CHAR_VALUE,
+	SIM_ATTR_CCCD,
+} sim_attr_type_t;
+
+typedef struct
+{
+	sim_attr_type_t type;
+	uint8_t uuid_type;							/* UUID_TYPE_16 / UUID_TYPE_128 */
+	uint8_t uuid[16];
+	uint16_t service;								/* Owning service declaration */
+	uint16_t decl;									/* Characteristic declaration (value, CCCD) */
+	/* Service: reserved handles [service, end] (Max_Attribute_Records) */
+	uint8_t records;
+	uint16_t end;
+	uint16_t fill;									/* Next free handle of the service */
+	/* Characteristic (declaration and value) */
+	uint8_t properties;
+	uint8_t permissions;
+	uint8_t evt_mask;
+	uint8_t enc_key_size;
+	uint8_t is_variable;
+	uint16_t max_len;
+	uint16_t len;
+	uint8_t value[SIM_ATTR_VALUE_MAX];
+} sim_attr_t;
+
+/* One aci_gatt_add_service() / aci_gatt_add_char() call of the application, as made */
+typedef struct
+{
+	bool service;										/* aci_gatt_add_service(), else aci_gatt_add_char() */
+	uint8_t uuid_type;
+	uint8_t uuid[16];
+	uint16_t parent;								/* add_char: Service_Handle */
+	uint8_t records;								/* add_service: Max_Attribute_Records */
+	uint16_t value_len;							/* add_char from here on */
+	uint8_t properties;
+	uint8_t permissions;
+	uint8_t evt_mask;
+	uint8_t enc_key_size;
+	uint8_t is_variable;
+	tBleStatus status;
+	uint16_t handle;								/* Returned handle, 0 on error */
+} sim_gatt_call_t;
+
+/* One simulated central. The test owns the structure, the controller keeps a
+ * pointer to it while it scans or is connected and updates the state part. */
+typedef struct
+{
+	/* Configuration */
+	uint8_t addr_type;
+	uint8_t addr[6];
+	uint16_t att_mtu;							/* Client RX MTU of the exchange */
+	bool dle;											/* LE feature: data length extension */
+	bool phy_2m;									/* LE feature: 2M PHY */
+	uint16_t conn_interval;				/* x 1.25 ms, at connection */
+	bool accept_params;						/* Accepts L2CAP parameter update requests */
+	bool pairs;										/* Answers the slave security request */
+	uint8_t pdus_per_event;				/* LL PDUs per connection event, 0: interval bound */
+	/* State */
+	bool has_keys;								/* Bonded to the device */
+	uint16_t conn_handle;					/* 0xFFFF when not connected */
+	uint64_t connected_ns;
+	uint64_t disconnected_ns;
+	/* Notifications received */
+	uint32_t notifications;
+	uint32_t notified_bytes;
+	void ( * on_notify )( void * p_central, uint16_t attr_handle, const uint8_t * data, uint16_t len );
+} sim_central_t;
+
+typedef struct
+{
+	uint16_t interval;
+	uint16_t latency;
+	uint16_t timeout;
+	uint16_t att_mtu;
+	uint16_t tx_octets;
+	uint8_t tx_phy;
+	bool encrypted;
+	uint32_t conn_events;
+	uint32_t data_events;					/* Connection events that carried notifications */
+	uint32_t ll_pdus;
+	uint64_t airtime_ns;					/* Radio time used by the notifications */
+	uint32_t notifications;
+	uint32_t truncated;						/* Notifications cut to ATT_MTU - 3 */
+	uint64_t read_latency_ns;			/* Last read permit request to allow / deny */
+} sim_conn_stats_t;
+
+typedef struct
+{
+	uint32_t commands;						/* ACI / HCI commands */
+	uint32_t pool_full;						/* aci_gatt_update_char_value() refused for the TX pool */
+	uint32_t pool_available;			/* aci_gatt_tx_pool_available_event() sent */
+	uint32_t events;							/* Events handed to the RX pool */
+	uint32_t events_held;					/* Events that waited for room in the RX pool */
+	/* Advertising */
+	uint32_t adv_starts;
+	uint32_t adv_events;
+	uint64_t adv_on_ns;						/* Time spent advertising */
+	uint64_t adv_airtime_ns;			/* Radio time of the advertising events */
+	uint32_t directed_timeouts;
+	/* SPI frames the commands and events above take on the board (the sim
+	 * reaches the controller without the transport) */
+	HCI_TL_SPI_Stats_t spi;
+} sim_ctrl_stats_t;
+
+/* Controller power on: erased GATT database, no bond, default TX pool */
+extern void sim_ctrl_power_on( uint32_t seed );
+/* Reset pin (hci_init): keeps the security database, like the BlueNRG-2 flash */
+extern void sim_ctrl_reset( void );
+extern void sim_ctrl_set_tx_pool( uint8_t buffers );
+/* Time of an ACI command on the SPI link and in the controller */
+extern void sim_ctrl_set_command_ns( uint32_t ns );
+/* Hung controller: the next count commands are never taken and end in
+ * BLE_STATUS_TIMEOUT after HCI_DEFAULT_TIMEOUT_MS, as from the middleware */
+extern void sim_ctrl_hang_commands( uint32_t count );
+extern void sim_ctrl_get_stats( sim_ctrl_stats_t * p_stats );
+extern void sim_ctrl_clear_stats( void );
+extern bool sim_ctrl_is_advertising( void );
+
+extern const sim_attr_t * sim_gatt_attr( uint16_t handle );
+/* First free handle of the database (one past the last service) */
+extern uint16_t sim_gatt_next_handle( void );
+/* First attribute of the type with the UUID (little endian), 0 if none */
+extern uint16_t sim_gatt_find_uuid( uint8_t uuid_type, const uint8_t * uuid, sim_attr_type_t type );
+/* add_service / add_char calls since aci_gatt_init(), returns their number */
+extern uint32_t sim_gatt_calls( const sim_gatt_call_t ** pp_calls );
+
+extern uint8_t sim_bond_count( void );
+extern bool sim_bond_add( uint8_t addr_type, const uint8_t addr[6] );
+
+/* Central side */
+extern void sim_central_init( sim_central_t * p_central, uint8_t addr_last );
+/* Immediate CONNECT_IND on the current advertising, returns the connection
+ * handle or 0xFFFF when the device does not advertise (or not to this central) */
+extern uint16_t sim_connect( sim_central_t * p_central );
+/* Background scanning: connects on the first advertising PDU heard */
+extern void sim_central_scan( sim_central_t * p_central, uint32_t interval_us, uint32_t window_us );
+extern void sim_central_stop_scan( sim_central_t * p_central );
+extern void sim_disconnect( sim_central_t * p_central, uint8_t reason );
+/* ATT write request, returns the ATT error code (0 on success) */
+extern uint8_t sim_write( sim_central_t * p_central, uint16_t handle, const uint8_t * data, uint16_t len );
+/* CCCD of the characteristic declared at decl: notifications on / off */
+extern uint8_t sim_subscribe( sim_central_t * p_central, uint16_t decl, bool enable );
+/* ATT read request, runs the application until it answers (ATT error code) */
+extern uint8_t sim_read( sim_central_t * p_central, uint16_t handle, uint8_t * out, uint16_t size, uint16_t * p_len );
+extern bool sim_conn_stats( const sim_central_t * p_central, sim_conn_stats_t * p_stats );
+
+/* Event injector: any event packet { 0x04, evt, plen, data }, delivered now */
+extern void sim_inject( const uint8_t * pkt, uint16_t len );
+extern void sim_inject_attribute_modified( uint16_t conn_handle, uint16_t attr_handle, const uint8_t * data, uint16_t len );
+extern void sim_inject_read_permit( uint16_t conn_handle, uint16_t attr_handle, uint16_t offset );
+
+/* ============================================================================
+ * Board without the BlueNRG-2 on the bus (sim_bsp.c)
+ * ==========================================================================*/
+/* IRQ line stuck high: hci_tl_lowlevel_bottom_half() reads empty frames
+ * until it reports RECOVERY_CAUSE_IRQ_STUCK, HCI_TL_SPI_STUCK_READS x
+ * TIMEOUT_IRQ_HIGH of virtual time */
+extern void sim_bsp_irq_stuck( void );
+
+/* ============================================================================
+ * BlueNRG-2 on the SPI bus (sim_spi_slave.c, in place of sim_bsp.c)
+ * ==========================================================================*/
+/* SPI1 of the BSP: APB2 64 MHz / SPI_BAUDRATEPRESCALER_64 */
+#define SIM_SPI_SCK_HZ_DEFAULT			( 1000000U )
+#define SIM_SPI_FRAME_MAX						( 255U )
+#define SIM_SPI_QUEUE_MAX						( 64U )
+
+typedef struct
+{
+	uint32_t sck_hz;
+	uint32_t wake_ns;							/* CS low to IRQ high: slave ready for the header */
+	uint32_t irq_low_ns;					/* End of the header to IRQ low */
+	uint32_t next_irq_ns;					/* CS high to IRQ high when another frame is queued */
+	uint32_t call_ns;							/* Polled HAL transfer: call overhead */
+	uint32_t dma_setup_ns;				/* DMA transfer: start to first byte */
+	uint32_t dma_irq_ns;					/* DMA transfer: last byte to the complete callback */
+	uint32_t gpio_read_ns;				/* HAL_GPIO_ReadPin(), one pass of a polling loop */
+	uint16_t write_buffer;				/* Command buffer of the slave */
+	uint32_t write_drain_ns;			/* A written command frees the buffer after this */
+	/* Fault injection */
+	bool irq_dead;								/* IRQ never raised: the master waits (-3) */
+	bool irq_stuck_high;					/* IRQ held high with nothing to send */
+	uint32_t dma_fail;						/* Next DMA transfers complete with BSP_ERROR_BUS_FAILURE */
+	bool dma_hang;								/* DMA transfers never complete */
+} sim_spi_config_t;
+
+typedef struct
+{
+	uint32_t read_frames;					/* 0x0b frames that carried an event */
+	uint32_t read_empty;					/* 0x0b frames with nothing to send */
+	uint32_t write_frames;				/* 0x0a frames with the command taken */
+	uint32_t write_refused;				/* 0x0a frames ended without payload (buffer short, -2) */
+	uint32_t header_errors;				/* Unknown first byte, payload past the frame */
+	uint32_t irq_edges;						/* IRQ rising edges */
+	uint32_t dma_transfers;
+	uint64_t bus_bytes;						/* Bytes clocked with CS low */
+	uint64_t bus_ns;							/* SCK running */
+	uint64_t cpu_busy_ns;					/* Core held by polled transfers */
+} sim_spi_stats_t;
+
+extern void sim_spi_default_config( sim_spi_config_t * p_cfg );
+/* Slave powered with p_cfg (NULL: defaults), empty queues, IRQ low */
+extern void sim_spi_slave_init( const sim_spi_config_t * p_cfg );
+/* Live configuration, for delays and faults injected mid test */
+extern sim_spi_config_t * sim_spi_config( void );
+/* Event frame for the master, IRQ raised once nothing else is in progress */
+extern bool sim_spi_slave_queue( const uint8_t * frame, uint16_t len );
+extern uint32_t sim_spi_slave_queued( void );
+/* Oldest command frame written by the master, 0 when none */
+extern uint16_t sim_spi_slave_pop_write( uint8_t * out, uint16_t size );
+extern bool sim_spi_slave_irq( void );
+extern void sim_spi_get_stats( sim_spi_stats_t * p_stats );
+extern void sim_spi_clear_stats( void );
+/* PendSV: runs hci_tl_lowlevel_bottom_half() when it is pended, thread mode only */
+extern bool sim_spi_pendsv( void );
+
+/* HCI middleware seen by hci_tl_interface.c in the SPI tests (sim_hci_spi.c) */
+/* Frames read by hci_notify_asynch_evt() fit in this many RX pool packets */
+extern void sim_hci_spi_set_pool( uint32_t packets );
+/* Oldest frame read through the registered Receive(), 0 when none */
+extern uint16_t sim_hci_spi_pop( uint8_t * out, uint16_t size );
+extern uint32_t sim_hci_spi_count( void );
+extern uint32_t sim_hci_spi_edges( void );					/* event_pump_isr_edge() calls */
+extern uint32_t sim_hci_spi_irq_stuck( void );			/* recovery_report( RECOVERY_CAUSE_IRQ_STUCK ) calls */
+
+/* ============================================================================
+ * ADC1 paced by TIM3, DMA2 Stream4 (sim_adc.c, APP_SAMPLER = 1)
+ * ==========================================================================*/
+/* 12-bit value of the channel (ADC_CHANNEL_x) at the scan, counted from
+ * HAL_TIM_Base_Start() */
+typedef uint16_t ( * sim_adc_source_t )( uint32_t scan, uint32_t channel );
+
+/* NULL: every conversion reads 0 */
+extern void sim_adc_set_source( sim_adc_source_t source );
+extern uint32_t sim_adc_scans( void );
+
+/* ============================================================================
+ * Application (sim_app.c)
+ * ==========================================================================*/
+/* main() up to the main loop */
+extern tBleStatus sim_boot( void );
+/* One pass of the main loop, true when it would sleep (WFI) */
+extern bool sim_loop_once( void );
+/* Main loop for ms of virtual time */
+extern void sim_run_ms( uint32_t ms );
+/* Main loop until cond() or timeout, true when cond() was met */
+extern bool sim_run_until( bool ( * cond )( void * arg ), void * arg, uint32_t timeout_ms );
+extern void sim_button_press( void );
+
+#endif /* HOST_SIM_H_ */
@@ -0,0 +1,183 @@
+/*
+ * sim_adc.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * TIM3 -> ADC1 -> DMA2 Stream4 of app_sampler.c, for the tests built with
+ * APP_SAMPLER = 1.
+ *
+ * Every TIM3 update (period from its prescaler and auto-reload at the HCLK
+ * timer clock) converts the NbrOfConversion ranked channels into the
+ * circular DMA buffer of HAL_ADC_Start_DMA(). The half and full transfer
+ * complete callbacks run from the clock in "interrupt" context, like
+ * DMA2_Stream4_IRQHandler() on the board. The converted values come from the
+ * source set by the test, 12-bit, scan counted from HAL_TIM_Base_Start().
+ */
+
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "sim.h"
+
+#define SIM_ADC_RANKS_MAX						( 16U )
+#define SIM_ADC_FULL_SCALE					( 0x0FFFU )
+#define SIM_ADC_NEVER								( UINT64_MAX )
+#define SIM_ADC_IPSR_DMA						( 16U + (uint32_t)DMA2_Stream4_IRQn )
+
+uint8_t host_adc1;
+uint8_t host_tim3;
+
+static ADC_HandleTypeDef * g_hadc = NULL;
+static uint32_t g_rank_channel[SIM_ADC_RANKS_MAX];
+static uint16_t * g_dma_buf = NULL;
+static uint32_t g_dma_len = 0;
+static uint32_t g_dma_pos = 0;
+static uint64_t g_period_ns = 0;
+static uint64_t g_scan_due = SIM_ADC_NEVER;
+static uint32_t g_scan = 0;
+static sim_adc_source_t g_source = NULL;
+
+static void sim_adc_run_until( uint64_t now_ns );
+static uint64_t sim_adc_next_due( void );
+
+static const sim_clock_client_t g_adc_clock = {
+	.run_until = sim_adc_run_until,
+	.next_due = sim_adc_next_due,
+};
+
+/* ============================================================================
+ * Clock
+ * ==========================================================================*/
+static void sim_adc_run_until( uint64_t now_ns )
+{
+	while( g_scan_due <= now_ns )
+	{
+		const uint32_t ipsr = host_ipsr;
+		uint32_t rank;
+
+		for( rank = 0; g_hadc->Init.NbrOfConversion > rank; rank++ )
+		{
+			const uint16_t value = ( NULL != g_source ) ? g_source( g_scan, g_rank_channel[rank] ) : 0U;
+			g_dma_buf[g_dma_pos++] = value & SIM_ADC_FULL_SCALE;
+		}
+		g_scan++;
+		g_scan_due += g_period_ns;
+
+		host_ipsr = SIM_ADC_IPSR_DMA;
+		if( ( g_dma_len / 2U ) == g_dma_pos )
+		{
+			HAL_ADC_ConvHalfCpltCallback( g_hadc );
+		}
+		else if( g_dma_len == g_dma_pos )
+		{
+			g_dma_pos = 0;
+			HAL_ADC_ConvCpltCallback( g_hadc );
+		}
+		host_ipsr = ipsr;
+	}
+}
+
+static uint64_t sim_adc_next_due( void )
+{
+	return g_scan_due;
+}
+
+/* ============================================================================
+ * HAL
+ * ==========================================================================*/
+uint32_t HAL_RCC_GetHCLKFreq( void )
+{
+	return SystemCoreClock;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Init( TIM_HandleTypeDef * htim )
+{
+	if( TIM3 != htim->Instance )
+	{
+		return HAL_ERROR;
+	}
+	/* APB1 timer clock = HCLK (APB1 prescaler 2) */
+	g_period_ns = ( (uint64_t)( htim->Init.Prescaler + 1U ) * ( htim->Init.Period + 1U ) * 1000000000ULL ) / HAL_RCC_GetHCLKFreq();
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization( TIM_HandleTypeDef * htim, TIM_MasterConfigTypeDef * sMasterConfig )
+{
+	return ( ( TIM3 == htim->Instance ) && ( TIM_TRGO_UPDATE == sMasterConfig->MasterOutputTrigger ) ) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init( ADC_HandleTypeDef * hadc )
+{
+	if( ( ADC1 != hadc->Instance ) || ( SIM_ADC_RANKS_MAX < hadc->Init.NbrOfConversion ) ||
+	    ( ADC_EXTERNALTRIGCONV_T3_TRGO != hadc->Init.ExternalTrigConv ) )
+	{
+		return HAL_ERROR;
+	}
+	memset( g_rank_channel, 0, sizeof( g_rank_channel ) );
+	g_hadc = hadc;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel( ADC_HandleTypeDef * hadc, ADC_ChannelConfTypeDef * sConfig )
+{
+	if( ( g_hadc != hadc ) || ( 0U == sConfig->Rank ) || ( hadc->Init.NbrOfConversion < sConfig->Rank ) )
+	{
+		return HAL_ERROR;
+	}
+	g_rank_channel[sConfig->Rank - 1U] = sConfig->Channel;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA( ADC_HandleTypeDef * hadc, uint32_t * pData, uint32_t Length )
+{
+	/* Half-word transfers: Length counts conversions, whole scans per half */
+	if( ( g_hadc != hadc ) || ( 0U != ( Length % ( 2U * hadc->Init.NbrOfConversion ) ) ) )
+	{
+		return HAL_ERROR;
+	}
+	g_dma_buf = (uint16_t *)pData;
+	g_dma_len = Length;
+	g_dma_pos = 0;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA( ADC_HandleTypeDef * hadc )
+{
+	(void)hadc;
+	g_dma_buf = NULL;
+	g_scan_due = SIM_ADC_NEVER;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start( TIM_HandleTypeDef * htim )
+{
+	if( ( TIM3 != htim->Instance ) || ( NULL == g_dma_buf ) || ( 0U == g_period_ns ) )
+	{
+		return HAL_ERROR;
+	}
+	g_scan = 0;
+	g_scan_due = sim_time_ns() + g_period_ns;
+	sim_clock_register( &g_adc_clock );
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop( TIM_HandleTypeDef * htim )
+{
+	(void)htim;
+	g_scan_due = SIM_ADC_NEVER;
+	return HAL_OK;
+}
+
+/* ============================================================================
+ * Test side
+ * ==========================================================================*/
+void sim_adc_set_source( sim_adc_source_t source )
+{
+	g_source = source;
+}
+
+uint32_t sim_adc_scans( void )
+{
+	return g_scan;
+}
@@ -0,0 +1,149 @@
+/*
+ * sim_app.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * main() of Core/Src/main.c for the host: the same boot sequence and main
+ * loop, one pass at a time. A pass that would end in WFI lets the virtual
+ * time run to the next controller activity or SysTick; a busy pass costs
+ * SIM_LOOP_NS.
+ *
+ * Keep sim_boot() and sim_loop_once() in step with main.c.
+ */
+
+#include <stdlib.h>
+
+#include "app_includes.h"
+#include "sim.h"
+
+/* One main loop pass that had work to do */
+#define SIM_LOOP_NS						( 5ULL * SIM_NS_PER_US )
+
+/* main.c globals */
+UART_HandleTypeDef huart2;
+volatile bool g_btn_event = false;
+DMA_HandleTypeDef hdma_usart2_tx;
+ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+TIM_HandleTypeDef htim3;
+
+void Error_Handler( void )
+{
+	abort();
+}
+
+tBleStatus sim_boot( void )
+{
+	tBleStatus ret;
+
+	boot_timeline_start();
+	log_init( &huart2 );
+	boot_mark( BOOT_PHASE_PERIPHERALS );
+
+	ret = bluenrg_init();
+	if( BLE_STATUS_SUCCESS != ret )
+	{
+		LOG_WARN("bluenrg_init FAILED (%d)", ret);
+		recovery_report( RECOVERY_CAUSE_INIT );
+	}
+	else
+	{
+		adv_request( ADV_REASON_BOOT );
+	}
+#if ( 1 == APP_SAMPLER )
+	sampler_init();
+	sampler_start();
+#endif /* ( 1 == APP_SAMPLER ) */
+	return ret;
+}
+
+bool sim_loop_once( void )
+{
+	if( false == recovery_poll() )
+	{
+		return false;
+	}
+	event_pump_run();
+	rx_queue_process();
+#if ( 1 == APP_SAMPLER )
+	sampler_poll();
+#endif /* ( 1 == APP_SAMPLER ) */
+#if ( 1 == APP_READ_CACHE )
+	read_cache_poll();
+#endif /* ( 1 == APP_READ_CACHE ) */
+	tx_queue_pump();
+#if ( 1 == APP_BENCH )
+	bench_run();
+#endif /* ( 1 == APP_BENCH ) */
+	conn_profile_poll();
+#if ( 1 == APP_SECURITY )
+	security_poll();
+#endif /* ( 1 == APP_SECURITY ) */
+	adv_poll();
+	if( g_btn_event )
+	{
+		g_btn_event = false;
+		if( link_any_subscribed( LINK_CCCD_DATA_TX ) )
+		{
+			static const uint8_t tx_health_data[] = { SAMPLER_FRAME_EVENT_BUTTON, 'h', 'l', 'g' };
+			tBleStatus ret = tx_queue_push( tx_health_data, sizeof( tx_health_data ) );
+			if( BLE_STATUS_SUCCESS != ret )
+			{
+				LOG_DEBUG("tx_queue_push dropped (%d)", ret);
+			}
+		}
+	}
+	return ( !event_pump_is_pending() && !rx_queue_is_ready() && !tx_queue_is_ready() && !adv_is_ready() && !g_btn_event
+#if ( 1 == APP_BENCH )
+	         && !bench_is_ready()
+#endif /* ( 1 == APP_BENCH ) */
+	       );
+}
+
+/* One pass, then the time it took or the sleep */
+static void sim_step( uint64_t end_ns )
+{
+	if( sim_loop_once() )
+	{
+		const uint64_t tick = ( ( sim_time_ns() / SIM_NS_PER_MS ) + 1U ) * SIM_NS_PER_MS;
+		const uint64_t due = sim_clock_next_due();
+		uint64_t wake = ( due > sim_time_ns() ) && ( due < tick ) ? due : tick;
+
+		sim_time_advance_to( ( wake < end_ns ) ? wake : end_ns );
+	}
+	else
+	{
+		sim_time_advance_ns( SIM_LOOP_NS );
+	}
+}
+
+void sim_run_ms( uint32_t ms )
+{
+	const uint64_t end = sim_time_ns() + ( (uint64_t)ms * SIM_NS_PER_MS );
+
+	while( sim_time_ns() < end )
+	{
+		sim_step( end );
+	}
+}
+
+bool sim_run_until( bool ( * cond )( void * arg ), void * arg, uint32_t timeout_ms )
+{
+	const uint64_t end = sim_time_ns() + ( (uint64_t)timeout_ms * SIM_NS_PER_MS );
+
+	while( false == cond( arg ) )
+	{
+		if( sim_time_ns() >= end )
+		{
+			return false;
+		}
+		sim_step( end );
+	}
+	return true;
+}
+
+void sim_button_press( void )
+{
+	HAL_GPIO_EXTI_Callback( B1_Pin );
+}
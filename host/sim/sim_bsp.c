@@ -0,0 +1,147 @@
+/*
+ * sim_bsp.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Passive board model: GPIO registers, EXTI / NVIC lines and an SPI bus with
+ * nothing on it. Used when the controller is reached through the aci_xxx /
+ * hci_xxx entry points of sim_controller.c; the SPI tests link
+ * sim_spi_slave.c instead, which models the BlueNRG-2 on the bus.
+ */
+
+#include "stm32f4xx_hal.h"
+#include "stm32f4xx_nucleo_bus.h"
+#include "sim.h"
+
+#define SIM_BSP_IPSR_PENDSV					( 14U )
+#define SIM_BSP_GPIO_READ_NS				( 100U )
+
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+GPIO_TypeDef host_gpioc;
+
+SPI_HandleTypeDef hspi1;
+DMA_HandleTypeDef hdma_spi1_rx;
+DMA_HandleTypeDef hdma_spi1_tx;
+
+void host_cpu_wait( void )
+{
+	sim_time_idle();
+}
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn )
+{
+	(void)IRQn;
+}
+
+void HAL_NVIC_DisableIRQ( IRQn_Type IRQn )
+{
+	(void)IRQn;
+}
+
+void HAL_NVIC_SetPendingIRQ( IRQn_Type IRQn )
+{
+	(void)IRQn;
+}
+
+void HAL_GPIO_Init( GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init )
+{
+	(void)GPIOx;
+	(void)GPIO_Init;
+}
+
+void HAL_GPIO_DeInit( GPIO_TypeDef * GPIOx, uint32_t GPIO_Pin )
+{
+	(void)GPIOx;
+	(void)GPIO_Pin;
+}
+
+/* One pass of a polling loop */
+GPIO_PinState HAL_GPIO_ReadPin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin )
+{
+	sim_time_advance_ns( SIM_BSP_GPIO_READ_NS );
+	return ( 0U != ( GPIOx->IDR & GPIO_Pin ) ) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState )
+{
+	if( GPIO_PIN_SET == PinState )
+	{
+		GPIOx->ODR |= GPIO_Pin;
+	}
+	else
+	{
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+	}
+}
+
+HAL_StatusTypeDef HAL_EXTI_GetHandle( EXTI_HandleTypeDef * hexti, uint32_t ExtiLine )
+{
+	hexti->Line = ExtiLine;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_EXTI_RegisterCallback( EXTI_HandleTypeDef * hexti, EXTI_CallbackIDTypeDef CallbackID, void ( * pPendingCbfn )( void ) )
+{
+	(void)CallbackID;
+	hexti->PendingCallback = pPendingCbfn;
+	return HAL_OK;
+}
+
+int32_t BSP_GetTick( void )
+{
+	return (int32_t)HAL_GetTick();
+}
+
+int32_t BSP_SPI1_Init( void )
+{
+	return BSP_ERROR_NONE;
+}
+
+int32_t BSP_SPI1_DeInit( void )
+{
+	return BSP_ERROR_NONE;
+}
+
+/* Nobody on the bus: MISO floats low */
+int32_t BSP_SPI1_SendRecv( uint8_t * pTxData, uint8_t * pRxData, uint16_t Length )
+{
+	(void)pTxData;
+	for( uint16_t i = 0; Length > i; i++ )
+	{
+		pRxData[i] = 0x00U;
+	}
+	return BSP_ERROR_NONE;
+}
+
+#if ( USE_BSP_SPI1_DMA == 1U )
+int32_t BSP_SPI1_SendRecv_DMA( uint8_t * pTxData, uint8_t * pRxData, uint16_t Length, BSP_SPI_XferCpltCb_t XferCpltCb )
+{
+	(void)BSP_SPI1_SendRecv( pTxData, pRxData, Length );
+	XferCpltCb( BSP_ERROR_NONE );
+	return BSP_ERROR_NONE;
+}
+
+int32_t BSP_SPI1_AbortDMA( void )
+{
+	return BSP_ERROR_NONE;
+}
+#endif /* ( USE_BSP_SPI1_DMA == 1U ) */
+
+/* Hung controller holding its IRQ line high with nothing to send: the
+ * EXTI0 edge, then the bottom half it pends (PendSV, run at once) reads
+ * empty frames until it masks the line and reports it. hci_init() (reset
+ * pin) releases the line */
+void sim_bsp_irq_stuck( void )
+{
+	const uint32_t ipsr = host_ipsr;
+
+	HCI_TL_SPI_IRQ_PORT->IDR |= HCI_TL_SPI_IRQ_PIN;
+	host_ipsr = 16U + (uint32_t)EXTI0_IRQn;
+	hci_tl_lowlevel_isr();
+	SCB->ICSR = 0;
+	host_ipsr = SIM_BSP_IPSR_PENDSV;
+	hci_tl_lowlevel_bottom_half();
+	host_ipsr = ipsr;
+}
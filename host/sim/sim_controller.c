@@ -0,0 +1,2138 @@
+/*
+ * sim_controller.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Simulated BlueNRG-2 behind the aci_xxx / hci_xxx commands of the
+ * application, and the centrals on the other side of the air.
+ *
+ * Model, in the order the application meets it:
+ *   - reset pin (hci_init()): aci_blue_initialized_event() after the boot
+ *     time, GATT database cleared, security database kept,
+ *   - GATT database with the BlueNRG-2 handle allocation: aci_gatt_init()
+ *     takes 0x0001..0x0004, aci_gap_init() 0x0005..0x000B, every service
+ *     reserves Max_Attribute_Records handles (declaration included) and its
+ *     characteristics take declaration, value and CCCD (notify / indicate)
+ *     in order,
+ *   - advertising events (advDelay, three channels) heard by scanning
+ *     centrals, high duty cycle directed advertising ended after 1.28 s,
+ *   - connections: procedures answered a number of connection intervals
+ *     later (MTU, features, DLE, PHY, L2CAP update, security), ATT
+ *     permissions enforced on the central requests,
+ *   - TX buffer pool counted in notifications: aci_gatt_update_char_value()
+ *     fails with BLE_STATUS_INSUFFICIENT_RESOURCES when it is short and
+ *     aci_gatt_tx_pool_available_event() follows once buffers are freed,
+ *   - connection events sending the queued notifications within the
+ *     interval, LL airtime per PDU from the PHY, the TX octets and the MIC.
+ *
+ * Events are scheduled with a due time and handed to the RX pool of
+ * sim_hci.c; the state change they report (connection closed, new interval,
+ * MTU...) is applied when they fall due, like in a controller that already
+ * acted when it reports. An event that finds the RX pool full is held with
+ * the IRQ line high until app_port_hci_irq_repend().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "hci.h"
+#include "hci_const.h"
+#include "bluenrg_conf.h"
+#include "bluenrg1_aci.h"
+#include "bluenrg1_hci_le.h"
+#include "bluenrg1_gap.h"
+#include "link_layer.h"
+#include "sim.h"
+
+#define SIM_INVALID_HANDLE				( 0xFFFFU )
+#define SIM_CONN_HANDLE_BASE			( 0x0801U )
+#define SIM_EVT_QUEUE_MAX					( 256U )
+#define SIM_EVT_PACKET_SIZE				( HCI_READ_PACKET_SIZE )
+#define SIM_TXQ_MAX								( 32U )
+#define SIM_SCANNERS_MAX					( 8U )
+#define SIM_BOND_CCCD_MAX					( 16U )
+
+/* Controller boot after the reset pin */
+#define SIM_BOOT_NS								( 8ULL * SIM_NS_PER_MS )
+/* ACI command on the SPI link and its command complete */
+#define SIM_COMMAND_NS_DEFAULT		( 60U * 1000U )
+/* SPI frames of hci_tl_interface.c: 5-byte header, then the HCI packet. A
+ * command is { 0x01, opcode, plen, params }, its command complete (or
+ * status) event { 0x04, evt, plen, ncmd, opcode, status, return params } */
+#define SIM_SPI_HEADER_LEN				( 5U )
+#define SIM_HCI_COMMAND_LEN( plen )	( 4U + ( plen ) )
+#define SIM_HCI_COMPLETE_LEN( rlen )	( 6U + ( rlen ) )
+#define SIM_UUID_LEN( uuid_type )	( ( UUID_TYPE_16 == ( uuid_type ) ) ? 2U : 16U )
+/* CONNECT_IND to the first connection event (transmit window) */
+#define SIM_CONNECT_DELAY_NS			( 1250ULL * SIM_NS_PER_US )
+/* Advertising */
+#define SIM_ADV_DELAY_MAX_US			( 10000U )
+#define SIM_ADV_DIRECTED_EVENT_NS	( 3750ULL * SIM_NS_PER_US )
+#define SIM_ADV_DIRECTED_NS				( 1280ULL * SIM_NS_PER_MS )
+#define SIM_ADV_RX_WINDOW_US			( 100U )
+/* Connection events: T_IFS and the margin kept before the next anchor */
+#define SIM_T_IFS_US							( 150U )
+#define SIM_EVENT_MARGIN_US				( 150U )
+#define SIM_SUPERVISION_TIMEOUT		( 500U )
+
+/* Procedures, in connection intervals after the request */
+#define SIM_PROC_FEATURES					( 1U )
+#define SIM_PROC_MTU							( 2U )
+#define SIM_PROC_DLE							( 2U )
+#define SIM_PROC_PHY							( 3U )
+#define SIM_PROC_L2CAP_RESP				( 1U )
+#define SIM_PROC_L2CAP_INSTANT		( 7U )
+#define SIM_PROC_TERMINATE				( 1U )
+#define SIM_PROC_RESUME						( 2U )
+#define SIM_PROC_BOND_LOST				( 2U )
+#define SIM_PROC_PAIR_ENC					( 6U )
+#define SIM_PROC_PAIR_DONE				( 8U )
+
+/* ATT error codes */
+#define SIM_ATT_INVALID_HANDLE		( 0x01U )
+#define SIM_ATT_READ_NOT_PERMITTED	( 0x02U )
+#define SIM_ATT_WRITE_NOT_PERMITTED	( 0x03U )
+#define SIM_ATT_INSUFF_AUTHEN			( 0x05U )
+#define SIM_ATT_INSUFF_KEY_SIZE		( 0x0CU )
+#define SIM_ATT_INVALID_LENGTH		( 0x0DU )
+#define SIM_ATT_UNLIKELY					( 0x0EU )
+#define SIM_ATT_INSUFF_ENCRYPTION	( 0x0FU )
+#define SIM_ATT_CCCD_IMPROPER			( 0xFDU )
+/* No answer within the ATT transaction timeout */
+#define SIM_ATT_TIMEOUT_MS				( 30000U )
+#define SIM_ATT_TIMEOUT						( 0xFFU )
+
+typedef struct
+{
+	uint64_t due;
+	bool applied;
+	bool held;										/* Waited for room in the RX pool */
+	uint16_t len;
+	uint8_t pkt[SIM_EVT_PACKET_SIZE];
+} sim_evt_t;
+
+typedef struct
+{
+	uint16_t attr;
+	uint16_t len;
+	uint16_t sent;								/* LL payload octets already sent */
+	uint8_t data[SIM_ATT_MTU_MAX];
+} sim_notification_t;
+
+typedef enum
+{
+	SIM_READ_IDLE = 0,
+	SIM_READ_WAIT,
+	SIM_READ_ALLOWED,
+	SIM_READ_DENIED,
+} sim_read_state_t;
+
+typedef struct
+{
+	bool used;
+	uint16_t handle;
+	sim_central_t * p_central;
+	uint16_t interval;
+	uint16_t latency;
+	uint16_t timeout;
+	uint16_t att_mtu;
+	bool mtu_exchanged;
+	uint16_t tx_octets;
+	uint8_t tx_phy;
+	bool encrypted;
+	bool l2cap_pending;
+	bool terminating;
+	bool rebond_wait;
+	uint64_t anchor_ns;
+	uint16_t cccd[SIM_GATT_MAX_HANDLES];
+	sim_notification_t txq[SIM_TXQ_MAX];
+	uint32_t txq_head;
+	uint32_t txq_count;
+	sim_read_state_t read_state;
+	uint8_t read_error;
+	uint64_t read_start_ns;
+	sim_conn_stats_t stats;
+} sim_conn_t;
+
+typedef struct
+{
+	bool used;
+	uint8_t addr_type;
+	uint8_t addr[6];
+	/* CCCD values kept for the bonded client */
+	uint8_t cccd_count;
+	uint16_t cccd_handle[SIM_BOND_CCCD_MAX];
+	uint16_t cccd_value[SIM_BOND_CCCD_MAX];
+} sim_bond_t;
+
+typedef enum
+{
+	SIM_ADV_OFF = 0,
+	SIM_ADV_UNDIRECTED,
+	SIM_ADV_DIRECTED,
+} sim_adv_mode_t;
+
+typedef struct
+{
+	sim_adv_mode_t mode;
+	uint16_t interval;
+	uint8_t payload;							/* AdvA + AdvData octets */
+	uint64_t start_ns;
+	uint64_t next_ns;
+	uint64_t directed_end_ns;
+	uint8_t peer_type;
+	uint8_t peer[6];
+} sim_adv_t;
+
+typedef struct
+{
+	sim_central_t * p_central;
+	uint64_t start_ns;
+	uint64_t interval_ns;
+	uint64_t window_ns;
+} sim_scanner_t;
+
+static sim_attr_t g_attrs[SIM_GATT_MAX_HANDLES];
+static uint16_t g_next_handle = 1;
+static bool g_gatt_init = false;
+static sim_gatt_call_t g_gatt_calls[SIM_GATT_CALLS_MAX];
+static uint32_t g_gatt_call_count;
+static bool g_gap_init = false;
+
+static sim_conn_t g_conns[SIM_MAX_CONNECTIONS];
+static sim_bond_t g_bonds[SIM_BOND_MAX];
+static sim_adv_t g_adv;
+static sim_scanner_t g_scanners[SIM_SCANNERS_MAX];
+
+static sim_evt_t g_evts[SIM_EVT_QUEUE_MAX];
+static uint32_t g_evt_count = 0;
+
+static uint8_t g_pool_size = SIM_TX_POOL_DEFAULT;
+static uint8_t g_pool_free = SIM_TX_POOL_DEFAULT;
+static bool g_pool_wait = false;
+
+static uint32_t g_command_ns = SIM_COMMAND_NS_DEFAULT;
+static uint32_t g_hung_commands = 0;
+static uint32_t g_prng = 1;
+static uint8_t g_public_addr[6];
+static sim_ctrl_stats_t g_stats;
+
+static void sim_ctrl_run_until( uint64_t now_ns );
+static uint64_t sim_ctrl_next_due( void );
+
+static const sim_clock_client_t g_ctrl_clock =
+{
+	.run_until = sim_ctrl_run_until,
+	.next_due = sim_ctrl_next_due,
+};
+
+static inline void put16( uint8_t * p, uint16_t v )
+{
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)( v >> 8 );
+}
+
+static inline uint16_t get16( const uint8_t * p )
+{
+	return (uint16_t)( p[0] | ( p[1] << 8 ) );
+}
+
+static uint32_t sim_rand( void )
+{
+	/* xorshift32 */
+	g_prng ^= g_prng << 13;
+	g_prng ^= g_prng >> 17;
+	g_prng ^= g_prng << 5;
+	return g_prng;
+}
+
+/* SPI traffic of the transport, as HCI_TL_SPI_GetStats() counts it: no
+ * retries, every frame taken whole */
+static void sim_spi_write( uint32_t len )
+{
+	g_stats.spi.tx_frames++;
+	g_stats.spi.tx_bytes += len;
+	g_stats.spi.wire_bytes += SIM_SPI_HEADER_LEN + len;
+}
+
+static void sim_spi_read( uint32_t len )
+{
+	g_stats.spi.rx_frames++;
+	g_stats.spi.rx_bytes += len;
+	g_stats.spi.wire_bytes += SIM_SPI_HEADER_LEN + len;
+}
+
+/* Every command: SPI write, controller processing, command complete read.
+ * param_len / return_len: parameters of the command and of its command
+ * complete, status included. BLE_STATUS_TIMEOUT while the controller is
+ * hung (sim_ctrl_hang_commands()): the command is not run */
+static tBleStatus sim_command( uint32_t param_len, uint32_t return_len )
+{
+	g_stats.commands++;
+	if( 0U != g_hung_commands )
+	{
+		/* Never taken: the middleware gives up on the command complete */
+		g_hung_commands--;
+		g_stats.spi.tx_timeouts++;
+		sim_time_advance_ns( (uint64_t)HCI_DEFAULT_TIMEOUT_MS * SIM_NS_PER_MS );
+		return BLE_STATUS_TIMEOUT;
+	}
+	sim_spi_write( SIM_HCI_COMMAND_LEN( param_len ) );
+	sim_spi_read( SIM_HCI_COMPLETE_LEN( return_len ) );
+	sim_time_advance_ns( g_command_ns );
+	return BLE_STATUS_SUCCESS;
+}
+
+/* ============================================================================
+ * Air time
+ * ==========================================================================*/
+/* One LL PDU: preamble, access address, header, payload, MIC, CRC */
+static uint64_t sim_pdu_air_ns( uint16_t payload, uint8_t phy, bool mic )
+{
+	const uint32_t octets = ( ( 2U == phy ) ? 2U : 1U ) + 4U + 2U + payload + ( mic ? 4U : 0U ) + 3U;
+	const uint32_t ns_per_octet = ( 2U == phy ) ? 4000U : 8000U;
+
+	return (uint64_t)octets * ns_per_octet;
+}
+
+/* Advertising event: PDU and receive window on the three channels */
+static uint64_t sim_adv_event_air_ns( uint8_t payload )
+{
+	return 3U * ( sim_pdu_air_ns( payload, 1U, false ) + ( ( SIM_T_IFS_US + SIM_ADV_RX_WINDOW_US ) * SIM_NS_PER_US ) );
+}
+
+/* ============================================================================
+ * Event queue
+ * ==========================================================================*/
+static void sim_evt_schedule( uint64_t due, const uint8_t * pkt, uint16_t len )
+{
+	uint32_t pos;
+
+	if( ( SIM_EVT_QUEUE_MAX <= g_evt_count ) || ( SIM_EVT_PACKET_SIZE < len ) )
+	{
+		fprintf( stderr, "sim_controller: event queue overflow\n" );
+		abort();
+	}
+	/* Sorted on the due time, same time keeps the order of scheduling */
+	pos = g_evt_count;
+	while( ( 0U < pos ) && ( g_evts[pos - 1U].due > due ) )
+	{
+		g_evts[pos] = g_evts[pos - 1U];
+		pos--;
+	}
+	g_evts[pos].due = due;
+	g_evts[pos].applied = false;
+	g_evts[pos].held = false;
+	g_evts[pos].len = len;
+	memcpy( g_evts[pos].pkt, pkt, len );
+	g_evt_count++;
+}
+
+/* HCI event: { 0x04, evt, plen, params } */
+static void sim_evt_hci( uint64_t due, uint8_t evt, const uint8_t * params, uint8_t plen )
+{
+	uint8_t pkt[SIM_EVT_PACKET_SIZE];
+
+	pkt[0] = HCI_EVENT_PKT;
+	pkt[1] = evt;
+	pkt[2] = plen;
+	memcpy( &pkt[3], params, plen );
+	sim_evt_schedule( due, pkt, (uint16_t)( 3U + plen ) );
+}
+
+static void sim_evt_le_meta( uint64_t due, uint8_t subevent, const uint8_t * params, uint8_t plen )
+{
+	uint8_t buf[SIM_EVT_PACKET_SIZE];
+
+	buf[0] = subevent;
+	memcpy( &buf[1], params, plen );
+	sim_evt_hci( due, EVT_LE_META_EVENT, buf, (uint8_t)( 1U + plen ) );
+}
+
+static void sim_evt_vendor( uint64_t due, uint16_t ecode, const uint8_t * params, uint8_t plen )
+{
+	uint8_t buf[SIM_EVT_PACKET_SIZE];
+
+	put16( buf, ecode );
+	memcpy( &buf[2], params, plen );
+	sim_evt_hci( due, EVT_VENDOR, buf, (uint8_t)( 2U + plen ) );
+}
+
+/* ============================================================================
+ * Database helpers
+ * ==========================================================================*/
+static sim_conn_t * sim_conn_find( uint16_t handle )
+{
+	uint32_t i;
+
+	for( i = 0; SIM_MAX_CONNECTIONS > i; i++ )
+	{
+		if( g_conns[i].used && ( handle == g_conns[i].handle ) )
+		{
+			return &g_conns[i];
+		}
+	}
+	return NULL;
+}
+
+static uint32_t sim_conn_count( void )
+{
+	uint32_t i;
+	uint32_t count = 0;
+
+	for( i = 0; SIM_MAX_CONNECTIONS > i; i++ )
+	{
+		count += g_conns[i].used ? 1U : 0U;
+	}
+	return count;
+}
+
+/* Time of n connection events from now on the current anchor */
+static uint64_t sim_conn_after( const sim_conn_t * p_conn, uint32_t events )
+{
+	return sim_time_ns() + ( (uint64_t)events * p_conn->interval * 1250U * SIM_NS_PER_US );
+}
+
+static uint64_t sim_conn_interval_ns( const sim_conn_t * p_conn )
+{
+	return (uint64_t)p_conn->interval * 1250U * SIM_NS_PER_US;
+}
+
+/* Empty connection events up to now: only counted */
+static void sim_conn_catch_up( sim_conn_t * p_conn, uint64_t now_ns )
+{
+	if( p_conn->anchor_ns < now_ns )
+	{
+		const uint64_t interval = sim_conn_interval_ns( p_conn );
+		const uint64_t events = ( now_ns - p_conn->anchor_ns + interval - 1U ) / interval;
+		p_conn->anchor_ns += events * interval;
+		p_conn->stats.conn_events += (uint32_t)events;
+	}
+}
+
+static sim_bond_t * sim_bond_find( uint8_t addr_type, const uint8_t addr[6] )
+{
+	uint32_t i;
+
+	for( i = 0; SIM_BOND_MAX > i; i++ )
+	{
+		if( g_bonds[i].used && ( addr_type == g_bonds[i].addr_type ) && ( 0 == memcmp( addr, g_bonds[i].addr, 6 ) ) )
+		{
+			return &g_bonds[i];
+		}
+	}
+	return NULL;
+}
+
+static sim_bond_t * sim_bond_store( uint8_t addr_type, const uint8_t addr[6] )
+{
+	sim_bond_t * p_bond = sim_bond_find( addr_type, addr );
+	uint32_t i;
+
+	for( i = 0; ( NULL == p_bond ) && ( SIM_BOND_MAX > i ); i++ )
+	{
+		if( false == g_bonds[i].used )
+		{
+			p_bond = &g_bonds[i];
+		}
+	}
+	if( NULL == p_bond )
+	{
+		/* Security database full: the oldest entry goes */
+		memmove( &g_bonds[0], &g_bonds[1], sizeof( g_bonds ) - sizeof( g_bonds[0] ) );
+		p_bond = &g_bonds[SIM_BOND_MAX - 1U];
+	}
+	memset( p_bond, 0, sizeof( *p_bond ) );
+	p_bond->used = true;
+	p_bond->addr_type = addr_type;
+	memcpy( p_bond->addr, addr, 6 );
+	return p_bond;
+}
+
+static sim_attr_t * sim_attr( uint16_t handle )
+{
+	if( ( 0U == handle ) || ( SIM_GATT_MAX_HANDLES <= handle ) || ( SIM_ATTR_FREE == g_attrs[handle].type ) )
+	{
+		return NULL;
+	}
+	return &g_attrs[handle];
+}
+
+static void sim_uuid_set( sim_attr_t * p_attr, uint8_t uuid_type, const uint8_t * uuid )
+{
+	p_attr->uuid_type = uuid_type;
+	memcpy( p_attr->uuid, uuid, ( UUID_TYPE_16 == uuid_type ) ? 2U : 16U );
+}
+
+/* Service declaration with Max_Attribute_Records handles reserved, 0 when full */
+static uint16_t sim_service_alloc( uint8_t uuid_type, const uint8_t * uuid, uint8_t records )
+{
+	const uint16_t handle = g_next_handle;
+	sim_attr_t * p_svc;
+
+	if( ( 0U == records ) || ( SIM_GATT_MAX_HANDLES < ( (uint32_t)handle + records ) ) )
+	{
+		return 0;
+	}
+	p_svc = &g_attrs[handle];
+	memset( p_svc, 0, sizeof( *p_svc ) );
+	p_svc->type = SIM_ATTR_SERVICE;
+	sim_uuid_set( p_svc, uuid_type, uuid );
+	p_svc->service = handle;
+	p_svc->records = records;
+	p_svc->end = (uint16_t)( handle + records - 1U );
+	p_svc->fill = (uint16_t)( handle + 1U );
+	g_next_handle = (uint16_t)( handle + records );
+	return handle;
+}
+
+static tBleStatus sim_char_alloc( uint16_t service, uint8_t uuid_type, const uint8_t * uuid, uint16_t value_len,
+                                  uint8_t properties, uint8_t permissions, uint8_t evt_mask, uint8_t key_size,
+                                  uint8_t is_variable, uint16_t * p_decl )
+{
+	sim_attr_t * p_svc = sim_attr( service );
+	const bool cccd = ( 0U != ( properties & ( CHAR_PROP_NOTIFY | CHAR_PROP_INDICATE ) ) );
+	const uint16_t needed = cccd ? 3U : 2U;
+	uint16_t decl;
+	sim_attr_t * p_attr;
+
+	if( ( NULL == p_svc ) || ( SIM_ATTR_SERVICE != p_svc->type ) )
+	{
+		return BLE_STATUS_INVALID_HANDLE;
+	}
+	if( SIM_ATTR_VALUE_MAX < value_len )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	/* Key size only checked (and used) with an encrypted permission */
+	if( ( ATTR_PERMISSION_NONE != ( permissions & ( ATTR_PERMISSION_ENCRY_READ | ATTR_PERMISSION_ENCRY_WRITE ) ) )
+	    && ( ( MIN_ENCRY_KEY_SIZE > key_size ) || ( MAX_ENCRY_KEY_SIZE < key_size ) ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	if( ( (uint32_t)p_svc->fill + needed - 1U ) > p_svc->end )
+	{
+		/* Max_Attribute_Records of the service used up */
+		return BLE_STATUS_INSUFFICIENT_RESOURCES;
+	}
+	decl = p_svc->fill;
+	p_svc->fill = (uint16_t)( p_svc->fill + needed );
+
+	for( uint16_t h = decl; ( decl + needed ) > h; h++ )
+	{
+		p_attr = &g_attrs[h];
+		memset( p_attr, 0, sizeof( *p_attr ) );
+		p_attr->service = service;
+		p_attr->decl = decl;
+		sim_uuid_set( p_attr, uuid_type, uuid );
+		p_attr->properties = properties;
+		p_attr->permissions = permissions;
+		p_attr->evt_mask = evt_mask;
+		p_attr->enc_key_size = key_size;
+		p_attr->is_variable = is_variable;
+		p_attr->max_len = value_len;
+		p_attr->len = ( CHAR_VALUE_LEN_VARIABLE == is_variable ) ? 0U : value_len;
+	}
+	g_attrs[decl].type = SIM_ATTR_CHAR_DECL;
+	g_attrs[decl + 1U].type = SIM_ATTR_CHAR_VALUE;
+	if( cccd )
+	{
+		g_attrs[decl + 2U].type = SIM_ATTR_CCCD;
+		g_attrs[decl + 2U].max_len = 2U;
+		g_attrs[decl + 2U].len = 2U;
+	}
+	*p_decl = decl;
+	return BLE_STATUS_SUCCESS;
+}
+
+static uint16_t sim_cccd_of( uint16_t decl )
+{
+	const sim_attr_t * p_cccd = sim_attr( (uint16_t)( decl + 2U ) );
+
+	return ( ( NULL != p_cccd ) && ( SIM_ATTR_CCCD == p_cccd->type ) && ( decl == p_cccd->decl ) ) ? (uint16_t)( decl + 2U ) : 0U;
+}
+
+/* ============================================================================
+ * Connections
+ * ==========================================================================*/
+static void sim_adv_stop( uint64_t at_ns )
+{
+	if( SIM_ADV_OFF != g_adv.mode )
+	{
+		g_stats.adv_on_ns += at_ns - g_adv.start_ns;
+		g_adv.mode = SIM_ADV_OFF;
+	}
+}
+
+static void sim_pool_release( uint16_t conn_handle, uint32_t buffers, uint64_t at_ns )
+{
+	uint8_t params[4];
+
+	g_pool_free = (uint8_t)( g_pool_free + buffers );
+	if( ( 0U != buffers ) && g_pool_wait )
+	{
+		g_pool_wait = false;
+		g_stats.pool_available++;
+		put16( &params[0], conn_handle );
+		put16( &params[2], g_pool_free );
+		sim_evt_vendor( at_ns, 0x0C16, params, sizeof( params ) );
+	}
+}
+
+/* Connection gone: CCCDs of a bonded client saved, buffers back to the pool */
+static void sim_conn_close( sim_conn_t * p_conn, bool report_pool )
+{
+	sim_central_t * p_central = p_conn->p_central;
+	sim_bond_t * p_bond = sim_bond_find( p_central->addr_type, p_central->addr );
+	const uint32_t queued = p_conn->txq_count;
+
+	if( ( NULL != p_bond ) && p_conn->encrypted )
+	{
+		p_bond->cccd_count = 0;
+		for( uint16_t h = 1; ( SIM_GATT_MAX_HANDLES > h ) && ( SIM_BOND_CCCD_MAX > p_bond->cccd_count ); h++ )
+		{
+			if( 0U != p_conn->cccd[h] )
+			{
+				p_bond->cccd_handle[p_bond->cccd_count] = h;
+				p_bond->cccd_value[p_bond->cccd_count] = p_conn->cccd[h];
+				p_bond->cccd_count++;
+			}
+		}
+	}
+	p_central->conn_handle = SIM_INVALID_HANDLE;
+	p_central->disconnected_ns = sim_time_ns();
+	p_conn->used = false;
+	if( report_pool )
+	{
+		sim_pool_release( p_conn->handle, queued, sim_time_ns() );
+	}
+	else
+	{
+		g_pool_free = (uint8_t)( g_pool_free + queued );
+	}
+}
+
+/* CONNECT_IND received at at_ns: the advertising stops, the connection
+ * complete event comes with the first connection event */
+static uint16_t sim_conn_create( sim_central_t * p_central, uint64_t at_ns )
+{
+	sim_conn_t * p_conn = NULL;
+	uint8_t params[18];
+	uint32_t i;
+
+	for( i = 0; ( SIM_MAX_CONNECTIONS > i ) && ( NULL == p_conn ); i++ )
+	{
+		if( false == g_conns[i].used )
+		{
+			p_conn = &g_conns[i];
+		}
+	}
+	if( NULL == p_conn )
+	{
+		return SIM_INVALID_HANDLE;
+	}
+	sim_adv_stop( at_ns );
+
+	memset( p_conn, 0, sizeof( *p_conn ) );
+	p_conn->used = true;
+	p_conn->handle = (uint16_t)( SIM_CONN_HANDLE_BASE + i - 1U );
+	p_conn->p_central = p_central;
+	p_conn->interval = p_central->conn_interval;
+	p_conn->latency = 0;
+	p_conn->timeout = SIM_SUPERVISION_TIMEOUT;
+	p_conn->att_mtu = 23U;
+	p_conn->tx_octets = 27U;
+	p_conn->tx_phy = 1U;
+	p_conn->anchor_ns = at_ns + SIM_CONNECT_DELAY_NS;
+
+	p_central->conn_handle = p_conn->handle;
+	p_central->connected_ns = p_conn->anchor_ns;
+
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], p_conn->handle );
+	params[3] = 0x01U;						/* Slave */
+	params[4] = p_central->addr_type;
+	memcpy( &params[5], p_central->addr, 6 );
+	put16( &params[11], p_conn->interval );
+	put16( &params[13], p_conn->latency );
+	put16( &params[15], p_conn->timeout );
+	params[17] = 0x00U;
+	sim_evt_le_meta( p_conn->anchor_ns, EVT_LE_CONN_COMPLETE, params, sizeof( params ) );
+	return p_conn->handle;
+}
+
+/* State change reported by an event, applied when it falls due */
+static void sim_evt_apply( const sim_evt_t * p_evt )
+{
+	const uint8_t * p = &p_evt->pkt[3];
+	sim_conn_t * p_conn;
+
+	switch( p_evt->pkt[1] )
+	{
+		case EVT_DISCONN_COMPLETE:
+			p_conn = sim_conn_find( get16( &p[1] ) );
+			if( NULL != p_conn )
+			{
+				sim_conn_close( p_conn, true );
+			}
+			break;
+
+		case EVT_ENCRYPT_CHANGE:
+			p_conn = sim_conn_find( get16( &p[1] ) );
+			if( NULL != p_conn )
+			{
+				const sim_central_t * p_central = p_conn->p_central;
+				const sim_bond_t * p_bond = sim_bond_find( p_central->addr_type, p_central->addr );
+				p_conn->encrypted = ( BLE_STATUS_SUCCESS == p[0] ) && ( 0U != p[3] );
+				p_conn->stats.encrypted = p_conn->encrypted;
+				/* Resumed bond: the CCCDs of the client come back */
+				if( p_conn->encrypted && ( NULL != p_bond ) && p_central->has_keys )
+				{
+					for( uint32_t i = 0; p_bond->cccd_count > i; i++ )
+					{
+						p_conn->cccd[p_bond->cccd_handle[i]] = p_bond->cccd_value[i];
+					}
+				}
+			}
+			break;
+
+		case EVT_LE_META_EVENT:
+			p_conn = sim_conn_find( get16( &p[( EVT_LE_DATA_LENGTH_CHANGE == p[0] ) ? 1U : 2U] ) );
+			if( NULL == p_conn )
+			{
+				break;
+			}
+			if( ( EVT_LE_CONN_UPDATE_COMPLETE == p[0] ) && ( BLE_STATUS_SUCCESS == p[1] ) )
+			{
+				sim_conn_catch_up( p_conn, sim_time_ns() );
+				p_conn->interval = get16( &p[4] );
+				p_conn->latency = get16( &p[6] );
+				p_conn->timeout = get16( &p[8] );
+			}
+			else if( EVT_LE_DATA_LENGTH_CHANGE == p[0] )
+			{
+				p_conn->tx_octets = get16( &p[3] );
+			}
+			else if( ( EVT_LE_PHY_UPDATE_COMPLETE == p[0] ) && ( BLE_STATUS_SUCCESS == p[1] ) )
+			{
+				p_conn->tx_phy = p[4];
+			}
+			break;
+
+		case EVT_VENDOR:
+			switch( get16( &p[0] ) )
+			{
+				case 0x0401:
+					/* Pairing complete: bonded on both sides */
+					p_conn = sim_conn_find( get16( &p[2] ) );
+					if( ( NULL != p_conn ) && ( SM_PAIRING_SUCCESS == p[4] ) )
+					{
+						(void)sim_bond_store( p_conn->p_central->addr_type, p_conn->p_central->addr );
+						p_conn->p_central->has_keys = true;
+					}
+					break;
+				case 0x0800:
+					p_conn = sim_conn_find( get16( &p[2] ) );
+					if( NULL != p_conn )
+					{
+						p_conn->l2cap_pending = false;
+					}
+					break;
+				case 0x0C03:
+					p_conn = sim_conn_find( get16( &p[2] ) );
+					if( NULL != p_conn )
+					{
+						p_conn->att_mtu = get16( &p[4] );
+					}
+					break;
+				default:
+					break;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/* Events due, into the RX pool while there is room (IRQ line held otherwise) */
+static void sim_evt_deliver( void )
+{
+	const uint64_t now = sim_time_ns();
+
+	while( ( 0U != g_evt_count ) && ( g_evts[0].due <= now ) && g_evts[0].applied )
+	{
+		sim_evt_t evt;
+
+		if( false == sim_hci_rx_room() )
+		{
+			if( false == g_evts[0].held )
+			{
+				g_evts[0].held = true;
+				g_stats.events_held++;
+			}
+			break;
+		}
+		evt = g_evts[0];
+		g_evt_count--;
+		memmove( &g_evts[0], &g_evts[1], g_evt_count * sizeof( g_evts[0] ) );
+		g_stats.events++;
+		sim_spi_read( evt.len );
+		(void)sim_hci_rx_push( evt.pkt, evt.len );
+	}
+}
+
+/* ============================================================================
+ * Connection events: queued notifications within the interval
+ * ==========================================================================*/
+static void sim_conn_event( sim_conn_t * p_conn )
+{
+	sim_central_t * p_central = p_conn->p_central;
+	const uint64_t start = p_conn->anchor_ns;
+	const uint64_t budget = sim_conn_interval_ns( p_conn ) - ( SIM_EVENT_MARGIN_US * SIM_NS_PER_US );
+	const uint64_t empty = sim_pdu_air_ns( 0, p_conn->tx_phy, false );
+	uint64_t used = 0;
+	uint32_t pdus = 0;
+	uint32_t freed = 0;
+
+	while( 0U != p_conn->txq_count )
+	{
+		sim_notification_t * p_ntf = &p_conn->txq[p_conn->txq_head];
+		/* ATT opcode + handle, L2CAP header */
+		const uint16_t total = (uint16_t)( p_ntf->len + 3U + 4U );
+		const uint16_t frag = ( ( total - p_ntf->sent ) < p_conn->tx_octets ) ? (uint16_t)( total - p_ntf->sent ) : p_conn->tx_octets;
+		const uint64_t cost = sim_pdu_air_ns( frag, p_conn->tx_phy, p_conn->encrypted ) + empty + ( 2U * SIM_T_IFS_US * SIM_NS_PER_US );
+
+		if( ( 0U != pdus ) && ( ( ( used + cost ) > budget ) || ( ( 0U != p_central->pdus_per_event ) && ( p_central->pdus_per_event <= pdus ) ) ) )
+		{
+			break;
+		}
+		used += cost;
+		pdus++;
+		p_ntf->sent = (uint16_t)( p_ntf->sent + frag );
+		if( total == p_ntf->sent )
+		{
+			p_central->notifications++;
+			p_central->notified_bytes += p_ntf->len;
+			p_conn->stats.notifications++;
+			if( NULL != p_central->on_notify )
+			{
+				p_central->on_notify( p_central, p_ntf->attr, p_ntf->data, p_ntf->len );
+			}
+			p_conn->txq_head = ( p_conn->txq_head + 1U ) % SIM_TXQ_MAX;
+			p_conn->txq_count--;
+			freed++;
+		}
+	}
+
+	p_conn->stats.conn_events++;
+	p_conn->stats.data_events++;
+	p_conn->stats.ll_pdus += pdus;
+	p_conn->stats.airtime_ns += used;
+	p_conn->anchor_ns += sim_conn_interval_ns( p_conn );
+	sim_pool_release( p_conn->handle, freed, start + used );
+}
+
+/* ============================================================================
+ * Advertising events
+ * ==========================================================================*/
+static bool sim_scanner_hears( const sim_scanner_t * p_scan, uint64_t at_ns )
+{
+	if( ( NULL == p_scan->p_central ) || ( at_ns < p_scan->start_ns ) || ( SIM_INVALID_HANDLE != p_scan->p_central->conn_handle ) )
+	{
+		return false;
+	}
+	return ( ( ( at_ns - p_scan->start_ns ) % p_scan->interval_ns ) < p_scan->window_ns );
+}
+
+static void sim_adv_event( void )
+{
+	const uint64_t at = g_adv.next_ns;
+	uint32_t i;
+
+	if( ( SIM_ADV_DIRECTED == g_adv.mode ) && ( at >= g_adv.directed_end_ns ) )
+	{
+		/* High duty cycle directed advertising ends with an advertising timeout */
+		uint8_t params[18];
+		memset( params, 0, sizeof( params ) );
+		params[0] = 0x3CU;
+		sim_adv_stop( g_adv.directed_end_ns );
+		g_stats.directed_timeouts++;
+		sim_evt_le_meta( g_adv.directed_end_ns, EVT_LE_CONN_COMPLETE, params, sizeof( params ) );
+		return;
+	}
+
+	g_stats.adv_events++;
+	g_stats.adv_airtime_ns += sim_adv_event_air_ns( g_adv.payload );
+
+	for( i = 0; SIM_SCANNERS_MAX > i; i++ )
+	{
+		sim_central_t * p_central = g_scanners[i].p_central;
+		if( false == sim_scanner_hears( &g_scanners[i], at ) )
+		{
+			continue;
+		}
+		if( ( SIM_ADV_DIRECTED == g_adv.mode )
+		 && ( ( g_adv.peer_type != p_central->addr_type ) || ( 0 != memcmp( g_adv.peer, p_central->addr, 6 ) ) ) )
+		{
+			continue;
+		}
+		g_scanners[i].p_central = NULL;
+		(void)sim_conn_create( p_central, at + sim_pdu_air_ns( g_adv.payload, 1U, false ) );
+		return;
+	}
+
+	if( SIM_ADV_DIRECTED == g_adv.mode )
+	{
+		g_adv.next_ns = at + SIM_ADV_DIRECTED_EVENT_NS;
+	}
+	else
+	{
+		/* advInterval + advDelay (0 .. 10 ms) */
+		g_adv.next_ns = at + ( (uint64_t)g_adv.interval * 625U * SIM_NS_PER_US )
+		              + ( ( sim_rand() % ( SIM_ADV_DELAY_MAX_US + 1U ) ) * SIM_NS_PER_US );
+	}
+}
+
+/* ============================================================================
+ * Clock client
+ * ==========================================================================*/
+static uint64_t sim_ctrl_next_due( void )
+{
+	uint64_t next = UINT64_MAX;
+	uint32_t i;
+
+	for( i = 0; g_evt_count > i; i++ )
+	{
+		if( false == g_evts[i].applied )
+		{
+			next = g_evts[i].due;
+			break;
+		}
+	}
+	if( ( SIM_ADV_OFF != g_adv.mode ) && ( g_adv.next_ns < next ) )
+	{
+		next = g_adv.next_ns;
+	}
+	if( ( SIM_ADV_DIRECTED == g_adv.mode ) && ( g_adv.directed_end_ns < next ) )
+	{
+		next = g_adv.directed_end_ns;
+	}
+	for( i = 0; SIM_MAX_CONNECTIONS > i; i++ )
+	{
+		if( g_conns[i].used && ( 0U != g_conns[i].txq_count ) && ( g_conns[i].anchor_ns < next ) )
+		{
+			next = g_conns[i].anchor_ns;
+		}
+	}
+	return next;
+}
+
+static void sim_ctrl_run_until( uint64_t now_ns )
+{
+	uint32_t i;
+
+	while( ( SIM_ADV_OFF != g_adv.mode )
+	    && ( ( g_adv.next_ns <= now_ns ) || ( ( SIM_ADV_DIRECTED == g_adv.mode ) && ( g_adv.directed_end_ns <= now_ns ) ) ) )
+	{
+		if( ( SIM_ADV_DIRECTED == g_adv.mode ) && ( g_adv.directed_end_ns <= now_ns ) )
+		{
+			g_adv.next_ns = g_adv.directed_end_ns;
+		}
+		sim_adv_event();
+	}
+
+	for( i = 0; SIM_MAX_CONNECTIONS > i; i++ )
+	{
+		sim_conn_t * p_conn = &g_conns[i];
+		while( p_conn->used && ( 0U != p_conn->txq_count ) && ( p_conn->anchor_ns <= now_ns ) )
+		{
+			sim_conn_event( p_conn );
+		}
+	}
+
+	for( i = 0; g_evt_count > i; i++ )
+	{
+		if( g_evts[i].due > now_ns )
+		{
+			break;
+		}
+		if( false == g_evts[i].applied )
+		{
+			g_evts[i].applied = true;
+			sim_evt_apply( &g_evts[i] );
+		}
+	}
+	sim_evt_deliver();
+}
+
+/* ============================================================================
+ * app_port.h: BlueNRG IRQ line
+ * ==========================================================================*/
+bool app_port_hci_irq_active( void )
+{
+	return ( 0U != g_evt_count ) && g_evts[0].applied && ( g_evts[0].due <= sim_time_ns() );
+}
+
+void app_port_hci_irq_repend( void )
+{
+	sim_evt_deliver();
+}
+
+/* ============================================================================
+ * Power / reset / configuration
+ * ==========================================================================*/
+static void sim_ctrl_clear( void )
+{
+	uint32_t i;
+
+	for( i = 0; SIM_MAX_CONNECTIONS > i; i++ )
+	{
+		if( g_conns[i].used )
+		{
+			/* Dropped without any event */
+			sim_conn_close( &g_conns[i], false );
+		}
+	}
+	for( i = 0; SIM_SCANNERS_MAX > i; i++ )
+	{
+		g_scanners[i].p_central = NULL;
+	}
+	sim_adv_stop( sim_time_ns() );
+	memset( g_attrs, 0, sizeof( g_attrs ) );
+	g_next_handle = 1;
+	g_gatt_init = false;
+	g_gatt_call_count = 0;
+	g_gap_init = false;
+	g_evt_count = 0;
+	g_pool_free = g_pool_size;
+	g_pool_wait = false;
+}
+
+void sim_ctrl_power_on( uint32_t seed )
+{
+	sim_ctrl_clear();
+	memset( g_bonds, 0, sizeof( g_bonds ) );
+	memset( &g_stats, 0, sizeof( g_stats ) );
+	g_prng = ( 0U != seed ) ? seed : 1U;
+	g_pool_size = SIM_TX_POOL_DEFAULT;
+	g_pool_free = g_pool_size;
+	g_command_ns = SIM_COMMAND_NS_DEFAULT;
+	g_hung_commands = 0;
+}
+
+void sim_ctrl_reset( void )
+{
+	const uint8_t reason = 0x01U;			/* Normal startup */
+
+	sim_clock_register( &g_ctrl_clock );
+	sim_ctrl_clear();
+	sim_evt_vendor( sim_time_ns() + SIM_BOOT_NS, 0x0001, &reason, 1U );
+}
+
+void sim_ctrl_set_tx_pool( uint8_t buffers )
+{
+	if( ( 0U == buffers ) || ( SIM_TXQ_MAX < buffers ) )
+	{
+		buffers = SIM_TX_POOL_DEFAULT;
+	}
+	g_pool_free = (uint8_t)( g_pool_free + buffers - g_pool_size );
+	g_pool_size = buffers;
+}
+
+void sim_ctrl_set_command_ns( uint32_t ns )
+{
+	g_command_ns = ns;
+}
+
+void sim_ctrl_hang_commands( uint32_t count )
+{
+	g_hung_commands = count;
+}
+
+void sim_ctrl_get_stats( sim_ctrl_stats_t * p_stats )
+{
+	*p_stats = g_stats;
+	if( SIM_ADV_OFF != g_adv.mode )
+	{
+		p_stats->adv_on_ns += sim_time_ns() - g_adv.start_ns;
+	}
+}
+
+void sim_ctrl_clear_stats( void )
+{
+	memset( &g_stats, 0, sizeof( g_stats ) );
+	if( SIM_ADV_OFF != g_adv.mode )
+	{
+		g_adv.start_ns = sim_time_ns();
+	}
+}
+
+bool sim_ctrl_is_advertising( void )
+{
+	return ( SIM_ADV_OFF != g_adv.mode );
+}
+
+const sim_attr_t * sim_gatt_attr( uint16_t handle )
+{
+	return sim_attr( handle );
+}
+
+uint16_t sim_gatt_next_handle( void )
+{
+	return g_next_handle;
+}
+
+uint32_t sim_gatt_calls( const sim_gatt_call_t ** pp_calls )
+{
+	*pp_calls = g_gatt_calls;
+	return g_gatt_call_count;
+}
+
+uint16_t sim_gatt_find_uuid( uint8_t uuid_type, const uint8_t * uuid, sim_attr_type_t type )
+{
+	for( uint16_t h = 1; SIM_GATT_MAX_HANDLES > h; h++ )
+	{
+		const sim_attr_t * p_attr = &g_attrs[h];
+		if( ( type == p_attr->type ) && ( uuid_type == p_attr->uuid_type )
+		 && ( 0 == memcmp( uuid, p_attr->uuid, ( UUID_TYPE_16 == uuid_type ) ? 2U : 16U ) ) )
+		{
+			return h;
+		}
+	}
+	return 0;
+}
+
+uint8_t sim_bond_count( void )
+{
+	uint8_t count = 0;
+
+	for( uint32_t i = 0; SIM_BOND_MAX > i; i++ )
+	{
+		count = (uint8_t)( count + ( g_bonds[i].used ? 1U : 0U ) );
+	}
+	return count;
+}
+
+bool sim_bond_add( uint8_t addr_type, const uint8_t addr[6] )
+{
+	return ( NULL != sim_bond_store( addr_type, addr ) );
+}
+
+/* ============================================================================
+ * HAL / HCI commands
+ * ==========================================================================*/
+tBleStatus aci_hal_write_config_data( uint8_t Offset, uint8_t Length, uint8_t Value[] )
+{
+	if( BLE_STATUS_SUCCESS != sim_command( 2U + Length, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( CONFIG_DATA_PUBADDR_OFFSET != Offset ) || ( CONFIG_DATA_PUBADDR_LEN != Length ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	memcpy( g_public_addr, Value, sizeof( g_public_addr ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus hci_reset( void )
+{
+	if( BLE_STATUS_SUCCESS != sim_command( 0U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus hci_le_read_remote_features( uint16_t Connection_Handle )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[11];
+
+	if( BLE_STATUS_SUCCESS != sim_command( 2U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	memset( params, 0, sizeof( params ) );
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], Connection_Handle );
+	params[3] = p_conn->p_central->dle ? 0x20U : 0x00U;
+	params[4] = p_conn->p_central->phy_2m ? 0x01U : 0x00U;
+	sim_evt_le_meta( sim_conn_after( p_conn, SIM_PROC_FEATURES ), EVT_LE_READ_REMOTE_USED_FEATURES_COMPLETE, params, sizeof( params ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus hci_le_set_data_length( uint16_t Connection_Handle, uint16_t TxOctets, uint16_t TxTime )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[10];
+
+	if( BLE_STATUS_SUCCESS != sim_command( 6U, 3U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( ( 27U > TxOctets ) || ( 251U < TxOctets ) || ( 328U > TxTime ) || ( 2120U < TxTime ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	/* A central without DLE keeps 27 octets: no change, no event */
+	if( p_conn->p_central->dle )
+	{
+		put16( &params[0], Connection_Handle );
+		put16( &params[2], TxOctets );
+		put16( &params[4], TxTime );
+		put16( &params[6], 251U );
+		put16( &params[8], 2120U );
+		sim_evt_le_meta( sim_conn_after( p_conn, SIM_PROC_DLE ), EVT_LE_DATA_LENGTH_CHANGE, params, sizeof( params ) );
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus hci_le_set_phy( uint16_t Connection_Handle, uint8_t ALL_PHYS, uint8_t TX_PHYS, uint8_t RX_PHYS, uint16_t PHY_options )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[5];
+
+	(void)ALL_PHYS;
+	(void)RX_PHYS;
+	(void)PHY_options;
+	if( BLE_STATUS_SUCCESS != sim_command( 7U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], Connection_Handle );
+	params[3] = ( p_conn->p_central->phy_2m && ( 0U != ( TX_PHYS & 0x02U ) ) ) ? 2U : 1U;
+	params[4] = params[3];
+	sim_evt_le_meta( sim_conn_after( p_conn, SIM_PROC_PHY ), EVT_LE_PHY_UPDATE_COMPLETE, params, sizeof( params ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_l2cap_connection_parameter_update_req( uint16_t Connection_Handle, uint16_t Conn_Interval_Min,
+                                                      uint16_t Conn_Interval_Max, uint16_t Slave_latency,
+                                                      uint16_t Timeout_Multiplier )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[9];
+
+	if( BLE_STATUS_SUCCESS != sim_command( 10U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( ( 6U > Conn_Interval_Min ) || ( Conn_Interval_Min > Conn_Interval_Max ) || ( 3200U < Conn_Interval_Max ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	if( p_conn->l2cap_pending )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->l2cap_pending = true;
+
+	put16( &params[0], Connection_Handle );
+	put16( &params[2], p_conn->p_central->accept_params ? 0x0000U : 0x0001U );
+	sim_evt_vendor( sim_conn_after( p_conn, SIM_PROC_L2CAP_RESP ), 0x0800, params, 4U );
+	if( p_conn->p_central->accept_params )
+	{
+		/* The central picks the shortest interval of the range */
+		params[0] = BLE_STATUS_SUCCESS;
+		put16( &params[1], Connection_Handle );
+		put16( &params[3], Conn_Interval_Min );
+		put16( &params[5], Slave_latency );
+		put16( &params[7], Timeout_Multiplier );
+		sim_evt_le_meta( sim_conn_after( p_conn, SIM_PROC_L2CAP_INSTANT ), EVT_LE_CONN_UPDATE_COMPLETE, params, sizeof( params ) );
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+/* ============================================================================
+ * GAP commands
+ * ==========================================================================*/
+tBleStatus aci_gap_init( uint8_t Role, uint8_t privacy_enabled, uint8_t device_name_char_len,
+                         uint16_t * Service_Handle, uint16_t * Dev_Name_Char_Handle, uint16_t * Appearance_Char_Handle )
+{
+	const uint8_t gap_uuid[2] = { 0x00, 0x18 };
+	const uint8_t name_uuid[2] = { 0x00, 0x2A };
+	const uint8_t appearance_uuid[2] = { 0x01, 0x2A };
+	const uint8_t ppcp_uuid[2] = { 0x04, 0x2A };
+	uint16_t service;
+	uint16_t ppcp;
+
+	(void)Role;
+	(void)privacy_enabled;
+	if( BLE_STATUS_SUCCESS != sim_command( 3U, 7U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( false == g_gatt_init ) || g_gap_init )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	/* Service, device name, appearance, peripheral preferred connection parameters */
+	service = sim_service_alloc( UUID_TYPE_16, gap_uuid, 7U );
+	if( ( 0U == service )
+	 || ( BLE_STATUS_SUCCESS != sim_char_alloc( service, UUID_TYPE_16, name_uuid, device_name_char_len, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                                            GATT_DONT_NOTIFY_EVENTS, MAX_ENCRY_KEY_SIZE, CHAR_VALUE_LEN_VARIABLE, Dev_Name_Char_Handle ) )
+	 || ( BLE_STATUS_SUCCESS != sim_char_alloc( service, UUID_TYPE_16, appearance_uuid, 2U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                                            GATT_DONT_NOTIFY_EVENTS, MAX_ENCRY_KEY_SIZE, CHAR_VALUE_LEN_CONSTANT, Appearance_Char_Handle ) )
+	 || ( BLE_STATUS_SUCCESS != sim_char_alloc( service, UUID_TYPE_16, ppcp_uuid, 8U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                                            GATT_DONT_NOTIFY_EVENTS, MAX_ENCRY_KEY_SIZE, CHAR_VALUE_LEN_CONSTANT, &ppcp ) ) )
+	{
+		return BLE_STATUS_INSUFFICIENT_RESOURCES;
+	}
+	*Service_Handle = service;
+	g_gap_init = true;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_set_io_capability( uint8_t IO_Capability )
+{
+	if( BLE_STATUS_SUCCESS != sim_command( 1U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	return ( 0x04U < IO_Capability ) ? BLE_STATUS_INVALID_PARAMS : BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_set_authentication_requirement( uint8_t Bonding_Mode, uint8_t MITM_Mode, uint8_t SC_Support,
+                                                   uint8_t KeyPress_Notification_Support, uint8_t Min_Encryption_Key_Size,
+                                                   uint8_t Max_Encryption_Key_Size, uint8_t Use_Fixed_Pin, uint32_t Fixed_Pin,
+                                                   uint8_t Identity_Address_Type )
+{
+	(void)Bonding_Mode;
+	(void)MITM_Mode;
+	(void)SC_Support;
+	(void)KeyPress_Notification_Support;
+	(void)Use_Fixed_Pin;
+	(void)Fixed_Pin;
+	(void)Identity_Address_Type;
+	if( BLE_STATUS_SUCCESS != sim_command( 12U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( MIN_ENCRY_KEY_SIZE > Min_Encryption_Key_Size ) || ( Min_Encryption_Key_Size > Max_Encryption_Key_Size )
+	 || ( MAX_ENCRY_KEY_SIZE < Max_Encryption_Key_Size ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_set_discoverable( uint8_t Advertising_Type, uint16_t Advertising_Interval_Min, uint16_t Advertising_Interval_Max,
+                                     uint8_t Own_Address_Type, uint8_t Advertising_Filter_Policy, uint8_t Local_Name_Length,
+                                     uint8_t Local_Name[], uint8_t Service_Uuid_length, uint8_t Service_Uuid_List[],
+                                     uint16_t Slave_Conn_Interval_Min, uint16_t Slave_Conn_Interval_Max )
+{
+	(void)Own_Address_Type;
+	(void)Advertising_Filter_Policy;
+	(void)Local_Name;
+	(void)Service_Uuid_List;
+	if( BLE_STATUS_SUCCESS != sim_command( 13U + Local_Name_Length + Service_Uuid_length, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( SIM_ADV_OFF != g_adv.mode ) || ( SIM_MAX_CONNECTIONS <= sim_conn_count() ) )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	if( ( ADV_IND != Advertising_Type ) || ( 0x20U > Advertising_Interval_Min ) || ( Advertising_Interval_Min > Advertising_Interval_Max ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	g_adv.mode = SIM_ADV_UNDIRECTED;
+	g_adv.interval = Advertising_Interval_Min;
+	/* AdvA, flags, local name, service UUIDs, slave connection interval range */
+	g_adv.payload = (uint8_t)( 6U + 3U + ( ( 0U != Local_Name_Length ) ? ( 1U + Local_Name_Length ) : 0U )
+	                         + ( ( 0U != Service_Uuid_length ) ? ( 1U + Service_Uuid_length ) : 0U )
+	                         + ( ( 0U != ( Slave_Conn_Interval_Min | Slave_Conn_Interval_Max ) ) ? 6U : 0U ) );
+	g_adv.start_ns = sim_time_ns();
+	g_adv.next_ns = g_adv.start_ns;
+	g_stats.adv_starts++;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_set_direct_connectable( uint8_t Own_Address_Type, uint8_t Directed_Advertising_Type, uint8_t Direct_Address_Type,
+                                           uint8_t Direct_Address[6], uint16_t Advertising_Interval_Min, uint16_t Advertising_Interval_Max )
+{
+	(void)Own_Address_Type;
+	(void)Advertising_Interval_Min;
+	(void)Advertising_Interval_Max;
+	if( BLE_STATUS_SUCCESS != sim_command( 13U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( SIM_ADV_OFF != g_adv.mode ) || ( SIM_MAX_CONNECTIONS <= sim_conn_count() ) )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	if( HIGH_DUTY_CYCLE_DIRECTED_ADV != Directed_Advertising_Type )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	g_adv.mode = SIM_ADV_DIRECTED;
+	g_adv.payload = 12U;					/* AdvA + TargetA */
+	g_adv.peer_type = Direct_Address_Type;
+	memcpy( g_adv.peer, Direct_Address, sizeof( g_adv.peer ) );
+	g_adv.start_ns = sim_time_ns();
+	g_adv.next_ns = g_adv.start_ns;
+	g_adv.directed_end_ns = g_adv.start_ns + SIM_ADV_DIRECTED_NS;
+	g_stats.adv_starts++;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_set_non_discoverable( void )
+{
+	if( BLE_STATUS_SUCCESS != sim_command( 0U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( SIM_ADV_OFF == g_adv.mode )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	sim_adv_stop( sim_time_ns() );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_terminate( uint16_t Connection_Handle, uint8_t Reason )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[4];
+
+	(void)Reason;
+	if( BLE_STATUS_SUCCESS != sim_command( 3U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( p_conn->terminating )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->terminating = true;
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], Connection_Handle );
+	params[3] = 0x16U;						/* Connection terminated by local host */
+	sim_evt_hci( sim_conn_after( p_conn, SIM_PROC_TERMINATE ), EVT_DISCONN_COMPLETE, params, sizeof( params ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+/* Pairing answered by the central: encryption first, pairing complete after */
+static void sim_pairing_schedule( sim_conn_t * p_conn )
+{
+	uint8_t params[4];
+
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], p_conn->handle );
+	params[3] = 0x01U;
+	sim_evt_hci( sim_conn_after( p_conn, SIM_PROC_PAIR_ENC ), EVT_ENCRYPT_CHANGE, params, sizeof( params ) );
+
+	put16( &params[0], p_conn->handle );
+	params[2] = SM_PAIRING_SUCCESS;
+	params[3] = 0x00U;
+	sim_evt_vendor( sim_conn_after( p_conn, SIM_PROC_PAIR_DONE ), 0x0401, params, 3U );
+}
+
+tBleStatus aci_gap_slave_security_req( uint16_t Connection_Handle )
+{
+	sim_conn_t * p_conn;
+	const sim_central_t * p_central;
+	uint8_t params[4];
+
+	if( BLE_STATUS_SUCCESS != sim_command( 2U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	p_central = p_conn->p_central;
+	if( p_conn->encrypted || ( false == p_central->pairs ) )
+	{
+		return BLE_STATUS_SUCCESS;
+	}
+
+	if( NULL == sim_bond_find( p_central->addr_type, p_central->addr ) )
+	{
+		sim_pairing_schedule( p_conn );
+	}
+	else if( p_central->has_keys )
+	{
+		/* Bond resumed: encryption with the stored LTK, no pairing */
+		params[0] = BLE_STATUS_SUCCESS;
+		put16( &params[1], Connection_Handle );
+		params[3] = 0x01U;
+		sim_evt_hci( sim_conn_after( p_conn, SIM_PROC_RESUME ), EVT_ENCRYPT_CHANGE, params, sizeof( params ) );
+	}
+	else
+	{
+		/* The central lost its keys and pairs again: the host must allow it */
+		p_conn->rebond_wait = true;
+		sim_evt_vendor( sim_conn_after( p_conn, SIM_PROC_BOND_LOST ), 0x0405, params, 0U );
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_allow_rebond( uint16_t Connection_Handle )
+{
+	sim_conn_t * p_conn;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 2U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( false == p_conn->rebond_wait )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->rebond_wait = false;
+	sim_pairing_schedule( p_conn );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_clear_security_db( void )
+{
+	if( BLE_STATUS_SUCCESS != sim_command( 0U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	memset( g_bonds, 0, sizeof( g_bonds ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gap_get_bonded_devices( uint8_t * Num_of_Addresses, Bonded_Device_Entry_t Bonded_Device_Entry[] )
+{
+	uint8_t count = 0;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 0U, 2U + ( 7U * sim_bond_count() ) ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	for( uint32_t i = 0; SIM_BOND_MAX > i; i++ )
+	{
+		if( g_bonds[i].used )
+		{
+			Bonded_Device_Entry[count].Address_Type = g_bonds[i].addr_type;
+			memcpy( Bonded_Device_Entry[count].Address, g_bonds[i].addr, 6 );
+			count++;
+		}
+	}
+	*Num_of_Addresses = count;
+	return BLE_STATUS_SUCCESS;
+}
+
+/* ============================================================================
+ * GATT commands
+ * ==========================================================================*/
+tBleStatus aci_gatt_init( void )
+{
+	const uint8_t gatt_uuid[2] = { 0x01, 0x18 };
+	const uint8_t changed_uuid[2] = { 0x05, 0x2A };
+	uint16_t service;
+	uint16_t changed;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 0U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( g_gatt_init )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	/* GATT service with the service changed characteristic: 0x0001 .. 0x0004 */
+	service = sim_service_alloc( UUID_TYPE_16, gatt_uuid, 4U );
+	(void)sim_char_alloc( service, UUID_TYPE_16, changed_uuid, 4U, CHAR_PROP_INDICATE, ATTR_PERMISSION_NONE,
+	                      GATT_DONT_NOTIFY_EVENTS, MAX_ENCRY_KEY_SIZE, CHAR_VALUE_LEN_CONSTANT, &changed );
+	g_gatt_init = true;
+	return BLE_STATUS_SUCCESS;
+}
+
+/* Appends a call to the log, NULL once it is full */
+static sim_gatt_call_t * sim_gatt_call_log( bool service, uint8_t uuid_type, const uint8_t * uuid )
+{
+	sim_gatt_call_t * p_call;
+
+	if( SIM_GATT_CALLS_MAX <= g_gatt_call_count )
+	{
+		return NULL;
+	}
+	p_call = &g_gatt_calls[g_gatt_call_count++];
+	memset( p_call, 0, sizeof( *p_call ) );
+	p_call->service = service;
+	p_call->uuid_type = uuid_type;
+	memcpy( p_call->uuid, uuid, ( UUID_TYPE_16 == uuid_type ) ? 2U : 16U );
+	return p_call;
+}
+
+static tBleStatus sim_gatt_add_service( uint8_t Service_UUID_Type, Service_UUID_t * Service_UUID, uint8_t Service_Type,
+                                        uint8_t Max_Attribute_Records, uint16_t * Service_Handle )
+{
+	uint16_t handle;
+
+	if( false == g_gatt_init )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	if( ( ( UUID_TYPE_16 != Service_UUID_Type ) && ( UUID_TYPE_128 != Service_UUID_Type ) ) || ( PRIMARY_SERVICE != Service_Type ) )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+	handle = sim_service_alloc( Service_UUID_Type, (const uint8_t *)Service_UUID, Max_Attribute_Records );
+	if( 0U == handle )
+	{
+		return ( 0U == Max_Attribute_Records ) ? BLE_STATUS_INVALID_PARAMS : BLE_STATUS_OUT_OF_HANDLE;
+	}
+	*Service_Handle = handle;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gatt_add_service( uint8_t Service_UUID_Type, Service_UUID_t * Service_UUID, uint8_t Service_Type,
+                                 uint8_t Max_Attribute_Records, uint16_t * Service_Handle )
+{
+	sim_gatt_call_t * p_call = sim_gatt_call_log( true, Service_UUID_Type, (const uint8_t *)Service_UUID );
+	tBleStatus ret;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 3U + SIM_UUID_LEN( Service_UUID_Type ), 3U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	ret = sim_gatt_add_service( Service_UUID_Type, Service_UUID, Service_Type, Max_Attribute_Records, Service_Handle );
+	if( NULL != p_call )
+	{
+		p_call->records = Max_Attribute_Records;
+		p_call->status = ret;
+		p_call->handle = ( BLE_STATUS_SUCCESS == ret ) ? *Service_Handle : 0U;
+	}
+	return ret;
+}
+
+tBleStatus aci_gatt_add_char( uint16_t Service_Handle, uint8_t Char_UUID_Type, Char_UUID_t * Char_UUID, uint16_t Char_Value_Length,
+                              uint8_t Char_Properties, uint8_t Security_Permissions, uint8_t GATT_Evt_Mask, uint8_t Enc_Key_Size,
+                              uint8_t Is_Variable, uint16_t * Char_Handle )
+{
+	sim_gatt_call_t * p_call = sim_gatt_call_log( false, Char_UUID_Type, (const uint8_t *)Char_UUID );
+	tBleStatus ret;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 10U + SIM_UUID_LEN( Char_UUID_Type ), 3U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	if( ( UUID_TYPE_16 != Char_UUID_Type ) && ( UUID_TYPE_128 != Char_UUID_Type ) )
+	{
+		ret = BLE_STATUS_INVALID_PARAMS;
+	}
+	else
+	{
+		ret = sim_char_alloc( Service_Handle, Char_UUID_Type, (const uint8_t *)Char_UUID, Char_Value_Length, Char_Properties,
+		                      Security_Permissions, GATT_Evt_Mask, Enc_Key_Size, Is_Variable, Char_Handle );
+	}
+	if( NULL != p_call )
+	{
+		p_call->parent = Service_Handle;
+		p_call->value_len = Char_Value_Length;
+		p_call->properties = Char_Properties;
+		p_call->permissions = Security_Permissions;
+		p_call->evt_mask = GATT_Evt_Mask;
+		p_call->enc_key_size = Enc_Key_Size;
+		p_call->is_variable = Is_Variable;
+		p_call->status = ret;
+		p_call->handle = ( BLE_STATUS_SUCCESS == ret ) ? *Char_Handle : 0U;
+	}
+	return ret;
+}
+
+tBleStatus aci_gatt_update_char_value( uint16_t Service_Handle, uint16_t Char_Handle, uint8_t Val_Offset,
+                                       uint8_t Char_Value_Length, uint8_t Char_Value[] )
+{
+	sim_attr_t * p_decl;
+	sim_attr_t * p_value;
+	uint16_t cccd;
+	uint32_t subscribed = 0;
+	uint32_t i;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 6U + Char_Value_Length, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_decl = sim_attr( Char_Handle );
+	if( ( NULL == p_decl ) || ( SIM_ATTR_CHAR_DECL != p_decl->type ) || ( Service_Handle != p_decl->service ) )
+	{
+		return BLE_STATUS_INVALID_HANDLE;
+	}
+	p_value = &g_attrs[Char_Handle + 1U];
+	if( ( (uint32_t)Val_Offset + Char_Value_Length ) > p_value->max_len )
+	{
+		return BLE_STATUS_INVALID_PARAMS;
+	}
+
+	/* One TX buffer per subscribed client */
+	cccd = sim_cccd_of( Char_Handle );
+	for( i = 0; ( 0U != cccd ) && ( SIM_MAX_CONNECTIONS > i ); i++ )
+	{
+		subscribed += ( g_conns[i].used && ( 0U != g_conns[i].cccd[cccd] ) ) ? 1U : 0U;
+	}
+	if( subscribed > g_pool_free )
+	{
+		g_stats.pool_full++;
+		g_pool_wait = true;
+		return BLE_STATUS_INSUFFICIENT_RESOURCES;
+	}
+
+	memcpy( &p_value->value[Val_Offset], Char_Value, Char_Value_Length );
+	if( CHAR_VALUE_LEN_VARIABLE == p_value->is_variable )
+	{
+		p_value->len = (uint16_t)( Val_Offset + Char_Value_Length );
+	}
+
+	for( i = 0; ( 0U != subscribed ) && ( SIM_MAX_CONNECTIONS > i ); i++ )
+	{
+		sim_conn_t * p_conn = &g_conns[i];
+		sim_notification_t * p_ntf;
+		const uint16_t room = (uint16_t)( p_conn->att_mtu - 3U );
+
+		if( ( false == p_conn->used ) || ( 0U == p_conn->cccd[cccd] ) )
+		{
+			continue;
+		}
+		if( 0U == p_conn->txq_count )
+		{
+			/* Idle link: the next connection event sends it */
+			sim_conn_catch_up( p_conn, sim_time_ns() );
+		}
+		p_ntf = &p_conn->txq[( p_conn->txq_head + p_conn->txq_count ) % SIM_TXQ_MAX];
+		p_ntf->attr = (uint16_t)( Char_Handle + 1U );
+		p_ntf->len = ( p_value->len > room ) ? room : p_value->len;
+		p_ntf->sent = 0;
+		memcpy( p_ntf->data, p_value->value, p_ntf->len );
+		if( p_value->len > room )
+		{
+			p_conn->stats.truncated++;
+		}
+		p_conn->txq_count++;
+		g_pool_free--;
+	}
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gatt_allow_read( uint16_t Connection_Handle )
+{
+	sim_conn_t * p_conn;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 2U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( SIM_READ_WAIT != p_conn->read_state )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->read_state = SIM_READ_ALLOWED;
+	p_conn->stats.read_latency_ns = sim_time_ns() - p_conn->read_start_ns;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gatt_deny_read( uint16_t Connection_Handle, uint8_t Error_Code )
+{
+	sim_conn_t * p_conn;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 3U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( SIM_READ_WAIT != p_conn->read_state )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->read_state = SIM_READ_DENIED;
+	p_conn->read_error = Error_Code;
+	p_conn->stats.read_latency_ns = sim_time_ns() - p_conn->read_start_ns;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gatt_exchange_config( uint16_t Connection_Handle )
+{
+	sim_conn_t * p_conn;
+	uint8_t params[4];
+	uint16_t mtu;
+
+	if( BLE_STATUS_SUCCESS != sim_command( 2U, 1U ) )
+	{
+		return BLE_STATUS_TIMEOUT;
+	}
+	p_conn = sim_conn_find( Connection_Handle );
+	if( NULL == p_conn )
+	{
+		return BLE_STATUS_UNKNOWN_CONNECTION_ID;
+	}
+	if( p_conn->mtu_exchanged )
+	{
+		return BLE_STATUS_NOT_ALLOWED;
+	}
+	p_conn->mtu_exchanged = true;
+	mtu = ( p_conn->p_central->att_mtu < SIM_ATT_MTU_MAX ) ? p_conn->p_central->att_mtu : SIM_ATT_MTU_MAX;
+	if( 23U > mtu )
+	{
+		mtu = 23U;
+	}
+	put16( &params[0], Connection_Handle );
+	put16( &params[2], mtu );
+	sim_evt_vendor( sim_conn_after( p_conn, SIM_PROC_MTU ), 0x0C03, params, sizeof( params ) );
+	return BLE_STATUS_SUCCESS;
+}
+
+/* ============================================================================
+ * Central side
+ * ==========================================================================*/
+void sim_central_init( sim_central_t * p_central, uint8_t addr_last )
+{
+	const uint8_t addr[6] = { addr_last, 0x00, 0x00, 0xE1, 0x80, 0x02 };
+
+	memset( p_central, 0, sizeof( *p_central ) );
+	p_central->addr_type = PUBLIC_ADDR;
+	memcpy( p_central->addr, addr, sizeof( addr ) );
+	p_central->att_mtu = SIM_ATT_MTU_MAX;
+	p_central->dle = true;
+	p_central->phy_2m = true;
+	p_central->conn_interval = 24U;					/* 30 ms */
+	p_central->accept_params = true;
+	p_central->pairs = true;
+	p_central->conn_handle = SIM_INVALID_HANDLE;
+}
+
+static sim_conn_t * sim_central_conn( const sim_central_t * p_central )
+{
+	return ( SIM_INVALID_HANDLE == p_central->conn_handle ) ? NULL : sim_conn_find( p_central->conn_handle );
+}
+
+uint16_t sim_connect( sim_central_t * p_central )
+{
+	uint16_t handle;
+
+	if( ( SIM_ADV_OFF == g_adv.mode ) || ( SIM_INVALID_HANDLE != p_central->conn_handle ) )
+	{
+		return SIM_INVALID_HANDLE;
+	}
+	if( ( SIM_ADV_DIRECTED == g_adv.mode )
+	 && ( ( g_adv.peer_type != p_central->addr_type ) || ( 0 != memcmp( g_adv.peer, p_central->addr, 6 ) ) ) )
+	{
+		return SIM_INVALID_HANDLE;
+	}
+	handle = sim_conn_create( p_central, sim_time_ns() );
+	sim_time_advance_to( sim_time_ns() );
+	return handle;
+}
+
+void sim_central_scan( sim_central_t * p_central, uint32_t interval_us, uint32_t window_us )
+{
+	uint32_t i;
+
+	sim_central_stop_scan( p_central );
+	for( i = 0; SIM_SCANNERS_MAX > i; i++ )
+	{
+		if( NULL == g_scanners[i].p_central )
+		{
+			g_scanners[i].p_central = p_central;
+			g_scanners[i].start_ns = sim_time_ns();
+			g_scanners[i].interval_ns = (uint64_t)interval_us * SIM_NS_PER_US;
+			g_scanners[i].window_ns = (uint64_t)( ( window_us < interval_us ) ? window_us : interval_us ) * SIM_NS_PER_US;
+			return;
+		}
+	}
+}
+
+void sim_central_stop_scan( sim_central_t * p_central )
+{
+	for( uint32_t i = 0; SIM_SCANNERS_MAX > i; i++ )
+	{
+		if( p_central == g_scanners[i].p_central )
+		{
+			g_scanners[i].p_central = NULL;
+		}
+	}
+}
+
+void sim_disconnect( sim_central_t * p_central, uint8_t reason )
+{
+	sim_conn_t * p_conn = sim_central_conn( p_central );
+	uint8_t params[4];
+
+	if( NULL == p_conn )
+	{
+		return;
+	}
+	params[0] = BLE_STATUS_SUCCESS;
+	put16( &params[1], p_conn->handle );
+	params[3] = reason;
+	sim_evt_hci( sim_time_ns(), EVT_DISCONN_COMPLETE, params, sizeof( params ) );
+	sim_time_advance_to( sim_time_ns() );
+}
+
+void sim_inject( const uint8_t * pkt, uint16_t len )
+{
+	sim_evt_schedule( sim_time_ns(), pkt, len );
+	sim_time_advance_to( sim_time_ns() );
+}
+
+void sim_inject_attribute_modified( uint16_t conn_handle, uint16_t attr_handle, const uint8_t * data, uint16_t len )
+{
+	uint8_t params[SIM_EVT_PACKET_SIZE];
+
+	put16( &params[0], conn_handle );
+	put16( &params[2], attr_handle );
+	put16( &params[4], 0U );
+	put16( &params[6], len );
+	memcpy( &params[8], data, len );
+	sim_evt_vendor( sim_time_ns(), 0x0C01, params, (uint8_t)( 8U + len ) );
+	sim_time_advance_to( sim_time_ns() );
+}
+
+void sim_inject_read_permit( uint16_t conn_handle, uint16_t attr_handle, uint16_t offset )
+{
+	uint8_t params[6];
+
+	put16( &params[0], conn_handle );
+	put16( &params[2], attr_handle );
+	put16( &params[4], offset );
+	sim_evt_vendor( sim_time_ns(), 0x0C14, params, sizeof( params ) );
+	sim_time_advance_to( sim_time_ns() );
+}
+
+uint8_t sim_write( sim_central_t * p_central, uint16_t handle, const uint8_t * data, uint16_t len )
+{
+	sim_conn_t * p_conn = sim_central_conn( p_central );
+	sim_attr_t * p_attr = sim_attr( handle );
+
+	if( NULL == p_conn )
+	{
+		return SIM_ATT_UNLIKELY;
+	}
+	if( NULL == p_attr )
+	{
+		return SIM_ATT_INVALID_HANDLE;
+	}
+	/* The event carries the value: it must fit an RX packet */
+	if( ( SIM_EVT_PACKET_SIZE - 13U ) < len )
+	{
+		return SIM_ATT_INVALID_LENGTH;
+	}
+
+	if( SIM_ATTR_CCCD == p_attr->type )
+	{
+		const uint8_t allowed = ( ( 0U != ( p_attr->properties & CHAR_PROP_NOTIFY ) ) ? 0x01U : 0x00U )
+		                      | ( ( 0U != ( p_attr->properties & CHAR_PROP_INDICATE ) ) ? 0x02U : 0x00U );
+		if( 2U != len )
+		{
+			return SIM_ATT_INVALID_LENGTH;
+		}
+		if( ( 0U != ( data[0] & (uint8_t)~allowed ) ) || ( 0U != data[1] ) )
+		{
+			return SIM_ATT_CCCD_IMPROPER;
+		}
+		p_conn->cccd[handle] = get16( data );
+		/* CCCD writes are always reported */
+		sim_inject_attribute_modified( p_conn->handle, handle, data, len );
+		return 0;
+	}
+
+	if( ( SIM_ATTR_CHAR_VALUE != p_attr->type )
+	 || ( 0U == ( p_attr->properties & ( CHAR_PROP_WRITE | CHAR_PROP_WRITE_WITHOUT_RESP ) ) ) )
+	{
+		return SIM_ATT_WRITE_NOT_PERMITTED;
+	}
+	if( 0U != ( p_attr->permissions & ATTR_PERMISSION_AUTHEN_WRITE ) )
+	{
+		/* Just Works pairing never authenticates */
+		return SIM_ATT_INSUFF_AUTHEN;
+	}
+	if( ( 0U != ( p_attr->permissions & ATTR_PERMISSION_ENCRY_WRITE ) ) && ( false == p_conn->encrypted ) )
+	{
+		return SIM_ATT_INSUFF_ENCRYPTION;
+	}
+	if( ( 0U != ( p_attr->permissions & ATTR_PERMISSION_ENCRY_WRITE ) ) && ( MAX_ENCRY_KEY_SIZE < p_attr->enc_key_size ) )
+	{
+		return SIM_ATT_INSUFF_KEY_SIZE;
+	}
+	if( len > p_attr->max_len )
+	{
+		return SIM_ATT_INVALID_LENGTH;
+	}
+	memcpy( p_attr->value, data, len );
+	if( CHAR_VALUE_LEN_VARIABLE == p_attr->is_variable )
+	{
+		p_attr->len = len;
+	}
+	if( 0U != ( p_attr->evt_mask & GATT_NOTIFY_ATTRIBUTE_WRITE ) )
+	{
+		sim_inject_attribute_modified( p_conn->handle, handle, data, len );
+	}
+	return 0;
+}
+
+uint8_t sim_subscribe( sim_central_t * p_central, uint16_t decl, bool enable )
+{
+	const uint8_t value[2] = { enable ? 0x01U : 0x00U, 0x00U };
+	const uint16_t cccd = sim_cccd_of( decl );
+
+	return ( 0U == cccd ) ? SIM_ATT_INVALID_HANDLE : sim_write( p_central, cccd, value, sizeof( value ) );
+}
+
+static bool sim_read_answered( void * arg )
+{
+	const sim_central_t * p_central = (const sim_central_t *)arg;
+	const sim_conn_t * p_conn = sim_central_conn( p_central );
+
+	return ( NULL == p_conn ) || ( SIM_READ_WAIT != p_conn->read_state );
+}
+
+uint8_t sim_read( sim_central_t * p_central, uint16_t handle, uint8_t * out, uint16_t size, uint16_t * p_len )
+{
+	sim_conn_t * p_conn = sim_central_conn( p_central );
+	const sim_attr_t * p_attr = sim_attr( handle );
+	uint8_t buf[SIM_ATTR_VALUE_MAX + 3U];
+	uint16_t len = 0;
+	uint16_t max;
+
+	*p_len = 0;
+	if( NULL == p_conn )
+	{
+		return SIM_ATT_UNLIKELY;
+	}
+	if( NULL == p_attr )
+	{
+		return SIM_ATT_INVALID_HANDLE;
+	}
+
+	switch( p_attr->type )
+	{
+		case SIM_ATTR_SERVICE:
+			len = ( UUID_TYPE_16 == p_attr->uuid_type ) ? 2U : 16U;
+			memcpy( buf, p_attr->uuid, len );
+			break;
+		case SIM_ATTR_CHAR_DECL:
+			buf[0] = p_attr->properties;
+			put16( &buf[1], (uint16_t)( handle + 1U ) );
+			len = ( UUID_TYPE_16 == p_attr->uuid_type ) ? 2U : 16U;
+			memcpy( &buf[3], p_attr->uuid, len );
+			len = (uint16_t)( len + 3U );
+			break;
+		case SIM_ATTR_CCCD:
+			put16( buf, p_conn->cccd[handle] );
+			len = 2U;
+			break;
+		default:
+			if( 0U == ( p_attr->properties & CHAR_PROP_READ ) )
+			{
+				return SIM_ATT_READ_NOT_PERMITTED;
+			}
+			if( 0U != ( p_attr->permissions & ATTR_PERMISSION_AUTHEN_READ ) )
+			{
+				return SIM_ATT_INSUFF_AUTHEN;
+			}
+			if( ( 0U != ( p_attr->permissions & ATTR_PERMISSION_ENCRY_READ ) ) && ( false == p_conn->encrypted ) )
+			{
+				return SIM_ATT_INSUFF_ENCRYPTION;
+			}
+			if( 0U != ( p_attr->evt_mask & GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP ) )
+			{
+				/* The application refreshes the value and allows (or denies) the read */
+				p_conn->read_state = SIM_READ_WAIT;
+				p_conn->read_start_ns = sim_time_ns();
+				sim_inject_read_permit( p_conn->handle, handle, 0U );
+				if( false == sim_run_until( sim_read_answered, p_central, SIM_ATT_TIMEOUT_MS ) )
+				{
+					p_conn->read_state = SIM_READ_IDLE;
+					return SIM_ATT_TIMEOUT;
+				}
+				p_conn = sim_central_conn( p_central );
+				if( NULL == p_conn )
+				{
+					return SIM_ATT_UNLIKELY;
+				}
+				if( SIM_READ_DENIED == p_conn->read_state )
+				{
+					p_conn->read_state = SIM_READ_IDLE;
+					return p_conn->read_error;
+				}
+				p_conn->read_state = SIM_READ_IDLE;
+			}
+			len = p_attr->len;
+			memcpy( buf, p_attr->value, len );
+			break;
+	}
+
+	/* Read response: ATT_MTU - 1 octets */
+	max = (uint16_t)( p_conn->att_mtu - 1U );
+	len = ( len > max ) ? max : len;
+	len = ( len > size ) ? size : len;
+	memcpy( out, buf, len );
+	*p_len = len;
+	return 0;
+}
+
+bool sim_conn_stats( const sim_central_t * p_central, sim_conn_stats_t * p_stats )
+{
+	sim_conn_t * p_conn = sim_central_conn( p_central );
+
+	if( NULL == p_conn )
+	{
+		return false;
+	}
+	if( 0U == p_conn->txq_count )
+	{
+		sim_conn_catch_up( p_conn, sim_time_ns() );
+	}
+	*p_stats = p_conn->stats;
+	p_stats->interval = p_conn->interval;
+	p_stats->latency = p_conn->latency;
+	p_stats->timeout = p_conn->timeout;
+	p_stats->att_mtu = p_conn->att_mtu;
+	p_stats->tx_octets = p_conn->tx_octets;
+	p_stats->tx_phy = p_conn->tx_phy;
+	p_stats->encrypted = p_conn->encrypted;
+	return true;
+}
@@ -0,0 +1,254 @@
+/*
+ * sim_hal.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Virtual time base and the core / flash part of the host HAL.
+ *
+ * Time only moves when the simulation says so: HAL_Delay(), a sleeping core
+ * (WFI / WFE), an ACI command on the SPI link or the main loop of sim_app.c.
+ * Every move runs the registered models (controller, SPI slave) up to the new
+ * time, in order, so their interrupts land where they would on the board.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "stm32f4xx_hal.h"
+#include "sim.h"
+
+#include "app_bond_store.h"
+
+#define SIM_CLOCK_CLIENTS_MAX			( 4U )
+/* 64 MHz core (SystemClock_Config) */
+#define SIM_CORE_MHZ							( 64U )
+/* STM32F4 word program and 128 KB sector erase times (datasheet typical) */
+#define SIM_FLASH_WORD_NS					( 16ULL * SIM_NS_PER_US )
+#define SIM_FLASH_ERASE_NS				( 1000ULL * SIM_NS_PER_MS )
+
+uint32_t SystemCoreClock = SIM_CORE_MHZ * 1000000U;
+__thread uint32_t host_ipsr = 0;
+
+static SCB_Type g_scb;
+SCB_Type * const SCB = &g_scb;
+
+static uint64_t g_now_ns = 0;
+static const sim_clock_client_t * g_clients[SIM_CLOCK_CLIENTS_MAX];
+static uint32_t g_client_count = 0;
+/* Models run from inside a move (an ISR issuing a command) do not recurse */
+static bool g_in_clients = false;
+
+static uint32_t g_basepri = 0;
+static bool g_flash_unlocked = false;
+
+/* ============================================================================
+ * Virtual time
+ * ==========================================================================*/
+uint64_t sim_time_ns( void )
+{
+	return g_now_ns;
+}
+
+void sim_clock_register( const sim_clock_client_t * p_client )
+{
+	uint32_t i;
+
+	for( i = 0; g_client_count > i; i++ )
+	{
+		if( p_client == g_clients[i] )
+		{
+			return;
+		}
+	}
+	if( SIM_CLOCK_CLIENTS_MAX > g_client_count )
+	{
+		g_clients[g_client_count++] = p_client;
+	}
+}
+
+uint64_t sim_clock_next_due( void )
+{
+	uint64_t next = UINT64_MAX;
+	uint32_t i;
+
+	for( i = 0; g_client_count > i; i++ )
+	{
+		const uint64_t due = g_clients[i]->next_due();
+		if( due < next )
+		{
+			next = due;
+		}
+	}
+	return next;
+}
+
+void sim_time_advance_to( uint64_t t_ns )
+{
+	if( t_ns < g_now_ns )
+	{
+		return;
+	}
+	if( true == g_in_clients )
+	{
+		g_now_ns = t_ns;
+		return;
+	}
+
+	g_in_clients = true;
+	/* Every model activity in time order, a model may schedule new ones */
+	for( ;; )
+	{
+		const uint64_t due = sim_clock_next_due();
+		uint32_t i;
+
+		if( due > t_ns )
+		{
+			break;
+		}
+		if( due > g_now_ns )
+		{
+			g_now_ns = due;
+		}
+		for( i = 0; g_client_count > i; i++ )
+		{
+			g_clients[i]->run_until( g_now_ns );
+		}
+	}
+	g_now_ns = t_ns;
+	g_in_clients = false;
+}
+
+void sim_time_advance_ns( uint64_t ns )
+{
+	sim_time_advance_to( g_now_ns + ns );
+}
+
+void sim_time_idle( void )
+{
+	const uint64_t tick = ( ( g_now_ns / SIM_NS_PER_MS ) + 1U ) * SIM_NS_PER_MS;
+	const uint64_t due = sim_clock_next_due();
+
+	sim_time_advance_to( ( due < tick ) && ( due > g_now_ns ) ? due : tick );
+}
+
+uint32_t HAL_GetTick( void )
+{
+	return (uint32_t)( g_now_ns / SIM_NS_PER_MS );
+}
+
+void HAL_Delay( uint32_t Delay )
+{
+	sim_time_advance_ns( (uint64_t)Delay * SIM_NS_PER_MS );
+}
+
+/* ============================================================================
+ * app_port.h (APP_HOST_BUILD)
+ * ==========================================================================*/
+uint32_t app_port_tick_ms( void )
+{
+	return HAL_GetTick();
+}
+
+void app_port_cycle_counter_init( void )
+{
+}
+
+uint32_t app_port_cycles( void )
+{
+	return (uint32_t)( ( g_now_ns * SIM_CORE_MHZ ) / SIM_NS_PER_US );
+}
+
+uint32_t app_port_cycles_per_us( void )
+{
+	return SIM_CORE_MHZ;
+}
+
+/* ============================================================================
+ * Core
+ * ==========================================================================*/
+void host_set_basepri( uint32_t basepri )
+{
+	g_basepri = basepri;
+}
+
+uint32_t host_get_basepri( void )
+{
+	return g_basepri;
+}
+
+void HAL_NVIC_SetPriority( IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority )
+{
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+}
+
+void HAL_PWR_EnableSEVOnPend( void )
+{
+}
+
+/* ============================================================================
+ * Flash: sector 7 mapped at its STM32F411 address, the bond store reads it
+ * through plain pointers
+ * ==========================================================================*/
+__attribute__(( constructor )) static void sim_flash_map( void )
+{
+	void * p = mmap( (void *)BOND_STORE_BASE, BOND_STORE_SIZE, PROT_READ | PROT_WRITE,
+	                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0 );
+
+	if( (void *)BOND_STORE_BASE != p )
+	{
+		fprintf( stderr, "sim_hal: cannot map the flash sector at 0x%08lX\n", (unsigned long)BOND_STORE_BASE );
+		abort();
+	}
+	sim_flash_erase_all();
+}
+
+void sim_flash_erase_all( void )
+{
+	memset( (void *)BOND_STORE_BASE, 0xFF, BOND_STORE_SIZE );
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock( void )
+{
+	g_flash_unlocked = true;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock( void )
+{
+	g_flash_unlocked = false;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program( uint32_t TypeProgram, uint32_t Address, uint64_t Data )
+{
+	volatile uint32_t * p_word = (volatile uint32_t *)(uintptr_t)Address;
+
+	if( ( false == g_flash_unlocked ) || ( FLASH_TYPEPROGRAM_WORD != TypeProgram ) || ( 0U != ( Address & 3U ) )
+	 || ( BOND_STORE_BASE > Address ) || ( ( BOND_STORE_BASE + BOND_STORE_SIZE ) <= Address ) )
+	{
+		return HAL_ERROR;
+	}
+	/* Programming only clears bits */
+	*p_word &= (uint32_t)Data;
+	sim_time_advance_ns( SIM_FLASH_WORD_NS );
+	return ( (uint32_t)Data == *p_word ) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase( FLASH_EraseInitTypeDef * pEraseInit, uint32_t * SectorError )
+{
+	if( ( false == g_flash_unlocked ) || ( FLASH_SECTOR_7 != pEraseInit->Sector ) || ( 1U != pEraseInit->NbSectors ) )
+	{
+		*SectorError = pEraseInit->Sector;
+		return HAL_ERROR;
+	}
+	sim_flash_erase_all();
+	sim_time_advance_ns( SIM_FLASH_ERASE_NS );
+	*SectorError = 0xFFFFFFFFU;
+	return HAL_OK;
+}
@@ -0,0 +1,359 @@
+/*
+ * sim_hci.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * HCI layer of the middleware (hci.c of X-CUBE-BLE2) for the host build:
+ * the RX packet pool, hci_init() / hci_user_evt_proc() and the event tables
+ * with their process functions, which unpack the packed little endian
+ * payloads into the callback arguments.
+ *
+ * Callbacks the application does not define (APP_SECURITY = 0, ...) fall back
+ * to the weak empty ones below, as the middleware does.
+ */
+
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "hci.h"
+#include "hci_tl.h"
+#include "hci_const.h"
+#include "sim.h"
+
+/* Middleware RX pool (hci.c HCI_READ_PACKET_NUM_MAX / HCI_READ_PACKET_SIZE) */
+#define SIM_HCI_RX_PACKETS				( HCI_READ_PACKET_NUM_MAX )
+#define SIM_HCI_PACKET_SIZE				( HCI_READ_PACKET_SIZE )
+/* hci_user_evt_proc() with nothing to deliver */
+#define SIM_HCI_POLL_NS						( 10ULL * SIM_NS_PER_US )
+
+typedef struct
+{
+	uint16_t len;
+	uint8_t data[SIM_HCI_PACKET_SIZE];
+} sim_hci_packet_t;
+
+static sim_hci_packet_t g_rx[SIM_HCI_RX_PACKETS];
+static uint32_t g_rx_head = 0;
+static uint32_t g_rx_count = 0;
+
+static void ( * g_user_evt_rx )( void * pData ) = NULL;
+static tHciIO g_io;
+static bool g_io_registered = false;
+
+static inline uint16_t le16( const uint8_t * p )
+{
+	return (uint16_t)( p[0] | ( p[1] << 8 ) );
+}
+
+/* ============================================================================
+ * RX pool
+ * ==========================================================================*/
+bool sim_hci_rx_room( void )
+{
+	return ( SIM_HCI_RX_PACKETS > g_rx_count );
+}
+
+uint32_t sim_hci_rx_count( void )
+{
+	return g_rx_count;
+}
+
+static bool sim_hci_rx_store( const uint8_t * pkt, uint16_t len )
+{
+	sim_hci_packet_t * p_pkt;
+
+	if( ( false == sim_hci_rx_room() ) || ( SIM_HCI_PACKET_SIZE < len ) )
+	{
+		return false;
+	}
+	p_pkt = &g_rx[( g_rx_head + g_rx_count ) % SIM_HCI_RX_PACKETS];
+	memcpy( p_pkt->data, pkt, len );
+	p_pkt->len = len;
+	g_rx_count++;
+	return true;
+}
+
+bool sim_hci_rx_push( const uint8_t * pkt, uint16_t len )
+{
+	const uint32_t ipsr = host_ipsr;
+
+	if( false == sim_hci_rx_store( pkt, len ) )
+	{
+		return false;
+	}
+	/* EXTI0: the packet was read by the transport, as after a real edge */
+	host_ipsr = 16U + EXTI0_IRQn;
+	hci_tl_lowlevel_isr();
+	host_ipsr = ipsr;
+	return true;
+}
+
+/* ============================================================================
+ * Middleware entry points
+ * ==========================================================================*/
+void hci_init( void ( * UserEvtRx )( void * pData ), void * pConf )
+{
+	(void)pConf;
+
+	g_user_evt_rx = UserEvtRx;
+	g_rx_head = 0;
+	g_rx_count = 0;
+	/* IO bus and EXTI0 of hci_tl_interface.c, as the middleware registers them */
+	hci_tl_lowlevel_init();
+	/* Reset pin: the controller boots and reports aci_blue_initialized_event(),
+	 * a line held high by a hung controller drops */
+	HCI_TL_SPI_IRQ_PORT->IDR &= ~(uint32_t)HCI_TL_SPI_IRQ_PIN;
+	sim_ctrl_reset();
+}
+
+void hci_user_evt_proc( void )
+{
+	sim_hci_packet_t pkt;
+
+	if( 0U == g_rx_count )
+	{
+		/* Busy polling loops (bluenrg_wait_ready()) still see time go by */
+		sim_time_advance_ns( SIM_HCI_POLL_NS );
+		return;
+	}
+	while( 0U != g_rx_count )
+	{
+		/* Copy out first: the callback may issue commands that queue new events */
+		pkt = g_rx[g_rx_head];
+		g_rx_head = ( g_rx_head + 1U ) % SIM_HCI_RX_PACKETS;
+		g_rx_count--;
+		if( NULL != g_user_evt_rx )
+		{
+			g_user_evt_rx( pkt.data );
+		}
+	}
+}
+
+void hci_register_io_bus( tHciIO * fops )
+{
+	g_io = *fops;
+	g_io_registered = true;
+}
+
+int32_t hci_notify_asynch_evt( void * pdata )
+{
+	uint8_t buf[SIM_HCI_PACKET_SIZE];
+	int32_t len;
+
+	(void)pdata;
+	if( false == sim_hci_rx_room() )
+	{
+		return 1;
+	}
+	if( ( false == g_io_registered ) || ( NULL == g_io.Receive ) )
+	{
+		return 0;
+	}
+	len = g_io.Receive( buf, sizeof( buf ) );
+	if( 0 < len )
+	{
+		(void)sim_hci_rx_store( buf, (uint16_t)len );
+	}
+	return 0;
+}
+
+/* ============================================================================
+ * Process functions: packed payload to callback arguments
+ * ==========================================================================*/
+static void hci_disconnection_complete_event_process( uint8_t * p )
+{
+	hci_disconnection_complete_event( p[0], le16( &p[1] ), p[3] );
+}
+
+static void hci_encryption_change_event_process( uint8_t * p )
+{
+	hci_encryption_change_event( p[0], le16( &p[1] ), p[3] );
+}
+
+static void hci_le_connection_complete_event_process( uint8_t * p )
+{
+	hci_le_connection_complete_event( p[0], le16( &p[1] ), p[3], p[4], &p[5], le16( &p[11] ), le16( &p[13] ), le16( &p[15] ), p[17] );
+}
+
+static void hci_le_connection_update_complete_event_process( uint8_t * p )
+{
+	hci_le_connection_update_complete_event( p[0], le16( &p[1] ), le16( &p[3] ), le16( &p[5] ), le16( &p[7] ) );
+}
+
+static void hci_le_read_remote_used_features_complete_event_process( uint8_t * p )
+{
+	hci_le_read_remote_used_features_complete_event( p[0], le16( &p[1] ), &p[3] );
+}
+
+static void hci_le_data_length_change_event_process( uint8_t * p )
+{
+	hci_le_data_length_change_event( le16( &p[0] ), le16( &p[2] ), le16( &p[4] ), le16( &p[6] ), le16( &p[8] ) );
+}
+
+static void hci_le_phy_update_complete_event_process( uint8_t * p )
+{
+	hci_le_phy_update_complete_event( p[0], le16( &p[1] ), p[3], p[4] );
+}
+
+static void aci_blue_initialized_event_process( uint8_t * p )
+{
+	aci_blue_initialized_event( p[0] );
+}
+
+static void aci_gap_pairing_complete_event_process( uint8_t * p )
+{
+	aci_gap_pairing_complete_event( le16( &p[0] ), p[2], p[3] );
+}
+
+static void aci_gap_bond_lost_event_process( uint8_t * p )
+{
+	(void)p;
+	aci_gap_bond_lost_event();
+}
+
+static void aci_l2cap_connection_update_resp_event_process( uint8_t * p )
+{
+	aci_l2cap_connection_update_resp_event( le16( &p[0] ), le16( &p[2] ) );
+}
+
+static void aci_l2cap_proc_timeout_event_process( uint8_t * p )
+{
+	aci_l2cap_proc_timeout_event( le16( &p[0] ), p[2], &p[3] );
+}
+
+static void aci_gatt_attribute_modified_event_process( uint8_t * p )
+{
+	aci_gatt_attribute_modified_event( le16( &p[0] ), le16( &p[2] ), le16( &p[4] ), le16( &p[6] ), &p[8] );
+}
+
+static void aci_att_exchange_mtu_resp_event_process( uint8_t * p )
+{
+	aci_att_exchange_mtu_resp_event( le16( &p[0] ), le16( &p[2] ) );
+}
+
+static void aci_gatt_read_permit_req_event_process( uint8_t * p )
+{
+	aci_gatt_read_permit_req_event( le16( &p[0] ), le16( &p[2] ), le16( &p[4] ) );
+}
+
+static void aci_gatt_tx_pool_available_event_process( uint8_t * p )
+{
+	aci_gatt_tx_pool_available_event( le16( &p[0] ), le16( &p[2] ) );
+}
+
+const hci_events_table_type hci_events_table[HCI_EVENTS_TABLE_SIZE] =
+{
+	{ 0x0005, hci_disconnection_complete_event_process },
+	{ 0x0008, hci_encryption_change_event_process },
+};
+
+const hci_le_meta_events_table_type hci_le_meta_events_table[HCI_LE_META_EVENTS_TABLE_SIZE] =
+{
+	{ 0x0001, hci_le_connection_complete_event_process },
+	{ 0x0003, hci_le_connection_update_complete_event_process },
+	{ 0x0004, hci_le_read_remote_used_features_complete_event_process },
+	{ 0x0007, hci_le_data_length_change_event_process },
+	{ 0x000C, hci_le_phy_update_complete_event_process },
+};
+
+const hci_vendor_specific_events_table_type hci_vendor_specific_events_table[HCI_VENDOR_SPECIFIC_EVENTS_TABLE_SIZE] =
+{
+	{ 0x0001, aci_blue_initialized_event_process },
+	{ 0x0401, aci_gap_pairing_complete_event_process },
+	{ 0x0405, aci_gap_bond_lost_event_process },
+	{ 0x0800, aci_l2cap_connection_update_resp_event_process },
+	{ 0x0801, aci_l2cap_proc_timeout_event_process },
+	{ 0x0C01, aci_gatt_attribute_modified_event_process },
+	{ 0x0C03, aci_att_exchange_mtu_resp_event_process },
+	{ 0x0C14, aci_gatt_read_permit_req_event_process },
+	{ 0x0C16, aci_gatt_tx_pool_available_event_process },
+};
+
+/* ============================================================================
+ * Default callbacks (weak, like the middleware)
+ * ==========================================================================*/
+__weak void hci_disconnection_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t Reason )
+{
+	(void)Status; (void)Connection_Handle; (void)Reason;
+}
+
+__weak void hci_encryption_change_event( uint8_t Status, uint16_t Connection_Handle, uint8_t Encryption_Enabled )
+{
+	(void)Status; (void)Connection_Handle; (void)Encryption_Enabled;
+}
+
+__weak void hci_le_connection_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t Role, uint8_t Peer_Address_Type,
+                                              uint8_t Peer_Address[6], uint16_t Conn_Interval, uint16_t Conn_Latency,
+                                              uint16_t Supervision_Timeout, uint8_t Master_Clock_Accuracy )
+{
+	(void)Status; (void)Connection_Handle; (void)Role; (void)Peer_Address_Type; (void)Peer_Address;
+	(void)Conn_Interval; (void)Conn_Latency; (void)Supervision_Timeout; (void)Master_Clock_Accuracy;
+}
+
+__weak void hci_le_connection_update_complete_event( uint8_t Status, uint16_t Connection_Handle, uint16_t Conn_Interval,
+                                                     uint16_t Conn_Latency, uint16_t Supervision_Timeout )
+{
+	(void)Status; (void)Connection_Handle; (void)Conn_Interval; (void)Conn_Latency; (void)Supervision_Timeout;
+}
+
+__weak void hci_le_read_remote_used_features_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t LE_Features[8] )
+{
+	(void)Status; (void)Connection_Handle; (void)LE_Features;
+}
+
+__weak void hci_le_data_length_change_event( uint16_t Connection_Handle, uint16_t MaxTxOctets, uint16_t MaxTxTime,
+                                             uint16_t MaxRxOctets, uint16_t MaxRxTime )
+{
+	(void)Connection_Handle; (void)MaxTxOctets; (void)MaxTxTime; (void)MaxRxOctets; (void)MaxRxTime;
+}
+
+__weak void hci_le_phy_update_complete_event( uint8_t Status, uint16_t Connection_Handle, uint8_t TX_PHY, uint8_t RX_PHY )
+{
+	(void)Status; (void)Connection_Handle; (void)TX_PHY; (void)RX_PHY;
+}
+
+__weak void aci_blue_initialized_event( uint8_t Reason_Code )
+{
+	(void)Reason_Code;
+}
+
+__weak void aci_gap_pairing_complete_event( uint16_t Connection_Handle, uint8_t Status, uint8_t Reason )
+{
+	(void)Connection_Handle; (void)Status; (void)Reason;
+}
+
+__weak void aci_gap_bond_lost_event( void )
+{
+}
+
+__weak void aci_l2cap_connection_update_resp_event( uint16_t Connection_Handle, uint16_t Result )
+{
+	(void)Connection_Handle; (void)Result;
+}
+
+__weak void aci_l2cap_proc_timeout_event( uint16_t Connection_Handle, uint8_t Data_Length, uint8_t Data[] )
+{
+	(void)Connection_Handle; (void)Data_Length; (void)Data;
+}
+
+__weak void aci_gatt_attribute_modified_event( uint16_t Connection_Handle, uint16_t Attr_Handle, uint16_t Offset,
+                                               uint16_t Attr_Data_Length, uint8_t Attr_Data[] )
+{
+	(void)Connection_Handle; (void)Attr_Handle; (void)Offset; (void)Attr_Data_Length; (void)Attr_Data;
+}
+
+__weak void aci_att_exchange_mtu_resp_event( uint16_t Connection_Handle, uint16_t Server_RX_MTU )
+{
+	(void)Connection_Handle; (void)Server_RX_MTU;
+}
+
+__weak void aci_gatt_read_permit_req_event( uint16_t Connection_Handle, uint16_t Attribute_Handle, uint16_t Offset )
+{
+	(void)Connection_Handle; (void)Attribute_Handle; (void)Offset;
+}
+
+__weak void aci_gatt_tx_pool_available_event( uint16_t Connection_Handle, uint16_t Available_Buffers )
+{
+	(void)Connection_Handle; (void)Available_Buffers;
+}
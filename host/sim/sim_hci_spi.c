@@ -0,0 +1,118 @@
+/*
+ * sim_hci_spi.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * What hci_tl_interface.c calls above it, for the SPI tests (in place of
+ * sim_hci.c and the application): the IO bus registration, an RX pool that
+ * keeps the frames read by hci_notify_asynch_evt() for the test, and the
+ * event pump / recovery hooks of the interrupt and bottom half, counted.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "hci_tl.h"
+#include "sim.h"
+
+#define SIM_HCI_SPI_FRAMES				( 256U )
+#define SIM_HCI_SPI_FRAME_SIZE		( HCI_READ_PACKET_SIZE )
+
+typedef struct
+{
+	uint16_t len;
+	uint8_t data[SIM_HCI_SPI_FRAME_SIZE];
+} sim_hci_spi_frame_t;
+
+static tHciIO g_io;
+static bool g_io_registered = false;
+
+static sim_hci_spi_frame_t g_frames[SIM_HCI_SPI_FRAMES];
+static uint32_t g_head;
+static uint32_t g_count;
+/* RX pool size seen by the bottom half (HCI_READ_PACKET_NUM_MAX by default) */
+static uint32_t g_pool = HCI_READ_PACKET_NUM_MAX;
+
+static uint32_t g_edges;
+static uint32_t g_irq_stuck;
+
+void hci_register_io_bus( tHciIO * fops )
+{
+	g_io = *fops;
+	g_io_registered = true;
+}
+
+/* hci.c: 1 when the RX pool is full, otherwise one frame read into it */
+int32_t hci_notify_asynch_evt( void * pdata )
+{
+	sim_hci_spi_frame_t * p_frame;
+	int32_t len;
+
+	(void)pdata;
+	if( ( g_pool <= g_count ) || ( SIM_HCI_SPI_FRAMES <= g_count ) )
+	{
+		return 1;
+	}
+	if( ( false == g_io_registered ) || ( NULL == g_io.Receive ) )
+	{
+		return 0;
+	}
+	p_frame = &g_frames[( g_head + g_count ) % SIM_HCI_SPI_FRAMES];
+	len = g_io.Receive( p_frame->data, sizeof( p_frame->data ) );
+	if( 0 < len )
+	{
+		p_frame->len = (uint16_t)len;
+		g_count++;
+	}
+	return 0;
+}
+
+void event_pump_isr_edge( void )
+{
+	g_edges++;
+}
+
+void recovery_report( recovery_cause_t cause )
+{
+	if( RECOVERY_CAUSE_IRQ_STUCK == cause )
+	{
+		g_irq_stuck++;
+	}
+}
+
+void sim_hci_spi_set_pool( uint32_t packets )
+{
+	g_pool = packets;
+}
+
+uint16_t sim_hci_spi_pop( uint8_t * out, uint16_t size )
+{
+	const sim_hci_spi_frame_t * p_frame = &g_frames[g_head];
+	uint16_t len;
+
+	if( 0U == g_count )
+	{
+		return 0;
+	}
+	len = ( p_frame->len < size ) ? p_frame->len : size;
+	memcpy( out, p_frame->data, len );
+	g_head = ( g_head + 1U ) % SIM_HCI_SPI_FRAMES;
+	g_count--;
+	return len;
+}
+
+uint32_t sim_hci_spi_count( void )
+{
+	return g_count;
+}
+
+uint32_t sim_hci_spi_edges( void )
+{
+	return g_edges;
+}
+
+uint32_t sim_hci_spi_irq_stuck( void )
+{
+	return g_irq_stuck;
+}
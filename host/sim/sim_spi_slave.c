@@ -0,0 +1,732 @@
+/*
+ * sim_spi_slave.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Board model with the BlueNRG-2 on SPI1, for the tests of
+ * hci_tl_interface.c (linked in place of sim_bsp.c).
+ *
+ * The slave side of the BlueNRG-2 SPI protocol:
+ *   - CS low wakes the slave, which raises IRQ once it is ready (wake_ns),
+ *   - the 5-byte header: the master sends 0x0a (write) or 0x0b (read), the
+ *     slave answers 0x02 (ready), the free bytes of its command buffer
+ *     (bytes 1..2) and the length of its next event frame (bytes 3..4). A
+ *     header clocked before IRQ is high reads as zeros,
+ *   - IRQ falls irq_low_ns after the header, then the payload,
+ *   - CS high ends the frame: a command is taken (and frees the buffer
+ *     write_drain_ns later), an event clocked out leaves the queue, and IRQ
+ *     rises again next_irq_ns later while events are queued.
+ *
+ * Every byte costs 8 SCK periods of virtual time. Polled transfers hold the
+ * core (cpu_busy_ns), DMA transfers complete from the clock with their
+ * callback in "interrupt" context. An IRQ rising edge runs the EXTI0 callback
+ * if the line is enabled in the NVIC, or when it is enabled again (pending
+ * bit); the bottom half it pends runs from sim_spi_pendsv().
+ */
+
+#include <string.h>
+
+#include "stm32f4xx_hal.h"
+#include "stm32f4xx_nucleo_bus.h"
+#include "hci_tl_interface.h"
+#include "sim.h"
+
+#define SIM_SPI_HEADER_SIZE					( 5U )
+#define SIM_SPI_CMD_WRITE						( 0x0AU )
+#define SIM_SPI_CMD_READ						( 0x0BU )
+#define SIM_SPI_READY								( 0x02U )
+#define SIM_SPI_NEVER								( UINT64_MAX )
+/* Exception numbers seen by the callbacks (__get_IPSR()) */
+#define SIM_SPI_IPSR_PENDSV					( 14U )
+#define SIM_SPI_IPSR_EXTI0					( 16U + (uint32_t)EXTI0_IRQn )
+#define SIM_SPI_IPSR_DMA						( 16U + 56U )		/* DMA2 stream 0 */
+
+typedef enum
+{
+	SIM_SPI_IDLE = 0,					/* CS high */
+	SIM_SPI_HEADER,
+	SIM_SPI_READ,
+	SIM_SPI_WRITE,
+	SIM_SPI_IGNORE,						/* Unknown header, rest of the frame dropped */
+} sim_spi_phase_t;
+
+typedef struct
+{
+	uint16_t len;
+	uint8_t data[SIM_SPI_FRAME_MAX];
+} sim_spi_frame_t;
+
+typedef struct
+{
+	sim_spi_frame_t frames[SIM_SPI_QUEUE_MAX];
+	uint32_t head;
+	uint32_t count;
+} sim_spi_fifo_t;
+
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+GPIO_TypeDef host_gpioc;
+
+SPI_HandleTypeDef hspi1;
+DMA_HandleTypeDef hdma_spi1_rx;
+DMA_HandleTypeDef hdma_spi1_tx;
+
+static sim_spi_config_t g_cfg;
+static sim_spi_stats_t g_stats;
+
+static sim_spi_fifo_t g_events;					/* Slave to master */
+static sim_spi_fifo_t g_commands;				/* Master to slave */
+
+/* Frame in progress */
+static sim_spi_phase_t g_phase = SIM_SPI_IDLE;
+static uint32_t g_pos;									/* Bytes clocked since CS low */
+static uint8_t g_hdr_mosi[SIM_SPI_HEADER_SIZE];
+static uint8_t g_hdr_miso[SIM_SPI_HEADER_SIZE];
+static uint16_t g_offered;							/* Read: event length, write: buffer room */
+static sim_spi_frame_t g_command;
+
+/* Lines */
+static bool g_irq = false;
+static uint64_t g_irq_rise_due = SIM_SPI_NEVER;
+static uint64_t g_irq_fall_due = SIM_SPI_NEVER;
+static bool g_exti0_enabled = false;
+static bool g_exti0_pending = false;
+static void ( * g_exti0_cb )( void ) = NULL;
+
+/* Command buffer */
+static uint16_t g_write_used;
+static uint64_t g_write_free_due = SIM_SPI_NEVER;
+
+/* DMA transfer in flight, completing at g_dma_due (never when it hangs) */
+static bool g_dma_busy = false;
+static uint64_t g_dma_due = SIM_SPI_NEVER;
+static uint8_t * g_dma_tx;
+static uint8_t * g_dma_rx;
+static uint16_t g_dma_len;
+static BSP_SPI_XferCpltCb_t g_dma_cb;
+
+static void sim_spi_run_until( uint64_t now_ns );
+static uint64_t sim_spi_next_due( void );
+
+static const sim_clock_client_t g_spi_clock =
+{
+	.run_until = sim_spi_run_until,
+	.next_due = sim_spi_next_due,
+};
+
+/* ============================================================================
+ * Queues
+ * ==========================================================================*/
+static bool sim_spi_fifo_push( sim_spi_fifo_t * p_fifo, const uint8_t * data, uint16_t len )
+{
+	sim_spi_frame_t * p_frame;
+
+	if( ( SIM_SPI_QUEUE_MAX <= p_fifo->count ) || ( SIM_SPI_FRAME_MAX < len ) )
+	{
+		return false;
+	}
+	p_frame = &p_fifo->frames[( p_fifo->head + p_fifo->count ) % SIM_SPI_QUEUE_MAX];
+	p_frame->len = len;
+	memcpy( p_frame->data, data, len );
+	p_fifo->count++;
+	return true;
+}
+
+static const sim_spi_frame_t * sim_spi_fifo_peek( const sim_spi_fifo_t * p_fifo )
+{
+	return ( 0U == p_fifo->count ) ? NULL : &p_fifo->frames[p_fifo->head];
+}
+
+static void sim_spi_fifo_drop( sim_spi_fifo_t * p_fifo )
+{
+	if( 0U != p_fifo->count )
+	{
+		p_fifo->head = ( p_fifo->head + 1U ) % SIM_SPI_QUEUE_MAX;
+		p_fifo->count--;
+	}
+}
+
+/* ============================================================================
+ * IRQ line
+ * ==========================================================================*/
+static void sim_spi_exti0( void )
+{
+	const uint32_t ipsr = host_ipsr;
+
+	if( NULL != g_exti0_cb )
+	{
+		host_ipsr = SIM_SPI_IPSR_EXTI0;
+		g_exti0_cb();
+		host_ipsr = ipsr;
+	}
+}
+
+static void sim_spi_irq_set( bool level )
+{
+	if( level == g_irq )
+	{
+		return;
+	}
+	g_irq = level;
+	if( level )
+	{
+		host_gpioa.IDR |= HCI_TL_SPI_IRQ_PIN;
+		g_stats.irq_edges++;
+		/* Rising edge: EXTI0 pending until the NVIC line is enabled */
+		if( g_exti0_enabled )
+		{
+			sim_spi_exti0();
+		}
+		else
+		{
+			g_exti0_pending = true;
+		}
+	}
+	else
+	{
+		host_gpioa.IDR &= ~(uint32_t)HCI_TL_SPI_IRQ_PIN;
+	}
+}
+
+static uint64_t sim_spi_byte_ns( void )
+{
+	return ( 8ULL * 1000000000ULL ) / g_cfg.sck_hz;
+}
+
+static uint16_t sim_spi_write_room( void )
+{
+	return (uint16_t)( g_cfg.write_buffer - g_write_used );
+}
+
+/* ============================================================================
+ * Frames
+ * ==========================================================================*/
+static void sim_spi_cs_low( void )
+{
+	g_phase = SIM_SPI_HEADER;
+	g_pos = 0;
+	g_command.len = 0;
+	/* Wake up: IRQ high once ready (already high when an event is waiting) */
+	if( ( false == g_irq ) && ( false == g_cfg.irq_dead ) && ( SIM_SPI_NEVER == g_irq_rise_due ) )
+	{
+		g_irq_rise_due = sim_time_ns() + g_cfg.wake_ns;
+	}
+}
+
+static void sim_spi_cs_high( void )
+{
+	switch( g_phase )
+	{
+	case SIM_SPI_READ:
+		if( SIM_SPI_HEADER_SIZE < g_pos )
+		{
+			/* Event clocked out (all of it or what the master had room for) */
+			sim_spi_fifo_drop( &g_events );
+			g_stats.read_frames++;
+		}
+		break;
+	case SIM_SPI_WRITE:
+		if( 0U != g_command.len )
+		{
+			(void)sim_spi_fifo_push( &g_commands, g_command.data, g_command.len );
+			g_write_used = (uint16_t)( g_write_used + g_command.len );
+			g_write_free_due = sim_time_ns() + g_cfg.write_drain_ns;
+			g_stats.write_frames++;
+		}
+		else
+		{
+			g_stats.write_refused++;
+		}
+		break;
+	case SIM_SPI_HEADER:
+		/* Released before the header: ready wait given up */
+		g_irq_rise_due = SIM_SPI_NEVER;
+		break;
+	default:
+		break;
+	}
+	if( ( SIM_SPI_READ == g_phase ) && ( SIM_SPI_HEADER_SIZE == g_pos ) && ( 0U == g_offered ) )
+	{
+		g_stats.read_empty++;
+	}
+	g_phase = SIM_SPI_IDLE;
+
+	/* Next event: IRQ up again once the line has gone low */
+	if( ( 0U != g_events.count ) && ( false == g_cfg.irq_dead ) )
+	{
+		g_irq_rise_due = sim_time_ns() + g_cfg.next_irq_ns;
+	}
+}
+
+/* Header answer, built when its first byte is clocked */
+static void sim_spi_header_start( uint8_t cmd )
+{
+	const sim_spi_frame_t * p_event = sim_spi_fifo_peek( &g_events );
+
+	memset( g_hdr_miso, 0, sizeof( g_hdr_miso ) );
+	if( false == g_irq )
+	{
+		/* Not ready: MISO reads as zeros */
+		g_offered = 0;
+		return;
+	}
+	g_offered = ( SIM_SPI_CMD_READ == cmd ) ? ( ( NULL != p_event ) ? p_event->len : 0U ) : sim_spi_write_room();
+	g_hdr_miso[0] = SIM_SPI_READY;
+	g_hdr_miso[1] = (uint8_t)( sim_spi_write_room() & 0xFFU );
+	g_hdr_miso[2] = (uint8_t)( sim_spi_write_room() >> 8 );
+	g_hdr_miso[3] = (uint8_t)( ( NULL != p_event ) ? ( p_event->len & 0xFFU ) : 0U );
+	g_hdr_miso[4] = (uint8_t)( ( NULL != p_event ) ? ( p_event->len >> 8 ) : 0U );
+}
+
+static void sim_spi_header_end( void )
+{
+	const uint8_t cmd = g_hdr_mosi[0];
+
+	if( ( SIM_SPI_CMD_READ != cmd ) && ( SIM_SPI_CMD_WRITE != cmd ) )
+	{
+		g_stats.header_errors++;
+		g_phase = SIM_SPI_IGNORE;
+		return;
+	}
+	if( SIM_SPI_READY != g_hdr_miso[0] )
+	{
+		/* Master went on without the slave: nothing happens in this frame */
+		g_phase = SIM_SPI_IGNORE;
+		return;
+	}
+	g_phase = ( SIM_SPI_CMD_READ == cmd ) ? SIM_SPI_READ : SIM_SPI_WRITE;
+	/* Header taken: IRQ back low */
+	g_irq_fall_due = sim_time_ns() + g_cfg.irq_low_ns;
+}
+
+static uint8_t sim_spi_byte( uint8_t mosi )
+{
+	const uint32_t pos = g_pos++;
+	uint8_t miso = 0x00U;
+
+	g_stats.bus_bytes++;
+	if( SIM_SPI_HEADER_SIZE > pos )
+	{
+		if( 0U == pos )
+		{
+			sim_spi_header_start( mosi );
+		}
+		g_hdr_mosi[pos] = mosi;
+		miso = g_hdr_miso[pos];
+		if( ( SIM_SPI_HEADER_SIZE - 1U ) == pos )
+		{
+			sim_spi_header_end();
+		}
+		return miso;
+	}
+
+	const uint32_t offset = pos - SIM_SPI_HEADER_SIZE;
+	switch( g_phase )
+	{
+	case SIM_SPI_READ:
+		if( offset < g_offered )
+		{
+			miso = sim_spi_fifo_peek( &g_events )->data[offset];
+		}
+		else
+		{
+			g_stats.header_errors++;
+		}
+		break;
+	case SIM_SPI_WRITE:
+		if( offset < g_offered )
+		{
+			g_command.data[g_command.len++] = mosi;
+		}
+		else
+		{
+			g_stats.header_errors++;
+		}
+		break;
+	default:
+		break;
+	}
+	return miso;
+}
+
+static void sim_spi_exchange( const uint8_t * tx, uint8_t * rx, uint16_t len )
+{
+	const bool selected = ( 0U == ( host_gpioa.ODR & HCI_TL_SPI_CS_PIN ) );
+
+	g_stats.bus_ns += (uint64_t)len * sim_spi_byte_ns();
+	for( uint16_t i = 0; len > i; i++ )
+	{
+		rx[i] = selected ? sim_spi_byte( tx[i] ) : 0xFFU;
+	}
+}
+
+/* ============================================================================
+ * Clock client
+ * ==========================================================================*/
+static void sim_spi_run_until( uint64_t now_ns )
+{
+	if( g_cfg.irq_stuck_high && ( false == g_irq ) )
+	{
+		sim_spi_irq_set( true );
+	}
+	if( g_irq_rise_due <= now_ns )
+	{
+		g_irq_rise_due = SIM_SPI_NEVER;
+		sim_spi_irq_set( true );
+	}
+	if( g_irq_fall_due <= now_ns )
+	{
+		g_irq_fall_due = SIM_SPI_NEVER;
+		if( false == g_cfg.irq_stuck_high )
+		{
+			sim_spi_irq_set( false );
+		}
+	}
+	if( g_write_free_due <= now_ns )
+	{
+		g_write_free_due = SIM_SPI_NEVER;
+		g_write_used = 0;
+	}
+	if( g_dma_due <= now_ns )
+	{
+		const BSP_SPI_XferCpltCb_t cb = g_dma_cb;
+		const uint32_t ipsr = host_ipsr;
+		int32_t status = BSP_ERROR_NONE;
+
+		g_dma_due = SIM_SPI_NEVER;
+		g_dma_busy = false;
+		g_dma_cb = NULL;
+		if( 0U != g_cfg.dma_fail )
+		{
+			g_cfg.dma_fail--;
+			status = BSP_ERROR_BUS_FAILURE;
+		}
+		else
+		{
+			sim_spi_exchange( g_dma_tx, g_dma_rx, g_dma_len );
+		}
+		host_ipsr = SIM_SPI_IPSR_DMA;
+		cb( status );
+		host_ipsr = ipsr;
+	}
+}
+
+static uint64_t sim_spi_next_due( void )
+{
+	uint64_t next = g_irq_rise_due;
+
+	if( g_cfg.irq_stuck_high && ( false == g_irq ) )
+	{
+		return sim_time_ns();
+	}
+	if( g_irq_fall_due < next )
+	{
+		next = g_irq_fall_due;
+	}
+	if( g_write_free_due < next )
+	{
+		next = g_write_free_due;
+	}
+	if( g_dma_due < next )
+	{
+		next = g_dma_due;
+	}
+	return next;
+}
+
+/* ============================================================================
+ * Test side
+ * ==========================================================================*/
+void sim_spi_default_config( sim_spi_config_t * p_cfg )
+{
+	memset( p_cfg, 0, sizeof( *p_cfg ) );
+	p_cfg->sck_hz = SIM_SPI_SCK_HZ_DEFAULT;
+	p_cfg->wake_ns = 30000U;
+	p_cfg->irq_low_ns = 2000U;
+	p_cfg->next_irq_ns = 20000U;
+	p_cfg->call_ns = 2000U;
+	p_cfg->dma_setup_ns = 3000U;
+	p_cfg->dma_irq_ns = 2000U;
+	p_cfg->gpio_read_ns = 100U;
+	p_cfg->write_buffer = SIM_SPI_FRAME_MAX;
+	p_cfg->write_drain_ns = 50000U;
+}
+
+void sim_spi_slave_init( const sim_spi_config_t * p_cfg )
+{
+	if( NULL == p_cfg )
+	{
+		sim_spi_default_config( &g_cfg );
+	}
+	else
+	{
+		g_cfg = *p_cfg;
+	}
+	memset( &g_stats, 0, sizeof( g_stats ) );
+	memset( &g_events, 0, sizeof( g_events ) );
+	memset( &g_commands, 0, sizeof( g_commands ) );
+	g_phase = SIM_SPI_IDLE;
+	g_irq = false;
+	host_gpioa.IDR &= ~(uint32_t)HCI_TL_SPI_IRQ_PIN;
+	g_irq_rise_due = SIM_SPI_NEVER;
+	g_irq_fall_due = SIM_SPI_NEVER;
+	g_exti0_pending = false;
+	g_write_used = 0;
+	g_write_free_due = SIM_SPI_NEVER;
+	g_dma_busy = false;
+	g_dma_due = SIM_SPI_NEVER;
+	g_dma_cb = NULL;
+	sim_clock_register( &g_spi_clock );
+}
+
+sim_spi_config_t * sim_spi_config( void )
+{
+	return &g_cfg;
+}
+
+bool sim_spi_slave_queue( const uint8_t * frame, uint16_t len )
+{
+	if( false == sim_spi_fifo_push( &g_events, frame, len ) )
+	{
+		return false;
+	}
+	/* Nothing in progress: raise IRQ now */
+	if( ( SIM_SPI_IDLE == g_phase ) && ( false == g_irq ) && ( false == g_cfg.irq_dead ) && ( SIM_SPI_NEVER == g_irq_rise_due ) )
+	{
+		g_irq_rise_due = sim_time_ns();
+		sim_time_advance_to( sim_time_ns() );
+	}
+	return true;
+}
+
+uint32_t sim_spi_slave_queued( void )
+{
+	return g_events.count;
+}
+
+uint16_t sim_spi_slave_pop_write( uint8_t * out, uint16_t size )
+{
+	const sim_spi_frame_t * p_frame = sim_spi_fifo_peek( &g_commands );
+	uint16_t len;
+
+	if( NULL == p_frame )
+	{
+		return 0;
+	}
+	len = ( p_frame->len < size ) ? p_frame->len : size;
+	memcpy( out, p_frame->data, len );
+	sim_spi_fifo_drop( &g_commands );
+	return len;
+}
+
+bool sim_spi_slave_irq( void )
+{
+	return g_irq;
+}
+
+void sim_spi_get_stats( sim_spi_stats_t * p_stats )
+{
+	*p_stats = g_stats;
+}
+
+void sim_spi_clear_stats( void )
+{
+	memset( &g_stats, 0, sizeof( g_stats ) );
+}
+
+bool sim_spi_pendsv( void )
+{
+	const uint32_t ipsr = host_ipsr;
+
+	/* Held off by BASEPRI (HCI_TL_SPI_Lock) like on the core: stays pended */
+	if( ( 0U == ( SCB->ICSR & SCB_ICSR_PENDSVSET_Msk ) )
+	 || ( ( 0U != __get_BASEPRI() ) && ( __get_BASEPRI() <= ( HCI_TL_SPI_BH_IT_PRIORITY << ( 8U - __NVIC_PRIO_BITS ) ) ) ) )
+	{
+		return false;
+	}
+	SCB->ICSR = 0;
+	host_ipsr = SIM_SPI_IPSR_PENDSV;
+	hci_tl_lowlevel_bottom_half();
+	host_ipsr = ipsr;
+	return true;
+}
+
+/* ============================================================================
+ * Board
+ * ==========================================================================*/
+void host_cpu_wait( void )
+{
+	sim_time_idle();
+}
+
+void HAL_NVIC_EnableIRQ( IRQn_Type IRQn )
+{
+	if( EXTI0_IRQn == IRQn )
+	{
+		g_exti0_enabled = true;
+		if( g_exti0_pending )
+		{
+			g_exti0_pending = false;
+			sim_spi_exti0();
+		}
+	}
+}
+
+void HAL_NVIC_DisableIRQ( IRQn_Type IRQn )
+{
+	if( EXTI0_IRQn == IRQn )
+	{
+		g_exti0_enabled = false;
+	}
+}
+
+void HAL_NVIC_SetPendingIRQ( IRQn_Type IRQn )
+{
+	if( EXTI0_IRQn == IRQn )
+	{
+		if( g_exti0_enabled )
+		{
+			sim_spi_exti0();
+		}
+		else
+		{
+			g_exti0_pending = true;
+		}
+	}
+}
+
+void HAL_GPIO_Init( GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init )
+{
+	(void)GPIOx;
+	(void)GPIO_Init;
+}
+
+void HAL_GPIO_DeInit( GPIO_TypeDef * GPIOx, uint32_t GPIO_Pin )
+{
+	(void)GPIOx;
+	(void)GPIO_Pin;
+}
+
+/* One pass of a polling loop */
+GPIO_PinState HAL_GPIO_ReadPin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin )
+{
+	sim_time_advance_ns( g_cfg.gpio_read_ns );
+	return ( 0U != ( GPIOx->IDR & GPIO_Pin ) ) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin( GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState )
+{
+	const uint32_t before = GPIOx->ODR;
+
+	if( GPIO_PIN_SET == PinState )
+	{
+		GPIOx->ODR |= GPIO_Pin;
+	}
+	else
+	{
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+	}
+	if( ( &host_gpioa != GPIOx ) || ( before == GPIOx->ODR ) )
+	{
+		return;
+	}
+	if( HCI_TL_SPI_CS_PIN == GPIO_Pin )
+	{
+		if( GPIO_PIN_RESET == PinState )
+		{
+			sim_spi_cs_low();
+		}
+		else
+		{
+			sim_spi_cs_high();
+		}
+	}
+	else if( ( HCI_TL_RST_PIN == GPIO_Pin ) && ( GPIO_PIN_RESET == PinState ) )
+	{
+		/* Reset: frame and command buffer lost, queued events kept for the test */
+		g_phase = SIM_SPI_IDLE;
+		g_write_used = 0;
+		g_irq_fall_due = SIM_SPI_NEVER;
+		sim_spi_irq_set( false );
+		if( 0U != g_events.count )
+		{
+			g_irq_rise_due = sim_time_ns() + g_cfg.next_irq_ns;
+		}
+	}
+}
+
+HAL_StatusTypeDef HAL_EXTI_GetHandle( EXTI_HandleTypeDef * hexti, uint32_t ExtiLine )
+{
+	hexti->Line = ExtiLine;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_EXTI_RegisterCallback( EXTI_HandleTypeDef * hexti, EXTI_CallbackIDTypeDef CallbackID, void ( * pPendingCbfn )( void ) )
+{
+	(void)CallbackID;
+	hexti->PendingCallback = pPendingCbfn;
+	if( EXTI_LINE_0 == hexti->Line )
+	{
+		g_exti0_cb = pPendingCbfn;
+	}
+	return HAL_OK;
+}
+
+int32_t BSP_GetTick( void )
+{
+	return (int32_t)HAL_GetTick();
+}
+
+int32_t BSP_SPI1_Init( void )
+{
+	host_gpioa.ODR |= HCI_TL_SPI_CS_PIN;
+	return BSP_ERROR_NONE;
+}
+
+int32_t BSP_SPI1_DeInit( void )
+{
+	return BSP_ERROR_NONE;
+}
+
+/* HAL_SPI_TransmitReceive(): the core clocks every byte */
+int32_t BSP_SPI1_SendRecv( uint8_t * pTxData, uint8_t * pRxData, uint16_t Length )
+{
+	const uint64_t busy = g_cfg.call_ns + ( (uint64_t)Length * sim_spi_byte_ns() );
+
+	sim_time_advance_ns( busy );
+	g_stats.cpu_busy_ns += busy;
+	sim_spi_exchange( pTxData, pRxData, Length );
+	return BSP_ERROR_NONE;
+}
+
+#if ( USE_BSP_SPI1_DMA == 1U )
+int32_t BSP_SPI1_SendRecv_DMA( uint8_t * pTxData, uint8_t * pRxData, uint16_t Length, BSP_SPI_XferCpltCb_t XferCpltCb )
+{
+	if( g_dma_busy )
+	{
+		return BSP_ERROR_BUSY;
+	}
+	/* Stream setup on the core, then the bytes go without it */
+	sim_time_advance_ns( g_cfg.call_ns );
+	g_stats.cpu_busy_ns += g_cfg.call_ns;
+	g_stats.dma_transfers++;
+	g_dma_tx = pTxData;
+	g_dma_rx = pRxData;
+	g_dma_len = Length;
+	g_dma_cb = XferCpltCb;
+	g_dma_busy = true;
+	/* A hung stream is only freed by BSP_SPI1_AbortDMA() */
+	g_dma_due = g_cfg.dma_hang ? SIM_SPI_NEVER
+	          : ( sim_time_ns() + g_cfg.dma_setup_ns + ( (uint64_t)Length * sim_spi_byte_ns() ) + g_cfg.dma_irq_ns );
+	return BSP_ERROR_NONE;
+}
+
+int32_t BSP_SPI1_AbortDMA( void )
+{
+	g_dma_busy = false;
+	g_dma_due = SIM_SPI_NEVER;
+	g_dma_cb = NULL;
+	return BSP_ERROR_NONE;
+}
+#endif /* ( USE_BSP_SPI1_DMA == 1U ) */
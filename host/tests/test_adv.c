@@ -0,0 +1,226 @@
+/*
+ * test_adv.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Advertising scheduler (app_adv.c) against the simulated controller:
+ *   - duty cycle of the FAST and SLOW phases: advertising events per second
+ *     and radio time, counted by the controller, against the phase times and
+ *     event estimate of adv_stats_t,
+ *   - time to reconnect of a central that scans again right after the
+ *     disconnect (FAST), that comes back once the burst is over (SLOW), and
+ *     of the bonded central (DIRECTED).
+ * The centrals scan with SCAN_INTERVAL_US / SCAN_WINDOW_US.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define SCAN_INTERVAL_US			( 100000U )
+#define SCAN_WINDOW_US				( 50000U )
+#define TRIALS								( 20U )
+#define SLOW_TRIALS						( 5U )
+/* Connected long enough for the link procedures, pairing included */
+#define CONNECTED_MS					( 1500U )
+#define RECONNECT_TIMEOUT_MS	( 10000U )
+
+/* Advertising event period bounds of a phase: advInterval + advDelay (0 .. 10 ms) */
+#define EVENT_MIN_NS( interv )	( (uint64_t)( interv ) * 625U * SIM_NS_PER_US )
+#define EVENT_MAX_NS( interv )	( ( (uint64_t)( interv ) * 625U * SIM_NS_PER_US ) + ( 10ULL * SIM_NS_PER_MS ) )
+
+typedef struct
+{
+	uint32_t n;
+	uint64_t sum_ns;
+	uint64_t max_ns;
+} reconnect_t;
+
+static sim_central_t g_central;
+
+static bool cond_connected( void * arg )
+{
+	return 0xFFFFU != ( (const sim_central_t *)arg )->conn_handle;
+}
+
+static bool cond_encrypted( void * arg )
+{
+	sim_conn_stats_t stats;
+
+	return sim_conn_stats( (const sim_central_t *)arg, &stats ) && stats.encrypted;
+}
+
+static bool cond_disconnected( void * arg )
+{
+	(void)arg;
+	return 0U == link_count();
+}
+
+static bool cond_linked( void * arg )
+{
+	(void)arg;
+	return 0U != link_count();
+}
+
+static bool cond_phase( void * arg )
+{
+	return adv_get_phase() == *(const adv_phase_t *)arg;
+}
+
+/* Events of the window [before, after] within the bounds of the interval range */
+static void check_duty_cycle( const char * name, const sim_ctrl_stats_t * p_before, const sim_ctrl_stats_t * p_after,
+                              uint32_t app_time_ms, uint16_t interv_min, uint16_t interv_max )
+{
+	const uint64_t on_ns = p_after->adv_on_ns - p_before->adv_on_ns;
+	const uint32_t events = p_after->adv_events - p_before->adv_events;
+	const uint64_t air_ns = p_after->adv_airtime_ns - p_before->adv_airtime_ns;
+	const uint32_t app_events = (uint32_t)( ( (uint64_t)app_time_ms * SIM_NS_PER_MS ) /
+	                            ( ( ( EVENT_MIN_NS( interv_min ) + EVENT_MIN_NS( interv_max ) ) / 2U ) + ( 5ULL * SIM_NS_PER_MS ) ) );
+
+	CHECK( 0U != events );
+	if( 0U == events )
+	{
+		return;
+	}
+	fprintf( stderr, "  %-4s : %6lu ms on, %5lu events, %7.2f ms per event, radio %.3f %% (adv_stats: %6lu ms, ~%lu events)\n",
+	         name, (unsigned long)( on_ns / SIM_NS_PER_MS ), (unsigned long)events,
+	         (double)on_ns / events / SIM_NS_PER_MS, ( 100.0 * (double)air_ns ) / (double)on_ns,
+	         (unsigned long)app_time_ms, (unsigned long)app_events );
+
+	/* Controller free to pick any interval of [min, max]; the first event
+	 * comes with the start, the last period is cut by the stop */
+	CHECK( on_ns >= ( ( events - 1U ) * EVENT_MIN_NS( interv_min ) ) );
+	CHECK( on_ns <= ( events * EVENT_MAX_NS( interv_max ) ) );
+	/* Phase time seen by the application: the controller one, give or take
+	 * the ms tick and the connection complete event */
+	CHECK( ( app_time_ms + 2U ) >= ( on_ns / SIM_NS_PER_MS ) );
+	CHECK( app_time_ms <= ( ( on_ns / SIM_NS_PER_MS ) + 10U ) );
+	/* The adv_print_stats() estimate within the same bounds */
+	CHECK( ( (uint64_t)app_events * EVENT_MIN_NS( interv_min ) ) <= ( on_ns + EVENT_MAX_NS( interv_max ) ) );
+	CHECK( ( (uint64_t)app_events * EVENT_MAX_NS( interv_max ) ) >= ( on_ns - EVENT_MAX_NS( interv_max ) ) );
+}
+
+/* Central scans from now until it connects, then stays for CONNECTED_MS and leaves */
+static bool reconnect( reconnect_t * p_rec, uint64_t from_ns )
+{
+	uint64_t ns;
+
+	sim_central_scan( &g_central, SCAN_INTERVAL_US, SCAN_WINDOW_US );
+	if( false == sim_run_until( cond_connected, &g_central, RECONNECT_TIMEOUT_MS ) )
+	{
+		sim_central_stop_scan( &g_central );
+		return false;
+	}
+	ns = g_central.connected_ns - from_ns;
+	p_rec->n++;
+	p_rec->sum_ns += ns;
+	p_rec->max_ns = ( ns > p_rec->max_ns ) ? ns : p_rec->max_ns;
+
+	sim_run_ms( CONNECTED_MS );
+	sim_disconnect( &g_central, 0x13U );
+	return sim_run_until( cond_disconnected, NULL, 1000U );
+}
+
+static void print_reconnect( const char * name, const reconnect_t * p_rec )
+{
+	if( 0U != p_rec->n )
+	{
+		fprintf( stderr, "  %-8s : %2lu reconnects, mean %7.1f ms, max %7.1f ms\n", name, (unsigned long)p_rec->n,
+		         (double)p_rec->sum_ns / p_rec->n / SIM_NS_PER_MS, (double)p_rec->max_ns / SIM_NS_PER_MS );
+	}
+}
+
+int main( void )
+{
+	static const adv_phase_t slow = ADV_PHASE_SLOW;
+	sim_ctrl_stats_t start;
+	sim_ctrl_stats_t at_slow;
+	sim_ctrl_stats_t end;
+	adv_stats_t adv;
+	reconnect_t fast_rec = { 0 };
+	reconnect_t slow_rec = { 0 };
+	reconnect_t directed_rec = { 0 };
+	uint32_t i;
+
+	sim_ctrl_power_on( 21U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	sim_ctrl_get_stats( &start );
+
+	/* Nobody around: the boot burst, then the slow phase */
+	fprintf( stderr, "Advertising duty cycle\n" );
+	CHECK( sim_run_until( cond_phase, (void *)&slow, ADV_FAST_WINDOW_MS + 1000U ) );
+	sim_ctrl_get_stats( &at_slow );
+	adv_get_stats( &adv );
+	CHECK_EQ( adv.phase[ADV_PHASE_FAST].starts, 1 );
+	check_duty_cycle( "fast", &start, &at_slow, adv.phase[ADV_PHASE_FAST].time_ms, ADV_FAST_INTERV_MIN, ADV_FAST_INTERV_MAX );
+
+	/* The slow phase is accounted when it ends: a central arrives. Controller
+	 * counts at the CONNECT_IND, application ones at the connection complete */
+	sim_run_ms( 60000U );
+	sim_central_init( &g_central, 0x21U );
+	g_central.pairs = false;
+	sim_central_scan( &g_central, SCAN_INTERVAL_US, SCAN_WINDOW_US );
+	CHECK( sim_run_until( cond_connected, &g_central, RECONNECT_TIMEOUT_MS ) );
+	sim_ctrl_get_stats( &end );
+	CHECK( sim_run_until( cond_linked, NULL, 1000U ) );
+	adv_get_stats( &adv );
+	check_duty_cycle( "slow", &at_slow, &end, adv.phase[ADV_PHASE_SLOW].time_ms, ADV_INTERV_MIN, ADV_INTERV_MAX );
+	sim_run_ms( CONNECTED_MS );
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_disconnected, NULL, 1000U ) );
+
+	/* Unbonded central scanning again straight after the disconnect: fast burst */
+	fprintf( stderr, "Time to reconnect, scan %u / %u ms\n", SCAN_WINDOW_US / 1000U, SCAN_INTERVAL_US / 1000U );
+	for( i = 0; TRIALS > i; i++ )
+	{
+		CHECK( reconnect( &fast_rec, g_central.disconnected_ns ) );
+	}
+
+	/* Same central back once the burst is over */
+	for( i = 0; SLOW_TRIALS > i; i++ )
+	{
+		CHECK( sim_run_until( cond_phase, (void *)&slow, ADV_FAST_WINDOW_MS + 1000U ) );
+		/* Anywhere into the slow phase */
+		sim_run_ms( 100U + ( 397U * i ) );
+		CHECK( reconnect( &slow_rec, sim_time_ns() ) );
+	}
+
+	/* Bonded central: pairs once, then found by the directed advertising */
+	sim_central_init( &g_central, 0x22U );
+	sim_central_scan( &g_central, SCAN_INTERVAL_US, SCAN_WINDOW_US );
+	CHECK( sim_run_until( cond_connected, &g_central, RECONNECT_TIMEOUT_MS ) );
+	CHECK( sim_run_until( cond_encrypted, &g_central, 2000U ) );
+	sim_run_ms( 500U );
+	CHECK( g_central.has_keys );
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_disconnected, NULL, 1000U ) );
+	sim_ctrl_get_stats( &start );
+	for( i = 0; TRIALS > i; i++ )
+	{
+		CHECK( reconnect( &directed_rec, g_central.disconnected_ns ) );
+	}
+	sim_ctrl_get_stats( &end );
+	/* Found by every directed burst, none timed out */
+	CHECK_EQ( end.directed_timeouts, start.directed_timeouts );
+	adv_get_stats( &adv );
+	CHECK( TRIALS <= adv.phase[ADV_PHASE_DIRECTED].connects );
+
+	print_reconnect( "fast", &fast_rec );
+	print_reconnect( "slow", &slow_rec );
+	print_reconnect( "directed", &directed_rec );
+	adv_print_stats();
+
+	CHECK_EQ( fast_rec.n, TRIALS );
+	CHECK_EQ( directed_rec.n, TRIALS );
+	/* A scan window always covers a fast advertising event (30 ms + advDelay < 50 ms) */
+	CHECK( fast_rec.max_ns <= ( ( SCAN_INTERVAL_US * SIM_NS_PER_US ) + ( 100ULL * SIM_NS_PER_MS ) ) );
+	/* Directed events every 3.75 ms: first scan window */
+	CHECK( directed_rec.max_ns <= ( ( SCAN_INTERVAL_US * SIM_NS_PER_US ) + ( 100ULL * SIM_NS_PER_MS ) ) );
+	/* The burst is what makes the difference */
+	CHECK( ( slow_rec.sum_ns / slow_rec.n ) > ( 4U * ( fast_rec.sum_ns / fast_rec.n ) ) );
+
+	return TEST_END( "test_adv" );
+}
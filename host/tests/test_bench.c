@@ -0,0 +1,205 @@
+/*
+ * test_bench.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Benchmark mode (app_bench.c) against the simulated controller, driven the
+ * way a central drives it on target: BENCH_CMD_START / BENCH_CMD_STOP
+ * written to health_control_rx on a paired link, notifications counted on
+ * health_bench_tx. The SUITE runs are the ones to repeat on the board, so
+ * both sets of numbers compare.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define RUN_TIMEOUT_MS				( 60000U )
+
+extern uint16_t health_control_rx_char_handle;
+extern uint16_t health_bench_tx_char_handle;
+
+typedef struct
+{
+	uint8_t size;
+	uint16_t count;
+} bench_run_t;
+
+/* Notification sizes: default ATT_MTU, a mid size, ATT_MTU 247 */
+static const bench_run_t SUITE[] = {
+	{ 20U, 1000U },
+	{ 100U, 1000U },
+	{ 244U, 1000U },
+};
+
+static sim_central_t g_central;
+static uint32_t g_rx_seq;
+static uint32_t g_rx_errors;
+static uint16_t g_rx_len;
+static uint64_t g_rx_first_ns;
+static uint64_t g_rx_last_ns;
+
+/* Payload: 32-bit sequence number, then the 0, 1, 2... filler */
+static void on_notify( void * p_central, uint16_t attr_handle, const uint8_t * data, uint16_t len )
+{
+	uint32_t seq;
+
+	(void)p_central;
+	memcpy( &seq, data, sizeof( seq ) );
+	if( ( ( health_bench_tx_char_handle + 1U ) != attr_handle ) || ( g_rx_len != len ) || ( g_rx_seq != seq ) ||
+	    ( ( BENCH_SEQ_LEN < len ) && ( BENCH_SEQ_LEN != data[BENCH_SEQ_LEN] ) ) )
+	{
+		g_rx_errors++;
+	}
+	if( 0U == g_rx_seq )
+	{
+		g_rx_first_ns = sim_time_ns();
+	}
+	g_rx_last_ns = sim_time_ns();
+	g_rx_seq = seq + 1U;
+}
+
+static bool cond_advertising( void * arg )
+{
+	(void)arg;
+	return sim_ctrl_is_advertising();
+}
+
+static bool cond_encrypted( void * arg )
+{
+	sim_conn_stats_t stats;
+
+	return sim_conn_stats( (const sim_central_t *)arg, &stats ) && stats.encrypted;
+}
+
+static bool cond_bench_done( void * arg )
+{
+	(void)arg;
+	return false == bench_is_running();
+}
+
+static uint8_t bench_command( uint8_t cmd, uint8_t size, uint16_t count )
+{
+	uint8_t data[BENCH_CMD_START_LEN] = { cmd, size, (uint8_t)( count ), (uint8_t)( count >> 8 ) };
+	const uint8_t status = sim_write( &g_central, health_control_rx_char_handle + 1U, data,
+	                                  ( BENCH_CMD_START == cmd ) ? BENCH_CMD_START_LEN : 1U );
+
+	sim_run_ms( 5U );
+	return status;
+}
+
+static void expect_rx( uint8_t size )
+{
+	g_central.notifications = 0;
+	g_central.notified_bytes = 0;
+	g_rx_seq = 0;
+	g_rx_errors = 0;
+	g_rx_len = size;
+}
+
+static void run_suite( void )
+{
+	bench_result_t result;
+	uint32_t i;
+
+	fprintf( stderr, "  size count : bytes/s (central)  notif/event  busy retries  elapsed\n" );
+	for( i = 0; ( sizeof( SUITE ) / sizeof( SUITE[0] ) ) > i; i++ )
+	{
+		const bench_run_t * p_run = &SUITE[i];
+		uint32_t rate;
+		uint32_t rx_rate;
+		uint32_t per_evt_x100;
+
+		expect_rx( p_run->size );
+		CHECK_EQ( bench_command( BENCH_CMD_START, p_run->size, p_run->count ), 0 );
+		CHECK( sim_run_until( cond_bench_done, NULL, RUN_TIMEOUT_MS ) );
+		/* Last notifications still in the controller */
+		sim_run_ms( 100U );
+		bench_get_result( &result );
+
+		CHECK_EQ( result.sent, p_run->count );
+		CHECK_EQ( g_central.notifications, p_run->count );
+		CHECK_EQ( g_rx_errors, 0 );
+		CHECK_EQ( result.att_mtu, SIM_ATT_MTU_MAX );
+		CHECK_EQ( result.conn_interval, g_central.conn_interval );
+		/* More notifications than the controller TX pool holds: it pushed back */
+		CHECK( 0U != result.busy_retries );
+		CHECK( 0U != result.elapsed_ms );
+		if( ( 0U == result.elapsed_ms ) || ( g_rx_last_ns <= g_rx_first_ns ) || ( 0U == result.conn_interval ) )
+		{
+			continue;
+		}
+
+		/* Same formulas as bench_print_result() */
+		rate = (uint32_t)( ( (uint64_t)result.sent * result.size * 1000U ) / result.elapsed_ms );
+		per_evt_x100 = ( result.sent * 100U ) / (uint32_t)( ( (uint64_t)result.elapsed_ms * 1000U ) / ( result.conn_interval * 1250U ) );
+		/* Rate seen by the central, first to last notification */
+		rx_rate = (uint32_t)( ( (uint64_t)( p_run->count - 1U ) * p_run->size * SIM_NS_PER_MS * 1000U ) / ( g_rx_last_ns - g_rx_first_ns ) );
+
+		fprintf( stderr, "  %4u %5u : %7lu (%7lu)  %8lu.%02lu  %12lu  %5lu ms\n",
+		         p_run->size, p_run->count, (unsigned long)rate, (unsigned long)rx_rate,
+		         (unsigned long)( per_evt_x100 / 100U ), (unsigned long)( per_evt_x100 % 100U ),
+		         (unsigned long)result.busy_retries, (unsigned long)result.elapsed_ms );
+
+		/* The firmware report agrees with what went over the air (within 5 %) */
+		CHECK( ( rate * 100U ) <= ( rx_rate * 105U ) );
+		CHECK( ( rate * 105U ) >= ( rx_rate * 100U ) );
+	}
+}
+
+int main( void )
+{
+	bench_result_t result;
+
+	sim_ctrl_power_on( 13U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	CHECK( sim_run_until( cond_advertising, NULL, 1000U ) );
+
+	/* Control RX needs an encrypted link: pair, then subscribe. The central
+	 * keeps its 30 ms interval (refuses the L2CAP updates of app_conn_profile.c)
+	 * so that every run of the suite sees the same link */
+	sim_central_init( &g_central, 0x13U );
+	g_central.accept_params = false;
+	g_central.on_notify = on_notify;
+	CHECK( 0xFFFFU != sim_connect( &g_central ) );
+	CHECK( sim_run_until( cond_encrypted, &g_central, 2000U ) );
+	sim_run_ms( 500U );
+	CHECK_EQ( sim_subscribe( &g_central, health_bench_tx_char_handle, true ), 0 );
+	sim_run_ms( 10U );
+	CHECK( link_any_subscribed( LINK_CCCD_BENCH_TX ) );
+
+	fprintf( stderr, "Benchmark mode, ATT_MTU %u, interval %u x 1.25 ms\n", link_get_att_mtu( g_central.conn_handle ), g_central.conn_interval );
+	run_suite();
+
+	/* Larger than ATT_MTU - 3: refused, nothing streamed */
+	expect_rx( 245U );
+	CHECK_EQ( bench_command( BENCH_CMD_START, 245U, 10U ), 0 );
+	CHECK( false == bench_is_running() );
+	sim_run_ms( 100U );
+	CHECK_EQ( g_central.notifications, 0 );
+
+	/* Stopped mid run: reports what was sent */
+	expect_rx( 64U );
+	CHECK_EQ( bench_command( BENCH_CMD_START, 64U, 60000U ), 0 );
+	CHECK( bench_is_running() );
+	sim_run_ms( 300U );
+	CHECK_EQ( bench_command( BENCH_CMD_STOP, 0U, 0U ), 0 );
+	CHECK( false == bench_is_running() );
+	bench_get_result( &result );
+	CHECK( ( 0U != result.sent ) && ( 60000U > result.sent ) );
+	sim_run_ms( 100U );
+	CHECK_EQ( g_central.notifications, result.sent );
+	CHECK_EQ( g_rx_errors, 0 );
+
+	/* Central gone mid run: the run ends with it */
+	expect_rx( 64U );
+	CHECK_EQ( bench_command( BENCH_CMD_START, 64U, 60000U ), 0 );
+	sim_run_ms( 100U );
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_bench_done, NULL, 1000U ) );
+
+	return TEST_END( "test_bench" );
+}
@@ -0,0 +1,242 @@
+/*
+ * test_codec.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * app_codec.c round trip: frames coded the way app_sampler.c codes them
+ * (codec_put_sample), decoded by the reference decoder. Built from app_codec.c
+ * alone with only Core/Inc on the include path, as a central would build it.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "app_codec.h"
+#include "test_util.h"
+
+#define ADC_MAX								( 4095U )			/* 12-bit samples */
+#define FRAME_MAX							( 244U )			/* ATT_MTU 247 - 3 */
+#define SAMPLES_MAX						( 64U )
+
+typedef struct
+{
+	uint8_t data[FRAME_MAX];
+	uint16_t len;
+	uint16_t prev[CODEC_CHANNELS];
+} frame_t;
+
+static void frame_open( frame_t * p_frame, uint8_t version, uint32_t ts_ms )
+{
+	memset( p_frame, 0, sizeof( *p_frame ) );
+	p_frame->data[0] = version;
+	p_frame->data[2] = (uint8_t)( ts_ms );
+	p_frame->data[3] = (uint8_t)( ts_ms >> 8 );
+	p_frame->data[4] = (uint8_t)( ts_ms >> 16 );
+	p_frame->data[5] = (uint8_t)( ts_ms >> 24 );
+	p_frame->len = CODEC_FRAME_HEADER_LEN;
+}
+
+/* Appends one record, false when the worst case record would not fit (sampler rule) */
+static bool frame_put( frame_t * p_frame, uint8_t dt_ms, const uint16_t * p_value )
+{
+	const uint16_t worst = ( CODEC_FRAME_VERSION_DELTA == p_frame->data[0] ) ? CODEC_RECORD_DELTA_MAX : CODEC_RECORD_RAW_LEN;
+	uint32_t ch;
+
+	if( ( p_frame->len + worst ) > FRAME_MAX )
+	{
+		return false;
+	}
+	if( CODEC_FRAME_VERSION_DELTA == p_frame->data[0] )
+	{
+		const uint8_t n = codec_put_sample( dt_ms, p_value, p_frame->prev, &p_frame->data[p_frame->len] );
+		CHECK( CODEC_RECORD_DELTA_MAX >= n );
+		p_frame->len += n;
+	}
+	else
+	{
+		p_frame->data[p_frame->len++] = dt_ms;
+		for( ch = 0; CODEC_CHANNELS > ch; ch++ )
+		{
+			p_frame->data[p_frame->len++] = (uint8_t)( p_value[ch] );
+			p_frame->data[p_frame->len++] = (uint8_t)( p_value[ch] >> 8 );
+		}
+	}
+	p_frame->data[1]++;
+	return true;
+}
+
+/* Codes n samples into one frame, decodes it and compares */
+static void round_trip( uint8_t version, uint32_t ts0, const uint8_t * p_dt, const uint16_t ( * p_values )[CODEC_CHANNELS], uint16_t n )
+{
+	codec_sample_t out[SAMPLES_MAX];
+	frame_t frame;
+	uint32_t ts = ts0;
+	uint32_t ok = 0;
+	uint16_t i;
+
+	frame_open( &frame, version, ts0 );
+	for( i = 0; n > i; i++ )
+	{
+		CHECK( frame_put( &frame, p_dt[i], p_values[i] ) );
+	}
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, out, SAMPLES_MAX ), n );
+	for( i = 0; n > i; i++ )
+	{
+		ts += p_dt[i];
+		if( ( ts == out[i].ts_ms ) && ( 0 == memcmp( out[i].value, p_values[i], sizeof( out[i].value ) ) ) )
+		{
+			ok++;
+		}
+	}
+	CHECK_EQ( ok, n );
+}
+
+static void test_primitives( void )
+{
+	static const int32_t zz[] = { 0, -1, 1, -2, 2, (int32_t)ADC_MAX, -(int32_t)ADC_MAX, INT16_MAX, INT16_MIN, INT32_MAX, INT32_MIN };
+	static const uint32_t vi[] = { 0U, 1U, 127U, 128U, 16383U, 16384U, 65535U, 2097151U, 2097152U, UINT32_MAX };
+	uint8_t buf[CODEC_VARINT32_MAX + 1U];
+	uint32_t v;
+	uint32_t i;
+
+	CHECK_EQ( codec_zigzag_encode( 0 ), 0 );
+	CHECK_EQ( codec_zigzag_encode( -1 ), 1 );
+	CHECK_EQ( codec_zigzag_encode( 1 ), 2 );
+	CHECK_EQ( codec_zigzag_encode( -(int32_t)ADC_MAX ), 8189 );
+	CHECK_EQ( codec_zigzag_encode( (int32_t)ADC_MAX ), 8190 );
+	for( i = 0; ( sizeof( zz ) / sizeof( zz[0] ) ) > i; i++ )
+	{
+		CHECK_EQ( codec_zigzag_decode( codec_zigzag_encode( zz[i] ) ), zz[i] );
+	}
+
+	for( i = 0; ( sizeof( vi ) / sizeof( vi[0] ) ) > i; i++ )
+	{
+		const uint8_t n = codec_varint_put( vi[i], buf );
+		CHECK_EQ( codec_varint_get( buf, n, &v ), n );
+		CHECK_EQ( v, vi[i] );
+		/* Truncated */
+		CHECK_EQ( codec_varint_get( buf, n - 1U, &v ), 0 );
+	}
+	/* Every 16-bit value within CODEC_VARINT16_MAX bytes, a ±4095 difference in 2 */
+	CHECK_EQ( codec_varint_put( 65535U, buf ), CODEC_VARINT16_MAX );
+	CHECK_EQ( codec_varint_put( UINT32_MAX, buf ), CODEC_VARINT32_MAX );
+	CHECK_EQ( codec_varint_put( codec_zigzag_encode( -(int32_t)ADC_MAX ), buf ), 2 );
+	/* Too long: continuation bit set on the last allowed byte */
+	memset( buf, 0x80, sizeof( buf ) );
+	CHECK_EQ( codec_varint_get( buf, sizeof( buf ), &v ), 0 );
+}
+
+/* Full scale steps both ways, dt of 0 and of 255 */
+static void test_extremes( void )
+{
+	static const uint8_t dt[] = { 0U, 255U, 1U, 255U, 0U, 255U, 10U };
+	static const uint16_t values[][CODEC_CHANNELS] = {
+		{ ADC_MAX, 0U },			/* +4095 / 0 against the keyframe 0 */
+		{ 0U, ADC_MAX },			/* -4095 / +4095 */
+		{ ADC_MAX, 0U },			/* +4095 / -4095 */
+		{ ADC_MAX, 0U },			/* 0 / 0 */
+		{ 0U, ADC_MAX },
+		{ 2048U, 2047U },
+		{ 2047U, 2048U },
+	};
+	const uint16_t n = sizeof( dt ) / sizeof( dt[0] );
+	frame_t frame;
+
+	round_trip( CODEC_FRAME_VERSION_DELTA, 0U, dt, values, n );
+	round_trip( CODEC_FRAME_VERSION_RAW, 0U, dt, values, n );
+	/* Timestamp wrap of the 32-bit header time */
+	round_trip( CODEC_FRAME_VERSION_DELTA, UINT32_MAX - 300U, dt, values, n );
+
+	/* ±4095 with dt 255 is the worst case the sampler sizes frames for */
+	frame_open( &frame, CODEC_FRAME_VERSION_DELTA, 0U );
+	CHECK( frame_put( &frame, 255U, values[0] ) );
+	CHECK( frame_put( &frame, 255U, values[1] ) );
+	/* dt 2 bytes, +4095 2, 0 1 / dt 2 bytes, -4095 2, +4095 2 */
+	CHECK_EQ( frame.len - CODEC_FRAME_HEADER_LEN, 5U + 6U );
+}
+
+/* Frame filled up to FRAME_MAX with worst case records still decodes */
+static void test_full_frame( void )
+{
+	codec_sample_t out[SAMPLES_MAX];
+	frame_t frame;
+	uint16_t value[CODEC_CHANNELS];
+	uint16_t n = 0;
+
+	frame_open( &frame, CODEC_FRAME_VERSION_DELTA, 1000U );
+	do
+	{
+		value[0] = ( 0U == ( n & 1U ) ) ? ADC_MAX : 0U;
+		value[1] = ADC_MAX - value[0];
+		n++;
+	} while( frame_put( &frame, 255U, value ) );
+	n--;
+	CHECK( FRAME_MAX >= frame.len );
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, out, SAMPLES_MAX ), n );
+	CHECK_EQ( out[n - 1U].ts_ms, 1000U + ( 255U * n ) );
+}
+
+static void test_malformed( void )
+{
+	static const uint8_t dt[] = { 0U, 255U, 3U };
+	static const uint16_t values[][CODEC_CHANNELS] = { { ADC_MAX, 1U }, { 0U, 2U }, { 100U, 3U } };
+	codec_sample_t out[SAMPLES_MAX];
+	frame_t frame;
+	uint16_t i;
+
+	frame_open( &frame, CODEC_FRAME_VERSION_DELTA, 0U );
+	for( i = 0; 3U > i; i++ )
+	{
+		(void)frame_put( &frame, dt[i], values[i] );
+	}
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, out, SAMPLES_MAX ), 3 );
+	/* Truncated anywhere, or a byte too many */
+	for( i = 0; frame.len > i; i++ )
+	{
+		CHECK_EQ( codec_decode_sample_frame( frame.data, i, out, SAMPLES_MAX ), -1 );
+	}
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len + 1U, out, SAMPLES_MAX ), -1 );
+	/* More samples than the caller has room for */
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, out, 2U ), -1 );
+	CHECK_EQ( codec_decode_sample_frame( NULL, frame.len, out, SAMPLES_MAX ), -1 );
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, NULL, SAMPLES_MAX ), -1 );
+	/* Other notifications on the characteristic are not sample frames */
+	frame.data[0] = 0x80U;
+	CHECK_EQ( codec_decode_sample_frame( frame.data, frame.len, out, SAMPLES_MAX ), -1 );
+}
+
+/* Random 12-bit walks and jumps, random dt */
+static void test_random( void )
+{
+	uint8_t dt[SAMPLES_MAX];
+	uint16_t values[SAMPLES_MAX][CODEC_CHANNELS];
+	uint32_t f;
+	uint16_t i;
+
+	srand( 0x5A17U );
+	for( f = 0; 2000U > f; f++ )
+	{
+		const uint16_t n = 1U + (uint16_t)( rand() % 24 );
+		for( i = 0; n > i; i++ )
+		{
+			dt[i] = (uint8_t)( rand() & 0xFF );
+			values[i][0] = (uint16_t)( rand() & ADC_MAX );
+			values[i][1] = ( 0U == i ) ? (uint16_t)( rand() & ADC_MAX ) :
+			               (uint16_t)( ( values[i - 1U][1] + ( rand() % 9 ) - 4 ) & ADC_MAX );
+		}
+		round_trip( ( 0U == ( f & 1U ) ) ? CODEC_FRAME_VERSION_DELTA : CODEC_FRAME_VERSION_RAW, (uint32_t)rand(), dt, (const uint16_t ( * )[CODEC_CHANNELS])values, n );
+	}
+}
+
+int main( void )
+{
+	test_primitives();
+	test_extremes();
+	test_full_frame();
+	test_malformed();
+	test_random();
+
+	return TEST_END( "test_codec" );
+}
@@ -0,0 +1,232 @@
+/*
+ * test_frame_fill.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Sampler frames (app_sampler.c) on health_data_tx with ATT_MTU 23, 100 and
+ * 247, slowly changing and noisy inputs: samples per notification and bytes
+ * per sample, against the raw frame (CODEC_FRAME_VERSION_RAW) of the same
+ * ATT_MTU. Built twice: sampler (CODEC_FRAME_VERSION_DELTA) and sampler_raw,
+ * both with SAMPLER_FLUSH_MS = 1000 so that every frame closes full (at
+ * 100 Hz the firmware 250 ms flush sends 25 samples at most); the rows of
+ * the two builds compare. Each delta record spends a byte on dt and the
+ * frame keeps CODEC_RECORD_DELTA_MAX free until it closes, so the gain stays
+ * under x5/3 whatever the input.
+ *
+ * The ADC model (sim_adc.c) converts source() every SAMPLER_PERIOD_MS;
+ * the central decodes every notification with codec_decode_sample_frame()
+ * and checks each sample against the source at its time stamp.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#if ( 1 == APP_SAMPLER_CODEC )
+#define TEST_NAME							"test_frame_fill (delta)"
+#define FRAME_VERSION					CODEC_FRAME_VERSION_DELTA
+#else
+#define TEST_NAME							"test_frame_fill (raw)"
+#define FRAME_VERSION					CODEC_FRAME_VERSION_RAW
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+
+#define SETTLE_MS							( 1000U )			/* MTU exchange, DLE, PHY, L2CAP update */
+#define WARMUP_MS							( 2000U )			/* First frames after the subscription */
+#define RUN_MS								( 20000U )
+#define FRAME_SAMPLES_MAX			( 128U )
+
+/* Raw frame of the same notification length: the sampler closes it when
+ * the next record would not fit */
+#define RAW_SAMPLES( len )		( ( ( len ) - CODEC_FRAME_HEADER_LEN ) / CODEC_RECORD_RAW_LEN )
+
+extern uint16_t health_data_tx_char_handle;
+
+typedef enum
+{
+	INPUT_SLOW = 0,
+	INPUT_NOISY,
+	INPUT_COUNT,
+} input_t;
+
+static const char * const INPUT_NAMES[INPUT_COUNT] = { "slow", "noisy" };
+
+static sim_central_t g_central;
+static input_t g_input;
+static uint32_t g_rx_samples;
+static uint32_t g_rx_bytes;
+static uint32_t g_rx_frames;
+static uint32_t g_rx_errors;
+
+/* Analog input: +-1 LSB steps of a 200 LSB triangle; temperature sensor:
+ * one LSB of drift every 2.5 s */
+static uint16_t source_slow( uint32_t scan, uint32_t channel )
+{
+	const uint32_t phase = scan % 400U;
+
+	if( ADC_CHANNEL_TEMPSENSOR == channel )
+	{
+		return (uint16_t)( 943U + ( ( scan / 250U ) % 4U ) );
+	}
+	return (uint16_t)( 1800U + ( ( 200U > phase ) ? phase : ( 400U - phase ) ) );
+}
+
+/* Full scale white noise, same value for the same scan and channel */
+static uint16_t source_noisy( uint32_t scan, uint32_t channel )
+{
+	uint32_t x = ( scan * 2654435761U ) ^ ( channel * 0x9E3779B9U );
+
+	x ^= x >> 16;
+	x *= 0x7FEB352DU;
+	x ^= x >> 15;
+	return (uint16_t)( x & 0x0FFFU );
+}
+
+static uint16_t source( uint32_t scan, uint32_t channel )
+{
+	return ( INPUT_NOISY == g_input ) ? source_noisy( scan, channel ) : source_slow( scan, channel );
+}
+
+/* Sampler channel of each value of a record */
+static const uint32_t CHANNELS[SAMPLER_CHANNELS] = {
+	[SAMPLER_CH_ANALOG] = ADC_CHANNEL_10,
+	[SAMPLER_CH_TEMPERATURE] = ADC_CHANNEL_TEMPSENSOR,
+};
+
+static void on_notify( void * p_central, uint16_t attr_handle, const uint8_t * data, uint16_t len )
+{
+	codec_sample_t samples[FRAME_SAMPLES_MAX];
+	int32_t n;
+	int32_t i;
+	uint32_t ch;
+
+	(void)p_central;
+	if( ( health_data_tx_char_handle + 1U ) != attr_handle )
+	{
+		return;
+	}
+	n = codec_decode_sample_frame( data, len, samples, FRAME_SAMPLES_MAX );
+	if( ( FRAME_VERSION != data[0] ) || ( 0 >= n ) )
+	{
+		g_rx_errors++;
+		return;
+	}
+	for( i = 0; n > i; i++ )
+	{
+		const uint32_t scan = samples[i].ts_ms / SAMPLER_PERIOD_MS;
+
+		if( 0U != ( samples[i].ts_ms % SAMPLER_PERIOD_MS ) )
+		{
+			g_rx_errors++;
+		}
+		for( ch = 0; SAMPLER_CHANNELS > ch; ch++ )
+		{
+			if( source( scan, CHANNELS[ch] ) != samples[i].value[ch] )
+			{
+				g_rx_errors++;
+			}
+		}
+	}
+	g_rx_samples += (uint32_t)n;
+	g_rx_bytes += len;
+	g_rx_frames++;
+}
+
+static bool cond_disconnected( void * arg )
+{
+	(void)arg;
+	return 0U == link_count();
+}
+
+/* Samples per notification x 100 */
+static uint32_t fill( uint16_t att_mtu, input_t input, uint8_t addr_last )
+{
+	const uint16_t len = (uint16_t)( att_mtu - LINK_ATT_NOTIFY_OVERHEAD );
+	sampler_stats_t before;
+	sampler_stats_t after;
+	uint32_t per_frame_x100;
+	uint32_t per_sample_x100;
+	uint32_t raw_x100;
+
+	g_input = input;
+	sim_central_init( &g_central, addr_last );
+	g_central.att_mtu = att_mtu;
+	g_central.pairs = false;
+	g_central.on_notify = on_notify;
+	CHECK( 0xFFFFU != sim_connect( &g_central ) );
+	sim_run_ms( SETTLE_MS );
+	CHECK_EQ( link_get_att_mtu( g_central.conn_handle ), att_mtu );
+	CHECK_EQ( sim_subscribe( &g_central, health_data_tx_char_handle, true ), 0 );
+	sim_run_ms( WARMUP_MS );
+
+	g_rx_samples = 0;
+	g_rx_bytes = 0;
+	g_rx_frames = 0;
+	g_rx_errors = 0;
+	sampler_get_stats( &before );
+	sim_run_ms( RUN_MS );
+	sampler_get_stats( &after );
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_disconnected, NULL, 1000U ) );
+
+	/* Every sample decoded as converted, none lost on the way */
+	CHECK_EQ( g_rx_errors, 0 );
+	CHECK_EQ( after.dropped, before.dropped );
+	CHECK( ( 0U != g_rx_frames ) && ( ( g_rx_bytes / g_rx_frames ) <= len ) );
+	if( ( 0U == g_rx_frames ) || ( 0U == g_rx_samples ) )
+	{
+		return 0;
+	}
+
+	per_frame_x100 = ( g_rx_samples * 100U ) / g_rx_frames;
+	per_sample_x100 = ( g_rx_bytes * 100U ) / g_rx_samples;
+	raw_x100 = RAW_SAMPLES( len ) * 100U;
+	fprintf( stderr, "  ATT_MTU %3u %-5s : %3lu.%02lu samples (raw %2u)  %lu.%02lu bytes per sample  x%lu.%02lu\n",
+	         att_mtu, INPUT_NAMES[input],
+	         (unsigned long)( per_frame_x100 / 100U ), (unsigned long)( per_frame_x100 % 100U ), (unsigned)RAW_SAMPLES( len ),
+	         (unsigned long)( per_sample_x100 / 100U ), (unsigned long)( per_sample_x100 % 100U ),
+	         (unsigned long)( ( per_frame_x100 * 100U ) / raw_x100 / 100U ), (unsigned long)( ( per_frame_x100 * 100U ) / raw_x100 % 100U ) );
+
+#if ( 0 == APP_SAMPLER_CODEC )
+	/* Raw frames hold the same count whatever the input */
+	CHECK_EQ( per_frame_x100, raw_x100 );
+#endif /* ( 0 == APP_SAMPLER_CODEC ) */
+	return per_frame_x100;
+}
+
+int main( void )
+{
+	static const uint16_t mtus[] = { LINK_ATT_MTU_DEFAULT, 100U, LINK_ATT_MTU_MAX };
+	uint32_t per_frame_x100[sizeof( mtus ) / sizeof( mtus[0] )][INPUT_COUNT];
+	uint32_t i;
+	uint32_t input;
+
+	sim_adc_set_source( source );
+	sim_ctrl_power_on( 16U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	sim_run_ms( 500U );
+	CHECK( 0U != sim_adc_scans() );
+
+	fprintf( stderr, "Sampler frames, version 0x%02X, %u Hz, per notification against the raw frame (target x2 to x4)\n",
+	         FRAME_VERSION, 1000U / SAMPLER_PERIOD_MS );
+	for( i = 0; ( sizeof( mtus ) / sizeof( mtus[0] ) ) > i; i++ )
+	{
+		for( input = 0; INPUT_COUNT > input; input++ )
+		{
+			per_frame_x100[i][input] = fill( mtus[i], (input_t)input, (uint8_t)( ( i * INPUT_COUNT ) + input + 1U ) );
+		}
+	}
+
+#if ( 1 == APP_SAMPLER_CODEC )
+	/* Slowly changing input: one byte per difference, more samples than raw
+	 * once the frame is larger than the worst case record reserve */
+	CHECK( per_frame_x100[1][INPUT_SLOW] > ( RAW_SAMPLES( 100U - LINK_ATT_NOTIFY_OVERHEAD ) * 100U ) );
+	CHECK( per_frame_x100[2][INPUT_SLOW] > ( RAW_SAMPLES( LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD ) * 150U ) );
+#else
+	(void)per_frame_x100;
+#endif /* ( 1 == APP_SAMPLER_CODEC ) */
+
+	return TEST_END( TEST_NAME );
+}
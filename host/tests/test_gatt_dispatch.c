@@ -0,0 +1,328 @@
+/*
+ * test_gatt_dispatch.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Cost of finding the handler of an attribute read / write with 8, 32 and
+ * 128 characteristics: gatt_db_lookup() (handle indexed table) against the
+ * if / else chain of ( xxx_char_handle + 1 ) == attr_handle comparisons it
+ * replaced, modelled as one compare and branch per characteristic in table
+ * order. app_gatt_db.c alone, built with GATT_DB_MAX_HANDLES = 512 (bench
+ * variant, see Makefile); aci_gatt_add_service() / aci_gatt_add_char() are
+ * mocked here, handles allocated the way the BlueNRG-2 stack does.
+ *
+ * app_gatt_db.c registers one database per boot, so each size runs in its
+ * own child process.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "app_includes.h"
+#include "test_util.h"
+
+#define CHARS_MAX							( 128U )
+#define CHARS_PER_SERVICE			( 6U )					/* 1 + 6 x 3 records: within the 20 allowed per service */
+#define SERVICES_MAX					( ( CHARS_MAX + CHARS_PER_SERVICE - 1U ) / CHARS_PER_SERVICE )
+#define FIRST_HANDLE					( 0x000CU )			/* After the GATT and GAP services */
+#define DISPATCHES						( 4000000U )
+#define ROUNDS								( 5U )
+
+/* ============================================================================
+ * Mocked stack: sequential handles, Max_Attribute_Records reserved per service
+ * ==========================================================================*/
+static uint16_t g_next_handle;
+static uint16_t g_service_fill;
+static uint16_t g_service_end;
+
+tBleStatus aci_gatt_add_service( uint8_t Service_UUID_Type, Service_UUID_t * Service_UUID, uint8_t Service_Type,
+                                 uint8_t Max_Attribute_Records, uint16_t * Service_Handle )
+{
+	(void)Service_UUID_Type;
+	(void)Service_UUID;
+	(void)Service_Type;
+	*Service_Handle = g_next_handle;
+	g_service_fill = g_next_handle + 1U;
+	g_service_end = g_next_handle + Max_Attribute_Records - 1U;
+	g_next_handle += Max_Attribute_Records;
+	return BLE_STATUS_SUCCESS;
+}
+
+tBleStatus aci_gatt_add_char( uint16_t Service_Handle, uint8_t Char_UUID_Type, Char_UUID_t * Char_UUID, uint16_t Char_Value_Length,
+                              uint8_t Char_Properties, uint8_t Security_Permissions, uint8_t GATT_Evt_Mask, uint8_t Enc_Key_Size,
+                              uint8_t Is_Variable, uint16_t * Char_Handle )
+{
+	const uint16_t records = ( 0U != ( Char_Properties & ( CHAR_PROP_NOTIFY | CHAR_PROP_INDICATE ) ) ) ? 3U : 2U;
+
+	(void)Service_Handle;
+	(void)Char_UUID_Type;
+	(void)Char_UUID;
+	(void)Char_Value_Length;
+	(void)Security_Permissions;
+	(void)GATT_Evt_Mask;
+	(void)Enc_Key_Size;
+	(void)Is_Variable;
+	if( ( g_service_fill + records - 1U ) > g_service_end )
+	{
+		return BLE_STATUS_OUT_OF_HANDLE;
+	}
+	*Char_Handle = g_service_fill;
+	g_service_fill += records;
+	return BLE_STATUS_SUCCESS;
+}
+
+/* ============================================================================
+ * Database of n characteristics: READ, WRITE and NOTIFY in turn
+ * ==========================================================================*/
+static uint8_t g_uuids[CHARS_MAX + SERVICES_MAX][16];
+static uint16_t g_char_handles[CHARS_MAX];
+static uint16_t g_service_handles[SERVICES_MAX];
+static gatt_char_desc_t g_chars[CHARS_MAX];
+static gatt_service_desc_t g_services[SERVICES_MAX];
+static volatile uint32_t g_calls[CHARS_MAX];
+
+static tBleStatus on_read( void * ctx )
+{
+	g_calls[(uintptr_t)ctx]++;
+	return BLE_STATUS_SUCCESS;
+}
+
+static tBleStatus on_write( uint16_t conn_handle, void * ctx, const uint8_t * data, uint16_t data_length )
+{
+	(void)conn_handle;
+	(void)data;
+	(void)data_length;
+	g_calls[(uintptr_t)ctx]++;
+	return BLE_STATUS_SUCCESS;
+}
+
+static uint8_t build_database( uint32_t n )
+{
+	uint8_t services = 0;
+
+	g_next_handle = FIRST_HANDLE;
+	for( uint32_t i = 0; n > i; i++ )
+	{
+		gatt_char_desc_t * p_char = &g_chars[i];
+
+		memset( g_uuids[i], 0xA5, 16U );
+		g_uuids[i][12] = (uint8_t)i;
+		memset( p_char, 0, sizeof( *p_char ) );
+		p_char->name = "bench";
+		p_char->uuid = g_uuids[i];
+		p_char->uuid_type = UUID_TYPE_128;
+		p_char->value_len = 20U;
+		p_char->permissions = ATTR_PERMISSION_NONE;
+		p_char->p_handle = &g_char_handles[i];
+		p_char->ctx = (void *)(uintptr_t)i;
+		switch( i % 3U )
+		{
+			case 0:
+				p_char->properties = CHAR_PROP_READ;
+				p_char->evt_mask = GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP;
+				p_char->on_read = on_read;
+				break;
+			case 1:
+				p_char->properties = CHAR_PROP_WRITE | CHAR_PROP_WRITE_WITHOUT_RESP;
+				p_char->evt_mask = GATT_NOTIFY_ATTRIBUTE_WRITE;
+				p_char->is_variable = 1U;
+				p_char->on_write = on_write;
+				break;
+			default:
+				p_char->properties = CHAR_PROP_NOTIFY;
+				p_char->evt_mask = GATT_DONT_NOTIFY_EVENTS;
+				p_char->is_variable = 1U;
+				p_char->on_cccd_write = on_write;
+				break;
+		}
+	}
+	for( uint32_t first = 0; n > first; first += CHARS_PER_SERVICE )
+	{
+		gatt_service_desc_t * p_service = &g_services[services];
+
+		memset( g_uuids[CHARS_MAX + services], 0x5A, 16U );
+		g_uuids[CHARS_MAX + services][12] = services;
+		p_service->name = "bench_service";
+		p_service->uuid = g_uuids[CHARS_MAX + services];
+		p_service->uuid_type = UUID_TYPE_128;
+		p_service->service_type = PRIMARY_SERVICE;
+		p_service->chars = &g_chars[first];
+		p_service->char_count = (uint8_t)( ( ( n - first ) < CHARS_PER_SERVICE ) ? ( n - first ) : CHARS_PER_SERVICE );
+		p_service->p_handle = &g_service_handles[services];
+		services++;
+	}
+	return services;
+}
+
+/* ============================================================================
+ * The two dispatchers
+ * ==========================================================================*/
+static bool dispatch_table( uint16_t attr_handle )
+{
+	const gatt_db_handle_entry_t * p_entry = gatt_db_lookup( attr_handle );
+
+	if( NULL == p_entry )
+	{
+		return false;
+	}
+	switch( p_entry->attr )
+	{
+		case GATT_DB_ATTR_VALUE:
+			if( NULL != p_entry->p_char->on_read )
+			{
+				return BLE_STATUS_SUCCESS == p_entry->p_char->on_read( p_entry->p_char->ctx );
+			}
+			return ( NULL != p_entry->p_char->on_write ) &&
+			       ( BLE_STATUS_SUCCESS == p_entry->p_char->on_write( 0x0801U, p_entry->p_char->ctx, NULL, 0U ) );
+		case GATT_DB_ATTR_CCCD:
+			return ( NULL != p_entry->p_char->on_cccd_write ) &&
+			       ( BLE_STATUS_SUCCESS == p_entry->p_char->on_cccd_write( 0x0801U, p_entry->p_char->ctx, NULL, 0U ) );
+		default:
+			return false;
+	}
+}
+
+/* if( ( h0 + 1 ) == attr ) ... else if( ( h0 + 2 ) == attr ) ... else if( ( h1 + 1 ) == attr ) ... */
+static bool dispatch_chain( uint32_t n, uint16_t attr_handle )
+{
+	for( uint32_t i = 0; n > i; i++ )
+	{
+		const gatt_char_desc_t * p_char = &g_chars[i];
+		const uint16_t handle = *p_char->p_handle;
+
+		if( GATT_DB_VALUE_HANDLE( handle ) == attr_handle )
+		{
+			if( NULL != p_char->on_read )
+			{
+				return BLE_STATUS_SUCCESS == p_char->on_read( p_char->ctx );
+			}
+			return ( NULL != p_char->on_write ) && ( BLE_STATUS_SUCCESS == p_char->on_write( 0x0801U, p_char->ctx, NULL, 0U ) );
+		}
+		else if( ( NULL != p_char->on_cccd_write ) && ( GATT_DB_CCCD_HANDLE( handle ) == attr_handle ) )
+		{
+			return BLE_STATUS_SUCCESS == p_char->on_cccd_write( 0x0801U, p_char->ctx, NULL, 0U );
+		}
+	}
+	return false;
+}
+
+static uint64_t now_ns( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+}
+
+/* ============================================================================
+ * One size: register, check both dispatchers agree, time them
+ * ==========================================================================*/
+static int bench_size( uint32_t n )
+{
+	static uint16_t sequence[DISPATCHES];
+	uint16_t targets[CHARS_MAX * 2U];
+	uint32_t target_count = 0;
+	double best_table = 1e9;
+	double best_chain = 1e9;
+	uint32_t hits;
+	const uint8_t services = build_database( n );
+
+	CHECK_EQ( gatt_db_register( g_services, services ), BLE_STATUS_SUCCESS );
+
+	/* Every handle that reaches Read_Request_CB() / Attribute_Modify_CB() */
+	for( uint32_t i = 0; n > i; i++ )
+	{
+		if( ( NULL != g_chars[i].on_read ) || ( NULL != g_chars[i].on_write ) )
+		{
+			targets[target_count++] = GATT_DB_VALUE_HANDLE( g_char_handles[i] );
+		}
+		if( NULL != g_chars[i].on_cccd_write )
+		{
+			targets[target_count++] = GATT_DB_CCCD_HANDLE( g_char_handles[i] );
+		}
+	}
+
+	/* Same handler, once per target, on either path; nothing for the others */
+	for( uint32_t i = 0; target_count > i; i++ )
+	{
+		const uint32_t ctx = (uint32_t)(uintptr_t)gatt_db_lookup( targets[i] )->p_char->ctx;
+		const uint32_t before = g_calls[ctx];
+
+		CHECK( dispatch_table( targets[i] ) );
+		CHECK( dispatch_chain( n, targets[i] ) );
+		CHECK_EQ( g_calls[ctx], before + 2U );
+	}
+	for( uint16_t h = FIRST_HANDLE - 1U; g_next_handle + 2U > h; h++ )
+	{
+		CHECK_EQ( dispatch_table( h ), dispatch_chain( n, h ) );
+	}
+
+	srand( 0xD15u + n );
+	for( uint32_t i = 0; DISPATCHES > i; i++ )
+	{
+		sequence[i] = targets[(uint32_t)rand() % target_count];
+	}
+	for( uint32_t r = 0; ROUNDS > r; r++ )
+	{
+		uint64_t start = now_ns();
+		hits = 0;
+		for( uint32_t i = 0; DISPATCHES > i; i++ )
+		{
+			hits += dispatch_table( sequence[i] ) ? 1U : 0U;
+		}
+		const double table = (double)( now_ns() - start ) / DISPATCHES;
+		CHECK_EQ( hits, DISPATCHES );
+
+		start = now_ns();
+		hits = 0;
+		for( uint32_t i = 0; DISPATCHES > i; i++ )
+		{
+			hits += dispatch_chain( n, sequence[i] ) ? 1U : 0U;
+		}
+		const double chain = (double)( now_ns() - start ) / DISPATCHES;
+		CHECK_EQ( hits, DISPATCHES );
+
+		best_table = ( table < best_table ) ? table : best_table;
+		best_chain = ( chain < best_chain ) ? chain : best_chain;
+	}
+
+	fprintf( stderr, "  %3lu chars %2u services %3u handles : table %6.2f ns, if/else chain %7.2f ns per dispatch\n",
+	         (unsigned long)n, services, (unsigned)( g_next_handle - FIRST_HANDLE ), best_table, best_chain );
+	/* Walking 128 comparisons is never cheaper than one indexed load */
+	if( CHARS_MAX == n )
+	{
+		CHECK( best_table < best_chain );
+	}
+
+	return ( 0U == g_test_failures ) ? 0 : 1;
+}
+
+int main( void )
+{
+	static const uint32_t sizes[] = { 8U, 32U, CHARS_MAX };
+
+	fprintf( stderr, "Attribute dispatch, best of %u x %u random value / CCCD handles\n", ROUNDS, DISPATCHES );
+	for( uint32_t i = 0; ( sizeof( sizes ) / sizeof( sizes[0] ) ) > i; i++ )
+	{
+		int status = 1;
+		pid_t pid;
+
+		fflush( stdout );
+		fflush( stderr );
+		pid = fork();
+		if( 0 == pid )
+		{
+			status = bench_size( sizes[i] );
+			fflush( stdout );
+			_exit( status );
+		}
+		CHECK( ( 0 < pid ) && ( pid == waitpid( pid, &status, 0 ) ) );
+		CHECK( WIFEXITED( status ) && ( 0 == WEXITSTATUS( status ) ) );
+	}
+
+	return TEST_END( "test_gatt_dispatch" );
+}
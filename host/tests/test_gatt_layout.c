@@ -0,0 +1,266 @@
+/*
+ * test_gatt_layout.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * GATT database built from the descriptor tables (app_gatt_db.c) against the
+ * one the hand written add_services() used to build: every
+ * aci_gatt_add_service() / aci_gatt_add_char() call is recorded by the
+ * simulated controller and compared, arguments and returned handles, with
+ * the old call sequence. Changes made on purpose since are applied to the
+ * old sequence one by one, so anything else that moves a handle fails here.
+ * Built for both variants (fw and legacy, see Makefile).
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#if ( 1 == APP_BENCH )
+#define TEST_NAME					"test_gatt_layout (fw)"
+#else
+#define TEST_NAME					"test_gatt_layout (legacy)"
+#endif /* ( 1 == APP_BENCH ) */
+
+#define LAYOUT_ROWS_MAX		( 16U )
+
+extern const uint8_t HEALTH_SERVICE_UUID[16];
+extern const uint8_t HEALTH_BPM_CHAR_UUID[16];
+extern const uint8_t HEALTH_WEIGHT_CHAR_UUID[16];
+extern const uint8_t HEALTH_DATA_TX_CHAR_UUID[16];
+extern const uint8_t HEALTH_CONTROL_RX_CHAR_UUID[16];
+extern const uint8_t HEALTH_BENCH_TX_CHAR_UUID[16];
+extern const uint8_t WEATHER_SERVICE_UUID[16];
+extern const uint8_t WEATHER_TEMPERATURE_CHAR_UUID[16];
+extern const uint8_t WEATHER_HUMIDITY_CHAR_UUID[16];
+
+extern uint16_t health_service_handle;
+extern uint16_t health_bpm_char_handle;
+extern uint16_t health_weight_char_handle;
+extern uint16_t health_data_tx_char_handle;
+extern uint16_t health_control_rx_char_handle;
+extern uint16_t weather_service_handle;
+extern uint16_t weather_temperature_char_handle;
+extern uint16_t weather_humidity_char_handle;
+#if ( 1 == APP_BENCH )
+extern uint16_t health_bench_tx_char_handle;
+#endif /* ( 1 == APP_BENCH ) */
+
+typedef struct
+{
+	bool service;
+	const uint8_t * uuid;
+	uint8_t records;
+	uint16_t value_len;
+	uint8_t properties;
+	uint8_t permissions;
+	uint8_t evt_mask;
+	uint8_t enc_key_size;
+	uint8_t is_variable;
+	uint16_t handle;
+} layout_row_t;
+
+enum
+{
+	ROW_HEALTH = 0,
+	ROW_BPM,
+	ROW_WEIGHT,
+	ROW_DATA_TX,
+	ROW_CONTROL_RX,
+	ROW_WEATHER,
+	ROW_TEMPERATURE,
+	ROW_HUMIDITY,
+	ROW_LEGACY_COUNT
+};
+
+/* The calls of the hand written add_services(), in order, with the handles
+ * the stack returned (GATT and GAP services take 0x0001 .. 0x000B) */
+static const layout_row_t g_legacy[ROW_LEGACY_COUNT] =
+{
+	[ROW_HEALTH] = { true, HEALTH_SERVICE_UUID, 10U, 0, 0, 0, 0, 0, 0, 0x000C },
+	[ROW_BPM] = { false, HEALTH_BPM_CHAR_UUID, 0, 2U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	              GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP, 0U, CHAR_VALUE_LEN_CONSTANT, 0x000D },
+	[ROW_WEIGHT] = { false, HEALTH_WEIGHT_CHAR_UUID, 0, 2U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                 GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP, 0U, CHAR_VALUE_LEN_CONSTANT, 0x000F },
+	[ROW_DATA_TX] = { false, HEALTH_DATA_TX_CHAR_UUID, 0, 20U, CHAR_PROP_NOTIFY, ATTR_PERMISSION_NONE,
+	                  GATT_DONT_NOTIFY_EVENTS, 0U, CHAR_VALUE_LEN_VARIABLE, 0x0011 },
+	[ROW_CONTROL_RX] = { false, HEALTH_CONTROL_RX_CHAR_UUID, 0, 20U, CHAR_PROP_WRITE | CHAR_PROP_WRITE_WITHOUT_RESP, ATTR_PERMISSION_NONE,
+	                     GATT_NOTIFY_ATTRIBUTE_WRITE, 0U, CHAR_VALUE_LEN_VARIABLE, 0x0014 },
+	[ROW_WEATHER] = { true, WEATHER_SERVICE_UUID, 10U, 0, 0, 0, 0, 0, 0, 0x0016 },
+	[ROW_TEMPERATURE] = { false, WEATHER_TEMPERATURE_CHAR_UUID, 0, 2U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                      GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP, 0U, CHAR_VALUE_LEN_CONSTANT, 0x0017 },
+	[ROW_HUMIDITY] = { false, WEATHER_HUMIDITY_CHAR_UUID, 0, 2U, CHAR_PROP_READ, ATTR_PERMISSION_NONE,
+	                   GATT_NOTIFY_READ_REQ_AND_WAIT_FOR_APPL_RESP, 0U, CHAR_VALUE_LEN_CONSTANT, 0x0019 },
+};
+
+/* The old sequence with the changes made on purpose since, returns the number of rows */
+static uint32_t expected_layout( layout_row_t * p_rows )
+{
+	uint32_t count = ROW_LEGACY_COUNT;
+
+	memcpy( p_rows, g_legacy, sizeof( g_legacy ) );
+
+	/* Records derived from the rows: weather reserves the 5 it uses instead
+	 * of 10. It is the last service, no handle moves */
+	p_rows[ROW_WEATHER].records = 5U;
+	/* data_tx sized for the largest ATT_MTU (247 - 3) */
+	p_rows[ROW_DATA_TX].value_len = LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD;
+	/* Control commands only over an encrypted link */
+	p_rows[ROW_CONTROL_RX].permissions = SECURITY_ATTR_PERMISSION;
+	p_rows[ROW_CONTROL_RX].enc_key_size = SECURITY_ATTR_KEY_SIZE;
+#if ( 1 == APP_READ_CACHE )
+	/* READ values served by the controller, published on change */
+	p_rows[ROW_BPM].evt_mask = GATT_DONT_NOTIFY_EVENTS;
+	p_rows[ROW_WEIGHT].evt_mask = GATT_DONT_NOTIFY_EVENTS;
+	p_rows[ROW_TEMPERATURE].evt_mask = GATT_DONT_NOTIFY_EVENTS;
+	p_rows[ROW_HUMIDITY].evt_mask = GATT_DONT_NOTIFY_EVENTS;
+#endif /* ( 1 == APP_READ_CACHE ) */
+#if ( 1 == APP_BENCH )
+	/* bench_tx (NOTIFY + CCCD) appended to the health service: 3 more
+	 * records, the weather service moves up by 3 */
+	memmove( &p_rows[ROW_WEATHER + 1U], &p_rows[ROW_WEATHER], ( ROW_LEGACY_COUNT - ROW_WEATHER ) * sizeof( layout_row_t ) );
+	p_rows[ROW_WEATHER] = p_rows[ROW_DATA_TX];
+	p_rows[ROW_WEATHER].uuid = HEALTH_BENCH_TX_CHAR_UUID;
+	p_rows[ROW_WEATHER].handle = 0x0016;
+	p_rows[ROW_HEALTH].records += 3U;
+	count++;
+	for( uint32_t i = ROW_WEATHER + 1U; count > i; i++ )
+	{
+		p_rows[i].handle += 3U;
+	}
+#endif /* ( 1 == APP_BENCH ) */
+
+	return count;
+}
+
+/* The calls made, against the expected ones */
+static void test_calls( void )
+{
+	layout_row_t expected[LAYOUT_ROWS_MAX];
+	const sim_gatt_call_t * p_calls;
+	const uint32_t count = expected_layout( expected );
+	uint32_t made = sim_gatt_calls( &p_calls );
+	uint16_t service = 0;
+
+	CHECK_EQ( made, count );
+	made = ( made < count ) ? made : count;
+	for( uint32_t i = 0; made > i; i++ )
+	{
+		const sim_gatt_call_t * p_call = &p_calls[i];
+		const layout_row_t * p_row = &expected[i];
+
+		CHECK_EQ( p_call->service, p_row->service );
+		CHECK_EQ( p_call->uuid_type, UUID_TYPE_128 );
+		CHECK( 0 == memcmp( p_call->uuid, p_row->uuid, 16U ) );
+		CHECK_EQ( p_call->status, BLE_STATUS_SUCCESS );
+		CHECK_EQ( p_call->handle, p_row->handle );
+		if( p_row->service )
+		{
+			CHECK_EQ( p_call->records, p_row->records );
+			service = p_call->handle;
+			continue;
+		}
+		CHECK_EQ( p_call->parent, service );
+		CHECK_EQ( p_call->value_len, p_row->value_len );
+		CHECK_EQ( p_call->properties, p_row->properties );
+		CHECK_EQ( p_call->permissions, p_row->permissions );
+		CHECK_EQ( p_call->evt_mask, p_row->evt_mask );
+		CHECK_EQ( p_call->enc_key_size, p_row->enc_key_size );
+		CHECK_EQ( p_call->is_variable, p_row->is_variable );
+	}
+}
+
+/* Handles the application keeps, and the attributes behind them */
+static void test_handles( void )
+{
+	static uint16_t * const p_chars[] =
+	{
+		&health_bpm_char_handle, &health_weight_char_handle, &health_data_tx_char_handle, &health_control_rx_char_handle,
+#if ( 1 == APP_BENCH )
+		&health_bench_tx_char_handle,
+#endif /* ( 1 == APP_BENCH ) */
+		&weather_temperature_char_handle, &weather_humidity_char_handle,
+	};
+	layout_row_t expected[LAYOUT_ROWS_MAX];
+	const uint32_t count = expected_layout( expected );
+	uint32_t c = 0;
+
+	for( uint32_t i = 0; count > i; i++ )
+	{
+		const layout_row_t * p_row = &expected[i];
+		const sim_attr_t * p_attr;
+
+		if( p_row->service )
+		{
+			CHECK_EQ( ( ROW_HEALTH == i ) ? health_service_handle : weather_service_handle, p_row->handle );
+			/* The service is full: nothing reserved and left unused */
+			p_attr = sim_gatt_attr( p_row->handle );
+			CHECK( ( NULL != p_attr ) && ( SIM_ATTR_SERVICE == p_attr->type ) && ( p_attr->fill == ( p_attr->end + 1U ) ) );
+			continue;
+		}
+		CHECK_EQ( *p_chars[c++], p_row->handle );
+
+		p_attr = sim_gatt_attr( p_row->handle );
+		CHECK( ( NULL != p_attr ) && ( SIM_ATTR_CHAR_DECL == p_attr->type ) );
+		p_attr = sim_gatt_attr( GATT_DB_VALUE_HANDLE( p_row->handle ) );
+		CHECK( ( NULL != p_attr ) && ( SIM_ATTR_CHAR_VALUE == p_attr->type ) );
+		p_attr = sim_gatt_attr( GATT_DB_CCCD_HANDLE( p_row->handle ) );
+		if( 0U != ( p_row->properties & ( CHAR_PROP_NOTIFY | CHAR_PROP_INDICATE ) ) )
+		{
+			CHECK( ( NULL != p_attr ) && ( SIM_ATTR_CCCD == p_attr->type ) );
+		}
+		else
+		{
+			CHECK( ( NULL == p_attr ) || ( SIM_ATTR_CCCD != p_attr->type ) );
+		}
+	}
+	CHECK_EQ( c, sizeof( p_chars ) / sizeof( p_chars[0] ) );
+	/* Nothing registered after the last service */
+	CHECK_EQ( sim_gatt_next_handle(), expected[count - 1U].handle + 2U );
+}
+
+/* The dispatch table maps every handle of the layout to its attribute */
+static void test_lookup( void )
+{
+	const sim_gatt_call_t * p_calls;
+	const uint32_t made = sim_gatt_calls( &p_calls );
+	uint32_t mapped = 0;
+
+	for( uint32_t i = 0; made > i; i++ )
+	{
+		const uint16_t h = p_calls[i].handle;
+		const gatt_db_handle_entry_t * p_entry;
+
+		if( p_calls[i].service )
+		{
+			p_entry = gatt_db_lookup( h );
+			CHECK( ( NULL == p_entry ) || ( GATT_DB_ATTR_NONE == p_entry->attr ) );
+			continue;
+		}
+		p_entry = gatt_db_lookup( GATT_DB_VALUE_HANDLE( h ) );
+		CHECK( ( NULL != p_entry ) && ( GATT_DB_ATTR_VALUE == p_entry->attr ) && ( h == *p_entry->p_char->p_handle ) );
+		mapped++;
+		if( 0U != ( p_calls[i].properties & ( CHAR_PROP_NOTIFY | CHAR_PROP_INDICATE ) ) )
+		{
+			p_entry = gatt_db_lookup( GATT_DB_CCCD_HANDLE( h ) );
+			CHECK( ( NULL != p_entry ) && ( GATT_DB_ATTR_CCCD == p_entry->attr ) && ( h == *p_entry->p_char->p_handle ) );
+			mapped++;
+		}
+	}
+	CHECK( 0U != mapped );
+}
+
+int main( void )
+{
+	sim_ctrl_power_on( 1U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+
+	test_calls();
+	test_handles();
+	test_lookup();
+
+	return TEST_END( TEST_NAME );
+}
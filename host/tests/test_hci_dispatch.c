@@ -0,0 +1,380 @@
+/*
+ * test_hci_dispatch.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * hci_dispatch_event() / hci_dispatch_le_meta() / hci_dispatch_vendor()
+ * (app_hci_dispatch.c) against the linear walk of hci_events_table,
+ * hci_le_meta_events_table and hci_vendor_specific_events_table that
+ * App_UserEvtRx() did before. The tables are the X-CUBE-BLE2 BlueNRG-2 ones
+ * (event codes of bluenrg1_events.c), plus VENDOR_OVERFLOW codes that do not
+ * fit the vendor key and take the bisection fallback. app_hci_dispatch.c is
+ * built with these table sizes (dispatch variant, see Makefile).
+ *
+ *   - every code of the three code spaces reaches the handler the linear walk
+ *     finds, or none on both paths,
+ *   - a recorded session (boot, connection, pairing, streaming, parameter
+ *     updates, disconnection, events nobody handles) replayed on both paths,
+ *     cycles per event for each class of event.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "test_util.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#define TICKS_UNIT						"cycles"
+#else
+#include <time.h>
+#define TICKS_UNIT						"ns"
+#endif
+
+#define REPLAYS								( 2000U )
+#define ROUNDS								( 5U )
+#define SEQUENCE_MAX					( 4096U )
+
+/* ============================================================================
+ * Event tables: one handler per entry, recording who it is
+ * ==========================================================================*/
+#define TAG_HCI								( 0x10000UL )
+#define TAG_LE_META						( 0x20000UL )
+#define TAG_VENDOR						( 0x30000UL )
+
+static uint32_t g_called;
+
+static void handled( uint32_t id, uint8_t * buffer_in )
+{
+	(void)buffer_in;
+	g_called = id;
+}
+
+/* Disconnection, encryption change, remote version, hardware error,
+ * completed packets, key refresh */
+#define HCI_EVENTS( X ) \
+	X( 0x0005 ) X( 0x0008 ) X( 0x000C ) X( 0x0010 ) X( 0x0013 ) X( 0x0030 )
+
+/* Connection, advertising report, connection update, remote features, LTK
+ * request, remote parameters request, data length, P-256 key, DHKey,
+ * enhanced connection, directed advertising report, PHY update */
+#define LE_META_EVENTS( X ) \
+	X( 0x0001 ) X( 0x0002 ) X( 0x0003 ) X( 0x0004 ) X( 0x0005 ) X( 0x0006 ) \
+	X( 0x0007 ) X( 0x0008 ) X( 0x0009 ) X( 0x000A ) X( 0x000B ) X( 0x000C )
+
+/* HAL 0x00xx, GAP 0x04xx, L2CAP 0x08xx, GATT / ATT 0x0Cxx */
+#define VENDOR_EVENTS( X ) \
+	X( 0x0001 ) X( 0x0002 ) X( 0x0003 ) X( 0x0004 ) X( 0x0005 ) X( 0x0006 ) \
+	X( 0x0400 ) X( 0x0401 ) X( 0x0402 ) X( 0x0403 ) X( 0x0404 ) X( 0x0405 ) \
+	X( 0x0407 ) X( 0x0408 ) X( 0x0409 ) X( 0x040A ) \
+	X( 0x0800 ) X( 0x0801 ) X( 0x0802 ) X( 0x080A ) \
+	X( 0x0C01 ) X( 0x0C02 ) X( 0x0C03 ) X( 0x0C04 ) X( 0x0C05 ) X( 0x0C06 ) \
+	X( 0x0C07 ) X( 0x0C08 ) X( 0x0C09 ) X( 0x0C0A ) X( 0x0C0C ) X( 0x0C0D ) \
+	X( 0x0C0E ) X( 0x0C0F ) X( 0x0C10 ) X( 0x0C11 ) X( 0x0C12 ) X( 0x0C13 ) \
+	X( 0x0C14 ) X( 0x0C15 ) X( 0x0C16 ) X( 0x0C17 ) X( 0x0C18 )
+
+/* Outside the key layout: sequence number past 0x1F, bits [9:8] or [15:12]
+ * set (a later stack, another layer). Bisection of the overflow list */
+#define VENDOR_OVERFLOW( X ) \
+	X( 0x0020 ) X( 0x0C21 ) X( 0x0D02 ) X( 0x1001 )
+
+#define HCI_HANDLER( code )			static void hci_##code( uint8_t * p ) { handled( TAG_HCI | code, p ); }
+#define LE_META_HANDLER( code )	static void le_meta_##code( uint8_t * p ) { handled( TAG_LE_META | code, p ); }
+#define VENDOR_HANDLER( code )	static void vendor_##code( uint8_t * p ) { handled( TAG_VENDOR | code, p ); }
+#define HCI_ENTRY( code )				{ code, hci_##code },
+#define LE_META_ENTRY( code )		{ code, le_meta_##code },
+#define VENDOR_ENTRY( code )		{ code, vendor_##code },
+
+HCI_EVENTS( HCI_HANDLER )
+LE_META_EVENTS( LE_META_HANDLER )
+VENDOR_EVENTS( VENDOR_HANDLER )
+VENDOR_OVERFLOW( VENDOR_HANDLER )
+
+/* Sized by the declarations: a count that differs from the Makefile one does not build */
+const hci_events_table_type hci_events_table[] = { HCI_EVENTS( HCI_ENTRY ) };
+const hci_le_meta_events_table_type hci_le_meta_events_table[] = { LE_META_EVENTS( LE_META_ENTRY ) };
+const hci_vendor_specific_events_table_type hci_vendor_specific_events_table[] = {
+	VENDOR_EVENTS( VENDOR_ENTRY )
+	VENDOR_OVERFLOW( VENDOR_ENTRY )
+};
+
+/* ============================================================================
+ * The two dispatchers
+ * ==========================================================================*/
+typedef enum
+{
+	KIND_HCI = 0,
+	KIND_LE_META,
+	KIND_VENDOR,
+} evt_kind_t;
+
+typedef struct
+{
+	uint8_t kind;
+	uint16_t code;
+} evt_t;
+
+static uint8_t g_data[32];
+
+static bool dispatch_indexed( const evt_t * p_evt )
+{
+	switch( p_evt->kind )
+	{
+		case KIND_HCI:
+			return hci_dispatch_event( (uint8_t)p_evt->code, g_data );
+		case KIND_LE_META:
+			return hci_dispatch_le_meta( (uint8_t)p_evt->code, g_data );
+		default:
+			return hci_dispatch_vendor( p_evt->code, g_data );
+	}
+}
+
+/* App_UserEvtRx() before app_hci_dispatch.c: first entry of the code wins */
+static bool dispatch_linear( const evt_t * p_evt )
+{
+	uint32_t i;
+
+	switch( p_evt->kind )
+	{
+		case KIND_HCI:
+			for( i = 0; HCI_EVENTS_TABLE_SIZE > i; i++ )
+			{
+				if( hci_events_table[i].evt_code == (uint8_t)p_evt->code )
+				{
+					hci_events_table[i].process( g_data );
+					return true;
+				}
+			}
+			return false;
+		case KIND_LE_META:
+			for( i = 0; HCI_LE_META_EVENTS_TABLE_SIZE > i; i++ )
+			{
+				if( hci_le_meta_events_table[i].evt_code == (uint8_t)p_evt->code )
+				{
+					hci_le_meta_events_table[i].process( g_data );
+					return true;
+				}
+			}
+			return false;
+		default:
+			for( i = 0; HCI_VENDOR_SPECIFIC_EVENTS_TABLE_SIZE > i; i++ )
+			{
+				if( hci_vendor_specific_events_table[i].evt_code == p_evt->code )
+				{
+					hci_vendor_specific_events_table[i].process( g_data );
+					return true;
+				}
+			}
+			return false;
+	}
+}
+
+/* Same handler (or none) on both paths */
+static bool same_handler( const evt_t * p_evt )
+{
+	bool indexed;
+	bool linear;
+	uint32_t indexed_id;
+
+	g_called = 0;
+	indexed = dispatch_indexed( p_evt );
+	indexed_id = g_called;
+	g_called = 0;
+	linear = dispatch_linear( p_evt );
+
+	return ( indexed == linear ) && ( indexed_id == g_called );
+}
+
+static void check_code_spaces( void )
+{
+	uint32_t mismatches = 0;
+	uint32_t found = 0;
+	evt_t evt;
+
+	for( uint32_t code = 0; 0xFFFFU >= code; code++ )
+	{
+		evt.code = (uint16_t)code;
+		if( 0xFFU >= code )
+		{
+			evt.kind = KIND_HCI;
+			mismatches += same_handler( &evt ) ? 0U : 1U;
+			found += ( 0U != g_called ) ? 1U : 0U;
+			evt.kind = KIND_LE_META;
+			mismatches += same_handler( &evt ) ? 0U : 1U;
+			found += ( 0U != g_called ) ? 1U : 0U;
+		}
+		evt.kind = KIND_VENDOR;
+		mismatches += same_handler( &evt ) ? 0U : 1U;
+		found += ( 0U != g_called ) ? 1U : 0U;
+	}
+	CHECK_EQ( mismatches, 0 );
+	/* Every table entry reached once */
+	CHECK_EQ( found, HCI_EVENTS_TABLE_SIZE + HCI_LE_META_EVENTS_TABLE_SIZE + HCI_VENDOR_SPECIFIC_EVENTS_TABLE_SIZE );
+}
+
+/* ============================================================================
+ * Recorded session, in arrival order; repeat = back to back copies
+ * ==========================================================================*/
+typedef enum
+{
+	CLASS_HCI = 0,
+	CLASS_LE_META,
+	CLASS_VENDOR,
+	CLASS_OVERFLOW,
+	CLASS_UNHANDLED,
+	CLASS_COUNT,
+} evt_class_t;
+
+static const char * const CLASS_NAMES[CLASS_COUNT] = { "HCI", "LE meta", "vendor", "vendor overflow", "unhandled" };
+
+typedef struct
+{
+	evt_t evt;
+	uint8_t class;
+	uint16_t repeat;
+} recorded_t;
+
+static const recorded_t SESSION[] = {
+	{ { KIND_VENDOR, 0x0001 }, CLASS_VENDOR, 1U },				/* aci_blue_initialized */
+	{ { KIND_VENDOR, 0x0004 }, CLASS_VENDOR, 40U },			/* end of radio activity, advertising */
+	{ { KIND_LE_META, 0x0002 }, CLASS_LE_META, 4U },
+	{ { KIND_LE_META, 0x0001 }, CLASS_LE_META, 1U },			/* connection */
+	{ { KIND_VENDOR, 0x0C03 }, CLASS_VENDOR, 1U },				/* MTU exchange */
+	{ { KIND_LE_META, 0x0007 }, CLASS_LE_META, 1U },			/* data length */
+	{ { KIND_LE_META, 0x000C }, CLASS_LE_META, 1U },			/* PHY */
+	{ { KIND_LE_META, 0x0004 }, CLASS_LE_META, 1U },
+	{ { KIND_HCI, 0x000C }, CLASS_HCI, 1U },
+	{ { KIND_VENDOR, 0x0404 }, CLASS_VENDOR, 1U },				/* pairing */
+	{ { KIND_LE_META, 0x0005 }, CLASS_LE_META, 1U },
+	{ { KIND_HCI, 0x0008 }, CLASS_HCI, 1U },
+	{ { KIND_VENDOR, 0x0401 }, CLASS_VENDOR, 1U },
+	{ { KIND_VENDOR, 0x0C01 }, CLASS_VENDOR, 3U },				/* CCCD writes */
+	{ { KIND_VENDOR, 0x0800 }, CLASS_VENDOR, 1U },				/* L2CAP update */
+	{ { KIND_LE_META, 0x0003 }, CLASS_LE_META, 1U },
+	{ { KIND_VENDOR, 0x0C14 }, CLASS_VENDOR, 12U },			/* reads */
+	{ { KIND_VENDOR, 0x0C16 }, CLASS_VENDOR, 60U },			/* streaming */
+	{ { KIND_HCI, 0x0013 }, CLASS_HCI, 60U },
+	{ { KIND_VENDOR, 0x0C01 }, CLASS_VENDOR, 8U },				/* control writes */
+	{ { KIND_VENDOR, 0x0020 }, CLASS_OVERFLOW, 6U },
+	{ { KIND_VENDOR, 0x0C21 }, CLASS_OVERFLOW, 6U },
+	{ { KIND_VENDOR, 0x1001 }, CLASS_OVERFLOW, 4U },
+	{ { KIND_VENDOR, 0x0C1A }, CLASS_UNHANDLED, 4U },		/* not in the tables */
+	{ { KIND_HCI, 0x003E }, CLASS_UNHANDLED, 2U },
+	{ { KIND_LE_META, 0x0014 }, CLASS_UNHANDLED, 2U },
+	{ { KIND_VENDOR, 0x0C16 }, CLASS_VENDOR, 60U },
+	{ { KIND_HCI, 0x0013 }, CLASS_HCI, 60U },
+	{ { KIND_VENDOR, 0x0802 }, CLASS_VENDOR, 1U },
+	{ { KIND_LE_META, 0x0003 }, CLASS_LE_META, 1U },
+	{ { KIND_HCI, 0x0005 }, CLASS_HCI, 1U },							/* disconnection */
+	{ { KIND_VENDOR, 0x0004 }, CLASS_VENDOR, 20U },
+};
+
+#define SESSION_LEN						( sizeof( SESSION ) / sizeof( SESSION[0] ) )
+
+static uint64_t now_ticks( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Events of the class (CLASS_COUNT: all of them) in session order */
+static uint32_t build_sequence( evt_t * sequence, uint8_t class, uint32_t * p_handled )
+{
+	uint32_t len = 0;
+
+	*p_handled = 0;
+	for( uint32_t i = 0; SESSION_LEN > i; i++ )
+	{
+		if( ( CLASS_COUNT != class ) && ( SESSION[i].class != class ) )
+		{
+			continue;
+		}
+		for( uint32_t r = 0; ( SESSION[i].repeat > r ) && ( SEQUENCE_MAX > len ); r++ )
+		{
+			sequence[len++] = SESSION[i].evt;
+			*p_handled += ( CLASS_UNHANDLED != SESSION[i].class ) ? 1U : 0U;
+		}
+	}
+	return len;
+}
+
+/* Best of ROUNDS, ticks per event */
+static double replay( bool ( * dispatch )( const evt_t * ), const evt_t * sequence, uint32_t len, uint32_t * p_hits )
+{
+	double best = 1e12;
+
+	for( uint32_t r = 0; ROUNDS > r; r++ )
+	{
+		uint32_t hits = 0;
+		const uint64_t start = now_ticks();
+
+		for( uint32_t n = 0; REPLAYS > n; n++ )
+		{
+			for( uint32_t i = 0; len > i; i++ )
+			{
+				hits += dispatch( &sequence[i] ) ? 1U : 0U;
+			}
+		}
+		const double per_event = (double)( now_ticks() - start ) / ( (double)REPLAYS * len );
+		best = ( per_event < best ) ? per_event : best;
+		*p_hits = hits / REPLAYS;
+	}
+	return best;
+}
+
+static void bench_session( void )
+{
+	static evt_t sequence[SEQUENCE_MAX];
+	double indexed_all = 0.0;
+	double linear_all = 0.0;
+
+	fprintf( stderr, "HCI event dispatch, recorded session replayed %u times, best of %u (" TICKS_UNIT " per event)\n", REPLAYS, ROUNDS );
+	fprintf( stderr, "  %-16s %6s : %8s %8s\n", "events", "count", "indexed", "linear" );
+	for( uint8_t class = 0; CLASS_COUNT >= class; class++ )
+	{
+		uint32_t handled_count;
+		const uint32_t len = build_sequence( sequence, class, &handled_count );
+		uint32_t i;
+		uint32_t mismatches = 0;
+		uint32_t indexed_hits;
+		uint32_t linear_hits;
+
+		for( i = 0; len > i; i++ )
+		{
+			mismatches += same_handler( &sequence[i] ) ? 0U : 1U;
+		}
+		CHECK_EQ( mismatches, 0 );
+
+		const double indexed = replay( dispatch_indexed, sequence, len, &indexed_hits );
+		const double linear = replay( dispatch_linear, sequence, len, &linear_hits );
+		CHECK_EQ( indexed_hits, linear_hits );
+		CHECK_EQ( indexed_hits, handled_count );
+
+		fprintf( stderr, "  %-16s %6lu : %8.1f %8.1f\n", ( CLASS_COUNT == class ) ? "whole session" : CLASS_NAMES[class],
+		         (unsigned long)len, indexed, linear );
+		if( CLASS_COUNT == class )
+		{
+			indexed_all = indexed;
+			linear_all = linear;
+		}
+	}
+
+	/* Up to 47 vendor entries walked against one indexed load */
+	CHECK( indexed_all < linear_all );
+}
+
+int main( void )
+{
+	hci_dispatch_init();
+	check_code_spaces();
+	bench_session();
+
+	return TEST_END( "test_hci_dispatch" );
+}
@@ -0,0 +1,368 @@
+/*
+ * test_log_stress.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * app_log.c alone, under truly concurrent producers: pthreads in thread mode
+ * (host_ipsr = 0) and in "interrupt" mode (host_ipsr != 0) call log_printf()
+ * while a UART thread plays the DMA transfer and the TX complete interrupt
+ * (HAL_UART_TxCpltCallback() from another thread, at any time).
+ *
+ * Every line that comes out of the UART must be whole, in order for its
+ * producer and accounted for: written + dropped = attempts, what the UART
+ * sent = written, truncated lines as counted. Bulk mode must lose no thread
+ * mode line while the UART drains, and give up after LOG_BULK_WAIT_MS when
+ * it does not.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "app_includes.h"
+#include "test_util.h"
+
+#define TEST_PRODUCERS_MAX		( 8U )
+#define TEST_LINES						( 50000U )
+#define TEST_USART2_IPSR			( 16U + 38U )
+#define TEST_EXTI_IPSR				( 16U + 6U )
+
+__thread uint32_t host_ipsr = 0;
+
+static UART_HandleTypeDef g_huart;
+
+/* DMA transfer handed over by HAL_UART_Transmit_DMA() */
+static const uint8_t * volatile g_dma_buf;
+static volatile uint16_t g_dma_len;
+static volatile uint32_t g_dma_pending;
+static volatile uint32_t g_dma_overlap;				/* Started while one was in flight */
+
+/* UART thread */
+static pthread_t g_uart_thread;
+static volatile uint32_t g_uart_stop;
+static volatile uint32_t g_uart_stalled;
+static char * g_out;
+static size_t g_out_len;
+static size_t g_out_size;
+static volatile uint32_t g_out_lines;
+
+typedef struct
+{
+	uint32_t id;
+	uint32_t ipsr;
+	uint32_t lines;
+	bool bulk;
+} producer_t;
+
+/* Checks of the UART output, per producer */
+typedef struct
+{
+	uint32_t received;
+	int64_t last_seq;
+	uint32_t out_of_order;
+	uint32_t corrupt;
+	uint32_t truncated;
+} producer_result_t;
+
+/* Polled by a bulk mode line waiting for a slot: on the MCU the UART
+ * interrupt preempts the wait, here the UART thread gets the CPU */
+uint32_t app_port_tick_ms( void )
+{
+	struct timespec ts;
+
+	sched_yield();
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (uint32_t)( ( (uint64_t)ts.tv_sec * 1000U ) + ( (uint64_t)ts.tv_nsec / 1000000U ) );
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA( UART_HandleTypeDef * huart, const uint8_t * pData, uint16_t Size )
+{
+	(void)huart;
+	if( 0U != __atomic_load_n( &g_dma_pending, __ATOMIC_ACQUIRE ) )
+	{
+		__atomic_fetch_add( &g_dma_overlap, 1U, __ATOMIC_RELAXED );
+		return HAL_BUSY;
+	}
+	g_dma_buf = pData;
+	g_dma_len = Size;
+	__atomic_store_n( &g_dma_pending, 1U, __ATOMIC_RELEASE );
+	return HAL_OK;
+}
+
+static void * uart_thread( void * arg )
+{
+	(void)arg;
+	host_ipsr = TEST_USART2_IPSR;
+	for( ;; )
+	{
+		if( ( 0U != __atomic_load_n( &g_uart_stalled, __ATOMIC_ACQUIRE ) )
+		    || ( 0U == __atomic_load_n( &g_dma_pending, __ATOMIC_ACQUIRE ) ) )
+		{
+			if( 0U != __atomic_load_n( &g_uart_stop, __ATOMIC_ACQUIRE ) )
+			{
+				break;
+			}
+			sched_yield();
+			continue;
+		}
+
+		const uint16_t len = g_dma_len;
+		if( ( g_out_len + len ) <= g_out_size )
+		{
+			memcpy( &g_out[g_out_len], (const void *)g_dma_buf, len );
+			g_out_len += len;
+		}
+		for( uint16_t i = 0; len > i; i++ )
+		{
+			if( '\n' == g_dma_buf[i] )
+			{
+				__atomic_fetch_add( &g_out_lines, 1U, __ATOMIC_RELEASE );
+			}
+		}
+
+		/* Transfer complete interrupt: the callback may start the next one */
+		__atomic_store_n( &g_dma_pending, 0U, __ATOMIC_RELEASE );
+		HAL_UART_TxCpltCallback( &g_huart );
+	}
+	return NULL;
+}
+
+static void uart_start( size_t size )
+{
+	g_out = malloc( size );
+	g_out_size = size;
+	g_out_len = 0;
+	g_out_lines = 0;
+	g_dma_pending = 0;
+	g_dma_overlap = 0;
+	g_uart_stop = 0;
+	g_uart_stalled = 0;
+	log_init( &g_huart );
+	pthread_create( &g_uart_thread, NULL, uart_thread, NULL );
+}
+
+/* Waits for the UART to send every written line, then stops it */
+static void uart_drain_stop( void )
+{
+	log_stats_t stats;
+	const uint32_t start = app_port_tick_ms();
+
+	do
+	{
+		log_get_stats( &stats );
+		sched_yield();
+	} while( ( __atomic_load_n( &g_out_lines, __ATOMIC_ACQUIRE ) < stats.written ) && ( 5000U > ( app_port_tick_ms() - start ) ) );
+
+	__atomic_store_n( &g_uart_stop, 1U, __ATOMIC_RELEASE );
+	pthread_join( g_uart_thread, NULL );
+}
+
+/* Line seq of producer id, before the LOG_LINE_MAX cut: 0 to 119 filler bytes */
+static int line_format( char * buf, size_t size, uint32_t id, uint32_t seq )
+{
+	const int fill = (int)( ( seq * 7U ) % 120U );
+	char filler[128];
+
+	memset( filler, (int)( 'a' + ( ( id + seq ) % 26U ) ), (size_t)fill );
+	filler[fill] = '\0';
+	return snprintf( buf, size, "P%u %06u %s" _NEXT_LINE_, (unsigned)id, (unsigned)seq, filler );
+}
+
+static void * producer_thread( void * arg )
+{
+	const producer_t * p = arg;
+	char line[256];
+	uint32_t seq;
+
+	host_ipsr = p->ipsr;
+	if( p->bulk )
+	{
+		log_bulk_begin();
+	}
+	for( seq = 0; p->lines > seq; seq++ )
+	{
+		(void)line_format( line, sizeof( line ), p->id, seq );
+		log_printf( "%s", line );
+		if( 0U == ( seq & 0xFFU ) )
+		{
+			sched_yield();
+		}
+	}
+	if( p->bulk )
+	{
+		log_bulk_end();
+	}
+	return NULL;
+}
+
+/* Splits the UART output in lines and checks each against its producer */
+static uint32_t check_output( producer_result_t * results, uint32_t producers )
+{
+	const size_t eol = sizeof( _NEXT_LINE_ ) - 1U;
+	uint32_t bad_lines = 0;
+	size_t pos = 0;
+
+	for( uint32_t i = 0; producers > i; i++ )
+	{
+		memset( &results[i], 0, sizeof( results[i] ) );
+		results[i].last_seq = -1;
+	}
+
+	while( pos < g_out_len )
+	{
+		const char * line = &g_out[pos];
+		const char * end = memchr( line, '\n', g_out_len - pos );
+		unsigned id;
+		unsigned seq;
+		char expect[256];
+		int len;
+
+		if( NULL == end )
+		{
+			bad_lines++;
+			break;
+		}
+		const size_t line_len = (size_t)( end - line ) + 1U;
+		pos += line_len;
+
+		if( ( 2 != sscanf( line, "P%u %u ", &id, &seq ) ) || ( producers <= id ) )
+		{
+			bad_lines++;
+			continue;
+		}
+		producer_result_t * r = &results[id];
+		r->received++;
+		if( (int64_t)seq <= r->last_seq )
+		{
+			r->out_of_order++;
+		}
+		r->last_seq = seq;
+
+		/* Expected bytes, with the cut of log_printf() */
+		len = line_format( expect, sizeof( expect ), id, seq );
+		if( (int)LOG_LINE_MAX <= len )
+		{
+			len = LOG_LINE_MAX - 1U;
+			memcpy( &expect[len - eol], _NEXT_LINE_, eol );
+			r->truncated++;
+		}
+		if( ( (size_t)len != line_len ) || ( 0 != memcmp( line, expect, line_len ) ) )
+		{
+			r->corrupt++;
+		}
+	}
+	return bad_lines;
+}
+
+/* Producers at the same time, then the UART output checked against the statistics */
+static void run_scenario( const char * name, producer_t * producers, uint32_t count, bool bulk_lossless )
+{
+	pthread_t threads[TEST_PRODUCERS_MAX];
+	producer_result_t results[TEST_PRODUCERS_MAX];
+	log_stats_t stats;
+	uint32_t attempts = 0;
+	uint32_t received = 0;
+	uint32_t truncated = 0;
+
+	uart_start( (size_t)TEST_PRODUCERS_MAX * TEST_LINES * LOG_LINE_MAX );
+	for( uint32_t i = 0; count > i; i++ )
+	{
+		producers[i].id = i;
+		attempts += producers[i].lines;
+		pthread_create( &threads[i], NULL, producer_thread, &producers[i] );
+	}
+	for( uint32_t i = 0; count > i; i++ )
+	{
+		pthread_join( threads[i], NULL );
+	}
+	uart_drain_stop();
+
+	log_get_stats( &stats );
+	CHECK_EQ( check_output( results, count ), 0 );
+	for( uint32_t i = 0; count > i; i++ )
+	{
+		CHECK_EQ( results[i].out_of_order, 0 );
+		CHECK_EQ( results[i].corrupt, 0 );
+		received += results[i].received;
+		truncated += results[i].truncated;
+		if( bulk_lossless && producers[i].bulk && ( 0U == producers[i].ipsr ) )
+		{
+			/* Thread mode bulk producer: waits, never drops */
+			CHECK_EQ( results[i].received, producers[i].lines );
+		}
+	}
+	CHECK_EQ( g_dma_overlap, 0 );
+	CHECK_EQ( (uint64_t)stats.written + stats.dropped, attempts );
+	CHECK_EQ( received, stats.written );
+	CHECK_EQ( truncated, stats.truncated );
+	fprintf( stderr, "%-28s attempts=%u written=%u dropped=%u truncated=%u waited=%u\n", name,
+	         (unsigned)attempts, (unsigned)stats.written, (unsigned)stats.dropped, (unsigned)stats.truncated, (unsigned)stats.waited );
+	free( g_out );
+}
+
+/* Bulk mode with the UART stopped: LOG_BULK_WAIT_MS per line past the queue, then dropped */
+static void run_bulk_timeout( void )
+{
+	log_stats_t stats;
+	uint32_t start;
+	uint32_t elapsed;
+	uint32_t i;
+
+	uart_start( 4096U );
+	__atomic_store_n( &g_uart_stalled, 1U, __ATOMIC_RELEASE );
+	host_ipsr = 0;
+	log_bulk_begin();
+	start = app_port_tick_ms();
+	for( i = 0; ( LOG_SLOT_COUNT + 2U ) > i; i++ )
+	{
+		log_printf( "stalled %u" _NEXT_LINE_, (unsigned)i );
+	}
+	elapsed = app_port_tick_ms() - start;
+	log_bulk_end();
+
+	/* Interrupt mode never waits */
+	host_ipsr = TEST_EXTI_IPSR;
+	log_printf( "isr" _NEXT_LINE_ );
+	host_ipsr = 0;
+
+	log_get_stats( &stats );
+	CHECK_EQ( stats.written, LOG_SLOT_COUNT );
+	CHECK_EQ( stats.dropped, 3 );
+	CHECK_EQ( stats.waited, 2 );
+	CHECK( ( 2U * LOG_BULK_WAIT_MS ) <= elapsed );
+
+	__atomic_store_n( &g_uart_stalled, 0U, __ATOMIC_RELEASE );
+	uart_drain_stop();
+	CHECK_EQ( g_out_lines, LOG_SLOT_COUNT );
+	free( g_out );
+}
+
+int main( void )
+{
+	/* Thread mode and interrupt producers, nobody waits: drops allowed */
+	producer_t mixed[] =
+	{
+		{ .ipsr = 0, .lines = TEST_LINES },
+		{ .ipsr = 0, .lines = TEST_LINES },
+		{ .ipsr = 0, .lines = TEST_LINES },
+		{ .ipsr = 0, .lines = TEST_LINES },
+		{ .ipsr = TEST_EXTI_IPSR, .lines = TEST_LINES },
+		{ .ipsr = TEST_EXTI_IPSR + 1U, .lines = TEST_LINES },
+	};
+	/* Statistics dump in bulk mode racing interrupt producers */
+	producer_t bulk[] =
+	{
+		{ .ipsr = 0, .lines = TEST_LINES, .bulk = true },
+		{ .ipsr = TEST_EXTI_IPSR, .lines = TEST_LINES },
+		{ .ipsr = TEST_EXTI_IPSR + 1U, .lines = TEST_LINES },
+	};
+
+	run_scenario( "log mixed producers", mixed, sizeof( mixed ) / sizeof( mixed[0] ), false );
+	run_scenario( "log bulk + interrupts", bulk, sizeof( bulk ) / sizeof( bulk[0] ), true );
+	run_bulk_timeout();
+
+	return TEST_END( "test_log_stress" );
+}
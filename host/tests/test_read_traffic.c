@@ -0,0 +1,142 @@
+/*
+ * test_read_traffic.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * SPI traffic and latency of central reads of the BPM, weight, temperature
+ * and humidity values: READS reads of each, READ_GAP_MS apart so that the
+ * main loop (sensor polling, read cache) runs between them. Only the time
+ * of a read is counted: the SPI frames and wire bytes of the controller
+ * statistics (HCI_TL_SPI_Stats_t framing) and the read latency, from the
+ * read permit request to aci_gatt_allow_read().
+ *
+ * Built for both variants: fw (APP_READ_CACHE, the controller answers from
+ * its GATT DB, no host traffic) and legacy (read permit event, then
+ * aci_gatt_update_char_value() and aci_gatt_allow_read() with their command
+ * completes: two frames written and three read per read).
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#if ( 1 == APP_READ_CACHE )
+#define TEST_NAME							"test_read_traffic (fw)"
+#else
+#define TEST_NAME							"test_read_traffic (legacy)"
+#endif /* ( 1 == APP_READ_CACHE ) */
+
+#define READS									( 100U )
+#define READ_GAP_MS						( 10U )
+#define SETTLE_MS							( 1000U )			/* MTU exchange, DLE, PHY, L2CAP update */
+
+extern uint16_t health_bpm_char_handle;
+extern uint16_t health_weight_char_handle;
+extern uint16_t weather_temperature_char_handle;
+extern uint16_t weather_humidity_char_handle;
+
+typedef struct
+{
+	const char * name;
+	const uint16_t * p_handle;
+} read_char_t;
+
+static const read_char_t READ_CHARS[] = {
+	{ "bpm", &health_bpm_char_handle },
+	{ "weight", &health_weight_char_handle },
+	{ "temperature", &weather_temperature_char_handle },
+	{ "humidity", &weather_humidity_char_handle },
+};
+
+static sim_central_t g_central;
+
+static bool cond_advertising( void * arg )
+{
+	(void)arg;
+	return sim_ctrl_is_advertising();
+}
+
+static void read_traffic( const read_char_t * p_char )
+{
+	HCI_TL_SPI_Stats_t spi;
+	sim_ctrl_stats_t before;
+	sim_ctrl_stats_t after;
+	uint64_t total_ns = 0;
+	uint64_t max_ns = 0;
+	uint32_t failed = 0;
+	uint32_t i;
+
+	memset( &spi, 0, sizeof( spi ) );
+	for( i = 0; READS > i; i++ )
+	{
+		sim_conn_stats_t conn;
+		uint8_t value[8];
+		uint16_t len = 0;
+		uint64_t start;
+		uint64_t wait_ns = 0;
+
+		sim_run_ms( READ_GAP_MS );
+		sim_ctrl_get_stats( &before );
+		start = sim_time_ns();
+		if( ( 0U != sim_read( &g_central, (uint16_t)( *p_char->p_handle + 1U ), value, sizeof( value ), &len ) ) || ( 2U != len ) )
+		{
+			failed++;
+		}
+		/* Read permit request to allow, when the read waited on the application */
+		if( ( sim_time_ns() != start ) && sim_conn_stats( &g_central, &conn ) )
+		{
+			wait_ns = conn.read_latency_ns;
+		}
+		sim_ctrl_get_stats( &after );
+
+		spi.rx_frames += after.spi.rx_frames - before.spi.rx_frames;
+		spi.tx_frames += after.spi.tx_frames - before.spi.tx_frames;
+		spi.wire_bytes += after.spi.wire_bytes - before.spi.wire_bytes;
+		total_ns += wait_ns;
+		max_ns = ( wait_ns > max_ns ) ? wait_ns : max_ns;
+	}
+
+	fprintf( stderr, "  %-11s : %4lu SPI frames (%3lu written, %3lu read), %6lu wire bytes, %5.1f per read, latency mean %6.1f us, max %6.1f us\n",
+	         p_char->name, (unsigned long)( spi.tx_frames + spi.rx_frames ), (unsigned long)spi.tx_frames, (unsigned long)spi.rx_frames,
+	         (unsigned long)spi.wire_bytes, (double)spi.wire_bytes / READS,
+	         (double)total_ns / READS / SIM_NS_PER_US, (double)max_ns / SIM_NS_PER_US );
+
+	CHECK_EQ( failed, 0 );
+#if ( 1 == APP_READ_CACHE )
+	/* Answered by the controller: nothing on the host side */
+	CHECK_EQ( spi.tx_frames, 0 );
+	CHECK_EQ( spi.rx_frames, 0 );
+	CHECK_EQ( spi.wire_bytes, 0 );
+	CHECK_EQ( max_ns, 0 );
+#else
+	/* Read permit event, update + allow and their command completes */
+	CHECK_EQ( spi.tx_frames, 2U * READS );
+	CHECK_EQ( spi.rx_frames, 3U * READS );
+	CHECK( 0U != max_ns );
+#endif /* ( 1 == APP_READ_CACHE ) */
+}
+
+int main( void )
+{
+	uint32_t i;
+
+	sim_ctrl_power_on( 17U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	CHECK( sim_run_until( cond_advertising, NULL, 1000U ) );
+
+	sim_central_init( &g_central, 0x17U );
+	g_central.pairs = false;
+	CHECK( 0xFFFFU != sim_connect( &g_central ) );
+	sim_run_ms( SETTLE_MS );
+
+	fprintf( stderr, "Reads, %u of each %u ms apart, host SPI traffic and read latency\n", READS, READ_GAP_MS );
+	for( i = 0; ( sizeof( READ_CHARS ) / sizeof( READ_CHARS[0] ) ) > i; i++ )
+	{
+		read_traffic( &READ_CHARS[i] );
+	}
+
+	return TEST_END( TEST_NAME );
+}
@@ -0,0 +1,219 @@
+/*
+ * test_recovery.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Controller fault recovery (app_recovery.c) end to end, with a bonded
+ * central connected and subscribed at every fault:
+ *   - RECOVERY_HCI_TIMEOUT_LIMIT ACI commands that never complete
+ *     (sim_ctrl_hang_commands()), hit by health_data_tx notifications,
+ *   - the IRQ line stuck high (sim_bsp_irq_stuck()), found by the bottom
+ *     half of hci_tl_interface.c,
+ *   - the RECOVERY_CMD_INJECT control command written by the central.
+ * Each one must end the connection on both sides, restart the controller
+ * through bluenrg_restart() with the GATT database replayed on the same
+ * handles, and advertise again. The time to recover of every fault and the
+ * min / average / max of recovery_get_stats() are printed, with the time
+ * each fault took to be detected after its injection.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define FAULT_DETECT_MS				( 10000U )
+#define RECOVER_MS						( 5000U )
+
+extern const uint8_t HEALTH_SERVICE_UUID[16];
+extern uint16_t health_service_handle;
+extern uint16_t health_bpm_char_handle;
+extern uint16_t health_weight_char_handle;
+extern uint16_t health_data_tx_char_handle;
+extern uint16_t health_control_rx_char_handle;
+extern uint16_t weather_service_handle;
+extern uint16_t weather_temperature_char_handle;
+extern uint16_t weather_humidity_char_handle;
+
+static uint16_t * const HANDLES[] = {
+	&health_service_handle,
+	&health_bpm_char_handle,
+	&health_weight_char_handle,
+	&health_data_tx_char_handle,
+	&health_control_rx_char_handle,
+	&weather_service_handle,
+	&weather_temperature_char_handle,
+	&weather_humidity_char_handle,
+};
+#define HANDLE_COUNT					( sizeof( HANDLES ) / sizeof( HANDLES[0] ) )
+
+typedef struct
+{
+	const char * name;
+	recovery_cause_t cause;
+	void ( * inject )( void );
+} fault_t;
+
+static sim_central_t g_central;
+static uint16_t g_handles[HANDLE_COUNT];
+static uint16_t g_next_handle;
+static recovery_stats_t g_before;
+
+static bool cond_advertising( void * arg )
+{
+	(void)arg;
+	return sim_ctrl_is_advertising();
+}
+
+static bool cond_encrypted( void * arg )
+{
+	sim_conn_stats_t stats;
+
+	return sim_conn_stats( (const sim_central_t *)arg, &stats ) && stats.encrypted;
+}
+
+static bool cond_notified( void * arg )
+{
+	return 0U != ( (const sim_central_t *)arg )->notifications;
+}
+
+static bool cond_fault( void * arg )
+{
+	recovery_stats_t stats;
+
+	recovery_get_stats( &stats );
+	return stats.faults[*(const recovery_cause_t *)arg] != g_before.faults[*(const recovery_cause_t *)arg];
+}
+
+static bool cond_recovered( void * arg )
+{
+	recovery_stats_t stats;
+
+	(void)arg;
+	recovery_get_stats( &stats );
+	return ( stats.recovered != g_before.recovered ) && sim_ctrl_is_advertising();
+}
+
+/* Notifications until the hung commands have been hit */
+static void inject_hci_timeouts( void )
+{
+	uint32_t i;
+
+	sim_ctrl_hang_commands( RECOVERY_HCI_TIMEOUT_LIMIT );
+	for( i = 0; RECOVERY_HCI_TIMEOUT_LIMIT > i; i++ )
+	{
+		sim_button_press();
+		sim_run_ms( 10U );
+	}
+}
+
+static void inject_irq_stuck( void )
+{
+	sim_bsp_irq_stuck();
+}
+
+static void inject_command( void )
+{
+	const uint8_t cmd = RECOVERY_CMD_INJECT;
+
+	CHECK_EQ( sim_write( &g_central, health_control_rx_char_handle + 1U, &cmd, 1U ), 0 );
+}
+
+static const fault_t FAULTS[] = {
+	{ "hci timeouts", RECOVERY_CAUSE_HCI_TIMEOUT, inject_hci_timeouts },
+	{ "irq stuck", RECOVERY_CAUSE_IRQ_STUCK, inject_irq_stuck },
+	{ "0xE0 command", RECOVERY_CAUSE_INJECTED, inject_command },
+};
+
+/* Bonded central, encrypted and subscribed to data_tx */
+static void connect( void )
+{
+	CHECK( sim_run_until( cond_advertising, NULL, 2000U ) );
+	g_central.conn_handle = 0xFFFFU;
+	CHECK( 0xFFFFU != sim_connect( &g_central ) );
+	CHECK( sim_run_until( cond_encrypted, &g_central, 3000U ) );
+	sim_run_ms( 500U );
+	CHECK_EQ( sim_subscribe( &g_central, health_data_tx_char_handle, true ), 0 );
+	sim_run_ms( 10U );
+	CHECK_EQ( link_count(), 1 );
+	CHECK( link_any_subscribed( LINK_CCCD_DATA_TX ) );
+}
+
+static void recover( const fault_t * p_fault )
+{
+	recovery_stats_t after;
+	uint64_t start;
+	uint64_t detect_ns;
+	uint32_t i;
+
+	connect();
+	recovery_get_stats( &g_before );
+	start = sim_time_ns();
+	p_fault->inject();
+	CHECK( sim_run_until( cond_fault, (void *)&p_fault->cause, FAULT_DETECT_MS ) );
+	detect_ns = sim_time_ns() - start;
+	CHECK( sim_run_until( cond_recovered, NULL, RECOVER_MS ) );
+	recovery_get_stats( &after );
+
+	/* One restart, the link gone on both sides */
+	CHECK_EQ( after.restarts, g_before.restarts + 1U );
+	CHECK_EQ( after.failed, g_before.failed );
+	CHECK_EQ( link_count(), 0 );
+	CHECK( false == link_any_subscribed( LINK_CCCD_DATA_TX ) );
+	CHECK_EQ( g_central.conn_handle, 0xFFFF );
+
+	/* GATT database replayed on the same handles */
+	for( i = 0; HANDLE_COUNT > i; i++ )
+	{
+		CHECK_EQ( *HANDLES[i], g_handles[i] );
+	}
+	CHECK_EQ( sim_gatt_next_handle(), g_next_handle );
+	CHECK_EQ( sim_gatt_find_uuid( UUID_TYPE_128, HEALTH_SERVICE_UUID, SIM_ATTR_SERVICE ), health_service_handle );
+
+	fprintf( stderr, "  %-12s : detected after %4lu ms, advertising again %4lu ms after the fault\n", p_fault->name,
+	         (unsigned long)( detect_ns / SIM_NS_PER_MS ), (unsigned long)( after.ttr_sum_ms - g_before.ttr_sum_ms ) );
+}
+
+int main( void )
+{
+	recovery_stats_t stats;
+	HCI_TL_SPI_Stats_t spi;
+	uint32_t i;
+
+	sim_ctrl_power_on( 23U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	for( i = 0; HANDLE_COUNT > i; i++ )
+	{
+		g_handles[i] = *HANDLES[i];
+	}
+	g_next_handle = sim_gatt_next_handle();
+	sim_central_init( &g_central, 0x23U );
+
+	fprintf( stderr, "Controller recovery, time to recover (fault to advertising)\n" );
+	for( i = 0; ( sizeof( FAULTS ) / sizeof( FAULTS[0] ) ) > i; i++ )
+	{
+		recover( &FAULTS[i] );
+	}
+
+	/* The stuck line was seen by the transport, and the link works again */
+	HCI_TL_SPI_GetStats( &spi );
+	CHECK_EQ( spi.irq_stuck, 1 );
+	connect();
+	g_central.notifications = 0;
+	sim_button_press();
+	CHECK( sim_run_until( cond_notified, &g_central, 1000U ) );
+
+	recovery_get_stats( &stats );
+	CHECK_EQ( stats.faults[RECOVERY_CAUSE_HCI_TIMEOUT], 1 );
+	CHECK_EQ( stats.faults[RECOVERY_CAUSE_IRQ_STUCK], 1 );
+	CHECK_EQ( stats.faults[RECOVERY_CAUSE_INJECTED], 1 );
+	CHECK_EQ( stats.recovered, 3 );
+	CHECK( ( stats.ttr_min_ms <= ( stats.ttr_sum_ms / stats.recovered ) ) && ( ( stats.ttr_sum_ms / stats.recovered ) <= stats.ttr_max_ms ) );
+	fprintf( stderr, "  ttr          : min %lu ms, avg %lu ms, max %lu ms over %lu recoveries\n",
+	         (unsigned long)stats.ttr_min_ms, (unsigned long)( stats.ttr_sum_ms / stats.recovered ),
+	         (unsigned long)stats.ttr_max_ms, (unsigned long)stats.recovered );
+
+	return TEST_END( "test_recovery" );
+}
@@ -0,0 +1,202 @@
+/*
+ * test_sim_smoke.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * One central through the life of a connection against the simulated
+ * controller: boot, GATT layout, advertising, connection procedures,
+ * pairing, CCCD write, button notification, read, control write and
+ * disconnection. Built for both variants (fw and legacy, see Makefile).
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#if ( 1 == APP_BENCH )
+#define TEST_NAME					"test_sim_smoke (fw)"
+#else
+#define TEST_NAME					"test_sim_smoke (legacy)"
+#endif /* ( 1 == APP_BENCH ) */
+
+extern const uint8_t HEALTH_SERVICE_UUID[16];
+extern uint16_t health_service_handle;
+extern uint16_t health_bpm_char_handle;
+extern uint16_t health_weight_char_handle;
+extern uint16_t health_data_tx_char_handle;
+extern uint16_t health_control_rx_char_handle;
+extern uint16_t weather_service_handle;
+extern uint16_t weather_temperature_char_handle;
+extern uint16_t weather_humidity_char_handle;
+#if ( 1 == APP_BENCH )
+extern uint16_t health_bench_tx_char_handle;
+#endif /* ( 1 == APP_BENCH ) */
+
+static sim_central_t g_central;
+static uint8_t g_last_notify[32];
+static uint16_t g_last_notify_len;
+static uint16_t g_last_notify_handle;
+
+static void on_notify( void * p_central, uint16_t attr_handle, const uint8_t * data, uint16_t len )
+{
+	(void)p_central;
+	g_last_notify_handle = attr_handle;
+	g_last_notify_len = ( len < sizeof( g_last_notify ) ) ? len : (uint16_t)sizeof( g_last_notify );
+	memcpy( g_last_notify, data, g_last_notify_len );
+}
+
+static bool cond_advertising( void * arg )
+{
+	(void)arg;
+	return sim_ctrl_is_advertising();
+}
+
+static bool cond_encrypted( void * arg )
+{
+	sim_conn_stats_t stats;
+
+	return sim_conn_stats( (const sim_central_t *)arg, &stats ) && stats.encrypted;
+}
+
+static bool cond_connected( void * arg )
+{
+	return 0xFFFFU != ( (const sim_central_t *)arg )->conn_handle;
+}
+
+static bool cond_notified( void * arg )
+{
+	return 0U != ( (const sim_central_t *)arg )->notifications;
+}
+
+static bool cond_disconnected( void * arg )
+{
+	(void)arg;
+	return 0U == link_count();
+}
+
+static void test_gatt_layout( void )
+{
+	const sim_attr_t * p_attr;
+
+	/* GATT and GAP services of aci_gatt_init() / aci_gap_init() first */
+	CHECK_EQ( health_service_handle, 0x000C );
+	CHECK_EQ( health_bpm_char_handle, 0x000D );
+	CHECK_EQ( health_weight_char_handle, 0x000F );
+	CHECK_EQ( health_data_tx_char_handle, 0x0011 );
+	CHECK_EQ( health_control_rx_char_handle, 0x0014 );
+#if ( 1 == APP_BENCH )
+	CHECK_EQ( health_bench_tx_char_handle, 0x0016 );
+	CHECK_EQ( weather_service_handle, 0x0019 );
+	CHECK_EQ( weather_temperature_char_handle, 0x001A );
+	CHECK_EQ( weather_humidity_char_handle, 0x001C );
+#else
+	CHECK_EQ( weather_service_handle, 0x0016 );
+	CHECK_EQ( weather_temperature_char_handle, 0x0017 );
+	CHECK_EQ( weather_humidity_char_handle, 0x0019 );
+#endif /* ( 1 == APP_BENCH ) */
+
+	p_attr = sim_gatt_attr( health_service_handle );
+	CHECK( ( NULL != p_attr ) && ( SIM_ATTR_SERVICE == p_attr->type ) );
+	CHECK_EQ( sim_gatt_find_uuid( UUID_TYPE_128, HEALTH_SERVICE_UUID, SIM_ATTR_SERVICE ), health_service_handle );
+
+	/* data_tx notifies: value then CCCD after the declaration */
+	p_attr = sim_gatt_attr( health_data_tx_char_handle + 2U );
+	CHECK( ( NULL != p_attr ) && ( SIM_ATTR_CCCD == p_attr->type ) );
+	p_attr = sim_gatt_attr( health_control_rx_char_handle + 1U );
+	CHECK( ( NULL != p_attr ) && ( SIM_ATTR_CHAR_VALUE == p_attr->type ) && ( 0U != ( p_attr->permissions & ATTR_PERMISSION_ENCRY_WRITE ) ) );
+}
+
+int main( void )
+{
+	sim_conn_stats_t stats;
+	rx_queue_stats_t rxq_before;
+	rx_queue_stats_t rxq_after;
+	uint8_t value[32];
+	uint16_t len = 0;
+	uint16_t conn;
+
+	sim_ctrl_power_on( 1U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+	test_gatt_layout();
+
+	/* Advertising requested at boot */
+	CHECK( sim_run_until( cond_advertising, NULL, 1000U ) );
+
+	sim_central_init( &g_central, 0x01U );
+	g_central.on_notify = on_notify;
+	conn = sim_connect( &g_central );
+	CHECK( 0xFFFFU != conn );
+	sim_run_ms( 500U );
+	CHECK( link_is_connected( conn ) );
+	CHECK_EQ( link_count(), 1 );
+
+	/* MTU exchange, DLE, 2M PHY, then the slave security request pairs */
+	CHECK( sim_run_until( cond_encrypted, &g_central, 2000U ) );
+	CHECK( sim_conn_stats( &g_central, &stats ) );
+	CHECK_EQ( stats.att_mtu, SIM_ATT_MTU_MAX );
+	CHECK_EQ( stats.tx_octets, 251 );
+	CHECK_EQ( stats.tx_phy, 2 );
+	CHECK_EQ( link_get_att_mtu( conn ), SIM_ATT_MTU_MAX );
+	sim_run_ms( 500U );
+	CHECK( g_central.has_keys );
+	CHECK_EQ( sim_bond_count(), 1 );
+
+	/* CCCD write, then the button notification on data_tx */
+	CHECK_EQ( sim_subscribe( &g_central, health_data_tx_char_handle, true ), 0 );
+	sim_run_ms( 10U );
+	CHECK( link_any_subscribed( LINK_CCCD_DATA_TX ) );
+	sim_button_press();
+	CHECK( sim_run_until( cond_notified, &g_central, 1000U ) );
+	CHECK_EQ( g_last_notify_handle, health_data_tx_char_handle + 1U );
+	CHECK_EQ( g_last_notify_len, 4 );
+	CHECK_EQ( g_last_notify[0], SAMPLER_FRAME_EVENT_BUTTON );
+	CHECK( 0 == memcmp( &g_last_notify[1], "hlg", 3 ) );
+
+	/* Read of a value: read permit request and allow in legacy, cached
+	 * value answered by the controller with APP_READ_CACHE */
+	CHECK_EQ( sim_read( &g_central, health_bpm_char_handle + 1U, value, sizeof( value ), &len ), 0 );
+	CHECK( 0U != len );
+	CHECK_EQ( sim_read( &g_central, weather_humidity_char_handle + 1U, value, sizeof( value ), &len ), 0 );
+	CHECK( 0U != len );
+
+	/* Control write on the encrypted link: unknown command, rejected by the
+	 * command processor but accepted by the RX queue */
+	rx_queue_get_stats( &rxq_before );
+	value[0] = 0x7EU;
+	CHECK_EQ( sim_write( &g_central, health_control_rx_char_handle + 1U, value, 1U ), 0 );
+	sim_run_ms( 10U );
+	rx_queue_get_stats( &rxq_after );
+	CHECK_EQ( rxq_after.received, rxq_before.received + 1U );
+	CHECK_EQ( rxq_after.rejected, rxq_before.rejected + 1U );
+
+	/* Event injector: the same write straight as aci_gatt_attribute_modified_event */
+	sim_inject_attribute_modified( conn, health_control_rx_char_handle + 1U, value, 1U );
+	sim_run_ms( 10U );
+	rx_queue_get_stats( &rxq_after );
+	CHECK_EQ( rxq_after.rejected, rxq_before.rejected + 2U );
+
+	/* Central leaves: link released, advertising back */
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_disconnected, NULL, 1000U ) );
+	CHECK( sim_run_until( cond_advertising, NULL, 1000U ) );
+
+	/* Unencrypted link: the control write needs encryption. Another central
+	 * that does not pair, scanning until the directed advertising to the
+	 * bonded one has timed out. */
+	sim_central_init( &g_central, 0x02U );
+	g_central.pairs = false;
+	sim_central_scan( &g_central, 100000U, 100000U );
+	CHECK( sim_run_until( cond_connected, &g_central, 3000U ) );
+	sim_central_stop_scan( &g_central );
+	sim_run_ms( 300U );
+	CHECK( sim_conn_stats( &g_central, &stats ) );
+	CHECK( false == stats.encrypted );
+	CHECK_EQ( sim_write( &g_central, health_control_rx_char_handle + 1U, value, 1U ), 0x0F );
+	sim_disconnect( &g_central, 0x13U );
+	sim_run_ms( 100U );
+
+	return TEST_END( TEST_NAME );
+}
@@ -0,0 +1,271 @@
+/*
+ * test_spi_dma.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * DMA and polled transports must move the same bytes: frames captured from a
+ * BlueNRG-2 are replayed by the SPI slave model (sim_spi_slave.c) and read
+ * through the bottom half with each fops table, and the commands the
+ * application sends are written both ways. Repeated at the other SCK rate,
+ * and with failing DMA transfers, which must be retried without changing a byte.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "hci_tl.h"
+#include "hci_tl_interface.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define STREAM_MAX						( 16384U )
+#define REPLAY_ROUNDS					( 8U )
+
+typedef struct
+{
+	uint16_t len;
+	const uint8_t * data;
+} capture_t;
+
+/* Events as read from the BlueNRG-2 (HCI UART packet type first) */
+static const uint8_t cap_cmd_complete[] = {					/* aci_hal_get_firmware_details */
+	0x04, 0x0E, 0x10, 0x01, 0x0C, 0xFC, 0x00, 0x03, 0x04, 0x00, 0x02, 0x00, 0x01, 0x03, 0x04, 0x02, 0x00, 0x00, 0x00
+};
+static const uint8_t cap_cmd_status[] = {						/* hci_le_create_connection, 7 bytes: polled even with DMA */
+	0x04, 0x0F, 0x04, 0x00, 0x01, 0x0D, 0x20
+};
+static const uint8_t cap_conn_complete[] = {				/* hci_le_connection_complete */
+	0x04, 0x3E, 0x13, 0x01, 0x00, 0x01, 0x08, 0x00, 0x00, 0x3A, 0x91, 0x5C, 0xE1, 0x80, 0xD4, 0x18, 0x00, 0x00, 0x00, 0xF4, 0x01, 0x00
+};
+static const uint8_t cap_data_length[] = {					/* hci_le_data_length_change */
+	0x04, 0x3E, 0x0B, 0x07, 0x01, 0x08, 0xFB, 0x00, 0x48, 0x08, 0xFB, 0x00, 0x48, 0x08
+};
+static const uint8_t cap_completed_pkts[] = {				/* hci_number_of_completed_packets, exactly HCI_TL_SPI_DMA_MIN_SIZE */
+	0x04, 0x13, 0x05, 0x01, 0x01, 0x08, 0x01, 0x00
+};
+static const uint8_t cap_mtu[] = {									/* aci_att_exchange_mtu_resp */
+	0x04, 0xFF, 0x06, 0x02, 0x0C, 0x01, 0x08, 0xF7, 0x00
+};
+static const uint8_t cap_attr_modified[] = {				/* aci_gatt_attribute_modified, CCCD */
+	0x04, 0xFF, 0x0B, 0x01, 0x0C, 0x01, 0x08, 0x0E, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00
+};
+static const uint8_t cap_disconn[] = {							/* hci_disconnection_complete */
+	0x04, 0x05, 0x04, 0x00, 0x01, 0x08, 0x13
+};
+static uint8_t cap_write_long[255];									/* aci_gatt_attribute_modified, longest frame */
+static uint8_t cap_write_mid[64];										/* aci_gatt_attribute_modified */
+
+static const capture_t g_events[] = {
+	{ sizeof( cap_cmd_complete ), cap_cmd_complete },
+	{ sizeof( cap_cmd_status ), cap_cmd_status },
+	{ sizeof( cap_conn_complete ), cap_conn_complete },
+	{ sizeof( cap_data_length ), cap_data_length },
+	{ sizeof( cap_mtu ), cap_mtu },
+	{ sizeof( cap_attr_modified ), cap_attr_modified },
+	{ sizeof( cap_write_long ), cap_write_long },
+	{ sizeof( cap_completed_pkts ), cap_completed_pkts },
+	{ sizeof( cap_write_mid ), cap_write_mid },
+	{ sizeof( cap_disconn ), cap_disconn },
+};
+#define EVENT_COUNT						( sizeof( g_events ) / sizeof( g_events[0] ) )
+
+/* Commands as the application writes them */
+static const uint8_t cmd_reset[] = { 0x01, 0x03, 0x0C, 0x00 };
+static const uint8_t cmd_adv_enable[] = {
+	0x01, 0x83, 0xFC, 0x0F, 0x00, 0xA0, 0x00, 0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+static uint8_t cmd_notify[3U + 1U + 244U];					/* aci_gatt_update_char_value_ext, full MTU */
+
+typedef struct
+{
+	uint8_t data[STREAM_MAX];
+	uint32_t len;
+} stream_t;
+
+static stream_t g_read[2];
+static stream_t g_written[2];
+static stream_t g_expected_read;
+static stream_t g_expected_written;
+
+static void stream_put( stream_t * p_stream, const uint8_t * data, uint16_t len )
+{
+	if( ( p_stream->len + len ) <= STREAM_MAX )
+	{
+		memcpy( &p_stream->data[p_stream->len], data, len );
+		p_stream->len += len;
+	}
+}
+
+static void captures_init( void )
+{
+	const uint8_t hdr[] = { 0x04, 0xFF, 0x00, 0x01, 0x0C, 0x01, 0x08, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+	memcpy( cap_write_long, hdr, sizeof( hdr ) );
+	cap_write_long[2] = sizeof( cap_write_long ) - 3U;
+	cap_write_long[11] = sizeof( cap_write_long ) - sizeof( hdr );
+	for( uint16_t i = sizeof( hdr ); sizeof( cap_write_long ) > i; i++ )
+	{
+		cap_write_long[i] = (uint8_t)( i * 7U );
+	}
+	memcpy( cap_write_mid, hdr, sizeof( hdr ) );
+	cap_write_mid[2] = sizeof( cap_write_mid ) - 3U;
+	cap_write_mid[11] = sizeof( cap_write_mid ) - sizeof( hdr );
+	for( uint16_t i = sizeof( hdr ); sizeof( cap_write_mid ) > i; i++ )
+	{
+		cap_write_mid[i] = (uint8_t)( 0xFFU - i );
+	}
+	cmd_notify[0] = 0x01;
+	cmd_notify[1] = 0x2C;
+	cmd_notify[2] = 0xFD;
+	cmd_notify[3] = 244U;
+	for( uint16_t i = 4; sizeof( cmd_notify ) > i; i++ )
+	{
+		cmd_notify[i] = (uint8_t)( i ^ 0x5AU );
+	}
+}
+
+static void transport_setup( bool dma, uint32_t sck_hz )
+{
+	sim_spi_config_t cfg;
+	tHciIO io;
+	uint8_t buf[SIM_SPI_FRAME_MAX];
+
+	sim_spi_default_config( &cfg );
+	cfg.sck_hz = sck_hz;
+	sim_spi_slave_init( &cfg );
+	/* DMA fops, as the firmware registers them */
+	hci_tl_lowlevel_init();
+	if( false == dma )
+	{
+		memset( &io, 0, sizeof( io ) );
+		io.Init = HCI_TL_SPI_Init;
+		io.DeInit = HCI_TL_SPI_DeInit;
+		io.Send = HCI_TL_SPI_Send;
+		io.Receive = HCI_TL_SPI_Receive;
+		io.Reset = HCI_TL_SPI_Reset;
+		io.GetTick = BSP_GetTick;
+		hci_register_io_bus( &io );
+	}
+	(void)HCI_TL_SPI_Init( NULL );
+	HCI_TL_SPI_ResetStats();
+	sim_hci_spi_set_pool( 256U );
+	while( 0U != sim_hci_spi_pop( buf, sizeof( buf ) ) )
+	{
+	}
+}
+
+static void run_bottom_half( void )
+{
+	const uint64_t end = sim_time_ns() + ( 1000ULL * SIM_NS_PER_MS );
+
+	while( sim_time_ns() < end )
+	{
+		if( sim_spi_pendsv() )
+		{
+			continue;
+		}
+		if( ( 0U == sim_spi_slave_queued() ) && ( false == sim_spi_slave_irq() ) )
+		{
+			return;
+		}
+		sim_time_idle();
+	}
+}
+
+/* Replays the captures REPLAY_ROUNDS times, sends the commands, records both directions */
+static void replay( bool dma, uint32_t sck_hz, uint32_t dma_fail )
+{
+	int32_t ( * const send )( uint8_t *, uint16_t ) = dma ? HCI_TL_SPI_Send_DMA : HCI_TL_SPI_Send;
+	stream_t * const p_read = &g_read[dma ? 1 : 0];
+	stream_t * const p_written = &g_written[dma ? 1 : 0];
+	uint8_t buf[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+	uint16_t len;
+
+	transport_setup( dma, sck_hz );
+	p_read->len = 0;
+	p_written->len = 0;
+	for( uint32_t r = 0; REPLAY_ROUNDS > r; r++ )
+	{
+		/* Events arrive between two commands, a whole burst read per bottom half */
+		for( uint32_t e = 0; EVENT_COUNT > e; e++ )
+		{
+			(void)sim_spi_slave_queue( g_events[e].data, g_events[e].len );
+		}
+		sim_spi_config()->dma_fail = dma_fail;
+		run_bottom_half();
+		CHECK_EQ( sim_spi_config()->dma_fail, 0 );
+		while( 0U != ( len = sim_hci_spi_pop( buf, sizeof( buf ) ) ) )
+		{
+			stream_put( p_read, buf, len );
+		}
+
+		sim_spi_config()->dma_fail = dma_fail;
+		CHECK_EQ( send( (uint8_t *)cmd_reset, sizeof( cmd_reset ) ), 0 );
+		CHECK_EQ( send( (uint8_t *)cmd_adv_enable, sizeof( cmd_adv_enable ) ), 0 );
+		CHECK_EQ( send( cmd_notify, sizeof( cmd_notify ) ), 0 );
+		CHECK_EQ( sim_spi_config()->dma_fail, dma ? 0U : dma_fail );
+		while( 0U != ( len = sim_spi_slave_pop_write( buf, sizeof( buf ) ) ) )
+		{
+			stream_put( p_written, buf, len );
+		}
+		run_bottom_half();
+	}
+
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( stats.rx_frames, REPLAY_ROUNDS * EVENT_COUNT );
+	CHECK_EQ( stats.tx_frames, REPLAY_ROUNDS * 3U );
+	CHECK_EQ( stats.irq_stuck, 0 );
+	CHECK_EQ( slave.header_errors, 0 );
+	CHECK_EQ( slave.bus_bytes, stats.wire_bytes );
+	/* Polled never touches the DMA stream */
+	CHECK( dma || ( 0U == slave.dma_transfers ) );
+	CHECK( ( false == dma ) || ( 0U != slave.dma_transfers ) );
+}
+
+static void compare( const char * what )
+{
+	CHECK_EQ( g_read[0].len, g_expected_read.len );
+	CHECK_EQ( g_read[1].len, g_expected_read.len );
+	CHECK( 0 == memcmp( g_read[0].data, g_expected_read.data, g_expected_read.len ) );
+	CHECK( 0 == memcmp( g_read[1].data, g_read[0].data, g_expected_read.len ) );
+	CHECK_EQ( g_written[0].len, g_expected_written.len );
+	CHECK_EQ( g_written[1].len, g_expected_written.len );
+	CHECK( 0 == memcmp( g_written[0].data, g_expected_written.data, g_expected_written.len ) );
+	CHECK( 0 == memcmp( g_written[1].data, g_written[0].data, g_expected_written.len ) );
+	fprintf( stderr, "%s: %lu bytes read, %lu bytes written, polled == DMA\n", what,
+	         (unsigned long)g_read[1].len, (unsigned long)g_written[1].len );
+}
+
+int main( void )
+{
+	captures_init();
+	for( uint32_t r = 0; REPLAY_ROUNDS > r; r++ )
+	{
+		for( uint32_t e = 0; EVENT_COUNT > e; e++ )
+		{
+			stream_put( &g_expected_read, g_events[e].data, g_events[e].len );
+		}
+		stream_put( &g_expected_written, cmd_reset, sizeof( cmd_reset ) );
+		stream_put( &g_expected_written, cmd_adv_enable, sizeof( cmd_adv_enable ) );
+		stream_put( &g_expected_written, cmd_notify, sizeof( cmd_notify ) );
+	}
+
+	replay( false, SIM_SPI_SCK_HZ_DEFAULT, 0U );
+	replay( true, SIM_SPI_SCK_HZ_DEFAULT, 0U );
+	compare( "1 MHz" );
+
+	replay( false, 8000000U, 0U );
+	replay( true, 8000000U, 0U );
+	compare( "8 MHz" );
+
+	/* DMA transfers failing in each burst: retried, same bytes */
+	replay( false, SIM_SPI_SCK_HZ_DEFAULT, 0U );
+	replay( true, SIM_SPI_SCK_HZ_DEFAULT, 2U );
+	compare( "1 MHz, 2 DMA failures per burst" );
+
+	return TEST_END( "test_spi_dma" );
+}
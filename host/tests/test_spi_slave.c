@@ -0,0 +1,587 @@
+/*
+ * test_spi_slave.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * hci_tl_interface.c against the BlueNRG-2 SPI slave model (sim_spi_slave.c):
+ * header bytes, buffer size bytes, the IRQ handshake, back-pressure (-2),
+ * timeouts (-3), injected delays and faults, bytes on the wire per frame,
+ * and a throughput benchmark of the read and write paths, polled and DMA.
+ *
+ * Every check of the wire bytes is made on both sides: the transport
+ * counters (HCI_TL_SPI_Stats_t.wire_bytes) and the bytes the slave saw.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "hci_tl.h"
+#include "hci_tl_interface.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define HDR									( 5U )
+#define BENCH_FRAMES				( 64U )
+
+typedef enum
+{
+	PATH_POLLED = 0,
+	PATH_DMA,
+} path_t;
+
+static const char * const g_path_name[] = { "polled", "DMA" };
+
+static void spi_setup( const sim_spi_config_t * p_cfg, path_t path )
+{
+	tHciIO io;
+	uint8_t buf[SIM_SPI_FRAME_MAX];
+
+	sim_spi_slave_init( p_cfg );
+	hci_tl_lowlevel_init();
+	(void)HCI_TL_SPI_Init( NULL );
+	if( PATH_POLLED == path )
+	{
+		/* Same transport, payloads clocked by the core */
+		memset( &io, 0, sizeof( io ) );
+		io.Init = HCI_TL_SPI_Init;
+		io.DeInit = HCI_TL_SPI_DeInit;
+		io.Send = HCI_TL_SPI_Send;
+		io.Receive = HCI_TL_SPI_Receive;
+		io.Reset = HCI_TL_SPI_Reset;
+		io.GetTick = BSP_GetTick;
+		hci_register_io_bus( &io );
+	}
+	HCI_TL_SPI_ResetStats();
+	sim_hci_spi_set_pool( 256U );
+	while( 0U != sim_hci_spi_pop( buf, sizeof( buf ) ) )
+	{
+	}
+	while( 0U != sim_spi_slave_pop_write( buf, sizeof( buf ) ) )
+	{
+	}
+}
+
+static void frame_fill( uint8_t * frame, uint16_t len, uint32_t tag )
+{
+	frame[0] = 0x04U;								/* HCI event packet */
+	frame[1] = 0xFFU;
+	frame[2] = (uint8_t)( len - 3U );
+	for( uint16_t i = 3; len > i; i++ )
+	{
+		frame[i] = (uint8_t)( ( tag * 31U ) + i );
+	}
+}
+
+/* Main loop asleep, PendSV runs the bottom half: until every event is read */
+static bool run_bottom_half( uint32_t timeout_ms )
+{
+	const uint64_t end = sim_time_ns() + ( (uint64_t)timeout_ms * SIM_NS_PER_MS );
+
+	while( sim_time_ns() < end )
+	{
+		if( sim_spi_pendsv() )
+		{
+			continue;
+		}
+		if( ( 0U == sim_spi_slave_queued() ) && ( false == sim_spi_slave_irq() ) )
+		{
+			return true;
+		}
+		sim_time_idle();
+	}
+	return false;
+}
+
+static void check_wire_bytes( uint32_t expected )
+{
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( stats.wire_bytes, expected );
+	CHECK_EQ( slave.bus_bytes, expected );
+	CHECK_EQ( slave.header_errors, 0 );
+}
+
+/* Header exchanged by hand: what the slave answers to 0x0b / 0x0a / junk */
+static void test_header( void )
+{
+	uint8_t tx[HDR] = { 0x0BU, 0, 0, 0, 0 };
+	uint8_t rx[HDR];
+	uint8_t event[40];
+	sim_spi_config_t cfg;
+	sim_spi_stats_t slave;
+
+	sim_spi_default_config( &cfg );
+	cfg.write_buffer = 0x0123U;
+	spi_setup( &cfg, PATH_DMA );
+	HAL_NVIC_DisableIRQ( EXTI0_IRQn );
+	frame_fill( event, sizeof( event ), 1U );
+	CHECK( sim_spi_slave_queue( event, sizeof( event ) ) );
+	CHECK( sim_spi_slave_irq() );
+
+	/* Read header: ready, buffer room, event length */
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_RESET );
+	(void)BSP_SPI1_SendRecv( tx, rx, HDR );
+	CHECK_EQ( rx[0], 0x02 );
+	CHECK_EQ( rx[1] | ( rx[2] << 8 ), 0x0123 );
+	CHECK_EQ( rx[3] | ( rx[4] << 8 ), sizeof( event ) );
+	/* IRQ falls irq_low_ns after the header */
+	sim_time_advance_ns( cfg.irq_low_ns );
+	CHECK( false == sim_spi_slave_irq() );
+	/* CS released without the payload: the event stays */
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET );
+	CHECK_EQ( sim_spi_slave_queued(), 1 );
+
+	/* Header clocked before IRQ is up (slave still asleep): zeros */
+	cfg.wake_ns = 1000000U;
+	sim_spi_slave_init( &cfg );
+	tx[0] = 0x0AU;
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_RESET );
+	(void)BSP_SPI1_SendRecv( tx, rx, HDR );
+	CHECK_EQ( rx[0] | rx[1] | rx[2] | rx[3] | rx[4], 0 );
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET );
+
+	/* Write header once awake: room, no event */
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_RESET );
+	sim_time_advance_ns( cfg.wake_ns );
+	CHECK( sim_spi_slave_irq() );
+	(void)BSP_SPI1_SendRecv( tx, rx, HDR );
+	CHECK_EQ( rx[0], 0x02 );
+	CHECK_EQ( rx[1] | ( rx[2] << 8 ), 0x0123 );
+	CHECK_EQ( rx[3] | ( rx[4] << 8 ), 0 );
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET );
+
+	/* Unknown first byte */
+	tx[0] = 0x0CU;
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_RESET );
+	sim_time_advance_ns( cfg.wake_ns );
+	(void)BSP_SPI1_SendRecv( tx, rx, HDR );
+	HAL_GPIO_WritePin( HCI_TL_SPI_CS_PORT, HCI_TL_SPI_CS_PIN, GPIO_PIN_SET );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( slave.header_errors, 1 );
+	HAL_NVIC_EnableIRQ( EXTI0_IRQn );
+}
+
+/* One command, one event, one empty read: counters and bytes per frame */
+static void test_frames( path_t path )
+{
+	uint8_t cmd[12] = { 0x01U, 0x06U, 0xFCU, 0x08U };
+	uint8_t event[40];
+	uint8_t out[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+	uint32_t edges;
+	int32_t ret;
+
+	spi_setup( NULL, path );
+	edges = sim_hci_spi_edges();
+	for( uint16_t i = 4; sizeof( cmd ) > i; i++ )
+	{
+		cmd[i] = (uint8_t)i;
+	}
+
+	/* Write: 0x0a header, room checked, payload taken */
+	ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ) : HCI_TL_SPI_Send( cmd, sizeof( cmd ) );
+	CHECK_EQ( ret, 0 );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), sizeof( cmd ) );
+	CHECK( 0 == memcmp( out, cmd, sizeof( cmd ) ) );
+	CHECK( 0U != ( host_gpioa.ODR & HCI_TL_SPI_CS_PIN ) );
+	check_wire_bytes( HDR + sizeof( cmd ) );
+
+	/* Read through the EXTI0 interrupt and the bottom half */
+	frame_fill( event, sizeof( event ), 2U );
+	CHECK( sim_spi_slave_queue( event, sizeof( event ) ) );
+	/* The ready edge of the write, pended while masked, and the event's */
+	CHECK_EQ( sim_hci_spi_edges(), edges + 2U );
+	CHECK( run_bottom_half( 10U ) );
+	CHECK_EQ( sim_hci_spi_pop( out, sizeof( out ) ), sizeof( event ) );
+	CHECK( 0 == memcmp( out, event, sizeof( event ) ) );
+	check_wire_bytes( HDR + sizeof( cmd ) + HDR + sizeof( event ) );
+
+	/* Read with nothing to send: header only */
+	ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Receive_DMA( out, sizeof( out ) ) : HCI_TL_SPI_Receive( out, sizeof( out ) );
+	CHECK_EQ( ret, 0 );
+	check_wire_bytes( HDR + sizeof( cmd ) + HDR + sizeof( event ) + HDR );
+
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( stats.tx_frames, 1 );
+	CHECK_EQ( stats.tx_bytes, sizeof( cmd ) );
+	CHECK_EQ( stats.rx_frames, 1 );
+	CHECK_EQ( stats.rx_bytes, sizeof( event ) );
+	CHECK_EQ( stats.rx_empty, 1 );
+	CHECK_EQ( stats.tx_retries, 0 );
+	CHECK_EQ( stats.tx_timeouts, 0 );
+	CHECK_EQ( stats.irq_low_timeouts, 0 );
+	/* One ready wait per write attempt, one end of frame wait per frame */
+	CHECK_EQ( stats.ready_wait.count, 1 );
+	CHECK_EQ( stats.low_wait.count, 3 );
+	CHECK_EQ( slave.write_frames, 1 );
+	CHECK_EQ( slave.read_frames, 1 );
+	CHECK_EQ( slave.dma_transfers, ( PATH_DMA == path ) ? 2 : 0 );
+}
+
+/* IRQ handshake: edges while EXTI0 is masked are taken when it is enabled */
+static void test_irq_handshake( void )
+{
+	uint8_t event[16];
+	uint8_t out[SIM_SPI_FRAME_MAX];
+	uint32_t edges;
+
+	spi_setup( NULL, PATH_DMA );
+	edges = sim_hci_spi_edges();
+	HAL_NVIC_DisableIRQ( EXTI0_IRQn );
+	for( uint32_t i = 0; 3U > i; i++ )
+	{
+		frame_fill( event, sizeof( event ), 10U + i );
+		CHECK( sim_spi_slave_queue( event, sizeof( event ) ) );
+	}
+	CHECK_EQ( sim_hci_spi_edges(), edges );
+	HAL_NVIC_EnableIRQ( EXTI0_IRQn );
+	CHECK_EQ( sim_hci_spi_edges(), edges + 1U );
+
+	/* One bottom half per edge: IRQ back up next_irq_ns after each frame */
+	CHECK( run_bottom_half( 10U ) );
+	CHECK_EQ( sim_hci_spi_count(), 3 );
+	CHECK_EQ( sim_hci_spi_edges(), edges + 3U );
+	for( uint32_t i = 0; 3U > i; i++ )
+	{
+		frame_fill( event, sizeof( event ), 10U + i );
+		CHECK_EQ( sim_hci_spi_pop( out, sizeof( out ) ), sizeof( event ) );
+		CHECK( 0 == memcmp( out, event, sizeof( event ) ) );
+	}
+
+	/* RX pool full: the bottom half leaves the frame with the slave */
+	sim_hci_spi_set_pool( 0U );
+	frame_fill( event, sizeof( event ), 20U );
+	CHECK( sim_spi_slave_queue( event, sizeof( event ) ) );
+	CHECK( sim_spi_pendsv() );
+	CHECK_EQ( sim_spi_slave_queued(), 1 );
+	sim_hci_spi_set_pool( 256U );
+	HAL_NVIC_SetPendingIRQ( EXTI0_IRQn );
+	CHECK( run_bottom_half( 10U ) );
+	CHECK_EQ( sim_hci_spi_count(), 1 );
+}
+
+/* Command buffer short: -2 retries until it drains, or until the timeout */
+static void test_back_pressure( path_t path )
+{
+	uint8_t cmd[60];
+	uint8_t out[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+	sim_spi_config_t cfg;
+	uint64_t start;
+	int32_t ret;
+
+	memset( cmd, 0x5A, sizeof( cmd ) );
+	sim_spi_default_config( &cfg );
+	cfg.write_buffer = 64U;
+	cfg.write_drain_ns = 300000U;
+	spi_setup( &cfg, path );
+
+	ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ) : HCI_TL_SPI_Send( cmd, sizeof( cmd ) );
+	CHECK_EQ( ret, 0 );
+	/* Second command while the first is still in the buffer */
+	start = sim_time_ns();
+	ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ) : HCI_TL_SPI_Send( cmd, sizeof( cmd ) );
+	CHECK_EQ( ret, 0 );
+	CHECK( ( sim_time_ns() - start ) >= ( cfg.write_drain_ns / 2U ) );
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK( 0U != stats.tx_retries );
+	CHECK_EQ( stats.tx_retries, slave.write_refused );
+	CHECK_EQ( stats.tx_frames, 2 );
+	CHECK_EQ( stats.tx_timeouts, 0 );
+	/* Headers of every attempt, payloads of the accepted ones */
+	check_wire_bytes( ( HDR * ( 2U + stats.tx_retries ) ) + ( 2U * sizeof( cmd ) ) );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), sizeof( cmd ) );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), sizeof( cmd ) );
+
+	/* Never enough room: -2 retried until TIMEOUT_DURATION, then -3 */
+	cfg.write_buffer = 16U;
+	spi_setup( &cfg, path );
+	start = sim_time_ns();
+	ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ) : HCI_TL_SPI_Send( cmd, sizeof( cmd ) );
+	CHECK_EQ( ret, -3 );
+	CHECK( ( sim_time_ns() - start ) >= ( 100ULL * SIM_NS_PER_MS ) );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK( 1U < stats.tx_retries );
+	CHECK_EQ( stats.tx_timeouts, 1 );
+	CHECK_EQ( stats.tx_frames, 0 );
+	check_wire_bytes( HDR * stats.tx_retries );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), 0 );
+}
+
+/* IRQ never raised after CS low: -3 after TIMEOUT_DURATION, CS released */
+static void test_timeout( void )
+{
+	uint8_t cmd[8] = { 0x01U, 0x03U, 0x0CU, 0x00U };
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_config_t cfg;
+	uint64_t start;
+
+	sim_spi_default_config( &cfg );
+	cfg.irq_dead = true;
+	spi_setup( &cfg, PATH_DMA );
+	start = sim_time_ns();
+	CHECK_EQ( HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ), -3 );
+	CHECK( ( sim_time_ns() - start ) >= ( 100ULL * SIM_NS_PER_MS ) );
+	CHECK( 0U != ( host_gpioa.ODR & HCI_TL_SPI_CS_PIN ) );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( stats.tx_timeouts, 1 );
+	CHECK_EQ( stats.tx_frames, 0 );
+	CHECK( 100000U <= stats.ready_wait.max_us );
+	check_wire_bytes( 0U );
+}
+
+/* Slow wake up and slow end of frame show in the wait statistics */
+static void test_delays( void )
+{
+	uint8_t cmd[4] = { 0x01U, 0x03U, 0x0CU, 0x00U };
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_config_t cfg;
+
+	sim_spi_default_config( &cfg );
+	cfg.wake_ns = 400000U;
+	cfg.irq_low_ns = 700000U;
+	spi_setup( &cfg, PATH_POLLED );
+	CHECK_EQ( HCI_TL_SPI_Send( cmd, sizeof( cmd ) ), 0 );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK( ( 400U <= stats.ready_wait.max_us ) && ( 1400U > stats.ready_wait.max_us ) );
+	/* IRQ low 700 us after the header, the payload took part of it */
+	CHECK( ( 600U <= stats.low_wait.max_us ) && ( 1700U > stats.low_wait.max_us ) );
+	CHECK_EQ( stats.irq_low_timeouts, 0 );
+}
+
+/* Failed or hung DMA: no payload on the wire, the event is read again */
+static void test_dma_faults( void )
+{
+	uint8_t event[64];
+	uint8_t cmd[32];
+	uint8_t out[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_config_t cfg;
+
+	sim_spi_default_config( &cfg );
+	spi_setup( &cfg, PATH_DMA );
+	HAL_NVIC_DisableIRQ( EXTI0_IRQn );
+	frame_fill( event, sizeof( event ), 30U );
+	CHECK( sim_spi_slave_queue( event, sizeof( event ) ) );
+
+	sim_spi_config()->dma_fail = 1U;
+	CHECK_EQ( HCI_TL_SPI_Receive_DMA( out, sizeof( out ) ), 0 );
+	check_wire_bytes( HDR );
+	CHECK_EQ( sim_spi_slave_queued(), 1 );
+
+	sim_spi_config()->dma_hang = true;
+	sim_time_advance_ns( cfg.next_irq_ns );
+	CHECK_EQ( HCI_TL_SPI_Receive_DMA( out, sizeof( out ) ), 0 );
+	check_wire_bytes( 2U * HDR );
+	sim_spi_config()->dma_hang = false;
+
+	sim_time_advance_ns( cfg.next_irq_ns );
+	CHECK_EQ( HCI_TL_SPI_Receive_DMA( out, sizeof( out ) ), sizeof( event ) );
+	CHECK( 0 == memcmp( out, event, sizeof( event ) ) );
+	check_wire_bytes( ( 3U * HDR ) + sizeof( event ) );
+	HAL_NVIC_EnableIRQ( EXTI0_IRQn );
+
+	/* Write: the failed payload is retried within the same call */
+	memset( cmd, 0xA5, sizeof( cmd ) );
+	spi_setup( &cfg, PATH_DMA );
+	sim_spi_config()->dma_fail = 1U;
+	CHECK_EQ( HCI_TL_SPI_Send_DMA( cmd, sizeof( cmd ) ), 0 );
+	check_wire_bytes( ( 2U * HDR ) + sizeof( cmd ) );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), sizeof( cmd ) );
+	CHECK_EQ( sim_spi_slave_pop_write( out, sizeof( out ) ), 0 );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( stats.tx_frames, 1 );
+}
+
+/* IRQ held high with nothing to read: the bottom half gives up and reports */
+static void test_irq_stuck( void )
+{
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_config_t cfg;
+
+	sim_spi_default_config( &cfg );
+	spi_setup( &cfg, PATH_DMA );
+	sim_spi_config()->irq_stuck_high = true;
+	sim_time_advance_ns( 1000U );
+	CHECK( sim_spi_pendsv() );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( stats.irq_stuck, 1 );
+	CHECK_EQ( stats.rx_empty, 3 );
+	CHECK_EQ( stats.irq_low_timeouts, 3 );
+	CHECK_EQ( sim_hci_spi_irq_stuck(), 1 );
+	sim_spi_config()->irq_stuck_high = false;
+	HAL_NVIC_EnableIRQ( EXTI0_IRQn );
+}
+
+/* Stats accessors called with the mask already up: left as they found it,
+ * the pended bottom half held off until the caller drops it */
+static void test_lock_nesting( void )
+{
+	const uint32_t bh_mask = HCI_TL_SPI_BH_IT_PRIORITY << ( 8U - __NVIC_PRIO_BITS );
+	const uint32_t high_mask = ( HCI_TL_SPI_BH_IT_PRIORITY - 10U ) << ( 8U - __NVIC_PRIO_BITS );
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_config_t cfg;
+
+	sim_spi_default_config( &cfg );
+	spi_setup( &cfg, PATH_POLLED );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( __get_BASEPRI(), 0 );
+
+	__set_BASEPRI( bh_mask );
+	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	HCI_TL_SPI_ResetStats();
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( __get_BASEPRI(), bh_mask );
+	CHECK( false == sim_spi_pendsv() );
+
+	/* A higher priority mask is not lowered to the bottom half one */
+	__set_BASEPRI( high_mask );
+	HCI_TL_SPI_ResetStats();
+	CHECK_EQ( __get_BASEPRI(), high_mask );
+	CHECK( false == sim_spi_pendsv() );
+
+	__set_BASEPRI( 0U );
+	CHECK( sim_spi_pendsv() );
+	HCI_TL_SPI_GetStats( &stats );
+	CHECK_EQ( stats.irq_stuck, 0 );
+	CHECK_EQ( __get_BASEPRI(), 0 );
+}
+
+/* ============================================================================
+ * Throughput: BENCH_FRAMES frames back to back of each size
+ * ==========================================================================*/
+static void bench_read( path_t path, uint32_t sck_hz, uint16_t size )
+{
+	uint8_t event[SIM_SPI_FRAME_MAX];
+	uint8_t out[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+	sim_spi_config_t cfg;
+	uint32_t intact = 0;
+	uint64_t start;
+	uint64_t ns;
+
+	sim_spi_default_config( &cfg );
+	cfg.sck_hz = sck_hz;
+	spi_setup( &cfg, path );
+	HAL_NVIC_DisableIRQ( EXTI0_IRQn );
+	for( uint32_t i = 0; BENCH_FRAMES > i; i++ )
+	{
+		frame_fill( event, size, i );
+		(void)sim_spi_slave_queue( event, size );
+	}
+	sim_spi_clear_stats();
+	start = sim_time_ns();
+	HAL_NVIC_EnableIRQ( EXTI0_IRQn );
+	CHECK( run_bottom_half( 1000U ) );
+	ns = sim_time_ns() - start;
+
+	for( uint32_t i = 0; BENCH_FRAMES > i; i++ )
+	{
+		frame_fill( event, size, i );
+		if( ( size == sim_hci_spi_pop( out, sizeof( out ) ) ) && ( 0 == memcmp( out, event, size ) ) )
+		{
+			intact++;
+		}
+	}
+	CHECK_EQ( intact, BENCH_FRAMES );
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( stats.wire_bytes, BENCH_FRAMES * ( HDR + size ) );
+	CHECK_EQ( slave.bus_bytes, stats.wire_bytes );
+
+	fprintf( stderr, "  read  %-6s %4lu kHz %3u B : %7.1f us/frame %6.1f kB/s payload, wire %4.1f%% payload, core busy %5.1f%%\n",
+	         g_path_name[path], (unsigned long)( sck_hz / 1000U ), size,
+	         (double)ns / 1000.0 / BENCH_FRAMES,
+	         ( (double)BENCH_FRAMES * size ) / ( (double)ns / 1e9 ) / 1000.0,
+	         100.0 * size / ( HDR + size ),
+	         100.0 * (double)slave.cpu_busy_ns / (double)ns );
+}
+
+static void bench_write( path_t path, uint32_t sck_hz, uint16_t size )
+{
+	uint8_t cmd[SIM_SPI_FRAME_MAX];
+	HCI_TL_SPI_Stats_t stats;
+	sim_spi_stats_t slave;
+	sim_spi_config_t cfg;
+	uint64_t start;
+	uint64_t ns;
+	uint32_t accepted = 0;
+
+	sim_spi_default_config( &cfg );
+	cfg.sck_hz = sck_hz;
+	spi_setup( &cfg, path );
+	memset( cmd, 0x3C, size );
+	start = sim_time_ns();
+	for( uint32_t i = 0; BENCH_FRAMES > i; i++ )
+	{
+		const int32_t ret = ( PATH_DMA == path ) ? HCI_TL_SPI_Send_DMA( cmd, size ) : HCI_TL_SPI_Send( cmd, size );
+		accepted += ( 0 == ret ) ? 1U : 0U;
+		/* The controller consumes it before the next command */
+		uint8_t out[SIM_SPI_FRAME_MAX];
+		(void)sim_spi_slave_pop_write( out, sizeof( out ) );
+	}
+	ns = sim_time_ns() - start;
+	CHECK_EQ( accepted, BENCH_FRAMES );
+	HCI_TL_SPI_GetStats( &stats );
+	sim_spi_get_stats( &slave );
+	CHECK_EQ( slave.bus_bytes, stats.wire_bytes );
+
+	fprintf( stderr, "  write %-6s %4lu kHz %3u B : %7.1f us/frame %6.1f kB/s payload, %lu retries, core busy %5.1f%%\n",
+	         g_path_name[path], (unsigned long)( sck_hz / 1000U ), size,
+	         (double)ns / 1000.0 / BENCH_FRAMES,
+	         ( (double)BENCH_FRAMES * size ) / ( (double)ns / 1e9 ) / 1000.0,
+	         (unsigned long)stats.tx_retries,
+	         100.0 * (double)slave.cpu_busy_ns / (double)ns );
+}
+
+static void bench( void )
+{
+	static const uint16_t sizes[] = { 8U, 16U, 32U, 64U, 128U, 255U };
+	static const uint32_t clocks[] = { SIM_SPI_SCK_HZ_DEFAULT, 8000000U };
+
+	fprintf( stderr, "SPI throughput, %u frames per line\n", (unsigned)BENCH_FRAMES );
+	for( uint32_t c = 0; ( sizeof( clocks ) / sizeof( clocks[0] ) ) > c; c++ )
+	{
+		for( uint32_t p = PATH_POLLED; PATH_DMA >= p; p++ )
+		{
+			for( uint32_t s = 0; ( sizeof( sizes ) / sizeof( sizes[0] ) ) > s; s++ )
+			{
+				bench_read( (path_t)p, clocks[c], sizes[s] );
+			}
+		}
+	}
+	for( uint32_t p = PATH_POLLED; PATH_DMA >= p; p++ )
+	{
+		for( uint32_t s = 0; ( sizeof( sizes ) / sizeof( sizes[0] ) ) > s; s++ )
+		{
+			bench_write( (path_t)p, SIM_SPI_SCK_HZ_DEFAULT, sizes[s] );
+		}
+	}
+}
+
+int main( void )
+{
+	test_header();
+	test_frames( PATH_POLLED );
+	test_frames( PATH_DMA );
+	test_irq_handshake();
+	test_back_pressure( PATH_POLLED );
+	test_back_pressure( PATH_DMA );
+	test_timeout();
+	test_delays();
+	test_dma_faults();
+	test_irq_stuck();
+	test_lock_nesting();
+	bench();
+
+	return TEST_END( "test_spi_slave" );
+}
@@ -0,0 +1,163 @@
+/*
+ * test_throughput.c
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * health_data_tx throughput against the simulated controller with ATT_MTU
+ * 23, 100 and 247: one central per MTU (client RX MTU of the exchange), the
+ * TX queue kept full with ATT_MTU - 3 byte payloads for STREAM_MS of virtual
+ * time. Same link otherwise (30 ms interval, DLE, 2M PHY, no pairing), so
+ * the difference is the number of notifications the payload takes. The
+ * controller TX pool (SIM_TX_POOL_DEFAULT buffers, freed at the end of a
+ * connection event) bounds every event to that many notifications, so the
+ * rate goes with the payload size.
+ */
+
+#include <string.h>
+
+#include "app_includes.h"
+#include "sim.h"
+#include "test_util.h"
+
+#define STREAM_MS							( 3000U )
+#define SETTLE_MS							( 1000U )			/* MTU exchange, DLE, PHY, L2CAP update */
+
+extern uint16_t health_data_tx_char_handle;
+extern tBleStatus health_data_tx( const uint8_t * data_tx, uint16_t tx_bytes_len );
+
+static sim_central_t g_central;
+static uint32_t g_next_seq;
+static uint32_t g_rx_seq;
+static uint32_t g_rx_errors;
+static uint16_t g_rx_len;
+
+/* Payload: 32-bit sequence number, then filler */
+static void on_notify( void * p_central, uint16_t attr_handle, const uint8_t * data, uint16_t len )
+{
+	uint32_t seq;
+
+	(void)p_central;
+	memcpy( &seq, data, sizeof( seq ) );
+	if( ( ( health_data_tx_char_handle + 1U ) != attr_handle ) || ( g_rx_len != len ) || ( g_rx_seq != seq ) )
+	{
+		g_rx_errors++;
+	}
+	g_rx_seq = seq + 1U;
+}
+
+static bool cond_advertising( void * arg )
+{
+	(void)arg;
+	return sim_ctrl_is_advertising();
+}
+
+static bool cond_disconnected( void * arg )
+{
+	(void)arg;
+	return 0U == link_count();
+}
+
+/* TX queue topped up with the next payloads. The queue keeps references:
+ * one buffer per entry, reused once the entry has gone to the controller */
+static void top_up( uint16_t len )
+{
+	static uint8_t payloads[TX_QUEUE_DEPTH][LINK_ATT_MTU_MAX - LINK_ATT_NOTIFY_OVERHEAD];
+
+	while( TX_QUEUE_DEPTH > tx_queue_depth() )
+	{
+		uint8_t * p_payload = payloads[g_next_seq % TX_QUEUE_DEPTH];
+
+		memset( p_payload, 0xA5, len );
+		memcpy( p_payload, &g_next_seq, sizeof( g_next_seq ) );
+		if( BLE_STATUS_SUCCESS != tx_queue_push( p_payload, len ) )
+		{
+			break;
+		}
+		g_next_seq++;
+	}
+}
+
+/* Bytes per second delivered at att_mtu */
+static uint32_t stream( uint16_t att_mtu, uint8_t addr_last )
+{
+	const uint16_t len = (uint16_t)( att_mtu - LINK_ATT_NOTIFY_OVERHEAD );
+	uint8_t payload[LINK_ATT_MTU_MAX] = { 0 };
+	sim_conn_stats_t stats_before;
+	sim_conn_stats_t stats;
+	uint32_t bytes;
+	uint64_t start;
+	uint16_t conn;
+
+	CHECK( sim_run_until( cond_advertising, NULL, 2000U ) );
+	sim_central_init( &g_central, addr_last );
+	g_central.att_mtu = att_mtu;
+	g_central.pairs = false;
+	g_central.on_notify = on_notify;
+	conn = sim_connect( &g_central );
+	CHECK( 0xFFFFU != conn );
+	sim_run_ms( SETTLE_MS );
+	CHECK_EQ( link_get_att_mtu( conn ), att_mtu );
+	CHECK_EQ( sim_subscribe( &g_central, health_data_tx_char_handle, true ), 0 );
+	sim_run_ms( 10U );
+	CHECK_EQ( link_get_fanout_notify_len( LINK_CCCD_DATA_TX ), len );
+
+	/* One byte more than ATT_MTU - 3 is refused, not truncated */
+	CHECK_EQ( health_data_tx( payload, len + 1U ), BLE_STATUS_INVALID_PARAMS );
+
+	g_next_seq = 0;
+	g_rx_seq = 0;
+	g_rx_errors = 0;
+	g_rx_len = len;
+	g_central.notifications = 0;
+	g_central.notified_bytes = 0;
+	CHECK( sim_conn_stats( &g_central, &stats_before ) );
+	start = sim_time_ns();
+	while( ( sim_time_ns() - start ) < ( (uint64_t)STREAM_MS * SIM_NS_PER_MS ) )
+	{
+		top_up( len );
+		sim_run_ms( 1U );
+	}
+	bytes = g_central.notified_bytes;
+	CHECK( sim_conn_stats( &g_central, &stats ) );
+
+	/* In order, whole, none cut to the MTU */
+	CHECK_EQ( g_rx_errors, 0 );
+	CHECK( 0U != g_central.notifications );
+	CHECK_EQ( bytes, g_central.notifications * len );
+	CHECK_EQ( stats.truncated, 0 );
+
+	fprintf( stderr, "  ATT_MTU %3u : %6lu bytes/s, %5lu notifications, %2lu.%02lu per connection event, %3lu us airtime per event (interval %u x 1.25 ms, %u B LL, %uM PHY)\n",
+	         att_mtu, (unsigned long)( ( (uint64_t)bytes * 1000U ) / STREAM_MS ),
+	         (unsigned long)g_central.notifications,
+	         (unsigned long)( ( g_central.notifications * 100U ) / ( stats.data_events - stats_before.data_events ) / 100U ),
+	         (unsigned long)( ( g_central.notifications * 100U ) / ( stats.data_events - stats_before.data_events ) % 100U ),
+	         (unsigned long)( ( stats.airtime_ns - stats_before.airtime_ns ) / ( stats.data_events - stats_before.data_events ) / SIM_NS_PER_US ),
+	         stats.interval, stats.tx_octets, stats.tx_phy );
+
+	sim_disconnect( &g_central, 0x13U );
+	CHECK( sim_run_until( cond_disconnected, NULL, 1000U ) );
+
+	return ( bytes * 1000U ) / STREAM_MS;
+}
+
+int main( void )
+{
+	uint32_t rate_23;
+	uint32_t rate_100;
+	uint32_t rate_247;
+
+	sim_ctrl_power_on( 7U );
+	CHECK_EQ( sim_boot(), BLE_STATUS_SUCCESS );
+
+	fprintf( stderr, "health_data_tx, TX queue kept full for %u ms\n", STREAM_MS );
+	rate_23 = stream( LINK_ATT_MTU_DEFAULT, 0x23U );
+	rate_100 = stream( 100U, 0x64U );
+	rate_247 = stream( LINK_ATT_MTU_MAX, 0xF7U );
+
+	/* Fewer, larger notifications carry more per connection event */
+	CHECK( rate_100 > rate_23 );
+	CHECK( rate_247 > rate_100 );
+
+	return TEST_END( "test_throughput" );
+}
@@ -0,0 +1,45 @@
+/*
+ * test_util.h
+ *
+ *  Created on: 17-Oct-2026
+ *      Author: Rajeev
+ *
+ * Checks of the host tests: a failed CHECK() is reported with its line and
+ * counted, TEST_END() turns the count into the exit status.
+ */
+
+#ifndef HOST_TEST_UTIL_H_
+#define HOST_TEST_UTIL_H_
+
+#include <stdio.h>
+
+static unsigned int g_test_checks = 0;
+static unsigned int g_test_failures = 0;
+
+#define CHECK( cond ) \
+	do { \
+		g_test_checks++; \
+		if( !( cond ) ) \
+		{ \
+			g_test_failures++; \
+			fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #cond ); \
+		} \
+	} while( 0 )
+
+#define CHECK_EQ( a, b ) \
+	do { \
+		const long long check_a_ = (long long)( a ); \
+		const long long check_b_ = (long long)( b ); \
+		g_test_checks++; \
+		if( check_a_ != check_b_ ) \
+		{ \
+			g_test_failures++; \
+			fprintf( stderr, "%s:%d: CHECK_EQ( %s, %s ) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a_, check_b_ ); \
+		} \
+	} while( 0 )
+
+#define TEST_END( name ) \
+	( fprintf( stderr, "%-28s %s (%u checks, %u failed)\n", ( name ), ( 0U == g_test_failures ) ? "PASS" : "FAIL", \
+	           g_test_checks, g_test_failures ), ( 0U == g_test_failures ) ? 0 : 1 )
+
+#endif /* HOST_TEST_UTIL_H_ */